@@ -0,0 +1,42 @@
+// デュアルクォータニオンスキニング（DualQuaternionSkinning.cppのSkinVertexDualQuaternionと同じ計算）
+// パレットは1ジョイント32バイト（回転real + 移動dual）
+
+struct DualQuaternion
+{
+    float32_t4 real;
+    float32_t4 dual;
+};
+StructuredBuffer<DualQuaternion> gDualQuaternionPalette : register(t1);
+
+// 単位クォータニオンでベクトルを回転
+float32_t3 RotateByQuaternion(float32_t4 q, float32_t3 v)
+{
+    return v + 2.0f * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+// 重みで合成したデュアルクォータニオンで位置と法線を変換する
+void SkinningDualQuaternion(float32_t4 position, float32_t3 normal, float32_t4 weight, int4 index,
+    out float32_t4 skinnedPosition, out float32_t3 skinnedNormal)
+{
+    DualQuaternion dq0 = gDualQuaternionPalette[index.x];
+    DualQuaternion dq1 = gDualQuaternionPalette[index.y];
+    DualQuaternion dq2 = gDualQuaternionPalette[index.z];
+    DualQuaternion dq3 = gDualQuaternionPalette[index.w];
+
+    // 最初のインフルエンスと同じ半球にそろえる（q と -q は同じ回転）
+    float32_t w1 = dot(dq0.real, dq1.real) < 0.0f ? -weight.y : weight.y;
+    float32_t w2 = dot(dq0.real, dq2.real) < 0.0f ? -weight.z : weight.z;
+    float32_t w3 = dot(dq0.real, dq3.real) < 0.0f ? -weight.w : weight.w;
+
+    float32_t4 real = dq0.real * weight.x + dq1.real * w1 + dq2.real * w2 + dq3.real * w3;
+    float32_t4 dual = dq0.dual * weight.x + dq1.dual * w1 + dq2.dual * w2 + dq3.dual * w3;
+    float32_t inverseLength = rsqrt(dot(real, real));
+    real *= inverseLength;
+    dual *= inverseLength;
+
+    // 移動 = 2 * dual * conj(real)
+    float32_t3 translate = 2.0f * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+
+    skinnedPosition = float32_t4(RotateByQuaternion(real, position.xyz) + translate, 1.0f);
+    skinnedNormal = normalize(RotateByQuaternion(real, normal));
+}
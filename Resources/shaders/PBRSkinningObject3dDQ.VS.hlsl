@@ -0,0 +1,81 @@
+// PBRスキニング専用頂点シェーダー（デュアルクォータニオンのパレット版）
+// PBRObject3d.PS.hlslと互換性のある出力を提供
+
+struct TransformationMatrix
+{
+    float32_t4x4 WVP;
+    float32_t4x4 World;
+};
+ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
+
+struct VertexShaderInput
+{
+    float32_t4 position : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t3 normal : NORMAL0;
+    float32_t4 weight : WEIGHT0;
+    int4 index : INDEX0;
+};
+
+struct VertexShaderOutput
+{
+    float32_t4 position : SV_POSITION;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t3 normal : NORMAL0;
+    float32_t3 worldPosition : POSITION0;
+    float32_t3 tangent : TANGENT0;
+    float32_t3 bitangent : BITANGENT0;
+};
+
+struct Skinned
+{
+    float32_t4 position;
+    float32_t3 normal;
+    float32_t3 tangent;
+    float32_t3 bitangent;
+};
+
+#include "DualQuaternionSkinning.hlsli"
+
+// スキニング処理（デュアルクォータニオンのパレット。TANGENTとBITANGENT計算を含む）
+Skinned Skinning(VertexShaderInput input)
+{
+    Skinned skinned;
+    
+    SkinningDualQuaternion(input.position, input.normal, input.weight, input.index, skinned.position, skinned.normal);
+    
+    // Tangent と Bitangent を Normal から計算（PBRで必要）
+    // 簡単な手法：Normalから垂直なベクトルを生成
+    float3 worldNormal = skinned.normal;
+    
+    // 法線ベクトルに垂直なタンジェントベクトルを計算
+    float3 arbitraryVector = abs(worldNormal.x) < 0.9 ? float3(1, 0, 0) : float3(0, 1, 0);
+    skinned.tangent = normalize(cross(arbitraryVector, worldNormal));
+    
+    // バイタンジェントはタンジェントと法線の外積
+    skinned.bitangent = normalize(cross(worldNormal, skinned.tangent));
+    
+    return skinned;
+}
+
+VertexShaderOutput main(VertexShaderInput input)
+{
+    VertexShaderOutput output;
+    
+    // スキニング処理
+    Skinned skinned = Skinning(input);
+    
+    // 座標変換
+    output.position = mul(skinned.position, gTransformationMatrix.WVP);
+    output.texcoord = input.texcoord;
+    
+    // ワールド座標での法線・タンジェント・バイタンジェント
+    output.normal = normalize(mul(skinned.normal, (float32_t3x3)gTransformationMatrix.World));
+    output.tangent = normalize(mul(skinned.tangent, (float32_t3x3)gTransformationMatrix.World));
+    output.bitangent = normalize(mul(skinned.bitangent, (float32_t3x3)gTransformationMatrix.World));
+    
+    // ワールド座標での位置
+    output.worldPosition = mul(skinned.position, gTransformationMatrix.World).xyz;
+    
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include "Particle.hlsli"
+
+struct RibbonTransform
+{
+    float32_t4x4 viewProjection;
+};
+
+ConstantBuffer<RibbonTransform> gRibbonTransform : register(b0);
+
+struct VertexShaderInput
+{
+    float32_t3 position : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t4 color : COLOR0;
+};
+
+// リボンの頂点はCPUでワールド座標に展開済み
+VertexShaderOutput main(VertexShaderInput input)
+{
+    VertexShaderOutput output;
+    output.position = mul(float32_t4(input.position, 1.0f), gRibbonTransform.viewProjection);
+    output.texcoord = input.texcoord;
+    output.color = input.color;
+    return output;
+}
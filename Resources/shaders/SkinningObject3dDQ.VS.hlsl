@@ -0,0 +1,55 @@
+#include "Object3d.hlsli"
+
+struct TransformationMatrix
+{
+    float32_t4x4 WVP;
+    float32_t4x4 World;
+};
+ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
+
+struct VertexShaderInput
+{
+    float32_t4 position : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t3 normal : NORMAL0;
+    float32_t4 weight : WEIGHT0;
+    int4 index : INDEX0;
+};
+
+#include "DualQuaternionSkinning.hlsli"
+
+struct Skinned
+{
+    float32_t4 position;
+    float32_t3 normal;
+};
+
+// デュアルクォータニオンのパレットでスキニング（SkinningObject3d.VS.hlslの行列パレット版と出力は同じ）
+Skinned Skinning(VertexShaderInput input)
+{
+    Skinned skinned;
+    SkinningDualQuaternion(input.position, input.normal, input.weight, input.index, skinned.position, skinned.normal);
+    return skinned;
+}
+
+VertexShaderOutput main(VertexShaderInput input)
+{
+    VertexShaderOutput output;
+    
+    // スキニング処理
+    Skinned skinned = Skinning(input);
+    
+    // スキニング後の頂点でWVP変換
+    output.position = mul(skinned.position, gTransformationMatrix.WVP);
+    output.texcoord = input.texcoord;
+    
+    // ワールド座標を計算
+    float32_t4 worldPos = mul(skinned.position, gTransformationMatrix.World);
+    output.worldPos = worldPos.xyz;
+    
+    // スキニング後の法線をワールド空間に変換
+    float32_t3 worldNormal = mul(skinned.normal, (float32_t3x3)gTransformationMatrix.World);
+    output.normal = normalize(worldNormal);
+    
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,2786 @@
+// AnimationBench - キーフレームサンプリングのヘッドレスベンチマーク
+// 同梱のwalk/sneakWalkと10分間の合成クリップを、線形探索（旧実装）・二分探索・カーソル付き・
+// コンパイル済みクリップ（ジョイント番号順の連続配列）・圧縮済みクリップで比較する
+// 各手法のキーのメモリ量と、旧実装に対する最大誤差も出力する
+// 1フレーム分のジョイントのループ全体も、名前でトラックを検索する旧経路とコンパイル済みクリップで比較する
+// 最後にブレンドツリーで複数クリップ・加算レイヤーを合成する負荷と、評価中のメモリ確保回数を計測し、
+// 多数のキャラクターのスケルトン評価（サンプリング～パレット書き込み）を1スレッドとJobSystemで比較する
+// 更新頻度LODは、なし・評価フレームのずらしなし・ずらしありで平均と最大のフレーム負荷を比較する
+// ポーズキャッシュは、同じクリップを8通りの位置から再生する群衆でキャッシュの有無を比較する
+// 焼き込んだパレットは、形式・サンプリングレートごとにメモリ量・読み出しの負荷・通常の評価との誤差を出力する
+// デュアルクォータニオンのパレットは、行列パレットとの作成負荷・サイズと、CPUでスキニングした頂点の差を出力する
+// CPUスキニングは、1頂点ずつの参照実装とSIMDのカーネルの負荷・誤差、ジョイントごとの範囲から求めたAABBを
+// 全頂点をスキニングしたAABBと比較する（結果が全頂点を含むかと、どれだけ大きいか）
+// ボーンウェイトの読み込みは、面を走査し直す旧実装と最適化の対応表で付け替える実装を格子状のメッシュの大きさごとに比較する
+// ルートモーションは、前計算した曲線の差分と毎フレームのルートの再サンプリングの負荷を比較し、
+// スケルトン全体の評価に対する抽出の誤差・ループをまたいで積み上げた誤差・除いた後の固定の誤差を出力する
+// アニメーションイベントは、イベントごとのリスナーが毎フレーム時刻を調べる方式と時刻順の配列の二分探索を比較し、
+// 不規則なフレーム時間でループをまたいでも各イベントがループごとにちょうど1回起きるかを確認する
+// IKは、2ボーン（脚・腕）と注視の解の誤差・1回の負荷と、脚を書き換えた後に部分木だけ計算し直す負荷を
+// スケルトン全体の再計算と比較する
+// スケルトンの差分更新は、深いジョイントから順に静止させたクリップでアニメーションするジョイントの割合を変え、
+// 値が変わるジョイントとその子孫だけを計算し直す更新と全体の再計算の負荷・行列の差を比較する
+// リターゲットは、名前空間を外して各ジョイントの向きと骨の長さを変えたスケルトンへ変換したクリップの位置・向きの誤差と、
+// 対応表の作成・キャッシュからの取得・クリップの変換の負荷を出力する
+// モデルのキャッシュは、インポート済みのメッシュ・スケルトン・クリップの書き出しとメモリにマップした読み込みの負荷と、
+// 読み込んだ内容が一致するか・元ファイルのハッシュが違うものや途中で切れたものを読まないかを確認する
+// OBJの読み込みは、1行ずつistringstreamで読む旧実装とファイルをマップしてstd::from_charsで読む実装を格子状のメッシュで比較し、
+// 頂点をまとめた結果を展開すると旧実装と一致するかと、負のインデックス・UVと法線のない四角形の面を読めるかを確認する
+// 頂点の溶接は、頂点ごとに文字列のキーを作る旧実装と量子化したキーの開番地法のハッシュ表を比較し、
+// まとめた頂点の数・メモリ確保の回数と、完全一致の溶接で元の頂点を復元できるかを出力する
+// メッシュの最適化は、展開した頂点を順に描く格子と三角形の順序が不規則な球で、溶接・頂点キャッシュ・オーバードロー・
+// 頂点の取得の順の並べ替えの前後のACMR・ATVRと、並べ替えた後も同じ三角形（巻き順を含む）が残っているかを出力する
+// また、溶接せずに最適化したメッシュのボーンウェイトの付け替えで、各頂点が元のジョイントと重みの組を保つかを確認する（違えば終了コード1）
+//
+// 使い方: AnimationBench [--clip all|walk|sneakWalk|synthetic10min|blend|skinning|lod|posecache|baked|dq|cpuskin|skinimport|rootmotion|events|ik|incremental|retarget|modelcache|objparse|weld|meshopt] [--frames N] [--instances N]
+//                        [--characters N] [--threads N] [--models DIR] [--csv]
+#include "AnimationBlendTree.h"
+#include "AnimationCompression.h"
+#include "AnimationEvent.h"
+#include "AnimationIk.h"
+#include "AnimationLod.h"
+#include "AnimationPlayer.h"
+#include "AnimationPoseCache.h"
+#include "AnimationRetarget.h"
+#include "BakedAnimation.h"
+#include "DualQuaternionSkinning.h"
+#include "AnimationSampler.h"
+#include "CompiledAnimationClip.h"
+#include "CpuSkinning.h"
+#include "JobSystem.h"
+#include "ModelCache.h"
+#include "MeshOptimizer.h"
+#include "ObjParser.h"
+#include "VertexWeld.h"
+#include "RootMotion.h"
+#include "SkeletonUpdate.h"
+#include "SkinWeightImport.h"
+#include "BenchAnimation.h"
+#include "BenchUtility.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    // 1フレームの時間
+    const float kDeltaTime = 1.0f / 60.0f;
+
+    // 旧実装（先頭からの線形探索）。比較の基準として残す
+    template <typename Keyframe, typename Value, typename Interpolate>
+    Value CalculateValueLinear(const std::vector<Keyframe>& keyframes, float time, Interpolate interpolate) {
+        if (keyframes.size() == 1 || time <= keyframes[0].time) {
+            return keyframes[0].value;
+        }
+        for (size_t index = 0; index < keyframes.size() - 1; ++index) {
+            size_t nextIndex = index + 1;
+            if (keyframes[index].time <= time && time <= keyframes[nextIndex].time) {
+                float t = (time - keyframes[index].time) / (keyframes[nextIndex].time - keyframes[index].time);
+                return interpolate(keyframes[index].value, keyframes[nextIndex].value, t);
+            }
+        }
+        return keyframes.back().value;
+    }
+
+    // トラック1つ分のカーソル（translate, rotate, scale）
+    struct NodeAnimationCursor {
+        KeyframeCursor translate;
+        KeyframeCursor rotate;
+        KeyframeCursor scale;
+    };
+
+    enum class Method { Linear, Binary, Cursor, Compiled, Compressed };
+    const char* kMethodNames[] = { "linear", "binary", "cursor", "compiled", "compressed" };
+
+    // 計測結果
+    struct Result {
+        double totalNs = 0.0;
+        uint64_t samples = 0;
+        size_t bytes = 0;           // キーのメモリ量
+        std::vector<float> values;  // 全サンプル値（手法間の誤差比較用）
+    };
+
+    // 元のキーフレーム配列のメモリ量
+    size_t GetAnimationMemorySize(const Animation& animation) {
+        size_t size = 0;
+        for (const auto& [name, track] : animation.nodeAnimations) {
+            size += track.translate.size() * sizeof(KeyframeVector3);
+            size += track.rotate.size() * sizeof(KeyframeQuaternion);
+            size += track.scale.size() * sizeof(KeyframeVector3);
+        }
+        return size;
+    }
+
+    // 1トラック分（10要素）の誤差。回転は量子化で符号が反転することがあるのでそろえて比較する
+    float CalculateTrackError(const float* a, const float* b) {
+        float error = 0.0f;
+        for (int i : { 0, 1, 2, 7, 8, 9 }) {
+            error = std::max(error, std::fabs(a[i] - b[i]));
+        }
+        Quaternion qa = { a[3], a[4], a[5], a[6] };
+        Quaternion qb = { b[3], b[4], b[5], b[6] };
+        return std::max(error, CalculateMaxError(qa, qb));
+    }
+
+    // instances体のキャラクターが、クリップ内の異なる位置から同じクリップを再生する
+    // compiledはスケルトンに結び付けたクリップで、全ジョイントのポーズをまとめてサンプリングする
+    Result Run(const Animation& animation, const Skeleton& skeleton, Method method, uint32_t frames, uint32_t instances) {
+        std::vector<const NodeAnimation*> tracks;
+        std::vector<int32_t> trackJoints;
+        for (const auto& [name, nodeAnimation] : animation.nodeAnimations) {
+            tracks.push_back(&nodeAnimation);
+            auto it = skeleton.jointMap.find(name);
+            trackJoints.push_back(it != skeleton.jointMap.end() ? it->second : -1);
+        }
+        std::vector<NodeAnimationCursor> cursors(tracks.size() * instances);
+
+        CompiledAnimationClip clip;
+        clip.Compile(animation, skeleton);
+        if (method == Method::Compressed) {
+            clip.Compress();
+        }
+        std::vector<KeyframeCursor> clipCursors(static_cast<size_t>(clip.GetCursorCount()) * instances);
+        AnimationPose pose;
+
+        Result result;
+        result.bytes = (method == Method::Compiled || method == Method::Compressed) ? clip.GetMemorySize() : GetAnimationMemorySize(animation);
+        result.values.reserve(static_cast<size_t>(frames) * instances * tracks.size() * 10);
+        std::vector<float> frameValues(tracks.size() * 10);
+
+        auto lerp = [](const Vector3& a, const Vector3& b, float t) { return Lerp(a, b, t); };
+        auto slerp = [](const Quaternion& a, const Quaternion& b, float t) { return Slerp(a, b, t); };
+
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            for (uint32_t instance = 0; instance < instances; ++instance) {
+                float start = animation.duration * static_cast<float>(instance) / static_cast<float>(instances);
+                float time = std::fmod(start + frame * kDeltaTime, animation.duration);
+
+                // コンパイル済みクリップは全ジョイントのポーズをまとめてサンプリングし、各トラックはその結果を読む
+                BenchUtility::Timer timer;
+                if (method == Method::Compiled || method == Method::Compressed) {
+                    clip.Sample(time, pose, &clipCursors[static_cast<size_t>(instance) * clip.GetCursorCount()]);
+                }
+                for (size_t i = 0; i < tracks.size(); ++i) {
+                    const NodeAnimation& track = *tracks[i];
+                    NodeAnimationCursor& cursor = cursors[instance * tracks.size() + i];
+                    Vector3 translate{};
+                    Quaternion rotate{};
+                    Vector3 scale{};
+                    switch (method) {
+                    case Method::Linear:
+                        translate = CalculateValueLinear<KeyframeVector3, Vector3>(track.translate, time, lerp);
+                        rotate = CalculateValueLinear<KeyframeQuaternion, Quaternion>(track.rotate, time, slerp);
+                        scale = CalculateValueLinear<KeyframeVector3, Vector3>(track.scale, time, lerp);
+                        break;
+                    case Method::Binary:
+                        translate = CalculateValue(track.translate, time);
+                        rotate = CalculateValue(track.rotate, time);
+                        scale = CalculateValue(track.scale, time);
+                        break;
+                    case Method::Cursor:
+                        translate = CalculateValue(track.translate, time, cursor.translate);
+                        rotate = CalculateValue(track.rotate, time, cursor.rotate);
+                        scale = CalculateValue(track.scale, time, cursor.scale);
+                        break;
+                    case Method::Compiled:
+                    case Method::Compressed:
+                        // スケルトンにないトラックはクリップに含まれないので0のまま
+                        if (trackJoints[i] >= 0) {
+                            translate = pose.translate[trackJoints[i]];
+                            rotate = pose.rotate[trackJoints[i]];
+                            scale = pose.scale[trackJoints[i]];
+                        }
+                        break;
+                    }
+                    float* out = &frameValues[i * 10];
+                    out[0] = translate.x; out[1] = translate.y; out[2] = translate.z;
+                    out[3] = rotate.x; out[4] = rotate.y; out[5] = rotate.z; out[6] = rotate.w;
+                    out[7] = scale.x; out[8] = scale.y; out[9] = scale.z;
+                }
+                result.totalNs += timer.ElapsedNs();
+                result.samples += tracks.size() * 3;
+                result.values.insert(result.values.end(), frameValues.begin(), frameValues.end());
+            }
+        }
+        return result;
+    }
+
+    // 最長トラックのキー数
+    size_t GetMaxKeyCount(const Animation& animation) {
+        size_t count = 0;
+        for (const auto& [name, track] : animation.nodeAnimations) {
+            count = std::max({ count, track.translate.size(), track.rotate.size(), track.scale.size() });
+        }
+        return count;
+    }
+
+    // clipCount個のクリップを均等な重みで合成し、additiveなら上半身マスク付きの加算レイヤーも重ねる
+    void BenchmarkBlend(const std::string& name, const std::vector<const CompiledAnimationClip*>& clips,
+        const Skeleton& skeleton, uint32_t clipCount, bool additive, uint32_t frames, bool csv) {
+
+        AnimationPose restPose;
+        ReadPoseFromSkeleton(skeleton, restPose);
+        AnimationBlendTree tree;
+        tree.Initialize(restPose);
+        uint32_t baseLayer = tree.AddLayer(AnimationBlendTree::BlendMode::Override, clipCount);
+        for (uint32_t i = 0; i < clipCount; ++i) {
+            tree.SetClip(baseLayer, i, clips[i % clips.size()]);
+            tree.SetClipWeight(baseLayer, i, 1.0f);
+            tree.SetClipTime(baseLayer, i, clips[i % clips.size()]->GetDuration() * static_cast<float>(i) / static_cast<float>(clipCount));
+        }
+        if (additive) {
+            uint32_t layer = tree.AddLayer(AnimationBlendTree::BlendMode::Additive, 1, 0.5f);
+            tree.SetClip(layer, 0, clips.back());
+            tree.SetClipWeight(layer, 0, 1.0f);
+            std::vector<float> mask = MakeBoneMask(skeleton, skeleton.joints.size() > 1 ? skeleton.joints[1].name : skeleton.joints[0].name);
+            tree.SetLayerMask(layer, mask.data());
+        }
+
+        AnimationPose pose;
+        tree.Evaluate(pose);
+
+        uint64_t allocations = BenchUtility::GetAllocationCount();
+        double totalNs = 0.0;
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            tree.Update(kDeltaTime);
+            BenchUtility::Timer timer;
+            tree.Evaluate(pose);
+            totalNs += timer.ElapsedNs();
+        }
+        allocations = BenchUtility::GetAllocationCount() - allocations;
+
+        uint32_t activeClips = clipCount + (additive ? 1 : 0);
+        double nsPerFrame = totalNs / frames;
+        double nsPerJointClip = nsPerFrame / (static_cast<double>(tree.GetJointCount()) * activeClips);
+        if (csv) {
+            std::printf("%s,blend%u%s,%u,%u,%.3f,%.3f,%llu\n", name.c_str(), clipCount, additive ? "+additive" : "",
+                tree.GetJointCount(), activeClips, nsPerFrame, nsPerJointClip, static_cast<unsigned long long>(allocations));
+        } else {
+            std::printf("%-15s blend %u clip%s%-10s joints:%4u  %9.1f ns/frame  %7.3f ns/joint/clip  allocations:%llu\n",
+                name.c_str(), clipCount, clipCount > 1 ? "s" : " ", additive ? " +additive" : "",
+                tree.GetJointCount(), nsPerFrame, nsPerJointClip, static_cast<unsigned long long>(allocations));
+        }
+    }
+
+    // 1体分のキャラクター（AnimatedModel相当の状態）
+    struct Character {
+        AnimationBlendTree tree;
+        Skeleton skeleton;
+        AnimationPose pose;
+        std::vector<WellForGPU> palette;
+    };
+
+    // 全キャラクターを1フレーム分評価（Object3d::UpdateAnimationと同じ処理）
+    double UpdateCharacters(std::vector<Character>& characters, const std::vector<Matrix4x4>& inverseBindPoses) {
+        BenchUtility::Timer timer;
+        JobSystem::GetInstance()->ParallelFor(static_cast<uint32_t>(characters.size()), 4, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                Character& character = characters[i];
+                character.tree.Update(kDeltaTime);
+                character.tree.Evaluate(character.pose);
+                ApplyPoseToSkeleton(character.pose, character.skeleton);
+                UpdateSkeletonSpaceMatrices(character.skeleton);
+                UpdateSkinPalette(character.skeleton, inverseBindPoses, character.palette);
+            }
+        });
+        return timer.ElapsedNs();
+    }
+
+    // characters体がwalkとsneakWalkをクロスフェードしながら再生する
+    void BenchmarkSkinning(const std::vector<const CompiledAnimationClip*>& clips, const Skeleton& skeleton,
+        uint32_t characterCount, uint32_t threadCount, uint32_t frames, bool csv) {
+
+        AnimationPose restPose;
+        ReadPoseFromSkeleton(skeleton, restPose);
+        Skeleton bindSkeleton = skeleton;
+        UpdateSkeletonSpaceMatrices(bindSkeleton);
+        std::vector<Matrix4x4> inverseBindPoses;
+        for (const Joint& joint : bindSkeleton.joints) {
+            inverseBindPoses.push_back(Inverse(joint.skeletonSpaceMatrix));
+        }
+
+        std::vector<Character> characters(characterCount);
+        for (uint32_t i = 0; i < characterCount; ++i) {
+            Character& character = characters[i];
+            character.skeleton = skeleton;
+            character.palette.resize(skeleton.joints.size());
+            character.tree.Initialize(restPose);
+            character.tree.AddLayer(AnimationBlendTree::BlendMode::Override, 2);
+            float phase = static_cast<float>(i) / static_cast<float>(characterCount);
+            for (uint32_t slot = 0; slot < 2; ++slot) {
+                character.tree.SetClip(0, slot, clips[slot % clips.size()]);
+                character.tree.SetClipTime(0, slot, clips[slot % clips.size()]->GetDuration() * phase);
+                character.tree.SetClipWeight(0, slot, slot == 0 ? 1.0f - phase : phase);
+            }
+        }
+
+        // 1スレッド（JobSystemの初期化前はその場で実行される）
+        double serialNs = 0.0;
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            serialNs += UpdateCharacters(characters, inverseBindPoses);
+        }
+
+        JobSystem::GetInstance()->Initialize(threadCount > 0 ? threadCount - 1 : 0);
+        uint32_t parallelThreads = JobSystem::GetInstance()->GetThreadCount();
+        double parallelNs = 0.0;
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            parallelNs += UpdateCharacters(characters, inverseBindPoses);
+        }
+        JobSystem::GetInstance()->Finalize();
+
+        double serialMs = serialNs / frames / 1.0e6;
+        double parallelMs = parallelNs / frames / 1.0e6;
+        if (csv) {
+            std::printf("characters,threads,joints,serial_ms,parallel_ms,speedup\n");
+            std::printf("%u,%u,%zu,%.3f,%.3f,%.2f\n", characterCount, parallelThreads, skeleton.joints.size(),
+                serialMs, parallelMs, serialMs / parallelMs);
+        } else {
+            std::printf("skinning        %u characters x %zu joints  1 thread: %7.3f ms/frame  %u threads: %7.3f ms/frame  x%.2f  (60Hz budget 16.667 ms)\n",
+                characterCount, skeleton.joints.size(), serialMs, parallelThreads, parallelMs, serialMs / parallelMs);
+        }
+    }
+
+    // DirectXの左手系の透視投影（行ベクトル規約）
+    Matrix4x4 MakePerspective(float fovY, float aspectRatio, float nearClip, float farClip) {
+        float cot = 1.0f / std::tan(fovY * 0.5f);
+        Matrix4x4 result{};
+        result.m[0][0] = cot / aspectRatio;
+        result.m[1][1] = cot;
+        result.m[2][2] = farClip / (farClip - nearClip);
+        result.m[2][3] = 1.0f;
+        result.m[3][2] = -nearClip * farClip / (farClip - nearClip);
+        return result;
+    }
+
+    enum class LodMode { Off, Unstaggered, Staggered };
+    const char* kLodModeNames[] = { "off", "unstaggered", "staggered" };
+
+    // 原点から+zを向くカメラの前に、近くから遠くまで（一部は画面外に）キャラクターを並べ、
+    // 更新頻度LODなし・ずらしなし・ずらしありでフレームごとの負荷を比較する（AnimationSystem::Executeと同じ判定）
+    void BenchmarkLod(const std::vector<const CompiledAnimationClip*>& clips, const Skeleton& skeleton,
+        uint32_t characterCount, uint32_t frames, bool csv) {
+
+        AnimationPose restPose;
+        ReadPoseFromSkeleton(skeleton, restPose);
+        Skeleton bindSkeleton = skeleton;
+        UpdateSkeletonSpaceMatrices(bindSkeleton);
+        std::vector<Matrix4x4> inverseBindPoses;
+        for (const Joint& joint : bindSkeleton.joints) {
+            inverseBindPoses.push_back(Inverse(joint.skeletonSpaceMatrix));
+        }
+
+        const float fovY = 0.45f;
+        Matrix4x4 viewProjection = MakePerspective(fovY, 16.0f / 9.0f, 0.1f, 1000.0f);
+        AnimationLodSettings settings;
+
+        if (csv) {
+            std::printf("lod_mode,characters,mean_ms,max_ms,max_over_mean,evaluated_per_frame\n");
+        }
+        for (LodMode mode : { LodMode::Off, LodMode::Unstaggered, LodMode::Staggered }) {
+            std::vector<Character> characters(characterCount);
+            std::vector<AnimationLodState> lods(characterCount);
+            std::vector<uint32_t> intervals(characterCount);
+            for (uint32_t i = 0; i < characterCount; ++i) {
+                Character& character = characters[i];
+                character.skeleton = skeleton;
+                character.palette.resize(skeleton.joints.size());
+                character.tree.Initialize(restPose);
+                character.tree.AddLayer(AnimationBlendTree::BlendMode::Override, 1);
+                character.tree.SetClip(0, 0, clips[i % clips.size()]);
+                character.tree.SetClipWeight(0, 0, 1.0f);
+
+                // 距離は3m～80m、横方向は画面の幅より広く散らす
+                float ratio = static_cast<float>(i) / static_cast<float>(characterCount);
+                float distance = 3.0f + 77.0f * ratio;
+                float side = std::sin(static_cast<float>(i) * 12.9898f) * distance * 0.6f;
+                Vector3 center = { side, settings.boundingRadius, distance };
+                bool visible = IsSphereInFrustum(viewProjection, center, settings.boundingRadius);
+                float screenSize = CalculateScreenSize(settings.boundingRadius, distance, fovY);
+                intervals[i] = mode == LodMode::Off ? 1 : SelectAnimationUpdateInterval(screenSize, visible, settings);
+                lods[i].phase = mode == LodMode::Staggered ? i : 0;
+            }
+
+            double totalNs = 0.0;
+            double maxNs = 0.0;
+            uint64_t evaluated = 0;
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                for (uint32_t i = 0; i < characterCount; ++i) {
+                    lods[i].SetInterval(intervals[i]);
+                    lods[i].evaluate = lods[i].ShouldEvaluate(frame);
+                    evaluated += lods[i].evaluate ? 1 : 0;
+                }
+
+                BenchUtility::Timer timer;
+                for (uint32_t i = 0; i < characterCount; ++i) {
+                    Character& character = characters[i];
+                    AnimationLodState& lod = lods[i];
+                    character.tree.Update(kDeltaTime);
+                    if (!lod.evaluate) {
+                        ++lod.framesSinceEvaluation;
+                        if (lod.framesSinceEvaluation < lod.interval) {
+                            InterpolatePalette(lod.previousPalette, lod.currentPalette, lod.GetInterpolationFactor(), character.palette);
+                        }
+                        continue;
+                    }
+                    character.tree.Evaluate(character.pose);
+                    ApplyPoseToSkeleton(character.pose, character.skeleton);
+                    UpdateSkeletonSpaceMatrices(character.skeleton);
+                    std::swap(lod.previousPalette, lod.currentPalette);
+                    lod.currentPalette.resize(character.skeleton.joints.size());
+                    UpdateSkinPalette(character.skeleton, inverseBindPoses, lod.currentPalette);
+                    lod.FinishEvaluation();
+                    InterpolatePalette(lod.previousPalette, lod.currentPalette, lod.GetInterpolationFactor(), character.palette);
+                }
+                double ns = timer.ElapsedNs();
+                // 最初の4フレームは全員が初回の評価をするため除く
+                if (frame >= 4) {
+                    totalNs += ns;
+                    maxNs = std::max(maxNs, ns);
+                }
+            }
+
+            uint32_t measured = frames > 4 ? frames - 4 : 1;
+            double meanMs = totalNs / measured / 1.0e6;
+            double maxMs = maxNs / 1.0e6;
+            double evaluatedPerFrame = static_cast<double>(evaluated) / frames;
+            if (csv) {
+                std::printf("%s,%u,%.3f,%.3f,%.2f,%.1f\n", kLodModeNames[static_cast<int>(mode)], characterCount,
+                    meanMs, maxMs, meanMs > 0.0 ? maxMs / meanMs : 0.0, evaluatedPerFrame);
+            } else {
+                std::printf("lod %-12s    %u characters  mean %7.3f ms/frame  max %7.3f ms/frame  (max/mean x%.2f)  evaluated %.1f/frame\n",
+                    kLodModeNames[static_cast<int>(mode)], characterCount, meanMs, maxMs,
+                    meanMs > 0.0 ? maxMs / meanMs : 0.0, evaluatedPerFrame);
+            }
+        }
+    }
+
+    // characters体が同じクリップをvariants通りの開始位置から再生する（同じ待機ループを再生する敵や群衆）
+    // ポーズキャッシュなしと、（クリップ・時刻・スキン）が同じインスタンスのパレットを共有する場合を比較する
+    void BenchmarkPoseCache(const CompiledAnimationClip& clip, const Skeleton& skeleton, uint32_t characterCount,
+        uint32_t variants, uint32_t frames, bool csv) {
+
+        AnimationPose restPose;
+        ReadPoseFromSkeleton(skeleton, restPose);
+        Skeleton bindSkeleton = skeleton;
+        UpdateSkeletonSpaceMatrices(bindSkeleton);
+        std::vector<Matrix4x4> inverseBindPoses;
+        for (const Joint& joint : bindSkeleton.joints) {
+            inverseBindPoses.push_back(Inverse(joint.skeletonSpaceMatrix));
+        }
+        uint64_t skinHash = HashSkin(skeleton, inverseBindPoses);
+
+        if (csv) {
+            std::printf("pose_cache,characters,variants,ms_per_frame,hits_per_frame,misses_per_frame,max_error\n");
+        }
+        std::vector<WellForGPU> reference;
+        for (bool useCache : { false, true }) {
+            std::vector<Character> characters(characterCount);
+            for (uint32_t i = 0; i < characterCount; ++i) {
+                Character& character = characters[i];
+                character.skeleton = skeleton;
+                character.palette.resize(skeleton.joints.size());
+                character.tree.Initialize(restPose);
+                character.tree.AddLayer(AnimationBlendTree::BlendMode::Override, 1);
+                character.tree.SetClip(0, 0, &clip);
+                character.tree.SetClipWeight(0, 0, 1.0f);
+                character.tree.SetClipTime(0, 0, clip.GetDuration() * static_cast<float>(i % variants) / static_cast<float>(variants));
+            }
+
+            AnimationPoseCache cache;
+            std::vector<uint32_t> owners(characterCount);
+            double totalNs = 0.0;
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                BenchUtility::Timer timer;
+                // 登録（AnimationSystem::Executeと同じ）
+                cache.Clear(characterCount);
+                for (uint32_t i = 0; i < characterCount; ++i) {
+                    Character& character = characters[i];
+                    character.tree.Update(kDeltaTime);
+                    owners[i] = AnimationPoseCache::kNone;
+                    const CompiledAnimationClip* singleClip = nullptr;
+                    float time = 0.0f;
+                    if (useCache && character.tree.GetSingleClip(singleClip, time)) {
+                        owners[i] = cache.FindOrAdd(*singleClip, time, skinHash, i).paletteOwner;
+                    }
+                }
+                // 共有元の評価
+                for (uint32_t i = 0; i < characterCount; ++i) {
+                    if (owners[i] != AnimationPoseCache::kNone) {
+                        continue;
+                    }
+                    Character& character = characters[i];
+                    character.tree.Evaluate(character.pose);
+                    ApplyPoseToSkeleton(character.pose, character.skeleton);
+                    UpdateSkeletonSpaceMatrices(character.skeleton);
+                    UpdateSkinPalette(character.skeleton, inverseBindPoses, character.palette);
+                }
+                // 共有先はパレットをコピーする
+                for (uint32_t i = 0; i < characterCount; ++i) {
+                    if (owners[i] != AnimationPoseCache::kNone) {
+                        characters[i].palette = characters[owners[i]].palette;
+                    }
+                }
+                totalNs += timer.ElapsedNs();
+                hits += cache.GetPaletteHitCount() + cache.GetPoseHitCount();
+                misses += cache.GetMissCount();
+            }
+
+            // キャッシュなしの結果との最大誤差（全員の最終フレームのパレット）
+            std::vector<WellForGPU> palettes;
+            for (const Character& character : characters) {
+                palettes.insert(palettes.end(), character.palette.begin(), character.palette.end());
+            }
+            float maxError = 0.0f;
+            if (!useCache) {
+                reference = palettes;
+            } else {
+                for (size_t i = 0; i < palettes.size(); ++i) {
+                    for (int r = 0; r < 4; ++r) {
+                        for (int c = 0; c < 4; ++c) {
+                            maxError = std::max(maxError, std::fabs(palettes[i].skeletonSpaceMatrix.m[r][c] - reference[i].skeletonSpaceMatrix.m[r][c]));
+                        }
+                    }
+                }
+            }
+
+            double msPerFrame = totalNs / frames / 1.0e6;
+            if (csv) {
+                std::printf("%s,%u,%u,%.3f,%.1f,%.1f,%g\n", useCache ? "on" : "off", characterCount, variants, msPerFrame,
+                    static_cast<double>(hits) / frames, static_cast<double>(misses) / frames, maxError);
+            } else {
+                std::printf("pose cache %-3s    %u characters (%u variants)  %7.3f ms/frame  hits %.1f/frame  misses %.1f/frame  max error %g\n",
+                    useCache ? "on" : "off", characterCount, variants, msPerFrame,
+                    static_cast<double>(hits) / frames, static_cast<double>(misses) / frames, maxError);
+            }
+        }
+    }
+
+    // 2つのパレットの行列要素の最大誤差（位置用の行列のみ。normalMatrixなら法線用）
+    float CalculatePaletteError(const std::vector<WellForGPU>& a, const std::vector<WellForGPU>& b, bool normalMatrix) {
+        float error = 0.0f;
+        for (size_t i = 0; i < a.size(); ++i) {
+            const Matrix4x4& ma = normalMatrix ? a[i].skeletonSpaceInverseTransposeMatrix : a[i].skeletonSpaceMatrix;
+            const Matrix4x4& mb = normalMatrix ? b[i].skeletonSpaceInverseTransposeMatrix : b[i].skeletonSpaceMatrix;
+            for (int r = 0; r < (normalMatrix ? 3 : 4); ++r) {
+                for (int c = 0; c < 3; ++c) {
+                    error = std::max(error, std::fabs(ma.m[r][c] - mb.m[r][c]));
+                }
+            }
+        }
+        return error;
+    }
+
+    // クリップをsampleRateで焼き込み、1体分の表の読み出し（最近傍の行・前後の補間）と通常の評価を比較する
+    // 誤差は焼き込んだフレームの時刻（表の丸めのみ）と、フレームの中間の時刻（補間の誤差を含む）で測る
+    void BenchmarkBaked(const CompiledAnimationClip& clip, const Skeleton& skeleton, uint32_t characterCount, bool csv) {
+        Skeleton bindSkeleton = skeleton;
+        UpdateSkeletonSpaceMatrices(bindSkeleton);
+        std::vector<Matrix4x4> inverseBindPoses;
+        for (const Joint& joint : bindSkeleton.joints) {
+            inverseBindPoses.push_back(Inverse(joint.skeletonSpaceMatrix));
+        }
+
+        // 通常の評価（Object3d::UpdateAnimationと同じ計算）
+        Skeleton work = skeleton;
+        AnimationPose pose;
+        std::vector<WellForGPU> reference(skeleton.joints.size());
+        auto evaluate = [&](float time) {
+            clip.Sample(time, pose);
+            ApplyPoseToSkeleton(pose, work);
+            UpdateSkeletonSpaceMatrices(work);
+            UpdateSkinPalette(work, inverseBindPoses, reference);
+        };
+
+        const uint32_t samples = 256;
+        BenchUtility::Timer evaluateTimer;
+        for (uint32_t i = 0; i < samples; ++i) {
+            evaluate(clip.GetDuration() * static_cast<float>(i) / samples);
+        }
+        double evaluateNs = evaluateTimer.ElapsedNs() / samples;
+
+        if (csv) {
+            std::printf("format,sample_rate,bytes,bake_ms,evaluate_ns,row_ns,interpolated_ns,frame_error,normal_error,midframe_error,crowd_ms\n");
+        }
+        for (BakedPaletteFormat format : { BakedPaletteFormat::Float3x4, BakedPaletteFormat::Half3x4 }) {
+            for (float sampleRate : { 30.0f, 60.0f }) {
+                BakedAnimationTable table;
+                BenchUtility::Timer bakeTimer;
+                table.Initialize(skeleton, inverseBindPoses, format);
+                uint32_t clipIndex = table.AddClip(clip, sampleRate);
+                double bakeMs = bakeTimer.ElapsedNs() / 1.0e6;
+                const BakedAnimationTable::ClipRange& range = table.GetClip(clipIndex);
+
+                // 焼き込んだフレームの時刻では表の丸めの誤差のみ、中間の時刻では補間の誤差も含む
+                std::vector<WellForGPU> decoded(skeleton.joints.size());
+                float frameError = 0.0f;
+                float normalError = 0.0f;
+                float midframeError = 0.0f;
+                for (uint32_t frame = 0; frame + 1 < range.frameCount; ++frame) {
+                    float time = static_cast<float>(frame) / sampleRate;
+                    evaluate(time);
+                    table.DecodeRow(table.GetRow(clipIndex, time), decoded);
+                    frameError = std::max(frameError, CalculatePaletteError(decoded, reference, false));
+                    normalError = std::max(normalError, CalculatePaletteError(decoded, reference, true));
+
+                    float midTime = (static_cast<float>(frame) + 0.5f) / sampleRate;
+                    evaluate(midTime);
+                    table.SamplePalette(clipIndex, midTime, false, decoded);
+                    midframeError = std::max(midframeError, CalculatePaletteError(decoded, reference, false));
+                }
+
+                BenchUtility::Timer rowTimer;
+                for (uint32_t i = 0; i < samples; ++i) {
+                    table.DecodeRow(table.GetRow(clipIndex, clip.GetDuration() * static_cast<float>(i) / samples), decoded);
+                }
+                double rowNs = rowTimer.ElapsedNs() / samples;
+                BenchUtility::Timer interpolatedTimer;
+                for (uint32_t i = 0; i < samples; ++i) {
+                    table.SamplePalette(clipIndex, clip.GetDuration() * static_cast<float>(i) / samples, true, decoded);
+                }
+                double interpolatedNs = interpolatedTimer.ElapsedNs() / samples;
+
+                // 群衆は1体あたり（クリップ, フレーム）の番号だけを持つ
+                std::vector<uint32_t> rows(characterCount);
+                for (uint32_t i = 0; i < characterCount; ++i) {
+                    rows[i] = table.GetRow(clipIndex, clip.GetDuration() * static_cast<float>(i) / characterCount);
+                }
+                BenchUtility::Timer crowdTimer;
+                for (uint32_t row : rows) {
+                    table.DecodeRow(row, decoded);
+                }
+                double crowdMs = crowdTimer.ElapsedNs() / 1.0e6;
+
+                const char* formatName = format == BakedPaletteFormat::Float3x4 ? "float3x4" : "half3x4";
+                if (csv) {
+                    std::printf("%s,%.0f,%zu,%.3f,%.1f,%.1f,%.1f,%g,%g,%g,%.3f\n", formatName, sampleRate, table.GetMemorySize(), bakeMs,
+                        evaluateNs, rowNs, interpolatedNs, frameError, normalError, midframeError, crowdMs);
+                } else {
+                    std::printf("baked %-8s %2.0fHz  %4u frames  %7.1f KB  bake %6.2f ms  evaluate %7.1f ns  row %7.1f ns  interpolated %7.1f ns  "
+                        "error frame %g normal %g midframe %g  %u decodes %.3f ms\n",
+                        formatName, sampleRate, range.frameCount, static_cast<double>(table.GetMemorySize()) / 1024.0, bakeMs,
+                        evaluateNs, rowNs, interpolatedNs, frameError, normalError, midframeError, characterCount, crowdMs);
+                }
+            }
+        }
+    }
+
+    // 行列パレットとデュアルクォータニオンのパレットの作成負荷・サイズを比較し、CPUのスキニングで結果を照合する
+    // 1ジョイントだけに属する頂点は両者が一致するはず（スケルトンにスケールがない場合）
+    // 親子2ジョイントに半分ずつ属する頂点は、線形ブレンドの潰れを避ける分だけ差が出る
+    void BenchmarkDualQuaternion(const CompiledAnimationClip& clip, const Skeleton& skeleton, uint32_t characterCount, bool csv) {
+        Skeleton bindSkeleton = skeleton;
+        UpdateSkeletonSpaceMatrices(bindSkeleton);
+        std::vector<Matrix4x4> inverseBindPoses;
+        for (const Joint& joint : bindSkeleton.joints) {
+            inverseBindPoses.push_back(Inverse(joint.skeletonSpaceMatrix));
+        }
+        size_t jointCount = skeleton.joints.size();
+
+        // 群衆の各キャラクターの時刻でスケルトンを評価しておき、パレットの作成だけを計測する
+        std::vector<Skeleton> skeletons(characterCount, skeleton);
+        AnimationPose pose;
+        for (uint32_t i = 0; i < characterCount; ++i) {
+            clip.Sample(clip.GetDuration() * static_cast<float>(i) / characterCount, pose);
+            ApplyPoseToSkeleton(pose, skeletons[i]);
+            UpdateSkeletonSpaceMatrices(skeletons[i]);
+        }
+        std::vector<WellForGPU> matrixPalette(jointCount);
+        std::vector<DualQuaternion> dualQuaternionPalette(jointCount);
+        BenchUtility::Timer matrixTimer;
+        for (const Skeleton& character : skeletons) {
+            UpdateSkinPalette(character, inverseBindPoses, matrixPalette);
+        }
+        double matrixMs = matrixTimer.ElapsedNs() / 1.0e6;
+        BenchUtility::Timer dualQuaternionTimer;
+        for (const Skeleton& character : skeletons) {
+            UpdateDualQuaternionPalette(character, inverseBindPoses, dualQuaternionPalette);
+        }
+        double dualQuaternionMs = dualQuaternionTimer.ElapsedNs() / 1.0e6;
+
+        // 各ジョイントのバインド位置の近くに頂点を置いてスキニングする
+        float singleError = 0.0f;
+        float singleNormalError = 0.0f;
+        float blendedDifference = 0.0f;
+        const Vector3 offset = { 0.05f, 0.1f, 0.02f };
+        const Vector3 normal = { 0.0f, 1.0f, 0.0f };
+        for (const Skeleton& character : skeletons) {
+            UpdateSkinPalette(character, inverseBindPoses, matrixPalette);
+            UpdateDualQuaternionPalette(character, inverseBindPoses, dualQuaternionPalette);
+            for (const Joint& joint : bindSkeleton.joints) {
+                const Matrix4x4& bind = joint.skeletonSpaceMatrix;
+                Vector3 position = { bind.m[3][0] + offset.x, bind.m[3][1] + offset.y, bind.m[3][2] + offset.z };
+
+                VertexInfluence influence = {};
+                influence.weights[0] = 1.0f;
+                influence.jointIndices[0] = joint.index;
+                if (joint.parent) {
+                    influence.jointIndices[1] = *joint.parent;
+                }
+                Vector3 linearPosition, linearNormal, dualQuaternionPosition, dualQuaternionNormal;
+                SkinVertexLinear(matrixPalette, influence, position, normal, linearPosition, linearNormal);
+                SkinVertexDualQuaternion(dualQuaternionPalette, influence, position, normal, dualQuaternionPosition, dualQuaternionNormal);
+                singleError = std::max({ singleError, std::fabs(linearPosition.x - dualQuaternionPosition.x),
+                    std::fabs(linearPosition.y - dualQuaternionPosition.y), std::fabs(linearPosition.z - dualQuaternionPosition.z) });
+                singleNormalError = std::max({ singleNormalError, std::fabs(linearNormal.x - dualQuaternionNormal.x),
+                    std::fabs(linearNormal.y - dualQuaternionNormal.y), std::fabs(linearNormal.z - dualQuaternionNormal.z) });
+
+                if (joint.parent) {
+                    influence.weights[0] = 0.5f;
+                    influence.weights[1] = 0.5f;
+                    SkinVertexLinear(matrixPalette, influence, position, normal, linearPosition, linearNormal);
+                    SkinVertexDualQuaternion(dualQuaternionPalette, influence, position, normal, dualQuaternionPosition, dualQuaternionNormal);
+                    blendedDifference = std::max({ blendedDifference, std::fabs(linearPosition.x - dualQuaternionPosition.x),
+                        std::fabs(linearPosition.y - dualQuaternionPosition.y), std::fabs(linearPosition.z - dualQuaternionPosition.z) });
+                }
+            }
+        }
+
+        size_t matrixBytes = jointCount * sizeof(WellForGPU);
+        size_t dualQuaternionBytes = jointCount * sizeof(DualQuaternion);
+        if (csv) {
+            std::printf("joints,characters,matrix_bytes,dq_bytes,matrix_ms,dq_ms,single_error,single_normal_error,blended_difference\n");
+            std::printf("%zu,%u,%zu,%zu,%.3f,%.3f,%g,%g,%g\n", jointCount, characterCount, matrixBytes, dualQuaternionBytes,
+                matrixMs, dualQuaternionMs, singleError, singleNormalError, blendedDifference);
+        } else {
+            std::printf("palette %zu joints x %u  matrix %6zu B %.3f ms  dual quaternion %6zu B %.3f ms  (x%.1f smaller)\n",
+                jointCount, characterCount, matrixBytes, matrixMs, dualQuaternionBytes, dualQuaternionMs,
+                static_cast<double>(matrixBytes) / static_cast<double>(dualQuaternionBytes));
+            std::printf("skinning single influence error %g (normal %g)  parent/child 50%% blend difference %g\n",
+                singleError, singleNormalError, blendedDifference);
+        }
+    }
+
+    // 各ジョイントのバインド位置の周りに頂点を置き、自分と親に重みを分けたメッシュを作る
+    void MakeSkinnedMesh(const Skeleton& bindSkeleton, uint32_t vertexCount, std::vector<VertexData>& vertices,
+        std::vector<VertexInfluence>& influences) {
+        std::mt19937 random(12345);
+        std::uniform_real_distribution<float> offset(-0.1f, 0.1f);
+        std::uniform_real_distribution<float> weight(0.5f, 1.0f);
+        vertices.resize(vertexCount);
+        influences.assign(vertexCount, VertexInfluence{});
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            const Joint& joint = bindSkeleton.joints[v % bindSkeleton.joints.size()];
+            const Matrix4x4& bind = joint.skeletonSpaceMatrix;
+            Vector3 normal = { offset(random), offset(random), offset(random) };
+            float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+            vertices[v].position = { bind.m[3][0] + offset(random), bind.m[3][1] + offset(random), bind.m[3][2] + offset(random), 1.0f };
+            vertices[v].texcoord = { 0.0f, 0.0f };
+            vertices[v].normal = length > 0.0f ? Vector3{ normal.x / length, normal.y / length, normal.z / length } : Vector3{ 0.0f, 1.0f, 0.0f };
+
+            influences[v].jointIndices[0] = joint.index;
+            influences[v].weights[0] = 1.0f;
+            if (joint.parent) {
+                float w = weight(random);
+                influences[v].weights[0] = w;
+                influences[v].weights[1] = 1.0f - w;
+                influences[v].jointIndices[1] = *joint.parent;
+            }
+        }
+    }
+
+    // CPUスキニングの参照実装（1頂点ずつ）とSIMDのカーネルを比較し、
+    // ジョイントごとの範囲から求めたAABBを全頂点をスキニングしたAABBと比較する
+    void BenchmarkCpuSkinning(const CompiledAnimationClip& clip, const Skeleton& skeleton, uint32_t vertexCount, bool csv) {
+        Skeleton bindSkeleton = skeleton;
+        UpdateSkeletonSpaceMatrices(bindSkeleton);
+        std::vector<Matrix4x4> inverseBindPoses;
+        for (const Joint& joint : bindSkeleton.joints) {
+            inverseBindPoses.push_back(Inverse(joint.skeletonSpaceMatrix));
+        }
+        std::vector<VertexData> vertices;
+        std::vector<VertexInfluence> influences;
+        MakeSkinnedMesh(bindSkeleton, vertexCount, vertices, influences);
+
+        BenchUtility::Timer jointBoundsTimer;
+        std::vector<SkinnedBounds> jointBounds = CalculateJointBounds(influences, vertices, skeleton.joints.size());
+        double jointBoundsMs = jointBoundsTimer.ElapsedNs() / 1.0e6;
+
+        SkinnedBounds bindBounds;
+        for (const VertexData& vertex : vertices) {
+            bindBounds.Expand({ vertex.position.x, vertex.position.y, vertex.position.z });
+        }
+
+        Skeleton work = skeleton;
+        AnimationPose pose;
+        std::vector<WellForGPU> palette(skeleton.joints.size());
+        std::vector<Vector3> referencePositions(vertexCount);
+        std::vector<Vector3> referenceNormals(vertexCount);
+        std::vector<Vector3> positions(vertexCount);
+        std::vector<Vector3> normals(vertexCount);
+
+        const uint32_t poseCount = 32;
+        double referenceNs = 0.0;
+        double simdNs = 0.0;
+        double bruteBoundsNs = 0.0;
+        double fastBoundsNs = 0.0;
+        float positionError = 0.0f;
+        float normalError = 0.0f;
+        bool contained = true;
+        double volumeRatio = 0.0;
+        double bindVolumeRatio = 0.0;
+        auto volume = [](const SkinnedBounds& bounds) {
+            return static_cast<double>(bounds.max.x - bounds.min.x) * (bounds.max.y - bounds.min.y) * (bounds.max.z - bounds.min.z);
+        };
+        for (uint32_t poseIndex = 0; poseIndex < poseCount; ++poseIndex) {
+            clip.Sample(clip.GetDuration() * static_cast<float>(poseIndex) / poseCount, pose);
+            ApplyPoseToSkeleton(pose, work);
+            UpdateSkeletonSpaceMatrices(work);
+            UpdateSkinPalette(work, inverseBindPoses, palette);
+
+            BenchUtility::Timer referenceTimer;
+            for (uint32_t v = 0; v < vertexCount; ++v) {
+                const VertexData& vertex = vertices[v];
+                SkinVertexLinear(palette, influences[v], { vertex.position.x, vertex.position.y, vertex.position.z }, vertex.normal,
+                    referencePositions[v], referenceNormals[v]);
+            }
+            referenceNs += referenceTimer.ElapsedNs();
+
+            BenchUtility::Timer simdTimer;
+            SkinVertices(palette, influences, vertices, positions, normals);
+            simdNs += simdTimer.ElapsedNs();
+
+            for (uint32_t v = 0; v < vertexCount; ++v) {
+                positionError = std::max({ positionError, std::fabs(positions[v].x - referencePositions[v].x),
+                    std::fabs(positions[v].y - referencePositions[v].y), std::fabs(positions[v].z - referencePositions[v].z) });
+                normalError = std::max({ normalError, std::fabs(normals[v].x - referenceNormals[v].x),
+                    std::fabs(normals[v].y - referenceNormals[v].y), std::fabs(normals[v].z - referenceNormals[v].z) });
+            }
+
+            // 全頂点のAABB（スキニング済みの頂点から）と、ジョイントごとの範囲から求めたAABB
+            BenchUtility::Timer bruteTimer;
+            SkinnedBounds bruteBounds;
+            for (const Vector3& position : positions) {
+                bruteBounds.Expand(position);
+            }
+            bruteBoundsNs += bruteTimer.ElapsedNs();
+            BenchUtility::Timer fastTimer;
+            SkinnedBounds fastBounds = CalculateSkinnedBounds(palette, jointBounds);
+            fastBoundsNs += fastTimer.ElapsedNs();
+
+            const float epsilon = 1.0e-4f;
+            contained = contained && fastBounds.min.x <= bruteBounds.min.x + epsilon && fastBounds.min.y <= bruteBounds.min.y + epsilon &&
+                fastBounds.min.z <= bruteBounds.min.z + epsilon && fastBounds.max.x >= bruteBounds.max.x - epsilon &&
+                fastBounds.max.y >= bruteBounds.max.y - epsilon && fastBounds.max.z >= bruteBounds.max.z - epsilon;
+            volumeRatio += volume(fastBounds) / volume(bruteBounds);
+            // バインドポーズのAABBが実際の姿勢をどれだけ外しているか（含まない分は衝突・カリングの誤り）
+            SkinnedBounds bindUnion = bindBounds;
+            bindUnion.Merge(bruteBounds);
+            bindVolumeRatio += volume(bindUnion) / volume(bindBounds);
+        }
+
+        double referenceNsPerVertex = referenceNs / (static_cast<double>(poseCount) * vertexCount);
+        double simdNsPerVertex = simdNs / (static_cast<double>(poseCount) * vertexCount);
+        double bruteBoundsUs = bruteBoundsNs / poseCount / 1.0e3;
+        double fastBoundsUs = fastBoundsNs / poseCount / 1.0e3;
+        volumeRatio /= poseCount;
+        bindVolumeRatio /= poseCount;
+        if (csv) {
+            std::printf("vertices,joints,reference_ns_per_vertex,simd_ns_per_vertex,speedup,position_error,normal_error,"
+                "joint_bounds_ms,skinned_aabb_us,joint_aabb_us,contained,volume_ratio,bind_pose_miss_ratio\n");
+            std::printf("%u,%zu,%.2f,%.2f,%.2f,%g,%g,%.3f,%.2f,%.2f,%d,%.3f,%.3f\n", vertexCount, skeleton.joints.size(), referenceNsPerVertex,
+                simdNsPerVertex, referenceNsPerVertex / simdNsPerVertex, positionError, normalError, jointBoundsMs, bruteBoundsUs,
+                fastBoundsUs, contained ? 1 : 0, volumeRatio, bindVolumeRatio);
+        } else {
+            std::printf("cpu skinning %u vertices  reference %.2f ns/vertex  simd %.2f ns/vertex (x%.2f)  error position %g normal %g\n",
+                vertexCount, referenceNsPerVertex, simdNsPerVertex, referenceNsPerVertex / simdNsPerVertex, positionError, normalError);
+            std::printf("skinned aabb  all vertices %.2f us (after skinning)  joint bounds %.2f us (%zu joints, setup %.3f ms)  "
+                "contains all vertices: %s  volume x%.3f  bind pose aabb needs x%.3f to cover the pose\n",
+                bruteBoundsUs, fastBoundsUs, skeleton.joints.size(), jointBoundsMs, contained ? "yes" : "NO", volumeRatio, bindVolumeRatio);
+        }
+    }
+
+    // assimpのメッシュ相当（三角形の頂点番号と、ボーンごとの(頂点番号, 重み)）
+    struct ImportMesh {
+        uint32_t vertexCount = 0;
+        std::vector<uint32_t> faces;  // 3つずつ
+        std::vector<std::vector<std::pair<uint32_t, float>>> boneWeights;
+    };
+
+    // gridSize×gridSizeの格子のメッシュを作り、各頂点に2～6本のボーンの重みを付ける
+    ImportMesh MakeImportMesh(uint32_t gridSize, uint32_t boneCount) {
+        ImportMesh mesh;
+        mesh.vertexCount = gridSize * gridSize;
+        for (uint32_t y = 0; y + 1 < gridSize; ++y) {
+            for (uint32_t x = 0; x + 1 < gridSize; ++x) {
+                uint32_t v = y * gridSize + x;
+                mesh.faces.insert(mesh.faces.end(), { v, v + 1, v + gridSize, v + 1, v + gridSize + 1, v + gridSize });
+            }
+        }
+        std::mt19937 random(4321);
+        std::uniform_real_distribution<float> weight(0.01f, 1.0f);
+        mesh.boneWeights.resize(boneCount);
+        for (uint32_t v = 0; v < mesh.vertexCount; ++v) {
+            uint32_t influenceCount = 2 + v % 5;
+            for (uint32_t i = 0; i < influenceCount; ++i) {
+                mesh.boneWeights[(v + i * 7) % boneCount].emplace_back(v, weight(random));
+            }
+        }
+        return mesh;
+    }
+
+    // 格子の頂点をAnimatedModel::ProcessAssimpMeshと同じようにウェイトの組をキーにして溶接・最適化する
+    // 戻り値は元の頂点番号から並べ直した後の番号への対応表（まとまった頂点は最初の1つ以外kUnusedVertex）
+    std::vector<uint32_t> OptimizeImportMesh(const ImportMesh& mesh, uint32_t gridSize, std::vector<VertexData>& vertices,
+        std::vector<uint32_t>& indices) {
+        vertices.resize(mesh.vertexCount);
+        for (uint32_t v = 0; v < mesh.vertexCount; ++v) {
+            float x = static_cast<float>(v % gridSize);
+            float y = static_cast<float>(v / gridSize);
+            vertices[v] = { { x, 0.0f, y, 1.0f }, { x / (gridSize - 1), y / (gridSize - 1) }, { 0.0f, 1.0f, 0.0f } };
+        }
+        indices = mesh.faces;
+        std::vector<std::vector<VertexWeightData>> boneWeights(mesh.boneWeights.size());
+        for (size_t bone = 0; bone < mesh.boneWeights.size(); ++bone) {
+            for (const auto& [vertexId, weight] : mesh.boneWeights[bone]) {
+                boneWeights[bone].push_back({ weight, vertexId });
+            }
+        }
+        std::vector<uint64_t> weldKeys = BuildWeightSetKeys(boneWeights, mesh.vertexCount);
+        std::vector<uint32_t> vertexRemap;
+        OptimizeMesh(vertices, indices, MeshOptimizeSettings{}, &vertexRemap, weldKeys.data());
+        DropWeldedDuplicates(vertexRemap);
+        return vertexRemap;
+    }
+
+    // 旧実装：ボーンの重みごとに全ての面を走査してコーナーを探し、空いているスロットに先着順で入れる
+    void ImportSkinWeightsScan(const ImportMesh& mesh, const Skeleton& skeleton, std::vector<VertexInfluence>& out) {
+        std::map<std::string, JointWeightData> skinClusterData;
+        uint32_t faceCount = static_cast<uint32_t>(mesh.faces.size() / 3);
+        for (size_t bone = 0; bone < mesh.boneWeights.size(); ++bone) {
+            JointWeightData& jointWeightData = skinClusterData[skeleton.joints[bone].name];
+            for (const auto& [vertexId, weight] : mesh.boneWeights[bone]) {
+                for (uint32_t faceIndex = 0; faceIndex < faceCount; ++faceIndex) {
+                    for (uint32_t i = 0; i < 3; ++i) {
+                        if (mesh.faces[faceIndex * 3 + i] == vertexId) {
+                            jointWeightData.vertexWeights.push_back({ weight, faceIndex * 3 + i });
+                        }
+                    }
+                }
+            }
+        }
+        out.assign(mesh.faces.size(), VertexInfluence{});
+        for (const auto& [name, jointWeight] : skinClusterData) {
+            int32_t joint = skeleton.jointMap.at(name);
+            for (const VertexWeightData& vertexWeight : jointWeight.vertexWeights) {
+                VertexInfluence& influence = out[vertexWeight.vectorIndex];
+                for (uint32_t index = 0; index < kNumMaxInfluence; ++index) {
+                    if (influence.weights[index] == 0.0f) {
+                        influence.weights[index] = vertexWeight.weight;
+                        influence.jointIndices[index] = joint;
+                        break;
+                    }
+                }
+            }
+        }
+        for (VertexInfluence& influence : out) {
+            float total = influence.weights[0] + influence.weights[1] + influence.weights[2] + influence.weights[3];
+            for (float& weight : influence.weights) {
+                weight /= total;
+            }
+        }
+    }
+
+    // 新実装（AnimatedModel::ProcessAssimpMesh / CreateSkinCluster と同じ手順）
+    // 頂点はOptimizeImportMeshで並べ直し済みで、ウェイトは対応表で新しい頂点番号に付け替える
+    void ImportSkinWeightsIndexed(const ImportMesh& mesh, const std::vector<uint32_t>& vertexRemap, size_t vertexCount,
+        const Skeleton& skeleton, std::vector<VertexInfluence>& out) {
+        std::map<std::string, JointWeightData> skinClusterData;
+        for (size_t bone = 0; bone < mesh.boneWeights.size(); ++bone) {
+            JointWeightData& jointWeightData = skinClusterData[skeleton.joints[bone].name];
+            size_t firstWeight = jointWeightData.vertexWeights.size();
+            for (const auto& [vertexId, weight] : mesh.boneWeights[bone]) {
+                jointWeightData.vertexWeights.push_back({ weight, vertexId });
+            }
+            RemapVertexWeights(jointWeightData.vertexWeights, firstWeight, vertexRemap);
+        }
+        out.resize(vertexCount);
+        BuildVertexInfluences(skinClusterData, skeleton.jointMap, out);
+    }
+
+    // 元の重みのうち、選んだ4つに残った割合（コーナーの平均）
+    // vertexRemapがあればinfluencesは並べ直した後の頂点ごと、なければ三角形のコーナーごと
+    double CalculateKeptWeight(const ImportMesh& mesh, const std::vector<VertexInfluence>& influences, const Skeleton& skeleton,
+        const std::vector<uint32_t>* vertexRemap) {
+        std::vector<std::vector<std::pair<int32_t, float>>> weights(mesh.vertexCount);
+        for (size_t bone = 0; bone < mesh.boneWeights.size(); ++bone) {
+            for (const auto& [vertexId, weight] : mesh.boneWeights[bone]) {
+                weights[vertexId].emplace_back(skeleton.jointMap.at(skeleton.joints[bone].name), weight);
+            }
+        }
+        double kept = 0.0;
+        for (size_t corner = 0; corner < mesh.faces.size(); ++corner) {
+            const auto& vertexWeights = weights[mesh.faces[corner]];
+            const VertexInfluence& influence = influences[vertexRemap ? (*vertexRemap)[mesh.faces[corner]] : corner];
+            double total = 0.0;
+            double selected = 0.0;
+            for (const auto& [joint, weight] : vertexWeights) {
+                total += weight;
+                for (uint32_t i = 0; i < kNumMaxInfluence; ++i) {
+                    if (influence.jointIndices[i] == joint && influence.weights[i] > 0.0f) {
+                        selected += weight;
+                        break;
+                    }
+                }
+            }
+            kept += total > 0.0 ? selected / total : 1.0;
+        }
+        return kept / static_cast<double>(mesh.faces.size());
+    }
+
+    // ボーンウェイトの読み込みを、旧実装（ボーン×重み×面）と最適化の対応表での付け替え（重みの数に比例）で比較する
+    // 最適化そのものはウェイトと関係なく行うので計測に含めない。旧実装は時間がかかるため、小さいメッシュでのみ計測する
+    void BenchmarkSkinWeightImport(const Skeleton& skeleton, bool csv) {
+        if (csv) {
+            std::printf("triangles,weights,scan_ms,indexed_ms,speedup,scan_kept_weight,indexed_kept_weight\n");
+        }
+        uint32_t boneCount = static_cast<uint32_t>(skeleton.joints.size());
+        for (uint32_t gridSize : { 32u, 64u, 128u, 256u }) {
+            ImportMesh mesh = MakeImportMesh(gridSize, boneCount);
+            size_t weightCount = 0;
+            for (const auto& weights : mesh.boneWeights) {
+                weightCount += weights.size();
+            }
+            uint32_t triangleCount = static_cast<uint32_t>(mesh.faces.size() / 3);
+
+            std::vector<VertexData> vertices;
+            std::vector<uint32_t> indices;
+            std::vector<uint32_t> vertexRemap = OptimizeImportMesh(mesh, gridSize, vertices, indices);
+
+            std::vector<VertexInfluence> indexed;
+            BenchUtility::Timer indexedTimer;
+            ImportSkinWeightsIndexed(mesh, vertexRemap, vertices.size(), skeleton, indexed);
+            double indexedMs = indexedTimer.ElapsedNs() / 1.0e6;
+            double indexedKept = CalculateKeptWeight(mesh, indexed, skeleton, &vertexRemap);
+
+            double scanMs = 0.0;
+            double scanKept = 0.0;
+            bool measureScan = gridSize <= 64;
+            if (measureScan) {
+                std::vector<VertexInfluence> scanned;
+                BenchUtility::Timer scanTimer;
+                ImportSkinWeightsScan(mesh, skeleton, scanned);
+                scanMs = scanTimer.ElapsedNs() / 1.0e6;
+                scanKept = CalculateKeptWeight(mesh, scanned, skeleton, nullptr);
+            }
+
+            if (csv) {
+                std::printf("%u,%zu,%.3f,%.3f,%.1f,%.4f,%.4f\n", triangleCount, weightCount, scanMs, indexedMs,
+                    measureScan ? scanMs / indexedMs : 0.0, scanKept, indexedKept);
+            } else if (measureScan) {
+                std::printf("skin weights %6u triangles %6zu weights  scan %9.3f ms  indexed %7.3f ms (x%.0f)  kept weight scan %.4f indexed %.4f\n",
+                    triangleCount, weightCount, scanMs, indexedMs, scanMs / indexedMs, scanKept, indexedKept);
+            } else {
+                std::printf("skin weights %6u triangles %6zu weights  scan   (skipped)  indexed %7.3f ms  kept weight indexed %.4f\n",
+                    triangleCount, weightCount, indexedMs, indexedKept);
+            }
+        }
+    }
+
+    // ルートモーションの曲線を、スケルトン全体を評価した腰の位置と比べて検証し、再生中の負荷を比較する
+    // 同梱のwalkはその場で足踏みするため、腰のトラックに一定速度の前進を加えたクリップも使う
+    void BenchmarkRootMotion(const Animation& walk, const Skeleton& skeleton, uint32_t characterCount, uint32_t frames, bool csv) {
+        const char* kHipsName = "mixamorig:Hips";
+        auto hipsIt = skeleton.jointMap.find(kHipsName);
+        if (hipsIt == skeleton.jointMap.end()) {
+            return;
+        }
+        int32_t hips = hipsIt->second;
+
+        Animation travel = walk;
+        for (KeyframeVector3& key : travel.nodeAnimations[kHipsName].translate) {
+            key.value.y += 150.0f * key.time;
+        }
+
+        if (csv) {
+            std::printf("clip,extract_yaw,loop_travel,build_us,track_ns,resample_ns,speedup,position_error,pin_error,accumulation_error\n");
+        }
+        const std::pair<const char*, const Animation*> animations[] = { { "walk", &walk }, { "walk+travel", &travel } };
+        for (const auto& [name, animation] : animations) {
+            for (bool extractYaw : { false, true }) {
+                CompiledAnimationClip clip;
+                clip.Compile(*animation, skeleton);
+                RootMotionSettings settings;
+                settings.extractYaw = extractYaw;
+                RootMotionBinding binding;
+                binding.Initialize(skeleton, hips, settings);
+                RootMotionTrack track;
+                BenchUtility::Timer buildTimer;
+                track.Build(clip, binding);
+                double buildUs = buildTimer.ElapsedNs() / 1.0e3;
+                float duration = clip.GetDuration();
+
+                // 抽出した位置とスケルトン全体を評価した腰の位置の差、除いた後に腰が固定されているか
+                Skeleton evaluated = skeleton;
+                AnimationPose pose;
+                Vector3 firstPosition = {};
+                Vector3 firstPinned = {};
+                float firstHeading = 0.0f;
+                float positionError = 0.0f;
+                float pinError = 0.0f;
+                const uint32_t kChecks = 240;
+                for (uint32_t i = 0; i <= kChecks; ++i) {
+                    float time = duration * static_cast<float>(i) / kChecks;
+                    clip.Sample(time, pose);
+                    ApplyPoseToSkeleton(pose, evaluated);
+                    UpdateSkeletonSpaceMatrices(evaluated);
+                    const Matrix4x4& hipsMatrix = evaluated.joints[hips].skeletonSpaceMatrix;
+                    Vector3 position = { hipsMatrix.m[3][0], hipsMatrix.m[3][1], hipsMatrix.m[3][2] };
+                    if (i == 0) {
+                        firstPosition = position;
+                    }
+                    Vector3 extracted = track.SamplePosition(time);
+                    positionError = std::max({ positionError, std::fabs(extracted.x - (position.x - firstPosition.x)),
+                        std::fabs(extracted.z - (position.z - firstPosition.z)) });
+
+                    binding.RemoveRootMotion(pose);
+                    ApplyPoseToSkeleton(pose, evaluated);
+                    UpdateSkeletonSpaceMatrices(evaluated);
+                    const Matrix4x4& pinnedMatrix = evaluated.joints[hips].skeletonSpaceMatrix;
+                    Vector3 pinned = { pinnedMatrix.m[3][0], pinnedMatrix.m[3][1], pinnedMatrix.m[3][2] };
+                    float heading = binding.CalculateHeading(pinnedMatrix);
+                    if (i == 0) {
+                        firstPinned = pinned;
+                        firstHeading = heading;
+                    }
+                    pinError = std::max({ pinError, std::fabs(pinned.x - firstPinned.x), std::fabs(pinned.z - firstPinned.z) });
+                    if (extractYaw) {
+                        pinError = std::max(pinError, std::fabs(std::remainder(heading - firstHeading, 6.28318531f)));
+                    }
+                }
+
+                // 不規則なフレーム時間（ときどきクリップより長い）で20ループ以上再生し、積み上げた移動量を一度に求めた値と比べる
+                AnimationPlayer player;
+                player.SetAnimation(*animation);
+                player.SetRootMotionTrack(&track);
+                player.Play();
+                std::mt19937 random(99);
+                std::uniform_real_distribution<float> deltaTime(0.004f, 0.05f);
+                RootMotionDelta accumulated;
+                float elapsed = 0.0f;
+                uint32_t updateCount = 0;
+                while (elapsed < duration * 20.0f) {
+                    float dt = (++updateCount % 97 == 0) ? duration * 2.5f : deltaTime(random);
+                    accumulated.Append(player.Update(dt));
+                    elapsed += dt;
+                }
+                uint32_t loops = static_cast<uint32_t>(std::floor(elapsed / duration + 1.0e-4f));
+                RootMotionDelta expected = track.CalculateDelta(0.0f, player.GetTime(), loops);
+                float loopTravel = std::sqrt(track.GetLoopDelta().translate.x * track.GetLoopDelta().translate.x +
+                    track.GetLoopDelta().translate.z * track.GetLoopDelta().translate.z);
+                float expectedLength = std::sqrt(expected.translate.x * expected.translate.x + expected.translate.z * expected.translate.z);
+                float accumulationError = std::max(std::fabs(accumulated.translate.x - expected.translate.x),
+                    std::fabs(accumulated.translate.z - expected.translate.z)) / std::max(expectedLength, 1.0e-3f);
+
+                // 再生中の負荷（前計算した曲線の差分 / 毎フレーム腰の連鎖を再サンプリングして行列を計算）
+                std::vector<float> times(characterCount);
+                for (uint32_t c = 0; c < characterCount; ++c) {
+                    times[c] = duration * static_cast<float>(c) / characterCount;
+                }
+                const float kFrameTime = 1.0f / 60.0f;
+                std::vector<RootMotionDelta> deltas(characterCount);
+                BenchUtility::Timer trackTimer;
+                for (uint32_t frame = 0; frame < frames; ++frame) {
+                    for (uint32_t c = 0; c < characterCount; ++c) {
+                        float from = times[c];
+                        float to = from + kFrameTime;
+                        uint32_t wrap = to >= duration ? 1 : 0;
+                        to = wrap ? to - duration : to;
+                        deltas[c].Append(track.CalculateDelta(from, to, wrap));
+                        times[c] = to;
+                    }
+                }
+                double trackNs = trackTimer.ElapsedNs() / (static_cast<double>(frames) * characterCount);
+
+                std::vector<Vector3> previousPositions(characterCount);
+                AnimationPose chainPose;
+                chainPose.Resize(clip.GetJointCount());
+                BenchUtility::Timer resampleTimer;
+                for (uint32_t frame = 0; frame < frames; ++frame) {
+                    for (uint32_t c = 0; c < characterCount; ++c) {
+                        float to = times[c] + kFrameTime;
+                        to = to >= duration ? to - duration : to;
+                        for (int32_t joint : binding.GetChain()) {
+                            chainPose.translate[joint] = clip.SampleTranslate(joint, to);
+                            chainPose.rotate[joint] = clip.SampleRotate(joint, to);
+                            chainPose.scale[joint] = clip.SampleScale(joint, to);
+                        }
+                        Matrix4x4 modelMatrix = binding.CalculateModelMatrix(chainPose);
+                        deltas[c].translate.z += modelMatrix.m[3][2] - previousPositions[c].z;
+                        previousPositions[c] = { modelMatrix.m[3][0], modelMatrix.m[3][1], modelMatrix.m[3][2] };
+                        times[c] = to;
+                    }
+                }
+                double resampleNs = resampleTimer.ElapsedNs() / (static_cast<double>(frames) * characterCount);
+
+                if (csv) {
+                    std::printf("%s,%d,%.4f,%.1f,%.1f,%.1f,%.1f,%.2e,%.2e,%.2e\n", name, extractYaw ? 1 : 0, loopTravel, buildUs, trackNs, resampleNs,
+                        resampleNs / trackNs, positionError, pinError, accumulationError);
+                } else {
+                    std::printf("root motion %-12s yaw %-3s  loop travel %8.4f  build %6.1f us  track %5.1f ns/update  resample %6.1f ns/update (x%.1f)  "
+                        "position error %.2e  pin error %.2e  accumulation error %.2e (%u loops)\n",
+                        name, extractYaw ? "on" : "off", loopTravel, buildUs, trackNs, resampleNs, resampleNs / trackNs,
+                        positionError, pinError, accumulationError, loops);
+                }
+            }
+        }
+    }
+
+    void BenchmarkEvents(const Animation& walk, uint32_t characterCount, uint32_t frames, bool csv) {
+        const float duration = walk.duration;
+        if (csv) {
+            std::printf("events,poll_ns,window_ns,speedup,fired_per_update,loops,count_errors,order_errors\n");
+        }
+        for (uint32_t eventCount : { 4u, 32u, 256u }) {
+            // 区間の境界（0と終端）に重ならない時刻にイベントを置く
+            Animation animation = walk;
+            std::mt19937 random(eventCount);
+            std::uniform_real_distribution<float> eventTime(0.01f * duration, 0.99f * duration);
+            std::vector<float> listenerTimes(eventCount);
+            for (uint32_t e = 0; e < eventCount; ++e) {
+                listenerTimes[e] = eventTime(random);
+                animation.events.Add(listenerTimes[e], e + 1, static_cast<float>(e));
+            }
+
+            // 不規則なフレーム時間（ときどきクリップより長い）で再生し、イベントごとの回数を通過した回数と比べる
+            AnimationPlayer player;
+            player.SetAnimation(animation);
+            player.SetLoop(true);
+            player.Play();
+            std::uniform_real_distribution<float> deltaTime(0.004f, 0.05f);
+            std::vector<uint32_t> fireCounts(eventCount + 1, 0);
+            double elapsed = 0.0;
+            uint32_t orderErrors = 0;
+            uint32_t updateCount = 0;
+            while (elapsed < duration * 50.0) {
+                float dt = (++updateCount % 89 == 0) ? duration * 2.5f : deltaTime(random);
+                float previousTime = player.GetTime();
+                player.Update(dt);
+                elapsed += dt;
+
+                // 発生順（ループをまたぐ所以外は時刻が増えていく）になっているか
+                const std::vector<AnimationEvent>& fired = player.GetFiredEvents();
+                float lastTime = previousTime;
+                for (const AnimationEvent& event : fired) {
+                    if (event.time < lastTime) {
+                        lastTime = -1.0f; // ループをまたいだ
+                    }
+                    if (event.time < lastTime || event.payload != static_cast<float>(event.id - 1)) {
+                        ++orderErrors;
+                    }
+                    lastTime = event.time;
+                    ++fireCounts[event.id];
+                }
+            }
+            uint32_t countErrors = 0;
+            for (uint32_t e = 0; e < eventCount; ++e) {
+                uint32_t expected = elapsed > listenerTimes[e] ? static_cast<uint32_t>((elapsed - listenerTimes[e]) / duration) + 1 : 0;
+                countErrors += fireCounts[e + 1] != expected ? 1 : 0;
+            }
+            uint32_t loops = static_cast<uint32_t>(elapsed / duration);
+
+            // 1フレームの負荷（多数のキャラクターが同じクリップをずらして再生）
+            const float kFrameTime = 1.0f / 60.0f;
+            std::vector<float> startTimes(characterCount);
+            for (uint32_t c = 0; c < characterCount; ++c) {
+                startTimes[c] = duration * static_cast<float>(c) / characterCount;
+            }
+
+            // イベントごとのリスナーが毎フレーム前回の時刻と今回の時刻の間に自分の時刻があるかを調べる
+            std::vector<float> times = startTimes;
+            uint64_t polled = 0;
+            BenchUtility::Timer pollTimer;
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                for (uint32_t c = 0; c < characterCount; ++c) {
+                    float from = times[c];
+                    float to = std::fmod(from + kFrameTime, duration);
+                    for (float listenerTime : listenerTimes) {
+                        bool crossed = (from <= to) ? (from <= listenerTime && listenerTime < to) : (listenerTime >= from || listenerTime < to);
+                        polled += crossed ? 1 : 0;
+                    }
+                    times[c] = to;
+                }
+            }
+            double pollNs = pollTimer.ElapsedNs() / (static_cast<double>(frames) * characterCount);
+
+            // 時刻順の配列の二分探索で通過した区間だけを取り出す
+            times = startTimes;
+            std::vector<AnimationEvent> fired;
+            uint64_t windowed = 0;
+            BenchUtility::Timer windowTimer;
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                for (uint32_t c = 0; c < characterCount; ++c) {
+                    float from = times[c];
+                    float to = from + kFrameTime;
+                    uint32_t wrap = to >= duration ? 1 : 0;
+                    to = wrap ? to - duration : to;
+                    fired.clear();
+                    animation.events.CollectPlayed(from, to, wrap, duration, false, fired);
+                    windowed += fired.size();
+                    times[c] = to;
+                }
+            }
+            double windowNs = windowTimer.ElapsedNs() / (static_cast<double>(frames) * characterCount);
+            double firedPerUpdate = static_cast<double>(windowed) / (static_cast<double>(frames) * characterCount);
+            if (polled != windowed) {
+                ++countErrors;
+            }
+
+            if (csv) {
+                std::printf("%u,%.1f,%.1f,%.1f,%.3f,%u,%u,%u\n", eventCount, pollNs, windowNs, pollNs / windowNs, firedPerUpdate,
+                    loops, countErrors, orderErrors);
+            } else {
+                std::printf("events %4u  poll %7.1f ns/update  window %5.1f ns/update (x%.1f)  fired %.3f/update  "
+                    "%u loops  count errors %u  order errors %u\n",
+                    eventCount, pollNs, windowNs, pollNs / windowNs, firedPerUpdate, loops, countErrors, orderErrors);
+            }
+        }
+    }
+
+    Vector3 GetJointPosition(const Skeleton& skeleton, int32_t joint) {
+        const Matrix4x4& m = skeleton.joints[joint].skeletonSpaceMatrix;
+        return { m.m[3][0], m.m[3][1], m.m[3][2] };
+    }
+
+    float Distance(const Vector3& a, const Vector3& b) {
+        Vector3 d = a - b;
+        return std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+    }
+
+    void BenchmarkIk(const CompiledAnimationClip& clip, const Skeleton& skeleton, bool csv) {
+        struct Limb {
+            const char* name;
+            const char* joints[3];
+        };
+        const Limb limbs[] = {
+            { "leg", { "mixamorig:LeftUpLeg", "mixamorig:LeftLeg", "mixamorig:LeftFoot" } },
+            { "arm", { "mixamorig:RightArm", "mixamorig:RightForeArm", "mixamorig:RightHand" } },
+        };
+        auto findJoint = [&skeleton](const char* name) {
+            auto it = skeleton.jointMap.find(name);
+            return it != skeleton.jointMap.end() ? it->second : -1;
+        };
+
+        if (csv) {
+            std::printf("solver,solves,ns_per_solve,max_error,pole_error,unreachable_direction_error\n");
+        }
+        const uint32_t kSolves = 4000;
+        Skeleton evaluated = skeleton;
+        AnimationPose pose;
+        for (const Limb& limb : limbs) {
+            int32_t upper = findJoint(limb.joints[0]);
+            int32_t middle = findJoint(limb.joints[1]);
+            int32_t end = findJoint(limb.joints[2]);
+            TwoBoneIkSolver solver;
+            if (!solver.Initialize(skeleton, upper, middle, end)) {
+                continue;
+            }
+
+            // 再生中のポーズからの目標（届く範囲・届かない範囲）とポールを乱数で作る
+            std::mt19937 random(7);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            std::uniform_real_distribution<float> phase(0.0f, clip.GetDuration());
+            clip.Sample(0.0f, pose);
+            ApplyPoseToSkeleton(pose, evaluated);
+            UpdateSkeletonSpaceMatrices(evaluated);
+            float limbLength = Distance(GetJointPosition(evaluated, upper), GetJointPosition(evaluated, middle)) +
+                Distance(GetJointPosition(evaluated, middle), GetJointPosition(evaluated, end));
+
+            std::vector<float> times(kSolves);
+            std::vector<Vector3> targets(kSolves);
+            std::vector<Vector3> poles(kSolves);
+            for (uint32_t i = 0; i < kSolves; ++i) {
+                times[i] = phase(random);
+                clip.Sample(times[i], pose);
+                Vector3 root = solver.CalculateEndPosition(pose);
+                Vector3 offset = { unit(random), unit(random), unit(random) };
+                float scale = (i % 8 == 7 ? 2.0f : 0.5f) * limbLength;
+                targets[i] = root + offset * scale;
+                poles[i] = root + Vector3{ unit(random), unit(random), unit(random) } * limbLength * 2.0f;
+            }
+
+            float maxError = 0.0f;
+            float poleError = 0.0f;
+            float directionError = 0.0f;
+            double totalNs = 0.0;
+            for (uint32_t i = 0; i < kSolves; ++i) {
+                clip.Sample(times[i], pose);
+                bool usePole = (i % 2) == 1;
+                BenchUtility::Timer timer;
+                solver.Solve(pose, targets[i], 1.0f, usePole ? &poles[i] : nullptr);
+                totalNs += timer.ElapsedNs();
+
+                // スケルトン全体を評価して、endが目標に届いたか（届かなければ目標の方向を向いたか）を確かめる
+                ApplyPoseToSkeleton(pose, evaluated);
+                UpdateSkeletonSpaceMatrices(evaluated);
+                Vector3 a = GetJointPosition(evaluated, upper);
+                Vector3 b = GetJointPosition(evaluated, middle);
+                Vector3 c = GetJointPosition(evaluated, end);
+                float reach = Distance(a, b) + Distance(b, c);
+                float toTarget = Distance(a, targets[i]);
+                if (toTarget < reach * 0.999f) {
+                    maxError = std::max(maxError, Distance(c, targets[i]) / limbLength);
+                } else {
+                    Vector3 ac = (c - a) / Distance(c, a);
+                    Vector3 at = (targets[i] - a) / toTarget;
+                    directionError = std::max(directionError, Distance(ac, at));
+                }
+                if (usePole && toTarget < reach * 0.999f) {
+                    // middleがa・目標・ポールの面にあるか
+                    Vector3 u = targets[i] - a;
+                    Vector3 v = poles[i] - a;
+                    Vector3 n = { u.y * v.z - u.z * v.y, u.z * v.x - u.x * v.z, u.x * v.y - u.y * v.x };
+                    float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+                    if (length > 1.0e-3f * limbLength * limbLength) {
+                        Vector3 ab = b - a;
+                        poleError = std::max(poleError, std::fabs(ab.x * n.x + ab.y * n.y + ab.z * n.z) / length / limbLength);
+                    }
+                }
+            }
+            double nsPerSolve = totalNs / kSolves;
+            if (csv) {
+                std::printf("two_bone_%s,%u,%.1f,%.2e,%.2e,%.2e\n", limb.name, kSolves, nsPerSolve, maxError, poleError, directionError);
+            } else {
+                std::printf("ik two-bone %-4s %5u solves  %6.1f ns/solve  max error %.2e  pole plane error %.2e  unreachable direction error %.2e"
+                    " (relative to limb length)\n", limb.name, kSolves, nsPerSolve, maxError, poleError, directionError);
+            }
+        }
+
+        // 注視：上限の角度以内の目標にはちょうど向き、上限を超えた目標には上限まで回る
+        int32_t head = findJoint("mixamorig:Head");
+        LookAtIkSolver lookAt;
+        const float kMaxAngle = 1.2f;
+        if (lookAt.Initialize(skeleton, head, { 0.0f, 0.0f, 1.0f }, kMaxAngle)) {
+            std::mt19937 random(11);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            std::uniform_real_distribution<float> phase(0.0f, clip.GetDuration());
+            float maxError = 0.0f;
+            float limitError = 0.0f;
+            double totalNs = 0.0;
+            for (uint32_t i = 0; i < kSolves; ++i) {
+                clip.Sample(phase(random), pose);
+                ApplyPoseToSkeleton(pose, evaluated);
+                UpdateSkeletonSpaceMatrices(evaluated);
+                Vector3 headPosition = GetJointPosition(evaluated, head);
+                Vector3 before = lookAt.CalculateAimDirection(pose);
+                Vector3 target = headPosition + Vector3{ unit(random), unit(random), unit(random) } * 100.0f;
+
+                BenchUtility::Timer timer;
+                lookAt.Solve(pose, target);
+                totalNs += timer.ElapsedNs();
+
+                Vector3 after = lookAt.CalculateAimDirection(pose);
+                Vector3 desired = (target - headPosition) / Distance(target, headPosition);
+                float required = std::acos(std::clamp(before.x * desired.x + before.y * desired.y + before.z * desired.z, -1.0f, 1.0f));
+                float turned = std::acos(std::clamp(before.x * after.x + before.y * after.y + before.z * after.z, -1.0f, 1.0f));
+                if (required <= kMaxAngle) {
+                    maxError = std::max(maxError, Distance(after, desired));
+                } else {
+                    limitError = std::max(limitError, std::fabs(turned - kMaxAngle));
+                }
+            }
+            double nsPerSolve = totalNs / kSolves;
+            if (csv) {
+                std::printf("look_at,%u,%.1f,%.2e,0,%.2e\n", kSolves, nsPerSolve, maxError, limitError);
+            } else {
+                std::printf("ik look-at        %5u solves  %6.1f ns/solve  max direction error %.2e  angle limit error %.2e\n",
+                    kSolves, nsPerSolve, maxError, limitError);
+            }
+        }
+
+        // 両脚を解いた後のスケルトンの更新：部分木だけ / 全体
+        int32_t legs[2][3] = {
+            { findJoint("mixamorig:LeftUpLeg"), findJoint("mixamorig:LeftLeg"), findJoint("mixamorig:LeftFoot") },
+            { findJoint("mixamorig:RightUpLeg"), findJoint("mixamorig:RightLeg"), findJoint("mixamorig:RightFoot") },
+        };
+        FootIkRig rig;
+        for (const auto& leg : legs) {
+            rig.AddLeg(skeleton, leg[0], leg[1], leg[2]);
+        }
+        if (rig.GetLegCount() == 2) {
+            clip.Sample(0.3f, pose);
+            ApplyPoseToSkeleton(pose, evaluated);
+            UpdateSkeletonSpaceMatrices(evaluated);
+            Skeleton full = evaluated;
+
+            // 左足だけ段差に乗せる（地面の高さは脚ごと、当たらなければNaN）
+            Matrix4x4 world = MakeIdentity4x4();
+            const float groundHeights[2] = { 0.15f, std::nanf("") };
+            AnimationPose solvedPose = pose;
+            rig.Apply(solvedPose, evaluated, world, groundHeights, 0.0f);
+            ApplyPoseToSkeleton(solvedPose, full);
+            UpdateSkeletonSpaceMatrices(full);
+            float subtreeError = 0.0f;
+            for (size_t j = 0; j < full.joints.size(); ++j) {
+                for (int row = 0; row < 4; ++row) {
+                    for (int column = 0; column < 3; ++column) {
+                        subtreeError = std::max(subtreeError, std::fabs(full.joints[j].skeletonSpaceMatrix.m[row][column] -
+                            evaluated.joints[j].skeletonSpaceMatrix.m[row][column]));
+                    }
+                }
+            }
+            // 左足首がワールドで段差の高さだけ上がったか（右足は当たらないので動かない）
+            Matrix4x4 originalFoot = full.joints[legs[0][2]].skeletonSpaceMatrix;
+            Skeleton unsolved = evaluated;
+            ApplyPoseToSkeleton(pose, unsolved);
+            UpdateSkeletonSpaceMatrices(unsolved);
+            float stepError = std::fabs((originalFoot.m[3][1] - GetJointPosition(unsolved, legs[0][2]).y) - groundHeights[0]) +
+                Distance(GetJointPosition(full, legs[1][2]), GetJointPosition(unsolved, legs[1][2]));
+
+            uint32_t subtreeJoints = 0;
+            for (const auto& leg : legs) {
+                std::vector<int32_t> stack = { leg[0] };
+                while (!stack.empty()) {
+                    int32_t joint = stack.back();
+                    stack.pop_back();
+                    ++subtreeJoints;
+                    stack.insert(stack.end(), evaluated.joints[joint].children.begin(), evaluated.joints[joint].children.end());
+                }
+            }
+
+            const uint32_t kRepeats = 20000;
+            BenchUtility::Timer subtreeTimer;
+            for (uint32_t i = 0; i < kRepeats; ++i) {
+                UpdateSkeletonSubtree(evaluated, legs[i & 1][0]);
+            }
+            double subtreeNs = subtreeTimer.ElapsedNs() / (kRepeats / 2);
+            BenchUtility::Timer fullTimer;
+            for (uint32_t i = 0; i < kRepeats / 2; ++i) {
+                UpdateSkeletonSpaceMatrices(evaluated);
+            }
+            double fullNs = fullTimer.ElapsedNs() / (kRepeats / 2);
+            if (csv) {
+                std::printf("recompute,%zu,%u,%.1f,%.1f,%.2e,%.2e\n", skeleton.joints.size(), subtreeJoints, subtreeNs, fullNs, subtreeError, stepError);
+            } else {
+                std::printf("ik recompute after 2 legs: subtrees %2u/%zu joints %6.1f ns  full skeleton %6.1f ns (x%.1f)  difference %.2e  "
+                    "foot step error %.2e\n", subtreeJoints, skeleton.joints.size(), subtreeNs, fullNs, fullNs / subtreeNs, subtreeError, stepError);
+            }
+        }
+    }
+
+    // frozenのジョイントのトラックを最初のキーだけの値にしたアニメーション（キーの数はそのまま）
+    // 指・顔などが静止した、部分的にアニメーションするリグの代わりに使う
+    Animation FreezeJoints(const Animation& animation, const Skeleton& skeleton, const std::vector<uint8_t>& frozen) {
+        Animation result = animation;
+        for (size_t i = 0; i < skeleton.joints.size(); ++i) {
+            auto it = result.nodeAnimations.find(skeleton.joints[i].name);
+            if (!frozen[i] || it == result.nodeAnimations.end()) {
+                continue;
+            }
+            auto freeze = [](auto& keyframes) {
+                for (auto& keyframe : keyframes) {
+                    keyframe.value = keyframes.front().value;
+                }
+            };
+            freeze(it->second.translate);
+            freeze(it->second.rotate);
+            freeze(it->second.scale);
+        }
+        return result;
+    }
+
+    // 深いジョイントから順にfrozenCount個を静止させる印
+    std::vector<uint8_t> SelectDeepJoints(const Skeleton& skeleton, uint32_t frozenCount) {
+        std::vector<uint32_t> depths(skeleton.joints.size(), 0);
+        std::vector<int32_t> order(skeleton.joints.size());
+        for (size_t i = 0; i < skeleton.joints.size(); ++i) {
+            if (skeleton.joints[i].parent) {
+                depths[i] = depths[*skeleton.joints[i].parent] + 1;
+            }
+            order[i] = static_cast<int32_t>(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [&depths](int32_t a, int32_t b) { return depths[a] > depths[b]; });
+        std::vector<uint8_t> frozen(skeleton.joints.size(), 0);
+        for (uint32_t i = 0; i < frozenCount && i < order.size(); ++i) {
+            frozen[order[i]] = 1;
+        }
+        return frozen;
+    }
+
+    void BenchmarkIncrementalUpdate(const Animation& walk, const Skeleton& skeleton, uint32_t frames, bool csv) {
+        if (csv) {
+            std::printf("clip,joints,animated_joints,updated_joints,full_ns,incremental_ns,speedup,max_difference\n");
+        }
+        const uint32_t jointCount = static_cast<uint32_t>(skeleton.joints.size());
+        const uint32_t kRepeats = 50;
+        // 深いジョイントから静止させて割合を変えたもの（腰が動くので子孫の行列は計算し直す）と、
+        // 頭から下だけが動くもの（祖先が静止しているので頭以外の部分木は丸ごと前回のまま）
+        struct Variant {
+            std::string name;
+            std::vector<uint8_t> frozen;
+        };
+        std::vector<Variant> variants;
+        for (uint32_t percent : { 100u, 75u, 50u, 25u, 10u }) {
+            variants.push_back({ "walk " + std::to_string(percent) + "%", SelectDeepJoints(skeleton, jointCount - jointCount * percent / 100) });
+        }
+        auto head = skeleton.jointMap.find("mixamorig:Head");
+        if (head != skeleton.jointMap.end()) {
+            std::vector<uint8_t> frozen(jointCount, 1);
+            for (uint32_t joint = 0; joint < jointCount; ++joint) {
+                for (std::optional<int32_t> ancestor = static_cast<int32_t>(joint); ancestor; ancestor = skeleton.joints[*ancestor].parent) {
+                    if (*ancestor == head->second) {
+                        frozen[joint] = 0;
+                        break;
+                    }
+                }
+            }
+            variants.push_back({ "head only", frozen });
+        }
+
+        for (const Variant& variant : variants) {
+            Animation animation = FreezeJoints(walk, skeleton, variant.frozen);
+            CompiledAnimationClip clip;
+            clip.Compile(animation, skeleton);
+
+            // 計測するのはポーズの適用とスケルトンの更新だけなので、ポーズは先にサンプリングしておく
+            std::vector<AnimationPose> poses(frames);
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                clip.Sample(std::fmod(frame * kDeltaTime, clip.GetDuration()), poses[frame]);
+            }
+
+            // 毎フレームの結果を全体の再計算と比べる（静的なジョイントは前回の行列のまま）
+            Skeleton full = skeleton;
+            Skeleton incremental = skeleton;
+            IncrementalSkeletonUpdate update;
+            std::vector<uint8_t> animatedJoints(jointCount);
+            float maxDifference = 0.0f;
+            uint32_t updatedJoints = 0;
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                ApplyPoseToSkeleton(poses[frame], full);
+                UpdateSkeletonSpaceMatrices(full);
+                ApplyPoseToSkeleton(poses[frame], incremental);
+                std::fill(animatedJoints.begin(), animatedJoints.end(), uint8_t{ 0 });
+                for (uint32_t joint = 0; joint < jointCount; ++joint) {
+                    animatedJoints[joint] |= clip.GetAnimatedJoints()[joint];
+                }
+                update.SetAnimatedJoints(incremental, animatedJoints);
+                updatedJoints = update.Update(incremental);
+                for (uint32_t j = 0; j < jointCount; ++j) {
+                    for (int row = 0; row < 4; ++row) {
+                        for (int column = 0; column < 4; ++column) {
+                            maxDifference = std::max(maxDifference, std::fabs(full.joints[j].skeletonSpaceMatrix.m[row][column] -
+                                incremental.joints[j].skeletonSpaceMatrix.m[row][column]));
+                        }
+                    }
+                }
+            }
+
+            BenchUtility::Timer fullTimer;
+            for (uint32_t repeat = 0; repeat < kRepeats; ++repeat) {
+                for (const AnimationPose& pose : poses) {
+                    ApplyPoseToSkeleton(pose, full);
+                    UpdateSkeletonSpaceMatrices(full);
+                }
+            }
+            double fullNs = fullTimer.ElapsedNs() / (static_cast<double>(kRepeats) * frames);
+
+            // 実行時と同じく毎フレーム印を作り直して比べる（同じ内容なら更新リストは作り直さない）
+            BenchUtility::Timer incrementalTimer;
+            for (uint32_t repeat = 0; repeat < kRepeats; ++repeat) {
+                for (const AnimationPose& pose : poses) {
+                    ApplyPoseToSkeleton(pose, incremental);
+                    std::fill(animatedJoints.begin(), animatedJoints.end(), uint8_t{ 0 });
+                    for (uint32_t joint = 0; joint < jointCount; ++joint) {
+                        animatedJoints[joint] |= clip.GetAnimatedJoints()[joint];
+                    }
+                    update.SetAnimatedJoints(incremental, animatedJoints);
+                    update.Update(incremental);
+                }
+            }
+            double incrementalNs = incrementalTimer.ElapsedNs() / (static_cast<double>(kRepeats) * frames);
+
+            const char* name = variant.name.c_str();
+            if (csv) {
+                std::printf("%s,%u,%u,%u,%.1f,%.1f,%.2f,%.2e\n", name, jointCount, clip.GetAnimatedJointCount(), updatedJoints,
+                    fullNs, incrementalNs, fullNs / incrementalNs, maxDifference);
+            } else {
+                std::printf("incremental %-9s animated %2u/%u joints  updated %2u  full %6.1f ns  incremental %6.1f ns (x%.2f)  max difference %.2e\n",
+                    name, clip.GetAnimatedJointCount(), jointCount, updatedJoints, fullNs, incrementalNs, fullNs / incrementalNs, maxDifference);
+            }
+        }
+    }
+
+    Quaternion MultiplyQuaternion(const Quaternion& a, const Quaternion& b) {
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        };
+    }
+
+    Vector3 RotateVector(const Quaternion& q, const Vector3& v) {
+        Quaternion p = MultiplyQuaternion(MultiplyQuaternion(q, { v.x, v.y, v.z, 0.0f }), { -q.x, -q.y, -q.z, q.w });
+        return { p.x, p.y, p.z };
+    }
+
+    // 別のキャラクターの代わりのスケルトン：名前空間を外し、各ジョイントの向きをframes[joint]だけ回し、骨の長さをlengthScale倍する
+    // 正しくリターゲットできていれば、各ジョイントのモデル空間の位置は元のlengthScale倍、向きは元 * frames[joint]になる
+    Skeleton MakeRetargetTarget(const Skeleton& source, const std::vector<Quaternion>& frames, float lengthScale) {
+        Skeleton target = source;
+        target.jointMap.clear();
+        for (Joint& joint : target.joints) {
+            Quaternion parentFrame = joint.parent ? frames[*joint.parent] : Quaternion{ 0.0f, 0.0f, 0.0f, 1.0f };
+            Quaternion inverseParent = { -parentFrame.x, -parentFrame.y, -parentFrame.z, parentFrame.w };
+            joint.name = std::string(GetRetargetJointName(joint.name));
+            joint.transform.rotate = MultiplyQuaternion(MultiplyQuaternion(inverseParent, joint.transform.rotate), frames[joint.index]);
+            joint.transform.translate = RotateVector(inverseParent, joint.transform.translate) * lengthScale;
+            target.jointMap.emplace(joint.name, joint.index);
+        }
+        return target;
+    }
+
+    void BenchmarkRetarget(const std::vector<std::pair<std::string, const Animation*>>& animations, const Skeleton& skeleton, uint32_t frames,
+        bool csv) {
+        std::mt19937 random(2024);
+        std::uniform_real_distribution<float> axisDistribution(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> angleDistribution(-1.5f, 1.5f);
+        std::vector<Quaternion> jointFrames(skeleton.joints.size());
+        for (Quaternion& frame : jointFrames) {
+            Vector3 axis = { axisDistribution(random), axisDistribution(random), axisDistribution(random) };
+            axis = axis / std::max(std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z), 1.0e-3f);
+            float angle = angleDistribution(random);
+            frame = { axis.x * std::sin(angle * 0.5f), axis.y * std::sin(angle * 0.5f), axis.z * std::sin(angle * 0.5f), std::cos(angle * 0.5f) };
+        }
+        const float kLengthScale = 1.25f;
+        Skeleton target = MakeRetargetTarget(skeleton, jointFrames, kLengthScale);
+        uint64_t sourceHash = HashSkeleton(skeleton);
+        uint64_t targetHash = HashSkeleton(target);
+
+        // 対応表の作成と、作成済みの組をキャッシュから引く負荷
+        const uint32_t kBuilds = 200;
+        BenchUtility::Timer buildTimer;
+        for (uint32_t i = 0; i < kBuilds; ++i) {
+            AnimationRetargetMap map;
+            map.Build(skeleton, target);
+        }
+        double buildUs = buildTimer.ElapsedNs() / kBuilds / 1000.0;
+        AnimationRetargetCache cache;
+        const AnimationRetargetMap& map = cache.GetMap(skeleton, sourceHash, target, targetHash);
+        const uint32_t kLookups = 100000;
+        BenchUtility::Timer lookupTimer;
+        const AnimationRetargetMap* found = nullptr;
+        for (uint32_t i = 0; i < kLookups; ++i) {
+            found = &cache.GetMap(skeleton, sourceHash, target, targetHash);
+        }
+        double lookupNs = lookupTimer.ElapsedNs() / kLookups;
+        if (found != &map || cache.GetMapCount() != 1) {
+            std::printf("retarget: the cache built another map for the same skeletons\n");
+            return;
+        }
+
+        AnimationRetargetMap identity;
+        identity.Build(skeleton, skeleton);
+
+        if (csv) {
+            std::printf("clip,joints,mapped,build_us,lookup_ns,convert_us,position_error,rotation_error,identity_error\n");
+        }
+        for (const auto& [name, animation] : animations) {
+            const uint32_t kConversions = 50;
+            BenchUtility::Timer convertTimer;
+            Animation retargeted;
+            for (uint32_t i = 0; i < kConversions; ++i) {
+                retargeted = map.Retarget(*animation);
+            }
+            double convertUs = convertTimer.ElapsedNs() / kConversions / 1000.0;
+
+            CompiledAnimationClip sourceClip;
+            CompiledAnimationClip targetClip;
+            CompiledAnimationClip identityClip;
+            sourceClip.Compile(*animation, skeleton);
+            targetClip.Compile(retargeted, target);
+            identityClip.Compile(identity.Retarget(*animation), skeleton);
+
+            // 位置は体の大きさ（バインドポーズの最も遠いジョイントまで）に対する比、向きは基底の差
+            Skeleton sourceSkeleton = skeleton;
+            Skeleton targetSkeleton = target;
+            Skeleton identitySkeleton = skeleton;
+            UpdateSkeletonSpaceMatrices(sourceSkeleton);
+            float size = 1.0e-6f;
+            for (size_t j = 0; j < skeleton.joints.size(); ++j) {
+                size = std::max(size, Distance(GetJointPosition(sourceSkeleton, static_cast<int32_t>(j)), GetJointPosition(sourceSkeleton, 0)));
+            }
+            AnimationPose pose;
+            float positionError = 0.0f;
+            float rotationError = 0.0f;
+            float identityError = 0.0f;
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                float time = std::fmod(frame * kDeltaTime, sourceClip.GetDuration());
+                sourceClip.Sample(time, pose);
+                ApplyPoseToSkeleton(pose, sourceSkeleton);
+                UpdateSkeletonSpaceMatrices(sourceSkeleton);
+                targetClip.Sample(time, pose);
+                ApplyPoseToSkeleton(pose, targetSkeleton);
+                UpdateSkeletonSpaceMatrices(targetSkeleton);
+                identityClip.Sample(time, pose);
+                ApplyPoseToSkeleton(pose, identitySkeleton);
+                UpdateSkeletonSpaceMatrices(identitySkeleton);
+
+                for (size_t j = 0; j < skeleton.joints.size(); ++j) {
+                    int32_t joint = static_cast<int32_t>(j);
+                    Vector3 expected = GetJointPosition(sourceSkeleton, joint) * kLengthScale;
+                    positionError = std::max(positionError, Distance(GetJointPosition(targetSkeleton, joint), expected) / (size * kLengthScale));
+                    identityError = std::max(identityError, Distance(GetJointPosition(identitySkeleton, joint), GetJointPosition(sourceSkeleton, joint)) / size);
+
+                    Matrix4x4 expectedBasis = Multiply(MakeRotateMatrix(jointFrames[j]), sourceSkeleton.joints[j].skeletonSpaceMatrix);
+                    const Matrix4x4& actualBasis = targetSkeleton.joints[j].skeletonSpaceMatrix;
+                    for (int row = 0; row < 3; ++row) {
+                        const float* e = expectedBasis.m[row];
+                        float scale = std::max(std::sqrt(e[0] * e[0] + e[1] * e[1] + e[2] * e[2]), 1.0e-6f);
+                        for (int column = 0; column < 3; ++column) {
+                            rotationError = std::max(rotationError, std::fabs(actualBasis.m[row][column] - e[column]) / scale);
+                        }
+                    }
+                }
+            }
+
+            if (csv) {
+                std::printf("%s,%zu,%u,%.2f,%.1f,%.2f,%.2e,%.2e,%.2e\n", name.c_str(), skeleton.joints.size(), map.GetMappedJointCount(), buildUs,
+                    lookupNs, convertUs, positionError, rotationError, identityError);
+            } else {
+                std::printf("retarget %-9s mapped %u/%zu joints  build %6.2f us  cached lookup %5.1f ns  convert %7.2f us/clip  "
+                    "position error %.2e  rotation error %.2e  same skeleton error %.2e\n",
+                    name.c_str(), map.GetMappedJointCount(), skeleton.joints.size(), buildUs, lookupNs, convertUs, positionError, rotationError,
+                    identityError);
+            }
+        }
+    }
+
+    // 格子のメッシュをAnimatedModel::ProcessAssimpMeshと同じように最適化したModelData（インデックス・ボーンウェイト付き）
+    ModelData MakeImportedModelData(const ImportMesh& mesh, uint32_t gridSize, const Skeleton& skeleton) {
+        ModelData modelData;
+        MaterialVertexData matVertexData;
+        matVertexData.materialIndex = 0;
+        std::vector<uint32_t> vertexRemap = OptimizeImportMesh(mesh, gridSize, matVertexData.vertices, matVertexData.indices);
+        modelData.vertices = matVertexData.vertices;
+        for (size_t bone = 0; bone < mesh.boneWeights.size(); ++bone) {
+            JointWeightData& jointWeightData = modelData.skinClusterData[skeleton.joints[bone].name];
+            jointWeightData.inverseBindPoseMatrix = MakeIdentity4x4();
+            size_t firstWeight = jointWeightData.vertexWeights.size();
+            for (const auto& [vertexId, weight] : mesh.boneWeights[bone]) {
+                jointWeightData.vertexWeights.push_back({ weight, vertexId });
+            }
+            RemapVertexWeights(jointWeightData.vertexWeights, firstWeight, vertexRemap);
+        }
+        modelData.matVertexData[L"body"] = std::move(matVertexData);
+        MaterialData material;
+        material.textureFilePath = "Resources/uvChecker.png";
+        material.isPBR = true;
+        modelData.materials.push_back(material);
+        modelData.material = material;
+        return modelData;
+    }
+
+    template <typename T>
+    bool IsSameBytes(const std::vector<T>& a, const std::vector<T>& b) {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+    }
+
+    bool IsSameModelData(const ModelData& a, const ModelData& b) {
+        bool same = IsSameBytes(a.vertices, b.vertices) && IsSameBytes(a.indices, b.indices) &&
+            a.skinClusterData.size() == b.skinClusterData.size() && a.matVertexData.size() == b.matVertexData.size() &&
+            a.materials.size() == b.materials.size() && a.material.textureFilePath == b.material.textureFilePath;
+        for (auto itA = a.skinClusterData.begin(), itB = b.skinClusterData.begin(); same && itA != a.skinClusterData.end(); ++itA, ++itB) {
+            same = itA->first == itB->first && IsSameBytes(itA->second.vertexWeights, itB->second.vertexWeights) &&
+                std::memcmp(&itA->second.inverseBindPoseMatrix, &itB->second.inverseBindPoseMatrix, sizeof(Matrix4x4)) == 0;
+        }
+        for (auto itA = a.matVertexData.begin(), itB = b.matVertexData.begin(); same && itA != a.matVertexData.end(); ++itA, ++itB) {
+            same = itA->first == itB->first && IsSameBytes(itA->second.vertices, itB->second.vertices) &&
+                IsSameBytes(itA->second.indices, itB->second.indices) && itA->second.materialIndex == itB->second.materialIndex;
+        }
+        for (size_t i = 0; same && i < a.materials.size(); ++i) {
+            same = a.materials[i].textureFilePath == b.materials[i].textureFilePath && a.materials[i].isPBR == b.materials[i].isPBR;
+        }
+        return same;
+    }
+
+    bool IsSameAnimation(const ModelCacheAnimation& a, const ModelCacheAnimation& b) {
+        bool same = a.rootNodeName == b.rootNodeName && a.skeleton.root == b.skeleton.root &&
+            a.skeleton.joints.size() == b.skeleton.joints.size() && a.skeleton.jointMap == b.skeleton.jointMap &&
+            a.animation.has_value() == b.animation.has_value();
+        for (size_t j = 0; same && j < a.skeleton.joints.size(); ++j) {
+            const Joint& jointA = a.skeleton.joints[j];
+            const Joint& jointB = b.skeleton.joints[j];
+            same = jointA.name == jointB.name && jointA.parent == jointB.parent && jointA.children == jointB.children &&
+                std::memcmp(&jointA.transform, &jointB.transform, sizeof(jointA.transform)) == 0 &&
+                std::memcmp(&jointA.localMatrix, &jointB.localMatrix, sizeof(Matrix4x4)) == 0;
+        }
+        if (same && a.animation) {
+            same = a.animation->duration == b.animation->duration && a.animation->nodeAnimations.size() == b.animation->nodeAnimations.size();
+            for (auto itA = a.animation->nodeAnimations.begin(), itB = b.animation->nodeAnimations.begin();
+                same && itA != a.animation->nodeAnimations.end(); ++itA, ++itB) {
+                same = itA->first == itB->first && IsSameBytes(itA->second.translate, itB->second.translate) &&
+                    IsSameBytes(itA->second.rotate, itB->second.rotate) && IsSameBytes(itA->second.scale, itB->second.scale);
+            }
+        }
+        return same;
+    }
+
+    // インポート済みモデルのキャッシュの書き出し・読み込みの負荷と、読み込んだ内容が書き出したものと一致するかを確認する
+    // インポートは頂点の最適化とボーンウェイトの付け替えだけの負荷（Assimpのファイルの解析は含まない）
+    // 同梱のwalk.gltfはtinygltfでスケルトンとアニメーションを読む負荷と、元ファイルのハッシュ＋キャッシュの読み込みを比較する
+    void BenchmarkModelCache(const std::string& walkPath, const Animation& walk, const Skeleton& skeleton, bool csv) {
+        std::string cachePath = (std::filesystem::temp_directory_path() / "AnimationBench.skin.modelcache").string();
+        const uint64_t kSourceHash = 0x0123456789ABCDEFull;
+        const uint32_t kRepeats = 5;
+        ModelCacheAnimation animation{ skeleton, "root", walk };
+
+        if (csv) {
+            std::printf("triangles,bytes,import_ms,write_ms,read_ms,read_gb_per_s,identical,stale_rejected,truncated_rejected\n");
+        }
+        for (uint32_t gridSize : { 64u, 256u, 512u }) {
+            ImportMesh mesh = MakeImportMesh(gridSize, static_cast<uint32_t>(skeleton.joints.size()));
+            BenchUtility::Timer importTimer;
+            ModelData modelData = MakeImportedModelData(mesh, gridSize, skeleton);
+            double importMs = importTimer.ElapsedNs() / 1.0e6;
+
+            BenchUtility::Timer writeTimer;
+            bool written = WriteModelCache(cachePath, ModelCacheKind::AnimatedMesh, kSourceHash, modelData, &animation);
+            double writeMs = writeTimer.ElapsedNs() / 1.0e6;
+            if (!written) {
+                std::printf("model cache: failed to write %s\n", cachePath.c_str());
+                return;
+            }
+            uintmax_t bytes = std::filesystem::file_size(cachePath);
+
+            double readMs = 1.0e30;
+            bool identical = true;
+            for (uint32_t i = 0; i < kRepeats; ++i) {
+                ModelData loaded;
+                ModelCacheAnimation loadedAnimation;
+                BenchUtility::Timer readTimer;
+                bool read = ReadModelCache(cachePath, ModelCacheKind::AnimatedMesh, kSourceHash, loaded, &loadedAnimation);
+                readMs = std::min(readMs, readTimer.ElapsedNs() / 1.0e6);
+                identical = identical && read && IsSameModelData(modelData, loaded) && IsSameAnimation(animation, loadedAnimation);
+            }
+
+            // 元ファイルのハッシュが違うキャッシュと、途中で切れたキャッシュは読まない
+            ModelData rejected;
+            bool staleRejected = !ReadModelCache(cachePath, ModelCacheKind::AnimatedMesh, kSourceHash + 1, rejected) &&
+                !ReadModelCache(cachePath, ModelCacheKind::StaticMesh, kSourceHash, rejected);
+            std::filesystem::resize_file(cachePath, bytes / 2);
+            bool truncatedRejected = !ReadModelCache(cachePath, ModelCacheKind::AnimatedMesh, kSourceHash, rejected);
+
+            uint32_t triangleCount = static_cast<uint32_t>(mesh.faces.size() / 3);
+            double gbPerSecond = static_cast<double>(bytes) / (readMs * 1.0e6);
+            if (csv) {
+                std::printf("%u,%ju,%.3f,%.3f,%.3f,%.2f,%d,%d,%d\n", triangleCount, bytes, importMs, writeMs, readMs, gbPerSecond, identical,
+                    staleRejected, truncatedRejected);
+            } else {
+                std::printf("model cache %6u triangles %7.2f MB  import %7.3f ms  write %7.3f ms  read %7.3f ms (%5.2f GB/s)  "
+                    "identical %s  stale rejected %s  truncated rejected %s\n",
+                    triangleCount, static_cast<double>(bytes) / (1024.0 * 1024.0), importMs, writeMs, readMs, gbPerSecond,
+                    identical ? "yes" : "NO", staleRejected ? "yes" : "NO", truncatedRejected ? "yes" : "NO");
+            }
+        }
+
+        // 同梱のwalk.gltfのスケルトンとアニメーション
+        size_t separator = walkPath.find_last_of("/\\");
+        std::string directory = walkPath.substr(0, separator);
+        std::string filename = walkPath.substr(separator + 1);
+        double parseMs = 1.0e30;
+        double cachedMs = 1.0e30;
+        WriteModelCache(cachePath, ModelCacheKind::AnimatedMesh, HashModelSource(directory, filename), ModelData{}, &animation);
+        for (uint32_t i = 0; i < kRepeats; ++i) {
+            Animation parsedAnimation;
+            Skeleton parsedSkeleton;
+            BenchUtility::Timer parseTimer;
+            BenchAnimation::LoadGltfSkeleton(walkPath, parsedSkeleton);
+            BenchAnimation::LoadGltfAnimation(walkPath, parsedAnimation);
+            parseMs = std::min(parseMs, parseTimer.ElapsedNs() / 1.0e6);
+
+            ModelData loaded;
+            ModelCacheAnimation loadedAnimation;
+            BenchUtility::Timer cachedTimer;
+            bool read = ReadModelCache(cachePath, ModelCacheKind::AnimatedMesh, HashModelSource(directory, filename), loaded, &loadedAnimation);
+            cachedMs = std::min(cachedMs, cachedTimer.ElapsedNs() / 1.0e6);
+            if (!read) {
+                std::printf("model cache: failed to read %s\n", cachePath.c_str());
+                return;
+            }
+        }
+        if (!csv) {
+            std::printf("model cache walk.gltf skeleton+animation  gltf parse %7.3f ms  hash+cache read %7.3f ms (x%.1f)\n", parseMs, cachedMs,
+                parseMs / cachedMs);
+        }
+        std::filesystem::remove(cachePath);
+    }
+
+    // 旧実装（1行ずつistringstreamで読み、三角形の頂点をそのまま展開する）。比較の基準として残す
+    std::vector<VertexData> LoadObjReference(const std::string& path) {
+        std::vector<VertexData> vertices;
+        std::vector<Vector4> positions;
+        std::vector<Vector3> normals;
+        std::vector<Vector2> texcoords;
+        std::string line;
+        std::ifstream file(path);
+        while (std::getline(file, line)) {
+            std::string identifier;
+            std::istringstream s(line);
+            s >> identifier;
+            if (identifier == "v") {
+                Vector4 position;
+                s >> position.x >> position.y >> position.z;
+                position.w = 1.0f;
+                position.x *= -1;
+                positions.push_back(position);
+            } else if (identifier == "vt") {
+                Vector2 texcoord;
+                s >> texcoord.x >> texcoord.y;
+                texcoord.y = 1 - texcoord.y;
+                texcoords.push_back(texcoord);
+            } else if (identifier == "vn") {
+                Vector3 normal;
+                s >> normal.x >> normal.y >> normal.z;
+                normal.x *= -1;
+                normals.push_back(normal);
+            } else if (identifier == "f") {
+                VertexData triangle[3];
+                for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
+                    std::string vertexDefinition;
+                    s >> vertexDefinition;
+                    std::istringstream v(vertexDefinition);
+                    uint32_t elementIndices[3];
+                    for (int32_t element = 0; element < 3; ++element) {
+                        std::string index;
+                        std::getline(v, index, '/');
+                        elementIndices[element] = std::stoi(index);
+                    }
+                    triangle[faceVertex] = { positions[elementIndices[0] - 1], texcoords[elementIndices[1] - 1], normals[elementIndices[2] - 1] };
+                }
+                vertices.push_back(triangle[2]);
+                vertices.push_back(triangle[1]);
+                vertices.push_back(triangle[0]);
+            }
+        }
+        return vertices;
+    }
+
+    // 格子状のメッシュのOBJを書き出す
+    // quadsなら位置だけを書き、四角形の面を負のインデックス（直前の行からの相対位置）で参照する
+    bool WriteGridObj(const std::string& path, uint32_t gridSize, bool quads) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        const uint32_t rowSize = gridSize + 1;
+        const float step = 1.0f / static_cast<float>(gridSize);
+        for (uint32_t z = 0; z < rowSize; ++z) {
+            for (uint32_t x = 0; x < rowSize; ++x) {
+                float height = 0.05f * std::sin(static_cast<float>(x) * 0.3f) * std::cos(static_cast<float>(z) * 0.2f);
+                std::fprintf(file, "v %.6f %.6f %.6f\n", x * step, quads ? 0.0f : height, z * step);
+            }
+        }
+        if (!quads) {
+            for (uint32_t z = 0; z < rowSize; ++z) {
+                for (uint32_t x = 0; x < rowSize; ++x) {
+                    std::fprintf(file, "vt %.6f %.6f\n", x * step, z * step);
+                    std::fprintf(file, "vn %.6f %.6f %.6f\n", 0.05f * std::cos(x * 0.3f), 1.0f, -0.05f * std::sin(z * 0.2f));
+                }
+            }
+        }
+        const int64_t vertexCount = static_cast<int64_t>(rowSize) * rowSize;
+        for (uint32_t z = 0; z < gridSize; ++z) {
+            for (uint32_t x = 0; x < gridSize; ++x) {
+                int64_t v00 = z * rowSize + x + 1;
+                int64_t v10 = v00 + 1;
+                int64_t v01 = v00 + rowSize;
+                int64_t v11 = v01 + 1;
+                if (quads) {
+                    std::fprintf(file, "f %lld %lld %lld %lld\n", static_cast<long long>(v00 - vertexCount - 1), static_cast<long long>(v01 - vertexCount - 1),
+                        static_cast<long long>(v11 - vertexCount - 1), static_cast<long long>(v10 - vertexCount - 1));
+                } else {
+                    std::fprintf(file, "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n", static_cast<long long>(v00), static_cast<long long>(v00),
+                        static_cast<long long>(v00), static_cast<long long>(v01), static_cast<long long>(v01), static_cast<long long>(v01),
+                        static_cast<long long>(v10), static_cast<long long>(v10), static_cast<long long>(v10));
+                    std::fprintf(file, "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n", static_cast<long long>(v10), static_cast<long long>(v10),
+                        static_cast<long long>(v10), static_cast<long long>(v01), static_cast<long long>(v01), static_cast<long long>(v01),
+                        static_cast<long long>(v11), static_cast<long long>(v11), static_cast<long long>(v11));
+                }
+            }
+        }
+        std::fclose(file);
+        return true;
+    }
+
+    // OBJの読み込みを旧実装と比較する（格子状のメッシュを一時ファイルに書き出して読む）
+    // 三角形のOBJはインデックスを展開した頂点が旧実装と一致するかを、位置だけの四角形のOBJは
+    // 負のインデックスの分割と法線の生成（平面なので全て上向き）を確認する
+    void BenchmarkObjParse(bool csv) {
+        std::string objPath = (std::filesystem::temp_directory_path() / "AnimationBench.obj").string();
+        const uint32_t kRepeats = 3;
+        if (csv) {
+            std::printf("grid,triangles,bytes,reference_ms,mapped_ms,speedup,mb_per_s,expanded_vertices,unique_vertices,identical\n");
+        }
+        for (uint32_t gridSize : { 128u, 512u }) {
+            if (!WriteGridObj(objPath, gridSize, false)) {
+                std::printf("obj parse: failed to write %s\n", objPath.c_str());
+                return;
+            }
+            uintmax_t bytes = std::filesystem::file_size(objPath);
+
+            BenchUtility::Timer referenceTimer;
+            std::vector<VertexData> reference = LoadObjReference(objPath);
+            double referenceMs = referenceTimer.ElapsedNs() / 1.0e6;
+
+            double mappedMs = 1.0e30;
+            ObjMeshData mesh;
+            for (uint32_t i = 0; i < kRepeats; ++i) {
+                BenchUtility::Timer mappedTimer;
+                LoadObjMesh(objPath, mesh);
+                mappedMs = std::min(mappedMs, mappedTimer.ElapsedNs() / 1.0e6);
+            }
+
+            // インデックスを展開して旧実装と比べる
+            bool identical = mesh.indices.size() == reference.size() && mesh.skippedFaceCount == 0;
+            for (size_t i = 0; identical && i < mesh.indices.size(); ++i) {
+                identical = std::memcmp(&mesh.vertices[mesh.indices[i]], &reference[i], sizeof(VertexData)) == 0;
+            }
+
+            uint32_t triangleCount = static_cast<uint32_t>(mesh.indices.size() / 3);
+            double mbPerSecond = static_cast<double>(bytes) / (mappedMs * 1.0e3);
+            if (csv) {
+                std::printf("%u,%u,%ju,%.3f,%.3f,%.2f,%.1f,%zu,%zu,%d\n", gridSize, triangleCount, bytes, referenceMs, mappedMs, referenceMs / mappedMs,
+                    mbPerSecond, reference.size(), mesh.vertices.size(), identical);
+            } else {
+                std::printf("obj parse %7u triangles %7.2f MB  istringstream %9.3f ms  mapped+from_chars %8.3f ms (x%5.1f, %6.1f MB/s)  "
+                    "vertices %zu -> %zu  identical %s\n",
+                    triangleCount, static_cast<double>(bytes) / (1024.0 * 1024.0), referenceMs, mappedMs, referenceMs / mappedMs, mbPerSecond,
+                    reference.size(), mesh.vertices.size(), identical ? "yes" : "NO");
+            }
+        }
+
+        // 位置だけの四角形を負のインデックスで参照するOBJ
+        const uint32_t kQuadGridSize = 256;
+        WriteGridObj(objPath, kQuadGridSize, true);
+        BenchUtility::Timer quadTimer;
+        ObjMeshData quadMesh;
+        bool loaded = LoadObjMesh(objPath, quadMesh);
+        double quadMs = quadTimer.ElapsedNs() / 1.0e6;
+        float maxNormalError = 0.0f;
+        for (const VertexData& vertex : quadMesh.vertices) {
+            maxNormalError = std::max({ maxNormalError, std::fabs(vertex.normal.x), std::fabs(vertex.normal.y - 1.0f), std::fabs(vertex.normal.z) });
+        }
+        bool quadValid = loaded && quadMesh.skippedFaceCount == 0 && quadMesh.indices.size() == kQuadGridSize * kQuadGridSize * 6 &&
+            quadMesh.vertices.size() == (kQuadGridSize + 1) * (kQuadGridSize + 1);
+        if (!csv) {
+            std::printf("obj parse quads (negative indices, no uv/normal) %u triangles  %8.3f ms  counts %s  max normal error %g\n",
+                static_cast<uint32_t>(quadMesh.indices.size() / 3), quadMs, quadValid ? "ok" : "NG", maxNormalError);
+        }
+        std::filesystem::remove(objPath);
+    }
+
+    // 旧実装（頂点ごとに小数点以下2桁の文字列を作り、文字列のハッシュ表で引く）。比較の基準として残す
+    uint32_t WeldReference(const std::vector<VertexData>& vertices, std::vector<uint32_t>& outIndices) {
+        std::unordered_map<std::string, uint32_t> vertexMap;
+        uint32_t weldedCount = 0;
+        outIndices.clear();
+        for (const VertexData& vertex : vertices) {
+            char buffer[256];
+            std::snprintf(buffer, sizeof(buffer), "%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f", vertex.position.x, vertex.position.y, vertex.position.z,
+                vertex.normal.x, vertex.normal.y, vertex.normal.z, vertex.texcoord.x, vertex.texcoord.y);
+            std::string key = buffer;
+            if (vertexMap.find(key) == vertexMap.end()) {
+                vertexMap[key] = weldedCount++;
+            }
+            outIndices.push_back(vertexMap[key]);
+        }
+        return weldedCount;
+    }
+
+    // 三角形ごとに頂点を展開した格子状のメッシュ（1辺1の正方形をgridSize×gridSizeに分ける）
+    std::vector<VertexData> MakeExpandedGrid(uint32_t gridSize) {
+        const uint32_t rowSize = gridSize + 1;
+        const float step = 1.0f / static_cast<float>(gridSize);
+        auto makeVertex = [&](uint32_t x, uint32_t z) {
+            float height = 0.05f * std::sin(static_cast<float>(x) * 0.3f) * std::cos(static_cast<float>(z) * 0.2f);
+            VertexData vertex;
+            vertex.position = { x * step, height, z * step, 1.0f };
+            vertex.texcoord = { x * step, 1.0f - z * step };
+            vertex.normal = { 0.05f * std::cos(x * 0.3f), 1.0f, -0.05f * std::sin(z * 0.2f) };
+            return vertex;
+        };
+        std::vector<VertexData> vertices;
+        vertices.reserve(static_cast<size_t>(gridSize) * gridSize * 6);
+        for (uint32_t z = 0; z + 1 < rowSize; ++z) {
+            for (uint32_t x = 0; x + 1 < rowSize; ++x) {
+                vertices.insert(vertices.end(), { makeVertex(x, z), makeVertex(x, z + 1), makeVertex(x + 1, z),
+                    makeVertex(x + 1, z), makeVertex(x, z + 1), makeVertex(x + 1, z + 1) });
+            }
+        }
+        return vertices;
+    }
+
+    // 頂点の溶接を旧実装と比較する
+    // 格子の間隔が0.01より細かいと旧実装は別の頂点をまとめてしまう（格子の頂点数より少なくなる）
+    // 完全一致の溶接は、対応表で引いた頂点が元の頂点とビット単位で一致するかも確認する
+    void BenchmarkWeld(bool csv) {
+        const uint32_t kRepeats = 3;
+        if (csv) {
+            std::printf("grid,input_vertices,expected_vertices,method,ms,ns_per_vertex,welded_vertices,allocations,exact\n");
+        }
+        for (uint32_t gridSize : { 64u, 512u }) {
+            std::vector<VertexData> vertices = MakeExpandedGrid(gridSize);
+            const size_t expectedCount = static_cast<size_t>(gridSize + 1) * (gridSize + 1);
+
+            std::vector<uint32_t> referenceIndices;
+            uint64_t allocations = BenchUtility::GetAllocationCount();
+            BenchUtility::Timer referenceTimer;
+            uint32_t referenceCount = WeldReference(vertices, referenceIndices);
+            double referenceMs = referenceTimer.ElapsedNs() / 1.0e6;
+            allocations = BenchUtility::GetAllocationCount() - allocations;
+
+            auto print = [&](const char* method, double ms, size_t weldedCount, uint64_t methodAllocations, const char* exact) {
+                double nsPerVertex = ms * 1.0e6 / static_cast<double>(vertices.size());
+                if (csv) {
+                    std::printf("%u,%zu,%zu,%s,%.3f,%.2f,%zu,%llu,%s\n", gridSize, vertices.size(), expectedCount, method, ms, nsPerVertex, weldedCount,
+                        static_cast<unsigned long long>(methodAllocations), exact);
+                } else {
+                    std::printf("weld %8zu -> %7zu (expected %7zu)  %-14s %9.3f ms  %6.2f ns/vertex (x%6.1f)  allocations %8llu  exact %s\n",
+                        vertices.size(), weldedCount, expectedCount, method, ms, nsPerVertex, referenceMs / ms,
+                        static_cast<unsigned long long>(methodAllocations), exact);
+                }
+            };
+            print("snprintf %.2f", referenceMs, referenceCount, allocations, "-");
+
+            // 2回目以降は作業用の配列を使い回す
+            VertexWelder welder;
+            std::vector<uint32_t> remap(vertices.size());
+            std::vector<VertexData> welded;
+            for (float epsilon : { 0.0f, 1.0e-4f }) {
+                VertexWeldSettings settings{ epsilon, epsilon, epsilon };
+                double ms = 1.0e30;
+                for (uint32_t i = 0; i < kRepeats; ++i) {
+                    allocations = BenchUtility::GetAllocationCount();
+                    BenchUtility::Timer timer;
+                    welder.Weld(vertices.data(), vertices.size(), settings, remap.data(), welded);
+                    ms = std::min(ms, timer.ElapsedNs() / 1.0e6);
+                    allocations = BenchUtility::GetAllocationCount() - allocations;
+                }
+                bool exact = true;
+                for (size_t i = 0; exact && i < vertices.size(); ++i) {
+                    exact = std::memcmp(&welded[remap[i]], &vertices[i], sizeof(VertexData)) == 0;
+                }
+                print(epsilon == 0.0f ? "exact" : "epsilon 1e-4", ms, welded.size(), allocations, exact ? "yes" : "NO");
+            }
+        }
+    }
+
+    // 緯度・経度で分割した球（インデックス付き）
+    void MakeIndexedSphere(uint32_t slices, uint32_t stacks, std::vector<VertexData>& outVertices, std::vector<uint32_t>& outIndices) {
+        const float pi = 3.14159265f;
+        outVertices.clear();
+        outIndices.clear();
+        for (uint32_t stack = 0; stack <= stacks; ++stack) {
+            float latitude = pi * static_cast<float>(stack) / static_cast<float>(stacks);
+            for (uint32_t slice = 0; slice <= slices; ++slice) {
+                float longitude = 2.0f * pi * static_cast<float>(slice) / static_cast<float>(slices);
+                Vector3 normal = { std::sin(latitude) * std::cos(longitude), std::cos(latitude), std::sin(latitude) * std::sin(longitude) };
+                VertexData vertex;
+                vertex.position = { normal.x, normal.y, normal.z, 1.0f };
+                vertex.normal = normal;
+                vertex.texcoord = { static_cast<float>(slice) / static_cast<float>(slices), static_cast<float>(stack) / static_cast<float>(stacks) };
+                outVertices.push_back(vertex);
+            }
+        }
+        const uint32_t rowSize = slices + 1;
+        for (uint32_t stack = 0; stack < stacks; ++stack) {
+            for (uint32_t slice = 0; slice < slices; ++slice) {
+                uint32_t v00 = stack * rowSize + slice;
+                uint32_t v01 = v00 + rowSize;
+                outIndices.insert(outIndices.end(), { v00, v00 + 1, v01, v00 + 1, v01 + 1, v01 });
+            }
+        }
+    }
+
+    // 三角形の集合（各三角形は巻き順を保って最小の頂点から始める）を並べたもの。並べ替えの前後で同じ三角形が残っているかの確認用
+    std::vector<std::array<VertexData, 3>> GetSortedTriangles(const std::vector<VertexData>& vertices, const std::vector<uint32_t>& indices) {
+        auto less = [](const VertexData& a, const VertexData& b) { return std::memcmp(&a, &b, sizeof(VertexData)) < 0; };
+        std::vector<std::array<VertexData, 3>> triangles(indices.size() / 3);
+        for (size_t t = 0; t < triangles.size(); ++t) {
+            std::array<VertexData, 3>& triangle = triangles[t];
+            for (uint32_t k = 0; k < 3; ++k) {
+                triangle[k] = vertices[indices[t * 3 + k]];
+            }
+            while (less(triangle[1], triangle[0]) || less(triangle[2], triangle[0])) {
+                std::rotate(triangle.begin(), triangle.begin() + 1, triangle.end());
+            }
+        }
+        std::sort(triangles.begin(), triangles.end(), [](const std::array<VertexData, 3>& a, const std::array<VertexData, 3>& b) {
+            return std::memcmp(a.data(), b.data(), sizeof(a)) < 0;
+        });
+        return triangles;
+    }
+
+    // インポート時のメッシュの最適化の前後の頂点キャッシュの効率を比較する
+    // 格子は三角形ごとに展開した頂点を順に描いていたもの、球はインデックス付きで三角形の順序が不規則なもの
+    // Tipsifyだけの場合と、オーバードローのためにクラスタを並べ替えた場合のACMRの差も出力する
+    void BenchmarkMeshOptimize(bool csv) {
+        if (csv) {
+            std::printf("mesh,triangles,input_vertices,output_vertices,before_acmr,before_atvr,tipsify_acmr,after_acmr,after_atvr,clusters,ms,same_triangles\n");
+        }
+        struct MeshCase {
+            const char* name;
+            std::vector<VertexData> vertices;
+            std::vector<uint32_t> indices;
+        };
+        std::vector<MeshCase> meshCases;
+        meshCases.push_back({ "grid256 expanded", MakeExpandedGrid(256), {} });
+        MeshCase sphere{ "sphere shuffled", {}, {} };
+        MakeIndexedSphere(256, 128, sphere.vertices, sphere.indices);
+        {
+            // 三角形の順序を不規則にする（三角形の中の順序は保つ）
+            std::vector<uint32_t> order(sphere.indices.size() / 3);
+            std::iota(order.begin(), order.end(), 0u);
+            std::shuffle(order.begin(), order.end(), std::mt19937(2468));
+            std::vector<uint32_t> shuffled;
+            shuffled.reserve(sphere.indices.size());
+            for (uint32_t t : order) {
+                shuffled.insert(shuffled.end(), sphere.indices.begin() + t * 3, sphere.indices.begin() + t * 3 + 3);
+            }
+            sphere.indices = std::move(shuffled);
+        }
+        meshCases.push_back(std::move(sphere));
+
+        for (const MeshCase& meshCase : meshCases) {
+            std::vector<uint32_t> referenceIndices = meshCase.indices;
+            if (referenceIndices.empty()) {
+                referenceIndices.resize(meshCase.vertices.size());
+                std::iota(referenceIndices.begin(), referenceIndices.end(), 0u);
+            }
+            std::vector<std::array<VertexData, 3>> referenceTriangles = GetSortedTriangles(meshCase.vertices, referenceIndices);
+
+            // Tipsifyだけ
+            MeshOptimizeSettings tipsifySettings;
+            tipsifySettings.overdrawThreshold = 0.0f;
+            std::vector<VertexData> tipsifyVertices = meshCase.vertices;
+            std::vector<uint32_t> tipsifyIndices = meshCase.indices;
+            MeshOptimizeStatistics tipsify = OptimizeMesh(tipsifyVertices, tipsifyIndices, tipsifySettings);
+
+            std::vector<VertexData> vertices = meshCase.vertices;
+            std::vector<uint32_t> indices = meshCase.indices;
+            BenchUtility::Timer timer;
+            MeshOptimizeStatistics statistics = OptimizeMesh(vertices, indices);
+            double ms = timer.ElapsedNs() / 1.0e6;
+            std::vector<std::array<VertexData, 3>> triangles = GetSortedTriangles(vertices, indices);
+            bool sameTriangles = triangles.size() == referenceTriangles.size() &&
+                std::memcmp(triangles.data(), referenceTriangles.data(), triangles.size() * sizeof(triangles[0])) == 0;
+
+            if (csv) {
+                std::printf("%s,%u,%u,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%u,%.3f,%d\n", meshCase.name, statistics.triangleCount, statistics.inputVertexCount,
+                    statistics.outputVertexCount, statistics.before.acmr, statistics.before.atvr, tipsify.after.acmr, statistics.after.acmr,
+                    statistics.after.atvr, statistics.clusterCount, ms, sameTriangles);
+            } else {
+                std::printf("mesh optimize %-17s %6u triangles  vertices %7u -> %6u  ACMR %.3f -> %.3f (tipsify only %.3f)  ATVR %.3f -> %.3f  "
+                    "vs invocations %7u -> %6u  clusters %5u  %7.3f ms  same triangles %s\n",
+                    meshCase.name, statistics.triangleCount, statistics.inputVertexCount, statistics.outputVertexCount, statistics.before.acmr,
+                    statistics.after.acmr, tipsify.after.acmr, statistics.before.atvr, statistics.after.atvr, statistics.before.transformedVertexCount,
+                    statistics.after.transformedVertexCount, statistics.clusterCount, ms, sameTriangles ? "yes" : "NO");
+            }
+        }
+    }
+
+    // AnimatedModel::ProcessAssimpMeshと同じくウェイトの組をキーにして溶接・最適化してボーンウェイトを付け替え、
+    // ウェイトの組が同じ頂点だけがまとまったか、並べ直した後の各頂点に元の頂点のジョイントと重みの組がそのまま（重ならずに）付いているか、
+    // どの三角形にも使われない頂点のウェイトが除かれているか、前のメッシュの分のウェイトが書き換わっていないかを確認する
+    bool CheckSkinWeightRemap(bool csv) {
+        const uint32_t kJointCount = 24;
+        const uint32_t kUnusedCount = 3;
+        std::vector<VertexData> sphereVertices;
+        std::vector<uint32_t> sphereIndices;
+        MakeIndexedSphere(16, 8, sphereVertices, sphereIndices);
+        {
+            // 三角形の順序を不規則にして、頂点の取得の順の並べ替えで番号が入れ替わるようにする
+            std::vector<uint32_t> order(sphereIndices.size() / 3);
+            std::iota(order.begin(), order.end(), 0u);
+            std::shuffle(order.begin(), order.end(), std::mt19937(1357));
+            std::vector<uint32_t> shuffled;
+            shuffled.reserve(sphereIndices.size());
+            for (uint32_t t : order) {
+                shuffled.insert(shuffled.end(), sphereIndices.begin() + t * 3, sphereIndices.begin() + t * 3 + 3);
+            }
+            sphereIndices = std::move(shuffled);
+        }
+
+        // 三角形のコーナーごとに頂点を分ける（JoinIdenticalVerticesなしで読んだメッシュ相当）
+        // 頂点ごとに1～4本のジョイントの重みを付ける。5つに1つの球の頂点はコーナーごとに別の重みにして、
+        // 位置・法線・UVが同じでもウェイトが違えばまとまらないことを確かめる
+        std::mt19937 random(97531);
+        std::uniform_real_distribution<float> weightDistribution(0.01f, 1.0f);
+        std::map<std::pair<uint32_t, uint32_t>, std::vector<std::pair<int32_t, float>>> weightSets;
+        auto getWeightSet = [&](uint32_t sphereVertex, uint32_t variant) -> const std::vector<std::pair<int32_t, float>>& {
+            auto [it, inserted] = weightSets.try_emplace({ sphereVertex, variant });
+            if (inserted) {
+                uint32_t influenceCount = 1 + sphereVertex % 4;
+                for (uint32_t i = 0; i < influenceCount; ++i) {
+                    it->second.emplace_back(static_cast<int32_t>((sphereVertex * 5 + i * 7) % kJointCount), weightDistribution(random));
+                }
+            }
+            return it->second;
+        };
+        std::vector<VertexData> vertices;
+        std::vector<uint32_t> indices;
+        std::vector<std::vector<std::pair<int32_t, float>>> expected;
+        for (uint32_t corner = 0; corner < sphereIndices.size(); ++corner) {
+            uint32_t sphereVertex = sphereIndices[corner];
+            vertices.push_back(sphereVertices[sphereVertex]);
+            indices.push_back(corner);
+            expected.push_back(getWeightSet(sphereVertex, sphereVertex % 5 == 0 ? corner + 1 : 0));
+        }
+        const size_t weldedCount = weightSets.size();
+        // どの三角形にも使われない頂点（ウェイトだけ付いている）
+        for (uint32_t i = 0; i < kUnusedCount; ++i) {
+            VertexData vertex{};
+            vertex.position = { 2.0f + static_cast<float>(i), 0.0f, 0.0f, 1.0f };
+            vertices.push_back(vertex);
+            expected.push_back(getWeightSet(static_cast<uint32_t>(sphereVertices.size()) + i, 0));
+        }
+        const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+
+        // ジョイントごとの(頂点番号, 重み)にする
+        std::vector<std::vector<VertexWeightData>> jointWeights(kJointCount);
+        for (uint32_t v = 0; v < vertexCount; ++v) {
+            for (const auto& [joint, weight] : expected[v]) {
+                jointWeights[joint].push_back({ weight, v });
+            }
+        }
+
+        std::vector<VertexData> optimizedVertices = vertices;
+        std::vector<uint64_t> weldKeys = BuildWeightSetKeys(jointWeights, vertexCount);
+        std::vector<uint32_t> vertexRemap;
+        OptimizeMesh(optimizedVertices, indices, MeshOptimizeSettings{}, &vertexRemap, weldKeys.data());
+        std::vector<uint32_t> weightRemap = vertexRemap;
+        DropWeldedDuplicates(weightRemap);
+
+        // 前のメッシュの分として、先頭に付け替えの対象外のウェイトを置いておく
+        const VertexWeightData kPreviousMeshWeight = { 0.25f, 0xFFFFu };
+        size_t weightCount = 0;
+        size_t remappedCount = 0;
+        bool previousKept = true;
+        for (std::vector<VertexWeightData>& weights : jointWeights) {
+            weightCount += weights.size();
+            weights.insert(weights.begin(), kPreviousMeshWeight);
+            RemapVertexWeights(weights, 1, weightRemap);
+            previousKept = previousKept && weights[0].weight == kPreviousMeshWeight.weight &&
+                weights[0].vectorIndex == kPreviousMeshWeight.vectorIndex;
+            remappedCount += weights.size() - 1;
+        }
+
+        // 対応表：使われる頂点は並べ直した後の頂点と同じデータを指し、使われない頂点はkUnusedVertexになっている
+        // まとまった頂点の数は、使われる頂点の(球の頂点, ウェイトの組)の数と同じ
+        uint32_t unusedCount = 0;
+        bool remapValid = vertexRemap.size() == vertexCount;
+        for (uint32_t v = 0; remapValid && v < vertexCount; ++v) {
+            if (vertexRemap[v] == kUnusedVertex) {
+                unusedCount++;
+                remapValid = v >= vertexCount - kUnusedCount;
+            } else {
+                remapValid = vertexRemap[v] < optimizedVertices.size() &&
+                    std::memcmp(&optimizedVertices[vertexRemap[v]], &vertices[v], sizeof(VertexData)) == 0;
+            }
+        }
+        remapValid = remapValid && unusedCount == kUnusedCount && optimizedVertices.size() == weldedCount;
+
+        // 並べ直した後の頂点ごとに集めたジョイントと重みの組が、元の頂点のものと一致するか（まとまった頂点の分が重なっていないか）
+        bool weightsKept = remapValid;
+        if (weightsKept) {
+            std::vector<std::vector<std::pair<int32_t, float>>> remapped(optimizedVertices.size());
+            for (int32_t joint = 0; weightsKept && joint < static_cast<int32_t>(kJointCount); ++joint) {
+                for (size_t i = 1; weightsKept && i < jointWeights[joint].size(); ++i) {
+                    const VertexWeightData& weight = jointWeights[joint][i];
+                    weightsKept = weight.vectorIndex < remapped.size();
+                    if (weightsKept) {
+                        remapped[weight.vectorIndex].emplace_back(joint, weight.weight);
+                    }
+                }
+            }
+            for (uint32_t v = 0; weightsKept && v < vertexCount; ++v) {
+                if (vertexRemap[v] == kUnusedVertex) {
+                    continue;
+                }
+                std::vector<std::pair<int32_t, float>> original = expected[v];
+                std::vector<std::pair<int32_t, float>>& result = remapped[vertexRemap[v]];
+                std::sort(original.begin(), original.end());
+                std::sort(result.begin(), result.end());
+                weightsKept = original == result;
+            }
+        }
+        size_t usedWeightCount = 0;
+        for (const auto& [key, weightSet] : weightSets) {
+            if (key.first < sphereVertices.size()) {
+                usedWeightCount += weightSet.size();
+            }
+        }
+        bool unusedDropped = remappedCount == usedWeightCount;
+        bool passed = remapValid && weightsKept && unusedDropped && previousKept;
+
+        if (csv) {
+            std::printf("vertices,welded_vertices,unused_vertices,weights,remapped_weights,remap_valid,weights_kept,unused_dropped,previous_kept\n");
+            std::printf("%u,%zu,%u,%zu,%zu,%d,%d,%d,%d\n", vertexCount, optimizedVertices.size(), kUnusedCount, weightCount, remappedCount,
+                remapValid, weightsKept, unusedDropped, previousKept);
+        } else {
+            std::printf("skin weight remap %u vertices (%u unused) -> %zu welded  weights %zu -> %zu  remap valid %s  joint/weight sets kept %s  "
+                "unused dropped %s  previous mesh kept %s\n",
+                vertexCount, kUnusedCount, optimizedVertices.size(), weightCount, remappedCount, remapValid ? "yes" : "NO",
+                weightsKept ? "yes" : "NO", unusedDropped ? "yes" : "NO", previousKept ? "yes" : "NO");
+        }
+        return passed;
+    }
+
+    // サンプリングの計測の繰り返し回数と、繰り返す上限の時間
+    const uint32_t kMaxRepeats = 7;
+    const double kRepeatBudgetNs = 1.0e9;
+
+    void Benchmark(const std::string& name, const Animation& animation, const Skeleton& skeleton, uint32_t frames, uint32_t instances, bool csv) {
+        Result reference;
+        for (Method method : { Method::Linear, Method::Binary, Method::Cursor, Method::Compiled, Method::Compressed }) {
+            // 短いクリップは1回の計測が短く揺れが大きいので、時間の許す範囲で繰り返して最短の回を使う
+            Result result = Run(animation, skeleton, method, frames, instances);
+            for (uint32_t repeat = 1; repeat < kMaxRepeats && result.totalNs * repeat < kRepeatBudgetNs; ++repeat) {
+                Result again = Run(animation, skeleton, method, frames, instances);
+                if (again.totalNs < result.totalNs) {
+                    result = std::move(again);
+                }
+            }
+
+            // 旧実装との最大誤差（境界での端数処理の差のみのはず）
+            float maxError = 0.0f;
+            if (method == Method::Linear) {
+                reference = result;
+            } else {
+                for (size_t i = 0; i < result.values.size(); i += 10) {
+                    maxError = std::max(maxError, CalculateTrackError(&result.values[i], &reference.values[i]));
+                }
+            }
+
+            double nsPerSample = result.samples ? result.totalNs / static_cast<double>(result.samples) : 0.0;
+            double speedup = result.totalNs > 0.0 ? reference.totalNs / result.totalNs : 0.0;
+            double memoryRatio = result.bytes ? static_cast<double>(reference.bytes) / static_cast<double>(result.bytes) : 0.0;
+            if (csv) {
+                std::printf("%s,%s,%zu,%zu,%.3f,%.2f,%zu,%.2f,%g\n", name.c_str(), kMethodNames[static_cast<int>(method)],
+                    animation.nodeAnimations.size(), GetMaxKeyCount(animation), nsPerSample, speedup,
+                    result.bytes, memoryRatio, maxError);
+            } else {
+                std::printf("%-15s %-10s tracks:%4zu keys:%6zu  %9.3f ns/sample  x%7.2f  %9.1f KB (x%5.2f)  max error %g\n",
+                    name.c_str(), kMethodNames[static_cast<int>(method)],
+                    animation.nodeAnimations.size(), GetMaxKeyCount(animation), nsPerSample, speedup,
+                    static_cast<double>(result.bytes) / 1024.0, memoryRatio, maxError);
+            }
+        }
+    }
+
+    // 1フレーム分のジョイントのループ全体（Object3d::ApplyAnimationと同じ処理）を比べる
+    // 旧経路はジョイントごとに名前でトラックを検索してカーソル付きでサンプリングし、スケルトンに書き込む
+    // コンパイル済みクリップはSampleでポーズを作り、ApplyPoseToSkeletonでスケルトンに書き込む
+    void BenchmarkJointLoop(const std::string& name, const Animation& animation, const Skeleton& skeleton, uint32_t frames, uint32_t instances, bool csv) {
+        CompiledAnimationClip clip;
+        clip.Compile(animation, skeleton);
+        AnimationPose pose;
+
+        const size_t cursorCount = clip.GetCursorCount();
+        std::vector<Skeleton> lookupSkeletons(instances, skeleton);
+        std::vector<Skeleton> compiledSkeletons(instances, skeleton);
+        std::vector<KeyframeCursor> lookupCursors(cursorCount * instances);
+        std::vector<KeyframeCursor> compiledCursors(cursorCount * instances);
+
+        double bestLookupNs = 0.0;
+        double bestCompiledNs = 0.0;
+        float maxDifference = 0.0f;
+        for (uint32_t repeat = 0; repeat < kMaxRepeats; ++repeat) {
+            double lookupNs = 0.0;
+            double compiledNs = 0.0;
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                for (uint32_t instance = 0; instance < instances; ++instance) {
+                    float start = animation.duration * static_cast<float>(instance) / static_cast<float>(instances);
+                    float time = std::fmod(start + frame * kDeltaTime, animation.duration);
+
+                    Skeleton& lookupSkeleton = lookupSkeletons[instance];
+                    KeyframeCursor* lookupCursor = &lookupCursors[instance * cursorCount];
+                    BenchUtility::Timer lookupTimer;
+                    for (Joint& joint : lookupSkeleton.joints) {
+                        if (auto it = animation.nodeAnimations.find(joint.name); it != animation.nodeAnimations.end()) {
+                            const NodeAnimation& nodeAnimation = it->second;
+                            KeyframeCursor* cursor = &lookupCursor[joint.index * CompiledAnimationClip::kChannelCount];
+                            joint.transform.translate = CalculateValue(nodeAnimation.translate, time, cursor[CompiledAnimationClip::kTranslate]);
+                            joint.transform.rotate = CalculateValue(nodeAnimation.rotate, time, cursor[CompiledAnimationClip::kRotate]);
+                            joint.transform.scale = CalculateValue(nodeAnimation.scale, time, cursor[CompiledAnimationClip::kScale]);
+                        }
+                    }
+                    lookupNs += lookupTimer.ElapsedNs();
+
+                    Skeleton& compiledSkeleton = compiledSkeletons[instance];
+                    BenchUtility::Timer compiledTimer;
+                    clip.Sample(time, pose, &compiledCursors[instance * cursorCount]);
+                    ApplyPoseToSkeleton(pose, compiledSkeleton);
+                    compiledNs += compiledTimer.ElapsedNs();
+
+                    if (repeat == 0) {
+                        for (size_t i = 0; i < skeleton.joints.size(); ++i) {
+                            const auto& a = lookupSkeleton.joints[i].transform;
+                            const auto& b = compiledSkeleton.joints[i].transform;
+                            float values[2][10] = {
+                                { a.translate.x, a.translate.y, a.translate.z, a.rotate.x, a.rotate.y, a.rotate.z, a.rotate.w, a.scale.x, a.scale.y, a.scale.z },
+                                { b.translate.x, b.translate.y, b.translate.z, b.rotate.x, b.rotate.y, b.rotate.z, b.rotate.w, b.scale.x, b.scale.y, b.scale.z },
+                            };
+                            maxDifference = std::max(maxDifference, CalculateTrackError(values[0], values[1]));
+                        }
+                    }
+                }
+            }
+            if (repeat == 0 || lookupNs < bestLookupNs) {
+                bestLookupNs = lookupNs;
+            }
+            if (repeat == 0 || compiledNs < bestCompiledNs) {
+                bestCompiledNs = compiledNs;
+            }
+            // 長いクリップは1回で十分
+            if ((lookupNs + compiledNs) * (repeat + 1) >= kRepeatBudgetNs) {
+                break;
+            }
+        }
+
+        const double evaluations = static_cast<double>(frames) * instances;
+        double lookupNsPerFrame = bestLookupNs / evaluations;
+        double compiledNsPerFrame = bestCompiledNs / evaluations;
+        double speedup = compiledNsPerFrame > 0.0 ? lookupNsPerFrame / compiledNsPerFrame : 0.0;
+        if (csv) {
+            std::printf("clip,joints,lookup_cursor_ns,compiled_ns,speedup,max_difference\n");
+            std::printf("%s,%zu,%.1f,%.1f,%.2f,%g\n", name.c_str(), skeleton.joints.size(), lookupNsPerFrame, compiledNsPerFrame, speedup, maxDifference);
+        } else {
+            std::printf("%-15s joint loop joints:%4zu  name lookup+cursor %8.1f ns/frame  compiled %8.1f ns/frame  x%5.2f  max difference %g\n",
+                name.c_str(), skeleton.joints.size(), lookupNsPerFrame, compiledNsPerFrame, speedup, maxDifference);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string clipName = BenchUtility::GetOption(argc, argv, "--clip", "all");
+    uint32_t frames = static_cast<uint32_t>(std::strtoul(BenchUtility::GetOption(argc, argv, "--frames", "600").c_str(), nullptr, 10));
+    uint32_t instances = static_cast<uint32_t>(std::strtoul(BenchUtility::GetOption(argc, argv, "--instances", "8").c_str(), nullptr, 10));
+    uint32_t characterCount = static_cast<uint32_t>(std::strtoul(BenchUtility::GetOption(argc, argv, "--characters", "500").c_str(), nullptr, 10));
+    uint32_t threadCount = static_cast<uint32_t>(std::strtoul(BenchUtility::GetOption(argc, argv, "--threads", "0").c_str(), nullptr, 10));
+    std::string modelDirectory = BenchUtility::GetOption(argc, argv, "--models", LE4_MODEL_DIR);
+    bool csv = BenchUtility::HasFlag(argc, argv, "--csv");
+
+    if (csv) {
+        std::printf("clip,method,tracks,max_keys,ns_per_sample,speedup,bytes,memory_ratio,max_error\n");
+    }
+
+    for (const char* gltfName : { "walk", "sneakWalk" }) {
+        if (clipName != "all" && clipName != gltfName) {
+            continue;
+        }
+        std::string filePath = modelDirectory + "/human/" + gltfName + ".gltf";
+        Animation animation;
+        Skeleton skeleton;
+        if (!BenchAnimation::LoadGltfAnimation(filePath, animation) || !BenchAnimation::LoadGltfSkeleton(filePath, skeleton)) {
+            return 1;
+        }
+        Benchmark(gltfName, animation, skeleton, frames, instances, csv);
+        BenchmarkJointLoop(gltfName, animation, skeleton, frames, instances, csv);
+    }
+
+    if (clipName == "all" || clipName == "synthetic10min") {
+        // モーションキャプチャ相当（65ジョイント・30fps・10分）
+        Animation animation = BenchAnimation::MakeSyntheticAnimation(65, 30.0f, 600.0f, 12345);
+        Skeleton skeleton = BenchAnimation::MakeSyntheticSkeleton(65);
+        Benchmark("synthetic10min", animation, skeleton, frames, instances, csv);
+        BenchmarkJointLoop("synthetic10min", animation, skeleton, frames, instances, csv);
+    }
+
+    // walkとsneakWalkを交互に割り当てて合成する
+    if (clipName == "all" || clipName == "blend" || clipName == "skinning" || clipName == "lod" || clipName == "posecache" || clipName == "baked" ||
+        clipName == "dq" || clipName == "cpuskin" || clipName == "skinimport" || clipName == "rootmotion" || clipName == "events" ||
+        clipName == "ik" || clipName == "incremental" ||
+        clipName == "retarget" || clipName == "modelcache") {
+        std::string walkPath = modelDirectory + "/human/walk.gltf";
+        Skeleton skeleton;
+        Animation walk;
+        Animation sneakWalk;
+        if (!BenchAnimation::LoadGltfSkeleton(walkPath, skeleton) || !BenchAnimation::LoadGltfAnimation(walkPath, walk) ||
+            !BenchAnimation::LoadGltfAnimation(modelDirectory + "/human/sneakWalk.gltf", sneakWalk)) {
+            return 1;
+        }
+        CompiledAnimationClip walkClip;
+        CompiledAnimationClip sneakWalkClip;
+        walkClip.Compile(walk, skeleton);
+        sneakWalkClip.Compile(sneakWalk, skeleton);
+        std::vector<const CompiledAnimationClip*> clips = { &walkClip, &sneakWalkClip };
+
+        if (clipName == "all" || clipName == "blend") {
+            if (csv) {
+                std::printf("clip,method,joints,active_clips,ns_per_frame,ns_per_joint_clip,allocations\n");
+            }
+            for (uint32_t clipCount : { 1u, 2u, 4u }) {
+                BenchmarkBlend("walk+sneakWalk", clips, skeleton, clipCount, false, frames, csv);
+            }
+            BenchmarkBlend("walk+sneakWalk", clips, skeleton, 2, true, frames, csv);
+        }
+        if (clipName == "all" || clipName == "skinning") {
+            // 0ならハードウェアスレッド数
+            BenchmarkSkinning(clips, skeleton, characterCount, threadCount, std::min(frames, 120u), csv);
+        }
+        if (clipName == "all" || clipName == "lod") {
+            BenchmarkLod(clips, skeleton, characterCount, std::min(frames, 120u), csv);
+        }
+        if (clipName == "all" || clipName == "posecache") {
+            BenchmarkPoseCache(walkClip, skeleton, characterCount, 8, std::min(frames, 120u), csv);
+        }
+        if (clipName == "all" || clipName == "baked") {
+            BenchmarkBaked(walkClip, skeleton, characterCount, csv);
+        }
+        if (clipName == "all" || clipName == "dq") {
+            BenchmarkDualQuaternion(walkClip, skeleton, characterCount, csv);
+        }
+        if (clipName == "all" || clipName == "cpuskin") {
+            BenchmarkCpuSkinning(walkClip, skeleton, 30000, csv);
+        }
+        if (clipName == "all" || clipName == "skinimport") {
+            BenchmarkSkinWeightImport(skeleton, csv);
+        }
+        if (clipName == "all" || clipName == "rootmotion") {
+            BenchmarkRootMotion(walk, skeleton, characterCount, std::min(frames, 120u), csv);
+        }
+        if (clipName == "all" || clipName == "events") {
+            BenchmarkEvents(walk, characterCount, std::min(frames, 120u), csv);
+        }
+        if (clipName == "all" || clipName == "ik") {
+            BenchmarkIk(walkClip, skeleton, csv);
+        }
+        if (clipName == "all" || clipName == "incremental") {
+            BenchmarkIncrementalUpdate(walk, skeleton, std::min(frames, 120u), csv);
+        }
+        if (clipName == "all" || clipName == "retarget") {
+            BenchmarkRetarget({ { "walk", &walk }, { "sneakWalk", &sneakWalk } }, skeleton, std::min(frames, 120u), csv);
+        }
+        if (clipName == "all" || clipName == "modelcache") {
+            BenchmarkModelCache(walkPath, walk, skeleton, csv);
+        }
+    }
+
+    if (clipName == "all" || clipName == "objparse") {
+        BenchmarkObjParse(csv);
+    }
+    if (clipName == "all" || clipName == "weld") {
+        BenchmarkWeld(csv);
+    }
+    if (clipName == "all" || clipName == "meshopt") {
+        BenchmarkMeshOptimize(csv);
+        if (!CheckSkinWeightRemap(csv)) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "BenchAnimation.h"
+#include "tiny_gltf.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <optional>
+
+namespace {
+    // アクセサのfloat要素を読み出す（componentCount個ずつ）
+    bool ReadFloats(const tinygltf::Model& model, int accessorIndex, uint32_t componentCount, std::vector<float>& out) {
+        if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size())) {
+            return false;
+        }
+        const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+        if (accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT || accessor.bufferView < 0) {
+            return false;
+        }
+        const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+        const tinygltf::Buffer& buffer = model.buffers[view.buffer];
+        size_t stride = accessor.ByteStride(view);
+        const unsigned char* base = buffer.data.data() + view.byteOffset + accessor.byteOffset;
+
+        out.resize(accessor.count * componentCount);
+        for (size_t i = 0; i < accessor.count; ++i) {
+            std::memcpy(&out[i * componentCount], base + i * stride, sizeof(float) * componentCount);
+        }
+        return true;
+    }
+
+    // ノードからジョイントを再帰的に作成
+    int32_t CreateJoint(const tinygltf::Model& model, int nodeIndex, std::optional<int32_t> parent, std::vector<Joint>& joints) {
+        const tinygltf::Node& node = model.nodes[nodeIndex];
+        Joint joint;
+        joint.name = node.name;
+        joint.transform.scale = { 1.0f, 1.0f, 1.0f };
+        joint.transform.rotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+        joint.transform.translate = { 0.0f, 0.0f, 0.0f };
+        if (node.scale.size() == 3) {
+            joint.transform.scale = { float(node.scale[0]), float(node.scale[1]), float(node.scale[2]) };
+        }
+        if (node.rotation.size() == 4) {
+            joint.transform.rotate = { float(node.rotation[0]), -float(node.rotation[1]), -float(node.rotation[2]), float(node.rotation[3]) };
+        }
+        if (node.translation.size() == 3) {
+            joint.transform.translate = { -float(node.translation[0]), float(node.translation[1]), float(node.translation[2]) };
+        }
+        joint.localMatrix = MakeAffineMatrix(joint.transform.scale, joint.transform.rotate, joint.transform.translate);
+        joint.skeletonSpaceMatrix = MakeIdentity4x4();
+        joint.index = static_cast<int32_t>(joints.size());
+        joint.parent = parent;
+        joints.push_back(joint);
+
+        for (int child : node.children) {
+            int32_t childIndex = CreateJoint(model, child, joint.index, joints);
+            joints[joint.index].children.push_back(childIndex);
+        }
+        return joint.index;
+    }
+}
+
+namespace BenchAnimation {
+    bool LoadGltfSkeleton(const std::string& filePath, Skeleton& outSkeleton) {
+        tinygltf::TinyGLTF loader;
+        tinygltf::Model model;
+        std::string error;
+        std::string warning;
+        if (!loader.LoadASCIIFromFile(&model, &error, &warning, filePath) || model.scenes.empty()) {
+            std::fprintf(stderr, "failed to load %s: %s\n", filePath.c_str(), error.c_str());
+            return false;
+        }
+
+        const tinygltf::Scene& scene = model.scenes[model.defaultScene >= 0 ? model.defaultScene : 0];
+        outSkeleton = Skeleton{};
+        for (int root : scene.nodes) {
+            CreateJoint(model, root, std::nullopt, outSkeleton.joints);
+        }
+        outSkeleton.root = 0;
+        for (const Joint& joint : outSkeleton.joints) {
+            outSkeleton.jointMap.emplace(joint.name, joint.index);
+        }
+        return !outSkeleton.joints.empty();
+    }
+
+    Skeleton MakeSyntheticSkeleton(uint32_t jointCount) {
+        Skeleton skeleton;
+        skeleton.root = 0;
+        for (uint32_t i = 0; i < jointCount; ++i) {
+            Joint joint;
+            joint.name = "joint" + std::to_string(i);
+            joint.transform.scale = { 1.0f, 1.0f, 1.0f };
+            joint.transform.rotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+            joint.transform.translate = { 0.0f, 1.0f, 0.0f };
+            joint.localMatrix = MakeIdentity4x4();
+            joint.skeletonSpaceMatrix = MakeIdentity4x4();
+            joint.index = static_cast<int32_t>(i);
+            if (i > 0) {
+                joint.parent = static_cast<int32_t>(i - 1);
+                skeleton.joints[i - 1].children.push_back(joint.index);
+            }
+            skeleton.joints.push_back(joint);
+            skeleton.jointMap.emplace(joint.name, joint.index);
+        }
+        return skeleton;
+    }
+
+    bool LoadGltfAnimation(const std::string& filePath, Animation& outAnimation) {
+        tinygltf::TinyGLTF loader;
+        tinygltf::Model model;
+        std::string error;
+        std::string warning;
+        if (!loader.LoadASCIIFromFile(&model, &error, &warning, filePath) || model.animations.empty()) {
+            std::fprintf(stderr, "failed to load %s: %s\n", filePath.c_str(), error.c_str());
+            return false;
+        }
+
+        const tinygltf::Animation& source = model.animations[0];
+        outAnimation.duration = 0.0f;
+        outAnimation.nodeAnimations.clear();
+
+        std::vector<float> times;
+        std::vector<float> values;
+        for (const tinygltf::AnimationChannel& channel : source.channels) {
+            const tinygltf::AnimationSampler& sampler = source.samplers[channel.sampler];
+            const std::string& nodeName = model.nodes[channel.target_node].name;
+            NodeAnimation& nodeAnimation = outAnimation.nodeAnimations[nodeName];
+
+            uint32_t componentCount = (channel.target_path == "rotation") ? 4 : 3;
+            if (!ReadFloats(model, sampler.input, 1, times) || !ReadFloats(model, sampler.output, componentCount, values)) {
+                return false;
+            }
+
+            for (size_t i = 0; i < times.size(); ++i) {
+                const float* v = &values[i * componentCount];
+                if (channel.target_path == "translation") {
+                    nodeAnimation.translate.push_back({ { -v[0], v[1], v[2] }, times[i] });
+                } else if (channel.target_path == "rotation") {
+                    nodeAnimation.rotate.push_back({ { v[0], -v[1], -v[2], v[3] }, times[i] });
+                } else if (channel.target_path == "scale") {
+                    nodeAnimation.scale.push_back({ { v[0], v[1], v[2] }, times[i] });
+                }
+                outAnimation.duration = std::max(outAnimation.duration, times[i]);
+            }
+        }
+        return true;
+    }
+
+    Animation MakeSyntheticAnimation(uint32_t jointCount, float fps, float durationSeconds, uint32_t seed) {
+        Animation animation;
+        animation.duration = durationSeconds;
+
+        uint32_t state = seed ? seed : 1;
+        auto random = [&state]() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return static_cast<float>(state) / 4294967296.0f;
+        };
+
+        uint32_t keyCount = static_cast<uint32_t>(durationSeconds * fps) + 1;
+        for (uint32_t joint = 0; joint < jointCount; ++joint) {
+            NodeAnimation& nodeAnimation = animation.nodeAnimations["joint" + std::to_string(joint)];
+            nodeAnimation.translate.reserve(keyCount);
+            nodeAnimation.rotate.reserve(keyCount);
+            nodeAnimation.scale.reserve(keyCount);
+
+            // ジョイントごとに周波数を変えた滑らかな動き
+            float frequency = 0.5f + random() * 2.0f;
+            float phase = random() * 6.2831853f;
+            for (uint32_t key = 0; key < keyCount; ++key) {
+                float time = static_cast<float>(key) / fps;
+                float angle = std::sin(time * frequency + phase) * 0.7f;
+                nodeAnimation.translate.push_back({ { std::sin(time + phase) * 0.1f, 1.0f, 0.0f }, time });
+                nodeAnimation.rotate.push_back({ { std::sin(angle * 0.5f), 0.0f, 0.0f, std::cos(angle * 0.5f) }, time });
+                nodeAnimation.scale.push_back({ { 1.0f, 1.0f, 1.0f }, time });
+            }
+        }
+        return animation;
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "AnimationData.h"
+#include <cstdint>
+#include <string>
+
+// アニメーション系ベンチマーク用のクリップ読み込み・生成
+namespace BenchAnimation {
+    // glTFの最初のアニメーションを読み込む（assimp経由と同じく右手系から左手系へ変換する）
+    bool LoadGltfAnimation(const std::string& filePath, Animation& outAnimation);
+
+    // glTFのノード階層からスケルトンを作成（AnimatedModel::CreateJointと同じ深さ優先の順番）
+    bool LoadGltfSkeleton(const std::string& filePath, Skeleton& outSkeleton);
+
+    // "joint0"～の名前を持つ一直線のスケルトンを作成（MakeSyntheticAnimationと対応）
+    Skeleton MakeSyntheticSkeleton(uint32_t jointCount);
+
+    // 長尺のクリップを生成（jointCount本のトラック、fpsごとにキー、durationSeconds秒）
+    Animation MakeSyntheticAnimation(uint32_t jointCount, float fps, float durationSeconds, uint32_t seed);
+}
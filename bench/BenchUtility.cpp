@@ -0,0 +1,97 @@
+#include "BenchUtility.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    // ヒープ確保回数
+    std::atomic<uint64_t> allocationCount{ 0 };
+}
+
+// 確保回数を数えるためにグローバルなoperator newを置き換える
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace BenchUtility {
+
+uint64_t GetAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+size_t GetResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    // /proc/self/statmの2番目の値が常駐ページ数
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    unsigned long totalPages = 0;
+    unsigned long residentPages = 0;
+    int read = std::fscanf(file, "%lu %lu", &totalPages, &residentPages);
+    std::fclose(file);
+    if (read != 2) {
+        return 0;
+    }
+    return static_cast<size_t>(residentPages) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+std::string GetOption(int argc, char** argv, const std::string& name, const std::string& defaultValue) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (name == argv[i]) {
+            return argv[i + 1];
+        }
+    }
+    return defaultValue;
+}
+
+bool HasFlag(int argc, char** argv, const std::string& name) {
+    for (int i = 1; i < argc; ++i) {
+        if (name == argv[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
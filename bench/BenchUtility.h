@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ベンチマーク共通の計測ユーティリティ
+namespace BenchUtility {
+    // 現在までのヒープ確保回数（operator newの呼び出し回数）
+    uint64_t GetAllocationCount();
+
+    // 現在の常駐メモリサイズ（バイト、取得できない場合は0）
+    size_t GetResidentBytes();
+
+    // 経過時間計測用
+    class Timer {
+    public:
+        Timer() : start_(std::chrono::steady_clock::now()) {}
+
+        // 開始からの経過時間（ナノ秒）
+        double ElapsedNs() const {
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start_).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // "--name value" 形式の引数を取得（見つからなければdefaultValue）
+    std::string GetOption(int argc, char** argv, const std::string& name, const std::string& defaultValue);
+
+    // "--name" 形式のフラグが指定されているか
+    bool HasFlag(int argc, char** argv, const std::string& name);
+}
@@ -0,0 +1,353 @@
+// ParticleBench - パーティクルシミュレーションのヘッドレスベンチマーク
+// 固定シードで決まったシナリオを実行し、ns/particle・フレームあたりの確保回数・常駐メモリを出力する
+//
+// 使い方: ParticleBench [--scenario all|burst100k|steady|hitstorm|forcefield|ribbon] [--frames N] [--seed N] [--csv]
+#include "HitEffectSettings.h"
+#include "Particle3DEmission.h"
+#include "ParticleSimulation.h"
+#include "ParticleRibbon.h"
+#include "BenchUtility.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // 1フレームの時間（ParticleManagerと同じ60FPS想定）
+    const float kDeltaTime = 1.0f / 60.0f;
+
+    // シナリオの計測結果
+    struct ScenarioResult {
+        std::string name;
+        uint32_t frames = 0;
+        uint64_t particleUpdates = 0;    // 全フレームの更新パーティクル数の合計
+        uint32_t peakParticles = 0;      // 最大生存数
+        double totalNs = 0.0;            // 発生と更新にかかった時間
+        uint64_t allocations = 0;        // 計測中のヒープ確保回数
+        size_t residentBytes = 0;        // 計測後の常駐メモリ
+        uint64_t checksum = 0;           // 決定性の確認用（同じシードなら同じ値）
+    };
+
+    // シナリオ（初期化と毎フレームの発生処理）
+    struct Scenario {
+        std::string name;
+        uint32_t capacity = 0;
+        std::function<void(ParticleSimulation&, uint32_t frame, uint32_t& random)> emit = nullptr;
+        // 力場の設定（省略可）
+        std::function<void(ParticleSimulation&)> setup = nullptr;
+        // 更新後の描画データ生成（省略可、計測に含める）
+        std::function<void(const ParticleSimulation&)> build = nullptr;
+        // ParticleSimulationを使わないシナリオの実行（指定した場合は上の3つを使わない）
+        std::function<ScenarioResult(uint32_t frames, uint32_t seed)> run = nullptr;
+    };
+
+    // シナリオ内で使う決定的な乱数
+    uint32_t NextRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // 座標の合計からチェックサムを作成
+    uint64_t MakeChecksum(const ParticleSimulation& simulation) {
+        double sum = 0.0;
+        for (uint32_t i = 0; i < simulation.GetCount(); ++i) {
+            sum += simulation.GetPositionX()[i] + simulation.GetPositionY()[i] * 3.0 + simulation.GetPositionZ()[i] * 7.0;
+        }
+        return static_cast<uint64_t>(static_cast<int64_t>(sum * 1000.0)) ^ (static_cast<uint64_t>(simulation.GetCount()) << 40);
+    }
+
+    uint64_t MakeChecksum(const std::list<Particle3DState>& particles) {
+        double sum = 0.0;
+        for (const Particle3DState& particle : particles) {
+            sum += particle.position.x + particle.position.y * 3.0 + particle.position.z * 7.0;
+        }
+        return static_cast<uint64_t>(static_cast<int64_t>(sum * 1000.0)) ^ (static_cast<uint64_t>(particles.size()) << 40);
+    }
+
+    // 毎フレームのチェックサムを合成する（全て消えた後の最終フレームだけでは回帰を検出できないため）
+    void AccumulateChecksum(uint64_t& checksum, uint64_t frameChecksum) {
+        checksum = (checksum ^ frameChecksum) * 0x100000001B3ull;
+    }
+
+    // HitEffect3Dの嵐：毎フレーム40か所でランダムなタイプのヒットエフェクトを発生させる
+    // HitEffect3Dと同じく、タイプごとのエミッターに位置を設定して発生を開始し、Particle3DEmitTimerで発生のタイミングを決める
+    ScenarioResult RunHitStormScenario(uint32_t frames, uint32_t seed) {
+        ScenarioResult result;
+        result.name = "hitstorm";
+        result.frames = frames;
+
+        // タイプごとの発生パラメータ（Particle3DManager::Emit3Dと同じく最小・最大を正したもの）
+        std::vector<HitEffectSettings> settingsList = BuildHitEffectSettings();
+        std::vector<Particle3DEmitParams> paramsList;
+        for (const HitEffectSettings& settings : settingsList) {
+            paramsList.push_back(MakeHitEffectEmitParams(settings));
+            ValidateParticle3DEmitParams(paramsList.back());
+        }
+
+        // 発生中でないエミッターを使い回す（EffectManager3Dのプールに相当）
+        struct HitEmitter {
+            uint32_t type = 0;
+            Vector3 position = { 0.0f, 0.0f, 0.0f };
+            Particle3DEmitTimer timer;
+        };
+        std::vector<HitEmitter> emitters;
+        std::list<Particle3DState> particles;
+        std::mt19937 randomEngine(seed);
+        uint32_t random = seed ? seed : 1;
+
+        uint64_t allocationStart = BenchUtility::GetAllocationCount();
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            BenchUtility::Timer timer;
+
+            // HitEffect3D::TriggerHitEffect
+            for (uint32_t hit = 0; hit < 40; ++hit) {
+                uint32_t type = NextRandom(random) % kHitEffectTypeCount;
+                Vector3 position = {
+                    static_cast<float>(NextRandom(random) % 2000) * 0.01f - 10.0f,
+                    static_cast<float>(NextRandom(random) % 400) * 0.01f,
+                    static_cast<float>(NextRandom(random) % 2000) * 0.01f - 10.0f };
+                auto it = std::find_if(emitters.begin(), emitters.end(),
+                    [type](const HitEmitter& emitter) { return emitter.type == type && !emitter.timer.IsEmitting(); });
+                if (it == emitters.end()) {
+                    HitEmitter emitter;
+                    emitter.type = type;
+                    it = emitters.insert(emitters.end(), emitter);
+                }
+                it->position = position;
+                it->timer.SetEmitting(true);
+            }
+
+            // Particle3DEmitter::Update → Particle3DManager::Emit3D
+            for (HitEmitter& emitter : emitters) {
+                if (emitter.timer.Advance(settingsList[emitter.type].emitRate)) {
+                    for (uint32_t i = 0; i < settingsList[emitter.type].particleCount; ++i) {
+                        EmitParticle3D(particles.emplace_back(), emitter.position, paramsList[emitter.type], randomEngine);
+                    }
+                }
+            }
+
+            // Particle3DManager::Update
+            for (auto it = particles.begin(); it != particles.end();) {
+                it = UpdateParticle3D(*it) ? std::next(it) : particles.erase(it);
+            }
+            result.totalNs += timer.ElapsedNs();
+
+            uint32_t count = static_cast<uint32_t>(particles.size());
+            result.particleUpdates += count;
+            result.peakParticles = (std::max)(result.peakParticles, count);
+            AccumulateChecksum(result.checksum, MakeChecksum(particles));
+        }
+        result.allocations = BenchUtility::GetAllocationCount() - allocationStart;
+        result.residentBytes = BenchUtility::GetResidentBytes();
+        return result;
+    }
+
+    // 100,000個を一度に発生させて寿命が尽きるまで更新
+    Scenario MakeBurstScenario() {
+        return Scenario{ .name = "burst100k", .capacity = 100000,
+            .emit = [](ParticleSimulation& simulation, uint32_t frame, uint32_t&) {
+                if (frame != 0) {
+                    return;
+                }
+                ParticleEmitParams params;
+                params.velocityMin = { -5.0f, 0.0f, -5.0f };
+                params.velocityMax = { 5.0f, 10.0f, 5.0f };
+                params.lifeTimeMin = 1.0f;
+                params.lifeTimeMax = 3.0f;
+                simulation.Emit(params, 100000);
+            } };
+    }
+
+    // 64個のエミッターが毎フレーム一定数を発生させ続ける
+    Scenario MakeSteadyScenario() {
+        return Scenario{ .name = "steady", .capacity = 32768,
+            .emit = [](ParticleSimulation& simulation, uint32_t, uint32_t&) {
+                ParticleEmitParams params;
+                params.startColorMin = { 0.5f, 0.5f, 0.5f, 1.0f };
+                params.lifeTimeMin = 1.0f;
+                params.lifeTimeMax = 3.0f;
+                for (uint32_t e = 0; e < 64; ++e) {
+                    params.position = { static_cast<float>(e % 8) * 2.0f, 0.0f, static_cast<float>(e / 8) * 2.0f };
+                    simulation.Emit(params, 4);
+                }
+            } };
+    }
+
+    // HitEffect3Dの各タイプを毎フレーム多数発生（ゲームと同じ設定・エミッターのタイミング・3Dパーティクルの発生と更新）
+    // ParticleSimulationではなく、Particle3DManagerと同じくリストに入れたParticle3DStateを更新する（Object3dの更新と描画は含まない）
+    Scenario MakeHitStormScenario() {
+        return Scenario{ .name = "hitstorm", .run = RunHitStormScenario };
+    }
+
+    // steadyに重力井戸・抵抗・渦・カールノイズ・ベクトル場を加えたもの
+    Scenario MakeForceFieldScenario() {
+        Scenario scenario = MakeSteadyScenario();
+        scenario.name = "forcefield";
+        scenario.setup = [](ParticleSimulation& simulation) {
+            auto noise = std::make_shared<ParticleVectorField>();
+            noise->GenerateCurlNoise(32, 4, 7);
+
+            auto field = std::make_shared<ParticleVectorField>();
+            field->Initialize(16, 16, 16);
+            for (uint32_t z = 0; z < 16; ++z) {
+                for (uint32_t y = 0; y < 16; ++y) {
+                    for (uint32_t x = 0; x < 16; ++x) {
+                        field->Set(x, y, z, Vector3{ 0.0f, 1.0f + y * 0.1f, 0.0f });
+                    }
+                }
+            }
+            field->SetBounds(Vector3{ 0.0f, 0.0f, 0.0f }, Vector3{ 14.0f, 8.0f, 14.0f });
+
+            ParticleForceField well;
+            well.type = ParticleForceField::Type::GravityWell;
+            well.position = { 7.0f, 2.0f, 7.0f };
+            well.strength = 20.0f;
+            well.radius = 12.0f;
+            simulation.AddForceField(well);
+
+            ParticleForceField drag;
+            drag.type = ParticleForceField::Type::Drag;
+            drag.strength = 0.5f;
+            simulation.AddForceField(drag);
+
+            ParticleForceField vortex;
+            vortex.type = ParticleForceField::Type::Vortex;
+            vortex.position = { 7.0f, 0.0f, 7.0f };
+            vortex.strength = 4.0f;
+            vortex.radius = 10.0f;
+            simulation.AddForceField(vortex);
+
+            ParticleForceField curl;
+            curl.type = ParticleForceField::Type::CurlNoise;
+            curl.strength = 6.0f;
+            curl.frequency = 2.0f;
+            curl.scroll = { 0.0f, 1.0f, 0.0f };
+            curl.volume = noise;
+            simulation.AddForceField(curl);
+
+            ParticleForceField baked;
+            baked.type = ParticleForceField::Type::VectorField;
+            baked.strength = 2.0f;
+            baked.volume = field;
+            simulation.AddForceField(baked);
+        };
+        return scenario;
+    }
+
+    // steadyの全パーティクルに16点の軌跡を持たせ、毎フレームリボンの頂点を生成
+    Scenario MakeRibbonScenario() {
+        Scenario scenario = MakeSteadyScenario();
+        scenario.name = "ribbon";
+
+        auto settings = std::make_shared<ParticleRibbonSettings>();
+        settings->historyLength = 16;
+        settings->widthScale = 0.5f;
+        auto vertices = std::make_shared<std::vector<RibbonVertex>>();
+
+        scenario.setup = [settings, vertices](ParticleSimulation& simulation) {
+            simulation.EnableTrail(settings->historyLength);
+            vertices->resize(static_cast<size_t>(simulation.GetCapacity()) * GetMaxRibbonVertexCount(*settings));
+        };
+        scenario.build = [settings, vertices](const ParticleSimulation& simulation) {
+            // カメラは発生域から少し離した位置（距離LODが一部に効く）
+            // ParticleManagerと同じく、頂点数を数えてから生成する
+            const Vector3 cameraPosition = { 7.0f, 4.0f, -30.0f };
+            uint32_t vertexCount = CountParticleRibbonVertices(simulation, *settings, cameraPosition);
+            uint32_t written = BuildParticleRibbons(simulation, *settings, cameraPosition, vertices->data(), vertexCount);
+            if (written != vertexCount) {
+                std::fprintf(stderr, "ribbon: counted %u vertices but wrote %u\n", vertexCount, written);
+                std::exit(1);
+            }
+        };
+        return scenario;
+    }
+
+    // シナリオを実行して計測
+    ScenarioResult RunScenario(const Scenario& scenario, uint32_t frames, uint32_t seed) {
+        ScenarioResult result;
+        result.name = scenario.name;
+        result.frames = frames;
+
+        ParticleSimulation simulation;
+        simulation.Initialize(scenario.capacity, seed);
+        if (scenario.setup) {
+            scenario.setup(simulation);
+        }
+        uint32_t random = seed ? seed : 1;
+
+        uint64_t allocationStart = BenchUtility::GetAllocationCount();
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            BenchUtility::Timer timer;
+            scenario.emit(simulation, frame, random);
+            simulation.Update(kDeltaTime);
+            if (scenario.build) {
+                scenario.build(simulation);
+            }
+            result.totalNs += timer.ElapsedNs();
+
+            result.particleUpdates += simulation.GetCount();
+            if (simulation.GetCount() > result.peakParticles) {
+                result.peakParticles = simulation.GetCount();
+            }
+            AccumulateChecksum(result.checksum, MakeChecksum(simulation));
+        }
+        result.allocations = BenchUtility::GetAllocationCount() - allocationStart;
+        result.residentBytes = BenchUtility::GetResidentBytes();
+        return result;
+    }
+
+    // 結果の出力
+    void PrintResult(const ScenarioResult& result, bool csv) {
+        double nsPerParticle = result.particleUpdates ? result.totalNs / static_cast<double>(result.particleUpdates) : 0.0;
+        double allocationsPerFrame = result.frames ? static_cast<double>(result.allocations) / result.frames : 0.0;
+        double residentMiB = static_cast<double>(result.residentBytes) / (1024.0 * 1024.0);
+
+        if (csv) {
+            std::printf("%s,%u,%u,%.3f,%.3f,%.2f,%016llx\n",
+                result.name.c_str(), result.frames, result.peakParticles,
+                nsPerParticle, allocationsPerFrame, residentMiB,
+                static_cast<unsigned long long>(result.checksum));
+        } else {
+            std::printf("%-10s frames:%5u peak:%7u  %8.3f ns/particle  %6.3f allocs/frame  RSS %7.2f MiB  checksum %016llx\n",
+                result.name.c_str(), result.frames, result.peakParticles,
+                nsPerParticle, allocationsPerFrame, residentMiB,
+                static_cast<unsigned long long>(result.checksum));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string scenarioName = BenchUtility::GetOption(argc, argv, "--scenario", "all");
+    uint32_t frames = static_cast<uint32_t>(std::strtoul(BenchUtility::GetOption(argc, argv, "--frames", "600").c_str(), nullptr, 10));
+    uint32_t seed = static_cast<uint32_t>(std::strtoul(BenchUtility::GetOption(argc, argv, "--seed", "12345").c_str(), nullptr, 10));
+    bool csv = BenchUtility::HasFlag(argc, argv, "--csv");
+
+    std::vector<Scenario> scenarios = { MakeBurstScenario(), MakeSteadyScenario(), MakeHitStormScenario(), MakeForceFieldScenario(), MakeRibbonScenario() };
+
+    if (csv) {
+        std::printf("scenario,frames,peak_particles,ns_per_particle,allocs_per_frame,rss_mib,checksum\n");
+    }
+
+    bool found = false;
+    for (const Scenario& scenario : scenarios) {
+        if (scenarioName != "all" && scenarioName != scenario.name) {
+            continue;
+        }
+        found = true;
+        PrintResult(scenario.run ? scenario.run(frames, seed) : RunScenario(scenario, frames, seed), csv);
+    }
+
+    if (!found) {
+        std::fprintf(stderr, "unknown scenario: %s\n", scenarioName.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,6 @@
+// ベンチマーク用のtinygltf実装（エンジン側のTinyGLTFImpl.cppと同じ定義）
+#define TINYGLTF_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+
+#include "tiny_gltf.h"
@@ -1,4 +1,8 @@
 #include "AnimatedModel.h"
+#include "AnimationPoseCache.h"
+#include "../Resource/MeshOptimizer.h"
+#include "../Resource/ModelCache.h"
+#include "SkinWeightImport.h"
 #include "Mymath.h"
 #include "UnoEngine.h"
 #include <algorithm>
@@ -14,7 +18,6 @@ AnimatedModel::~AnimatedModel() {
 void AnimatedModel::Initialize(DirectXCommon* dxCommon) {
     Model::Initialize(dxCommon);
     dxCommon_ = dxCommon;
-    animationBlender_.Initialize();
 }
 
 void AnimatedModel::LoadFromFile(const std::string& directoryPath, const std::string& filename) {
@@ -60,27 +63,57 @@ void AnimatedModel::LoadFromFile(const std::string& directoryPath, const std::st
 }
 
 void AnimatedModel::LoadFromGLTFWithAssimp(const std::string& directoryPath, const std::string& filename) {
-    // OutputDebugStringA(("AnimatedModel: Loading GLTF with Assimp from " + directoryPath + "/" + filename + "\n").c_str());
-    
-    std::string fullPath = directoryPath + "/" + filename;
-    
-    const aiScene* scene = assimpImporter_.ReadFile(fullPath,
-        aiProcess_Triangulate |
-        aiProcess_FlipUVs
-    );
-    
-    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
-        // OutputDebugStringA(("AnimatedModel: Error loading GLTF file: " + std::string(assimpImporter_.GetErrorString()) + "\n").c_str());
-        return;
+    // 元ファイルが変わっていなければ、インポート済みのメッシュ・スケルトン・アニメーションをキャッシュから読む
+    uint64_t sourceHash = HashModelSource(directoryPath, filename);
+    std::string cachePath = GetModelCachePath(directoryPath, filename, ModelCacheKind::AnimatedMesh);
+    ModelCacheAnimation cached;
+    if (sourceHash != 0 && ReadModelCache(cachePath, ModelCacheKind::AnimatedMesh, sourceHash, GetModelDataInternal(), &cached)) {
+        LoadMaterialTextures();
+        skeleton_ = std::move(cached.skeleton);
+        rootNodeName_ = cached.rootNodeName;
+        if (cached.animation) {
+            animation_ = std::move(*cached.animation);
+            SetupImportedAnimation();
+        }
+        OutputDebugStringA(("AnimatedModel: Loaded from cache " + cachePath + "\n").c_str());
+    } else {
+        // OutputDebugStringA(("AnimatedModel: Loading GLTF with Assimp from " + directoryPath + "/" + filename + "\n").c_str());
+        
+        std::string fullPath = directoryPath + "/" + filename;
+        
+        const aiScene* scene = assimpImporter_.ReadFile(fullPath,
+            aiProcess_Triangulate |
+            aiProcess_FlipUVs
+        );
+        
+        if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+            // OutputDebugStringA(("AnimatedModel: Error loading GLTF file: " + std::string(assimpImporter_.GetErrorString()) + "\n").c_str());
+            return;
+        }
+        
+        // OutputDebugStringA(("AnimatedModel: Successfully loaded GLTF file\n"));
+        
+        ProcessAssimpScene(scene, directoryPath);
+        
+        Node rootNode = ReadAssimpNode(scene->mRootNode);
+        skeleton_ = CreateSkeleton(rootNode);
+        
+        if (sourceHash != 0) {
+            cached.skeleton = skeleton_;
+            cached.rootNodeName = rootNodeName_;
+            if (scene->mNumAnimations > 0) {
+                cached.animation = animation_;
+            }
+            WriteModelCache(cachePath, ModelCacheKind::AnimatedMesh, sourceHash, GetModelData(), &cached);
+        }
     }
     
-    // OutputDebugStringA(("AnimatedModel: Successfully loaded GLTF file\n"));
-    
-    ProcessAssimpScene(scene, directoryPath);
-    
-    Node rootNode = ReadNode(scene->mRootNode);
-    skeleton_ = CreateSkeleton(rootNode);
     skinCluster_ = CreateSkinCluster();
+    skinHash_ = HashSkin(skeleton_, skinCluster_.inverseBindPoseMatrices);
+    jointBounds_ = CalculateJointBounds(skinCluster_.mappedInfluence, GetModelData().vertices, skeleton_.joints.size());
+    if (skinningMethod_ == SkinningMethod::DualQuaternion) {
+        CreateDualQuaternionPalette();
+    }
     
     for (const Joint& joint : skeleton_.joints) {
         JointTransform transform;
@@ -90,6 +123,13 @@ void AnimatedModel::LoadFromGLTFWithAssimp(const std::string& directoryPath, con
         initialJointTransforms_[joint.name] = transform;
     }
     
+    // 読み込んだアニメーションをスケルトンに結び付ける
+    for (const auto& [name, animation] : animations_) {
+        CompileAnimation(name, animation);
+    }
+    currentClip_ = FindCompiledClip(currentAnimationName_);
+    SetupBlendTree();
+    
     CreateVertexBuffer();
 }
 
@@ -98,74 +138,255 @@ void AnimatedModel::LoadAnimation(const std::string& directoryPath, const std::s
     
     animationPlayer_.SetAnimation(animation_);
     animationPlayer_.SetLoop(true);
-    
-    animationBlender_.SetAnimation(animation_);
-    animationBlender_.SetLoop(true);
-    animationBlender_.Play();
 }
 
 void AnimatedModel::Update(float deltaTime) {
-    animationPlayer_.Update(deltaTime);
+    RootMotionDelta rootMotion = animationPlayer_.Update(deltaTime);
+    
+    // 追加したレイヤーの時刻を進める（ベースレイヤーの時刻は後でプレイヤーに合わせる）
+    blendTree_.Update(deltaTime);
     
+    pendingEvents_.clear();
     if (isBlending_) {
-        targetPlayer_.Update(deltaTime);
+        RootMotionDelta targetRootMotion = targetPlayer_.Update(deltaTime);
         
         blendElapsedTime_ += deltaTime;
         blendProgress_ = std::min(blendElapsedTime_ / blendDuration_, 1.0f);
+        rootMotion = BlendRootMotion(rootMotion, targetRootMotion, blendProgress_);
+        
+        // 入れ替える前に両方のクリップのイベントを重み付きで集める
+        if (!eventListeners_.empty()) {
+            for (const AnimationEvent& event : animationPlayer_.GetFiredEvents()) {
+                pendingEvents_.push_back({ event, 1.0f - blendProgress_ });
+            }
+            for (const AnimationEvent& event : targetPlayer_.GetFiredEvents()) {
+                pendingEvents_.push_back({ event, blendProgress_ });
+            }
+        }
         
         if (blendProgress_ >= 1.0f) {
             animationPlayer_ = targetPlayer_;
             currentAnimationName_ = targetAnimationName_;
+            currentClip_ = targetClip_;
+            targetClip_ = nullptr;
+            
+            // ブレンド先のスロットを現在のスロットにする
+            if (blendTree_.GetLayerCount() > 0) {
+                blendTree_.SwapClips(kBaseLayer, kCurrentSlot, kTargetSlot);
+                blendTree_.SetClip(kBaseLayer, kTargetSlot, nullptr);
+            }
             
             isBlending_ = false;
             blendProgress_ = 0.0f;
             blendElapsedTime_ = 0.0f;
         }
+    } else if (!eventListeners_.empty()) {
+        for (const AnimationEvent& event : animationPlayer_.GetFiredEvents()) {
+            pendingEvents_.push_back({ event, 1.0f });
+        }
     }
     
-    // animationBlender_.Update(deltaTime);
+    rootMotionDelta_.Append(rootMotion);
+    
+    // ベースレイヤーの時刻と重みをプレイヤーに合わせる
+    if (blendTree_.GetLayerCount() > 0) {
+        blendTree_.SetClipTime(kBaseLayer, kCurrentSlot, animationPlayer_.GetTime());
+        blendTree_.SetClipWeight(kBaseLayer, kCurrentSlot, isBlending_ ? 1.0f - blendProgress_ : 1.0f);
+        blendTree_.SetClipTime(kBaseLayer, kTargetSlot, targetPlayer_.GetTime());
+        blendTree_.SetClipWeight(kBaseLayer, kTargetSlot, isBlending_ ? blendProgress_ : 0.0f);
+    }
+    
+    // イベントの呼び出し（集め終えた後なので、リスナーの中でアニメーションを切り替えてもよい）
+    for (const PendingEvent& pending : pendingEvents_) {
+        for (const EventListenerEntry& entry : eventListeners_) {
+            if (entry.eventId == 0 || entry.eventId == pending.event.id) {
+                entry.listener(pending.event, pending.weight);
+            }
+        }
+    }
 }
 
-Matrix4x4 AnimatedModel::GetAnimationLocalMatrix() {
-    // ブレンダーが有効な場合はブレンダーから取得
-    if (!animations_.empty()) {
-        return animationBlender_.GetLocalMatrix(rootNodeName_);
+bool AnimatedModel::GetSharablePose(const CompiledAnimationClip*& outClip, float& outTime) const {
+    // ルートモーションを取り出したポーズはクリップのサンプリングと一致しない
+    if (rootMotionBinding_.IsValid()) {
+        return false;
+    }
+    if (blendTree_.GetLayerCount() == 0 || !currentClip_ || blendTree_.GetJointCount() != skeleton_.joints.size()) {
+        return false;
     }
-    // 互換性のため、単一アニメーションの場合はプレイヤーから取得
+    return blendTree_.GetSingleClip(outClip, outTime);
+}
+
+void AnimatedModel::BakeAnimations(float sampleRate, BakedPaletteFormat format) {
+    bakedClipIndices_.clear();
+    if (skeleton_.joints.empty()) {
+        return;
+    }
+    bakedTable_.Initialize(skeleton_, skinCluster_.inverseBindPoseMatrices, format);
+    for (const auto& [name, clip] : compiledClips_) {
+        if (clip.GetJointCount() == skeleton_.joints.size()) {
+            bakedClipIndices_[&clip] = bakedTable_.AddClip(clip, sampleRate);
+        }
+    }
+}
+
+bool AnimatedModel::GetBakedRow(uint32_t& outRow) const {
+    const CompiledAnimationClip* clip = nullptr;
+    float time = 0.0f;
+    if (bakedClipIndices_.empty() || !GetSharablePose(clip, time)) {
+        return false;
+    }
+    auto it = bakedClipIndices_.find(clip);
+    if (it == bakedClipIndices_.end()) {
+        return false;
+    }
+    outRow = bakedTable_.GetRow(it->second, time);
+    return true;
+}
+
+bool AnimatedModel::EvaluatePose(AnimationPose& outPose) {
+    if (blendTree_.GetLayerCount() == 0 || !currentClip_ || blendTree_.GetJointCount() != skeleton_.joints.size()) {
+        return false;
+    }
+    blendTree_.Evaluate(outPose);
+    if (rootMotionBinding_.IsValid()) {
+        rootMotionBinding_.RemoveRootMotion(outPose);
+    }
+    return true;
+}
+
+uint64_t AnimatedModel::MarkAnimatedJoints(std::span<uint8_t> outFlags) const {
+    uint64_t hash = blendTree_.MarkAnimatedJoints(outFlags);
+    // 固定する位置・向きは連鎖の親の変化にも左右されるので、常に変わるものとして扱う
+    if (rootMotionBinding_.IsValid()) {
+        outFlags[rootMotionBinding_.GetJoint()] = 1;
+    }
+    return hash;
+}
+
+bool AnimatedModel::EnableRootMotion(const std::string& jointName, const RootMotionSettings& settings) {
+    auto it = skeleton_.jointMap.find(jointName);
+    if (it == skeleton_.jointMap.end()) {
+        return false;
+    }
+    rootMotionBinding_.Initialize(skeleton_, it->second, settings);
+    rootMotionTracks_.clear();
+    for (const auto& [name, clip] : compiledClips_) {
+        rootMotionTracks_[name].Build(clip, rootMotionBinding_);
+    }
+    animationPlayer_.SetRootMotionTrack(FindRootMotionTrack(currentAnimationName_));
+    if (isBlending_) {
+        targetPlayer_.SetRootMotionTrack(FindRootMotionTrack(targetAnimationName_));
+    }
+    rootMotionDelta_ = {};
+    return true;
+}
+
+void AnimatedModel::DisableRootMotion() {
+    rootMotionBinding_ = {};
+    rootMotionTracks_.clear();
+    animationPlayer_.SetRootMotionTrack(nullptr);
+    targetPlayer_.SetRootMotionTrack(nullptr);
+    rootMotionDelta_ = {};
+}
+
+RootMotionDelta AnimatedModel::ConsumeRootMotion() {
+    RootMotionDelta delta = rootMotionDelta_;
+    rootMotionDelta_ = {};
+    return delta;
+}
+
+const RootMotionTrack* AnimatedModel::FindRootMotionTrack(const std::string& name) const {
+    auto it = rootMotionTracks_.find(name);
+    return (it != rootMotionTracks_.end()) ? &it->second : nullptr;
+}
+
+bool AnimatedModel::AddAnimationEvent(const std::string& animationName, float time, uint32_t eventId, float payload) {
+    auto it = animations_.find(animationName);
+    if (it == animations_.end()) {
+        return false;
+    }
+    it->second.events.Add(time, eventId, payload);
+    
+    // プレイヤーはアニメーションのコピーを持つため、再生中のクリップにも追加する
+    if (animationName == currentAnimationName_) {
+        animationPlayer_.GetAnimation().events.Add(time, eventId, payload);
+    }
+    if (isBlending_ && animationName == targetAnimationName_) {
+        targetPlayer_.GetAnimation().events.Add(time, eventId, payload);
+    }
+    return true;
+}
+
+uint32_t AnimatedModel::AddAnimationEventListener(uint32_t eventId, AnimationEventListener listener) {
+    uint32_t handle = nextEventListenerHandle_++;
+    eventListeners_.push_back({ handle, eventId, std::move(listener) });
+    return handle;
+}
+
+void AnimatedModel::RemoveAnimationEventListener(uint32_t handle) {
+    std::erase_if(eventListeners_, [handle](const EventListenerEntry& entry) { return entry.handle == handle; });
+}
+
+Matrix4x4 AnimatedModel::GetAnimationLocalMatrix() {
     return animationPlayer_.GetLocalMatrix(rootNodeName_);
 }
 
+void AnimatedModel::SetSkinningMethod(SkinningMethod method) {
+    if (method == SkinningMethod::DualQuaternion && !skinCluster_.dualQuaternionPaletteResource && !skeleton_.joints.empty()) {
+        CreateDualQuaternionPalette();
+    }
+    skinningMethod_ = method;
+}
+
 // アニメーション再生制御
 void AnimatedModel::PlayAnimation() {
     animationPlayer_.Play();
-    animationBlender_.Play();
 }
 
 void AnimatedModel::StopAnimation() {
     animationPlayer_.Stop();
-    animationBlender_.Stop();
 }
 
 void AnimatedModel::PauseAnimation() {
     animationPlayer_.Pause();
-    animationBlender_.Pause();
 }
 
 void AnimatedModel::SetAnimationLoop(bool loop) {
     animationPlayer_.SetLoop(loop);
-    animationBlender_.SetLoop(loop);
 }
 
 // アニメーションの追加
 void AnimatedModel::AddAnimation(const std::string& name, const Animation& animation) {
     animations_[name] = animation;
+    CompileAnimation(name, animation);
     
     // 最初のアニメーションの場合は自動的に設定
     if (animations_.size() == 1) {
         currentAnimationName_ = name;
-        animationBlender_.SetAnimation(animation);
-        animationBlender_.Play();
+        currentClip_ = FindCompiledClip(name);
+        if (blendTree_.GetLayerCount() > 0) {
+            blendTree_.SetClip(kBaseLayer, kCurrentSlot, currentClip_);
+        }
+    }
+}
+
+bool AnimatedModel::AddRetargetedAnimation(const std::string& name, const AnimationClipAsset& clip) {
+    if (skeleton_.joints.empty()) {
+        return false;
+    }
+    // 同じスケルトンから作ったクリップは変換しない
+    uint64_t skeletonHash = HashSkeleton(skeleton_);
+    if (clip.skeletonHash == skeletonHash) {
+        AddAnimation(name, clip.animation);
+        return true;
     }
+    const AnimationRetargetMap& map = AnimationRetargetCache::GetInstance()->GetMap(clip.skeleton, clip.skeletonHash, skeleton_, skeletonHash);
+    if (map.GetMappedJointCount() == 0) {
+        return false;
+    }
+    AddAnimation(name, map.Retarget(clip.animation));
+    return true;
 }
 
 // アニメーションの切り替え（即座）
@@ -174,10 +395,12 @@ void AnimatedModel::ChangeAnimation(const std::string& name) {
     if (it != animations_.end()) {
         currentAnimationName_ = name;
         animationPlayer_.SetAnimation(it->second);
+        animationPlayer_.SetRootMotionTrack(FindRootMotionTrack(name));
         animationPlayer_.Play();
-        // animationBlender_も更新（互換性のため）
-        animationBlender_.SetAnimation(it->second);
-        animationBlender_.Play();
+        currentClip_ = FindCompiledClip(name);
+        if (blendTree_.GetLayerCount() > 0) {
+            blendTree_.SetClip(kBaseLayer, kCurrentSlot, currentClip_);
+        }
     }
 }
 
@@ -191,6 +414,11 @@ void AnimatedModel::TransitionToAnimation(const std::string& name, float transit
         targetPlayer_.SetLoop(true); // 常にループ（後で改善）
         targetPlayer_.Play();
         targetPlayer_.SetTime(0.0f); // 新しいアニメーションは最初から
+        targetPlayer_.SetRootMotionTrack(FindRootMotionTrack(name));
+        targetClip_ = FindCompiledClip(name);
+        if (blendTree_.GetLayerCount() > 0) {
+            blendTree_.SetClip(kBaseLayer, kTargetSlot, targetClip_);
+        }
         
         isBlending_ = true;
         blendDuration_ = transitionDuration;
@@ -200,55 +428,50 @@ void AnimatedModel::TransitionToAnimation(const std::string& name, float transit
 }
 
 
-Node AnimatedModel::ReadNode(aiNode* node)
-{
-    Node result;
-    aiVector3D scale, translate;
-    aiQuaternion rotation;
-
-    node->mTransformation.Decompose(scale, rotation, translate);
-    result.transform.scale = { scale.x, scale.y, scale.z };
-    result.transform.rotate = { rotation.x, -rotation.y, -rotation.z, rotation.w };  
-    result.transform.translate = { -translate.x, translate.y, translate.z };  
-    result.localMatrix = MakeAffineMatrix(result.transform.scale, result.transform.rotate, result.transform.translate);
-    result.name = node->mName.C_Str();
-    result.children.resize(node->mNumChildren);
-    for (uint32_t childIndex = 0; childIndex < node->mNumChildren; ++childIndex) {
-        result.children[childIndex] = ReadNode(node->mChildren[childIndex]);
+const CompiledAnimationClip* AnimatedModel::CompileAnimation(const std::string& name, const Animation& animation) {
+    // スケルトンの読み込み前（OBJなど）はコンパイルしない
+    if (skeleton_.joints.empty()) {
+        return nullptr;
+    }
+    CompiledAnimationClip& clip = compiledClips_[name];
+    clip.Compile(animation, skeleton_);
+    if (compressionSettings_) {
+        clip.Compress(*compressionSettings_);
+    }
+    if (rootMotionBinding_.IsValid()) {
+        rootMotionTracks_[name].Build(clip, rootMotionBinding_);
     }
-    return result;
+    return &clip;
 }
 
-Skeleton AnimatedModel::CreateSkeleton(const Node& rootNode)
-{
-    Skeleton skeleton;
-    skeleton.root = CreateJoint(rootNode, {}, skeleton.joints);
-    for (const Joint& joint : skeleton.joints) {
-        skeleton.jointMap.emplace(joint.name, joint.index);
+void AnimatedModel::EnableAnimationCompression(const AnimationCompressionSettings& settings) {
+    compressionSettings_ = settings;
+    for (auto& [name, clip] : compiledClips_) {
+        clip.Compress(settings);
     }
-    return skeleton;
 }
 
-int32_t AnimatedModel::CreateJoint(const Node& node, std::optional<int32_t> parent, std::vector<Joint>& joints)
-{
-    Joint joint;
-    joint.name = node.name;
-    joint.localMatrix = node.localMatrix;
-    joint.skeletonSpaceMatrix = MakeIdentity4x4();
-    joint.transform.scale = node.transform.scale;
-    joint.transform.rotate = node.transform.rotate;
-    joint.transform.translate = node.transform.translate;
-    joint.index = int32_t(joints.size());
-    joint.parent = parent;
-
-    joints.push_back(joint);
-
-    for (const Node& child : node.children) {
-        int32_t childIndex = CreateJoint(child, joint.index, joints);
-        joints[joint.index].children.push_back(childIndex);
+size_t AnimatedModel::GetCompiledClipMemorySize() const {
+    size_t size = 0;
+    for (const auto& [name, clip] : compiledClips_) {
+        size += clip.GetMemorySize();
     }
+    return size;
+}
 
-    return joint.index;
+void AnimatedModel::SetupBlendTree() {
+    // レイヤー0は現在のクリップとブレンド先の2つを持つクロスフェード用
+    AnimationPose restPose;
+    ReadPoseFromSkeleton(skeleton_, restPose);
+    blendTree_.Initialize(restPose);
+    blendTree_.AddLayer(AnimationBlendTree::BlendMode::Override, 2);
+    blendTree_.SetClip(kBaseLayer, kCurrentSlot, currentClip_);
+    blendTree_.SetClipWeight(kBaseLayer, kCurrentSlot, 1.0f);
+}
+
+const CompiledAnimationClip* AnimatedModel::FindCompiledClip(const std::string& name) const {
+    auto it = compiledClips_.find(name);
+    return (it != compiledClips_.end()) ? &it->second : nullptr;
 }
 
 SkinCluster AnimatedModel::CreateSkinCluster()
@@ -284,7 +507,6 @@ SkinCluster AnimatedModel::CreateSkinCluster()
     skinCluster.influenceResource = dxCommon_->CreateBufferResource(sizeof(VertexInfluence) * modelData.vertices.size());
     VertexInfluence* mappedInfluence = nullptr;
     skinCluster.influenceResource->Map(0, nullptr, reinterpret_cast<void**>(&mappedInfluence));
-    std::memset(mappedInfluence, 0, sizeof(VertexInfluence) * modelData.vertices.size());
     skinCluster.mappedInfluence = { mappedInfluence, modelData.vertices.size() };
     
     // Influence用のVBVを作成
@@ -296,62 +518,50 @@ SkinCluster AnimatedModel::CreateSkinCluster()
     skinCluster.inverseBindPoseMatrices.resize(skeleton_.joints.size());
     std::generate(skinCluster.inverseBindPoseMatrices.begin(), skinCluster.inverseBindPoseMatrices.end(), [] { return MakeIdentity4x4(); });
     
-    // ボーンウェイト情報をインフルエンスデータに設定
+    // InverseBindPoseMatrixを設定
     for (const auto& jointWeight : modelData.skinClusterData) {
         auto it = skeleton_.jointMap.find(jointWeight.first);
-        if (it == skeleton_.jointMap.end()) {
-            continue; // このジョイントがスケルトンに存在しない場合はスキップ
-        }
-        
-        // InverseBindPoseMatrixを設定
-        skinCluster.inverseBindPoseMatrices[it->second] = jointWeight.second.inverseBindPoseMatrix;
-        
-        // 各頂点のウェイト情報を設定
-        for (const auto& vertexWeight : jointWeight.second.vertexWeights) {
-            if (vertexWeight.vectorIndex >= modelData.vertices.size()) {
-                continue; // 無効なインデックスはスキップ
-            }
-            
-            auto& currentInfluence = skinCluster.mappedInfluence[vertexWeight.vectorIndex];
-            
-            // 空いているスロットにウェイトとジョイントインデックスを設定
-            for (uint32_t index = 0; index < kNumMaxInfluence; ++index) {
-                if (currentInfluence.weights[index] == 0.0f) {
-                    currentInfluence.weights[index] = vertexWeight.weight;
-                    currentInfluence.jointIndices[index] = it->second;
-                    break;
-                }
-            }
+        if (it != skeleton_.jointMap.end()) {
+            skinCluster.inverseBindPoseMatrices[it->second] = jointWeight.second.inverseBindPoseMatrix;
         }
     }
     
-    // ウェイトの正規化（合計が1になるように）
-    for (size_t i = 0; i < modelData.vertices.size(); ++i) {
-        auto& influence = skinCluster.mappedInfluence[i];
-        float totalWeight = 0.0f;
-        
-        // 合計ウェイトを計算
-        for (uint32_t j = 0; j < kNumMaxInfluence; ++j) {
-            totalWeight += influence.weights[j];
-        }
-        
-        // 正規化
-        if (totalWeight > 0.0f) {
-            for (uint32_t j = 0; j < kNumMaxInfluence; ++j) {
-                influence.weights[j] /= totalWeight;
-            }
-        } else {
-            // ウェイトが設定されていない頂点はルートジョイントに100%バインド
-            influence.weights[0] = 1.0f;
-            influence.jointIndices[0] = 0;
-        }
-    }
+    // ボーンウェイト情報を頂点ごとに集め、重みの大きい順に4つを選んで正規化してから書き込む
+    BuildVertexInfluences(modelData.skinClusterData, skeleton_.jointMap, skinCluster.mappedInfluence);
     
     // OutputDebugStringA(("AnimatedModel: Created SkinCluster with " + std::to_string(skeleton_.joints.size()) + " joints\n").c_str());
     
     return skinCluster;
 }
 
+void AnimatedModel::CreateDualQuaternionPalette()
+{
+    // palette用のリソースを作成（行列パレットの1/4のサイズ）
+    skinCluster_.dualQuaternionPaletteResource = dxCommon_->CreateBufferResource(sizeof(DualQuaternion) * skeleton_.joints.size());
+    DualQuaternion* mappedPalette = nullptr;
+    skinCluster_.dualQuaternionPaletteResource->Map(0, nullptr, reinterpret_cast<void**>(&mappedPalette));
+    skinCluster_.mappedDualQuaternionPalette = { mappedPalette, skeleton_.joints.size() };
+    
+    // 評価前に描画されても崩れないよう、バインドポーズ（恒等変換）で埋める
+    std::fill(skinCluster_.mappedDualQuaternionPalette.begin(), skinCluster_.mappedDualQuaternionPalette.end(),
+        DualQuaternion{ { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } });
+    
+    // SRVを作成
+    UnoEngine* engine = UnoEngine::GetInstance();
+    if (engine && engine->GetSrvManager()) {
+        SrvManager* srvManager = engine->GetSrvManager();
+        uint32_t srvIndex = srvManager->Allocate();
+        srvManager->CreateSRVForStructuredBuffer(srvIndex, skinCluster_.dualQuaternionPaletteResource,
+                                                  static_cast<UINT>(skeleton_.joints.size()), sizeof(DualQuaternion));
+        skinCluster_.dualQuaternionPaletteSrvHandle.first = srvManager->GetCPUDescriptorHandle(srvIndex);
+        skinCluster_.dualQuaternionPaletteSrvHandle.second = srvManager->GetGPUDescriptorHandle(srvIndex);
+    } else {
+        OutputDebugStringA("AnimatedModel: WARNING - Could not access SrvManager\n");
+        skinCluster_.dualQuaternionPaletteSrvHandle.first = {};
+        skinCluster_.dualQuaternionPaletteSrvHandle.second = {};
+    }
+}
+
 // assimpシーンからモデルデータを作成
 void AnimatedModel::ProcessAssimpScene(const aiScene* scene, const std::string& directoryPath) {
     ModelData& modelData = GetModelDataInternal();
@@ -451,7 +661,7 @@ void AnimatedModel::ProcessAssimpMesh(const aiMesh* mesh, const aiScene* scene)
         }
     }
     
-    // インデックスを使用して三角形ごとに頂点を作成（DirectX用に座標変換も適用）
+    // インデックスバッファを作る（X軸反転により巻き順を反転）
     for (unsigned int faceIndex = 0; faceIndex < mesh->mNumFaces; faceIndex++) {
         const aiFace& face = mesh->mFaces[faceIndex];
         
@@ -460,15 +670,34 @@ void AnimatedModel::ProcessAssimpMesh(const aiMesh* mesh, const aiScene* scene)
             continue;
         }
         
-        // X軸反転により巻き順を反転（0, 2, 1の順序）
-        unsigned int indices[3] = { face.mIndices[0], face.mIndices[2], face.mIndices[1] };
-        
-        for (int i = 0; i < 3; i++) {
-            unsigned int vertexIndex = indices[i];
-            matVertexData.vertices.push_back(indexedVertices[vertexIndex]);
-            modelData.vertices.push_back(indexedVertices[vertexIndex]);
+        matVertexData.indices.insert(matVertexData.indices.end(), { face.mIndices[0], face.mIndices[2], face.mIndices[1] });
+    }
+    
+    // ボーンごとのウェイト（頂点番号は元の番号）
+    std::vector<std::vector<VertexWeightData>> boneWeights(mesh->mNumBones);
+    for (unsigned int boneIndex = 0; boneIndex < mesh->mNumBones; boneIndex++) {
+        const aiBone* bone = mesh->mBones[boneIndex];
+        boneWeights[boneIndex].reserve(bone->mNumWeights);
+        for (unsigned int weightIndex = 0; weightIndex < bone->mNumWeights; weightIndex++) {
+            const aiVertexWeight& weight = bone->mWeights[weightIndex];
+            boneWeights[boneIndex].push_back({ weight.mWeight, weight.mVertexId });
         }
     }
+
+    // 同じ頂点を溶接し、頂点キャッシュとオーバードローのために三角形を並べ替え、使う順に頂点を並べ直す
+    // （JoinIdenticalVerticesを使わずに読むので、glTF以外の形式ではコーナーごとに頂点が分かれている）
+    // ウェイトの組もキーに入れるので、位置・法線・UVが同じでもウェイトが違う頂点はまとめない
+    // ウェイトは対応表で新しい頂点番号に付け替える。まとまった頂点は組が同じなので最初の1つの分だけを使う
+    std::vector<uint64_t> weldKeys = BuildWeightSetKeys(boneWeights, indexedVertices.size());
+    MeshOptimizeSettings optimizeSettings;
+    std::vector<uint32_t> vertexRemap;
+    MeshOptimizeStatistics optimizeStatistics = OptimizeMesh(indexedVertices, matVertexData.indices, optimizeSettings, &vertexRemap,
+        weldKeys.data());
+    DropWeldedDuplicates(vertexRemap);
+    OutputDebugStringA(("AnimatedModel: Optimized mesh \"" + utf8 + "\" - ACMR " + std::to_string(optimizeStatistics.before.acmr) +
+        " -> " + std::to_string(optimizeStatistics.after.acmr) + "\n").c_str());
+    matVertexData.vertices = std::move(indexedVertices);
+    modelData.vertices.insert(modelData.vertices.end(), matVertexData.vertices.begin(), matVertexData.vertices.end());
     
     // ボーン情報の処理
     // OutputDebugStringA(("AnimatedModel: Processing " + std::to_string(mesh->mNumBones) + " bones\n").c_str());
@@ -501,27 +730,10 @@ void AnimatedModel::ProcessAssimpMesh(const aiMesh* mesh, const aiScene* scene)
         jointWeightData.inverseBindPoseMatrix = Inverse(bindPoseMatrixConverted);
         
         // 頂点ウェイト情報を格納
-        for (unsigned int weightIndex = 0; weightIndex < bone->mNumWeights; weightIndex++) {
-            const aiVertexWeight& weight = bone->mWeights[weightIndex];
-            
-            // 元の頂点インデックスから実際の頂点配列でのインデックスを探す
-            // 各面で頂点が複製されているため、元のインデックスを持つすべての頂点を探す
-            for (unsigned int faceIndex = 0; faceIndex < mesh->mNumFaces; faceIndex++) {
-                const aiFace& face = mesh->mFaces[faceIndex];
-                // X軸反転により巻き順を反転（0, 2, 1の順序）
-                unsigned int indices[3] = { face.mIndices[0], face.mIndices[2], face.mIndices[1] };
-                
-                for (int i = 0; i < 3; i++) {
-                    if (indices[i] == weight.mVertexId) {
-                        // この頂点は modelData.vertices の (faceIndex * 3 + i) 番目に格納されている
-                        VertexWeightData vwd;
-                        vwd.weight = weight.mWeight;
-                        vwd.vectorIndex = faceIndex * 3 + i;
-                        jointWeightData.vertexWeights.push_back(vwd);
-                    }
-                }
-            }
-        }
+        // （頂点の番号はこのメッシュの溶接・並べ直した後の頂点配列での位置。どの三角形にも使われない頂点は除く）
+        size_t firstWeight = jointWeightData.vertexWeights.size();
+        jointWeightData.vertexWeights.insert(jointWeightData.vertexWeights.end(), boneWeights[boneIndex].begin(), boneWeights[boneIndex].end());
+        RemapVertexWeights(jointWeightData.vertexWeights, firstWeight, vertexRemap);
     }
 
     // このメッシュのデータをmatVertexDataに格納
@@ -703,70 +915,24 @@ void AnimatedModel::ProcessAssimpAnimation(const aiScene* scene) {
         return;
     }
     
-    const aiAnimation* assimpAnimation = scene->mAnimations[0];
+    // OutputDebugStringA(("AnimatedModel: Processing animation with " + std::to_string(scene->mAnimations[0]->mNumChannels) + " channels\n").c_str());
     
-    // OutputDebugStringA(("AnimatedModel: Processing animation with " + std::to_string(assimpAnimation->mNumChannels) + " channels\n").c_str());
+    animation_ = ConvertAssimpAnimation(scene->mAnimations[0]);
     
-    // アニメーション時間を設定
-    animation_.duration = static_cast<float>(assimpAnimation->mDuration / assimpAnimation->mTicksPerSecond);
-    animation_.nodeAnimations.clear();
+    SetupImportedAnimation();
     
-    // 各ノードアニメーションチャンネルを処理
-    for (unsigned int i = 0; i < assimpAnimation->mNumChannels; i++) {
-        const aiNodeAnim* nodeAnim = assimpAnimation->mChannels[i];
-        std::string nodeName = nodeAnim->mNodeName.C_Str();
-        
-        NodeAnimation& nodeAnimation = animation_.nodeAnimations[nodeName];
-        
-        // 位置キーフレーム（右手座標系→左手座標系：X座標を反転）
-        for (unsigned int j = 0; j < nodeAnim->mNumPositionKeys; j++) {
-            const aiVectorKey& key = nodeAnim->mPositionKeys[j];
-            KeyframeVector3 keyframe;
-            keyframe.time = static_cast<float>(key.mTime / assimpAnimation->mTicksPerSecond);
-            keyframe.value = {-key.mValue.x, key.mValue.y, key.mValue.z};  
-            nodeAnimation.translate.push_back(keyframe);
-        }
-        
-        // 回転キーフレーム（右手座標系→左手座標系）
-        for (unsigned int j = 0; j < nodeAnim->mNumRotationKeys; j++) {
-            const aiQuatKey& key = nodeAnim->mRotationKeys[j];
-            KeyframeQuaternion keyframe;
-            keyframe.time = static_cast<float>(key.mTime / assimpAnimation->mTicksPerSecond);
-            
+    // OutputDebugStringA(("AnimatedModel: Animation duration: " + std::to_string(animation_.duration) + " seconds\n").c_str());
+}
 
-            // Y,Z成分を反転
-            keyframe.value = {key.mValue.x, -key.mValue.y, -key.mValue.z, key.mValue.w};
-            nodeAnimation.rotate.push_back(keyframe);
-        }
-        
-        // スケールキーフレーム（スケールは座標系に依存しない）
-        for (unsigned int j = 0; j < nodeAnim->mNumScalingKeys; j++) {
-            const aiVectorKey& key = nodeAnim->mScalingKeys[j];
-            KeyframeVector3 keyframe;
-            keyframe.time = static_cast<float>(key.mTime / assimpAnimation->mTicksPerSecond);
-            keyframe.value = {key.mValue.x, key.mValue.y, key.mValue.z};
-            nodeAnimation.scale.push_back(keyframe);
-        }
-        
-        // OutputDebugStringA(("AnimatedModel: Node " + nodeName + " - Position keys: " + std::to_string(nodeAnimation.translate.size()) + 
-        //                   ", Rotation keys: " + std::to_string(nodeAnimation.rotate.size()) + 
-        //                   ", Scale keys: " + std::to_string(nodeAnimation.scale.size()) + "\n").c_str());
-    }
-    
+void AnimatedModel::SetupImportedAnimation() {
     animationPlayer_.SetAnimation(animation_);
     animationPlayer_.SetLoop(true);
     
-    animationBlender_.SetAnimation(animation_);
-    animationBlender_.SetLoop(true);
-    animationBlender_.Play();
-    
     // デフォルトアニメーションとして登録
     if (animations_.empty()) {
         animations_["default"] = animation_;
         currentAnimationName_ = "default";
     }
-    
-    // OutputDebugStringA(("AnimatedModel: Animation duration: " + std::to_string(animation_.duration) + " seconds\n").c_str());
 }
 
 // 指定したジョイントのブレンドされた変換を取得
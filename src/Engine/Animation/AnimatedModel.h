@@ -2,12 +2,17 @@
 #include "Model.h"
 #include "Animation.h"
 #include "AnimationPlayer.h"
-#include "AnimationBlender.h"
+#include "AnimationBlendTree.h"
 #include "AnimationUtility.h"
+#include "CompiledAnimationClip.h"
+#include "BakedAnimation.h"
+#include "CpuSkinning.h"
 #include "TextureManager.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <functional>
+#include <optional>
 #include <unordered_map>
 
 // ジョイント変換構造体
@@ -17,6 +22,15 @@ struct JointTransform {
     Vector3 translate;
 };
 
+// スキニングの方式
+enum class SkinningMethod {
+    Linear,          // 行列パレットの線形ブレンド（1ジョイント128バイト）
+    DualQuaternion,  // デュアルクォータニオン（1ジョイント32バイト。スケールは無視される）
+};
+
+// アニメーションイベントの受け取り（weightはクロスフェード中のクリップの重み。ブレンドしていなければ1）
+using AnimationEventListener = std::function<void(const AnimationEvent& event, float weight)>;
+
 // アニメーション付きモデルクラス
 class AnimatedModel : public Model {
 public:
@@ -48,9 +62,33 @@ public:
     AnimationPlayer& GetAnimationPlayer() { return animationPlayer_; }
     const AnimationPlayer& GetAnimationPlayer() const { return animationPlayer_; }
     
-    // アニメーションブレンダーを取得
-    AnimationBlender& GetAnimationBlender() { return animationBlender_; }
-    const AnimationBlender& GetAnimationBlender() const { return animationBlender_; }
+    // ブレンド先のアニメーションプレイヤーを取得
+    const AnimationPlayer& GetTargetAnimationPlayer() const { return targetPlayer_; }
+    
+    // 再生中・ブレンド先のコンパイル済みクリップを取得（スケルトンがなければnullptr）
+    const CompiledAnimationClip* GetCurrentClip() const { return currentClip_; }
+    const CompiledAnimationClip* GetTargetClip() const { return targetClip_; }
+    
+    // ブレンドツリーを取得（レイヤー0は再生中・ブレンド先のクロスフェードに使用し、1以降を自由に追加できる）
+    AnimationBlendTree& GetBlendTree() { return blendTree_; }
+    const AnimationBlendTree& GetBlendTree() const { return blendTree_; }
+    
+    // ブレンドツリーを評価してジョイント番号順のポーズを書き込む（コンパイル済みクリップがなければfalse）
+    bool EvaluatePose(AnimationPose& outPose);
+
+    // EvaluatePoseで値が時間とともに変わるジョイントのoutFlagsを1にする（ルートモーションで書き換えるジョイントも含む）
+    // 戻り値は合成するクリップの組のハッシュ（AnimationBlendTree::MarkAnimatedJoints）
+    uint64_t MarkAnimatedJoints(std::span<uint8_t> outFlags) const;
+    
+    // ポーズが1つのクリップのサンプリングそのもの（クロスフェードや追加レイヤーなし）ならクリップと時刻を返す
+    // 同じクリップ・時刻のインスタンス間でポーズやパレットを共有するのに使う
+    bool GetSharablePose(const CompiledAnimationClip*& outClip, float& outTime) const;
+    
+    // スケルトンの親子関係とバインドポーズのハッシュ（同じモデルならパレットを共有できる）
+    uint64_t GetSkinHash() const { return skinHash_; }
+    
+    // 各ジョイントに重みを持つ頂点のバインドポーズでの範囲（パレットで変換してスキニング後の範囲を求める）
+    const std::vector<SkinnedBounds>& GetJointBounds() const { return jointBounds_; }
     
     // スケルトンを取得
     Skeleton& GetSkeleton() { return skeleton_; }
@@ -60,6 +98,10 @@ public:
     SkinCluster& GetSkinCluster() { return skinCluster_; }
     const SkinCluster& GetSkinCluster() const { return skinCluster_; }
     
+    // スキニングの方式（DualQuaternionを初めて選んだときにパレットのバッファを作る）
+    void SetSkinningMethod(SkinningMethod method);
+    SkinningMethod GetSkinningMethod() const { return skinningMethod_; }
+    
     // アニメーション再生制御
     void PlayAnimation();
     void StopAnimation();
@@ -69,6 +111,49 @@ public:
     // アニメーションの追加
     void AddAnimation(const std::string& name, const Animation& animation);
     
+    // アニメーションだけのアセットをこのモデルのスケルトンにリターゲットして追加する
+    // 対応表とバインドポーズの補正はスケルトンの組ごとにAnimationRetargetCacheで使い回す（対応するジョイントがなければfalse）
+    bool AddRetargetedAnimation(const std::string& name, const AnimationClipAsset& clip);
+    
+    // コンパイル済みクリップを圧縮する（有効にした後に追加したアニメーションも圧縮される）
+    void EnableAnimationCompression(const AnimationCompressionSettings& settings = {});
+    bool IsAnimationCompressionEnabled() const { return compressionSettings_.has_value(); }
+    
+    // コンパイル済みクリップが使用するキーのメモリ量（バイト）
+    size_t GetCompiledClipMemorySize() const;
+    
+    // 読み込み済みの全クリップのパレットを焼き込む（背景の群衆向け）
+    // 以降、1つのクリップを再生している間はサンプリングとスケルトンの評価を省いて表から読む
+    void BakeAnimations(float sampleRate = 30.0f, BakedPaletteFormat format = BakedPaletteFormat::Float3x4);
+    bool IsAnimationBaked() const { return bakedTable_.GetClipCount() > 0; }
+    const BakedAnimationTable& GetBakedAnimationTable() const { return bakedTable_; }
+    
+    // 現在のポーズに対応する焼き込み済みの行（焼き込んでいない、クロスフェード中、追加レイヤーがある場合はfalse）
+    bool GetBakedRow(uint32_t& outRow) const;
+    
+    // ルートモーション（jointNameのジョイントの移動をポーズから取り出してオブジェクトに移す）
+    // 読み込み済みのクリップと以降に追加したクリップごとに移動量の曲線を前計算する
+    // 有効な間はポーズが元のクリップと変わるため、インスタンス間のポーズ共有と焼き込み済みの表は使わない
+    bool EnableRootMotion(const std::string& jointName, const RootMotionSettings& settings = {});
+    void DisableRootMotion();
+    bool IsRootMotionEnabled() const { return rootMotionBinding_.IsValid(); }
+    
+    // 前回の取得からのルートの移動量を返してリセットする（クロスフェード中は2つのクリップの移動量を重みで合成する）
+    RootMotionDelta ConsumeRootMotion();
+    
+    // クリップのルートモーションの曲線（無効ならnullptr）
+    const RootMotionTrack* FindRootMotionTrack(const std::string& name) const;
+    
+    // アニメーションイベント（クリップの時刻に足音などを起こす）
+    // 読み込み済みのアニメーションにイベントを追加する（再生中のクリップにも反映される。見つからなければfalse）
+    bool AddAnimationEvent(const std::string& animationName, float time, uint32_t eventId, float payload = 0.0f);
+    
+    // イベントを受け取る関数を登録し、解除用のハンドルを返す（eventIdが0なら全てのイベントを受け取る）
+    // Updateの最後に、その更新で再生中・ブレンド先のクリップが通過したイベントを発生順に呼び出す
+    // リスナーの登録・解除はイベントの呼び出し中には行わない
+    uint32_t AddAnimationEventListener(uint32_t eventId, AnimationEventListener listener);
+    void RemoveAnimationEventListener(uint32_t handle);
+    
     // アニメーションの切り替え（即座）
     void ChangeAnimation(const std::string& name);
     
@@ -106,15 +191,24 @@ private:
     // assimpノードからアニメーションデータを作成
     void ProcessAssimpAnimation(const aiScene* scene);
     
+    // 読み込んだanimation_をプレイヤーに設定し、最初のアニメーションなら"default"として登録
+    void SetupImportedAnimation();
+    
    
-    Node ReadNode(aiNode* node);
-    Skeleton CreateSkeleton(const Node& rootNode);
-    int32_t CreateJoint(const Node& node, std::optional<int32_t> parent, std::vector<Joint>& joints);
     SkinCluster CreateSkinCluster();
+    void CreateDualQuaternionPalette();
+    
+    // アニメーションをスケルトンに結び付けてコンパイル（スケルトンがなければnullptr）
+    const CompiledAnimationClip* CompileAnimation(const std::string& name, const Animation& animation);
+    
+    // スケルトンの作成後にブレンドツリーを構築
+    void SetupBlendTree();
+    
+    // 名前からコンパイル済みクリップを検索（切り替え時のみ使用）
+    const CompiledAnimationClip* FindCompiledClip(const std::string& name) const;
 
     AnimationPlayer animationPlayer_;  // 現在のアニメーションプレイヤー
     AnimationPlayer targetPlayer_;     // ブレンド先のアニメーションプレイヤー
-    AnimationBlender animationBlender_; // アニメーションブレンダー（使用しない）
     Animation animation_;              // アニメーション格納するでーた　
     std::string rootNodeName_;         // ルートノード名
     
@@ -123,6 +217,41 @@ private:
     std::string currentAnimationName_;  // 現在のアニメーション名
     std::string targetAnimationName_;   // ブレンド先のアニメーション名
     
+    // スケルトンに結び付けたクリップ（名前はanimations_と共通）
+    std::unordered_map<std::string, CompiledAnimationClip> compiledClips_;
+    const CompiledAnimationClip* currentClip_ = nullptr;  // animationPlayer_のクリップ
+    const CompiledAnimationClip* targetClip_ = nullptr;   // targetPlayer_のクリップ
+    std::optional<AnimationCompressionSettings> compressionSettings_; // 圧縮の設定（無効ならnullopt）
+    
+    // 焼き込んだパレットの表と、コンパイル済みクリップから表のクリップ番号への対応
+    BakedAnimationTable bakedTable_;
+    std::unordered_map<const CompiledAnimationClip*, uint32_t> bakedClipIndices_;
+    
+    // ルートモーション（曲線の名前はanimations_と共通）
+    RootMotionBinding rootMotionBinding_;
+    std::unordered_map<std::string, RootMotionTrack> rootMotionTracks_;
+    RootMotionDelta rootMotionDelta_;  // ConsumeRootMotionまでに溜まった移動量
+    
+    // アニメーションイベント
+    struct EventListenerEntry {
+        uint32_t handle;
+        uint32_t eventId;  // 0なら全て
+        AnimationEventListener listener;
+    };
+    struct PendingEvent {
+        AnimationEvent event;
+        float weight;
+    };
+    std::vector<EventListenerEntry> eventListeners_;
+    std::vector<PendingEvent> pendingEvents_;  // Updateで集めて最後に呼び出す（呼び出し中の切り替えに備える）
+    uint32_t nextEventListenerHandle_ = 1;
+    
+    // ポーズの合成（レイヤー0のスロット0が現在、スロット1がブレンド先）
+    static const uint32_t kBaseLayer = 0;
+    static const uint32_t kCurrentSlot = 0;
+    static const uint32_t kTargetSlot = 1;
+    AnimationBlendTree blendTree_;
+    
     // ブレンド関連
     bool isBlending_ = false;          // ブレンド中かどうか
     float blendProgress_ = 0.0f;       // ブレンド進行度（0.0〜1.0）
@@ -132,6 +261,9 @@ private:
     // スキニング関連
     Skeleton skeleton_;                // スケルトン
     SkinCluster skinCluster_;          // スキンクラスター
+    uint64_t skinHash_ = 0;            // スキンのハッシュ
+    std::vector<SkinnedBounds> jointBounds_; // ジョイントごとのバインドポーズでの範囲
+    SkinningMethod skinningMethod_ = SkinningMethod::Linear; // スキニングの方式
     DirectXCommon* dxCommon_;          // DirectXCommon
     
     Assimp::Importer assimpImporter_;  // assimpインポーター
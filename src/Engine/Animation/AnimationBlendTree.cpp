@@ -0,0 +1,436 @@
+#include "AnimationBlendTree.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+// x64ではSSE2が常に使えるため、クォータニオン1つを1レジスタで処理する
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ANIMATION_BLEND_SSE2
+#endif
+
+namespace {
+    // Vector3の配列を連続したfloatとして扱う
+    static_assert(sizeof(Vector3) == sizeof(float) * 3, "Vector3 must be tightly packed");
+    static_assert(sizeof(Quaternion) == sizeof(float) * 4, "Quaternion must be tightly packed");
+
+    Quaternion Multiply(const Quaternion& a, const Quaternion& b) {
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        };
+    }
+
+    Quaternion Conjugate(const Quaternion& q) { return { -q.x, -q.y, -q.z, q.w }; }
+
+    // 正規化（長さが0に近ければ単位クォータニオン）
+    Quaternion NormalizeQuaternion(const Quaternion& q) {
+        float lengthSq = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+        if (lengthSq < 1.0e-12f) {
+            return { 0.0f, 0.0f, 0.0f, 1.0f };
+        }
+        float invLength = 1.0f / std::sqrt(lengthSq);
+        return { q.x * invLength, q.y * invLength, q.z * invLength, q.w * invLength };
+    }
+
+#ifdef ANIMATION_BLEND_SSE2
+    // 4成分の内積を全要素に入れる
+    __m128 Dot4(__m128 a, __m128 b) {
+        __m128 m = _mm_mul_ps(a, b);
+        __m128 s = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+
+    // bをaと同じ半球にそろえる（内積が負なら符号を反転）
+    __m128 AlignHemisphere(__m128 a, __m128 b) {
+        __m128 negative = _mm_cmplt_ps(Dot4(a, b), _mm_setzero_ps());
+        return _mm_xor_ps(b, _mm_and_ps(negative, _mm_set1_ps(-0.0f)));
+    }
+
+    __m128 Normalize4(__m128 q) {
+        __m128 lengthSq = Dot4(q, q);
+        __m128 valid = _mm_cmpgt_ps(lengthSq, _mm_set1_ps(1.0e-12f));
+        __m128 normalized = _mm_div_ps(q, _mm_sqrt_ps(_mm_max_ps(lengthSq, _mm_set1_ps(1.0e-12f))));
+        __m128 identity = _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f);
+        return _mm_or_ps(_mm_and_ps(valid, normalized), _mm_andnot_ps(valid, identity));
+    }
+#endif
+
+    // acc = acc + weight * q（qはaccと同じ半球にそろえる）
+    void AccumulateRotations(Quaternion* acc, const Quaternion* src, float weight, uint32_t count) {
+#ifdef ANIMATION_BLEND_SSE2
+        const __m128 w = _mm_set1_ps(weight);
+        for (uint32_t i = 0; i < count; ++i) {
+            __m128 a = _mm_loadu_ps(&acc[i].x);
+            __m128 q = AlignHemisphere(a, _mm_loadu_ps(&src[i].x));
+            _mm_storeu_ps(&acc[i].x, _mm_add_ps(a, _mm_mul_ps(q, w)));
+        }
+#else
+        for (uint32_t i = 0; i < count; ++i) {
+            const Quaternion& q = src[i];
+            float sign = (acc[i].x * q.x + acc[i].y * q.y + acc[i].z * q.z + acc[i].w * q.w) < 0.0f ? -weight : weight;
+            acc[i] = { acc[i].x + q.x * sign, acc[i].y + q.y * sign, acc[i].z + q.z * sign, acc[i].w + q.w * sign };
+        }
+#endif
+    }
+
+    void NormalizeRotations(Quaternion* rotations, uint32_t count) {
+#ifdef ANIMATION_BLEND_SSE2
+        for (uint32_t i = 0; i < count; ++i) {
+            _mm_storeu_ps(&rotations[i].x, Normalize4(_mm_loadu_ps(&rotations[i].x)));
+        }
+#else
+        for (uint32_t i = 0; i < count; ++i) {
+            rotations[i] = NormalizeQuaternion(rotations[i]);
+        }
+#endif
+    }
+
+    // dst = normalize(lerp(dst, src, weight * mask[i]))（maskがnullptrなら全ジョイントweight）
+    void NlerpRotations(Quaternion* dst, const Quaternion* src, float weight, const float* mask, uint32_t count) {
+#ifdef ANIMATION_BLEND_SSE2
+        for (uint32_t i = 0; i < count; ++i) {
+            float jointWeight = mask ? weight * mask[i] : weight;
+            if (jointWeight <= 0.0f) {
+                continue;
+            }
+            __m128 w = _mm_set1_ps(jointWeight);
+            __m128 a = _mm_loadu_ps(&dst[i].x);
+            __m128 b = AlignHemisphere(a, _mm_loadu_ps(&src[i].x));
+            _mm_storeu_ps(&dst[i].x, Normalize4(_mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), w))));
+        }
+#else
+        for (uint32_t i = 0; i < count; ++i) {
+            float jointWeight = mask ? weight * mask[i] : weight;
+            if (jointWeight <= 0.0f) {
+                continue;
+            }
+            const Quaternion& a = dst[i];
+            const Quaternion& b = src[i];
+            float sign = (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w) < 0.0f ? -1.0f : 1.0f;
+            dst[i] = NormalizeQuaternion({
+                a.x + (b.x * sign - a.x) * jointWeight,
+                a.y + (b.y * sign - a.y) * jointWeight,
+                a.z + (b.z * sign - a.z) * jointWeight,
+                a.w + (b.w * sign - a.w) * jointWeight,
+            });
+        }
+#endif
+    }
+
+    // dst = lerp(dst, src, weight * mask[i])
+    void LerpVectors(Vector3* dst, const Vector3* src, float weight, const float* mask, uint32_t count) {
+        if (!mask) {
+            // 連続したfloatとしてまとめて処理する（コンパイラの自動ベクトル化に任せる）
+            float* d = &dst[0].x;
+            const float* s = &src[0].x;
+            for (uint32_t i = 0; i < count * 3; ++i) {
+                d[i] += (s[i] - d[i]) * weight;
+            }
+            return;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            float jointWeight = weight * mask[i];
+            if (jointWeight > 0.0f) {
+                dst[i] = Lerp(dst[i], src[i], jointWeight);
+            }
+        }
+    }
+
+    // dst = dst + src * weight
+    void AccumulateVectors(Vector3* dst, const Vector3* src, float weight, uint32_t count) {
+        float* d = &dst[0].x;
+        const float* s = &src[0].x;
+        for (uint32_t i = 0; i < count * 3; ++i) {
+            d[i] += s[i] * weight;
+        }
+    }
+
+    void ScaleVectors(Vector3* values, float weight, uint32_t count) {
+        float* v = &values[0].x;
+        for (uint32_t i = 0; i < count * 3; ++i) {
+            v[i] *= weight;
+        }
+    }
+
+    void ScaleRotations(Quaternion* rotations, float weight, uint32_t count) {
+        float* v = &rotations[0].x;
+        for (uint32_t i = 0; i < count * 4; ++i) {
+            v[i] *= weight;
+        }
+    }
+
+    // 基準ポーズからの差分をweight * mask[i]だけ加える
+    void ApplyAdditivePose(AnimationPose& dst, const AnimationPose& sample, const AnimationPose& reference,
+        float weight, const float* mask) {
+
+        const Quaternion identity = { 0.0f, 0.0f, 0.0f, 1.0f };
+        for (uint32_t i = 0; i < dst.GetJointCount(); ++i) {
+            float w = mask ? weight * mask[i] : weight;
+            if (w <= 0.0f) {
+                continue;
+            }
+
+            // 移動は差分を加算
+            const Vector3& t = sample.translate[i];
+            const Vector3& tr = reference.translate[i];
+            dst.translate[i].x += (t.x - tr.x) * w;
+            dst.translate[i].y += (t.y - tr.y) * w;
+            dst.translate[i].z += (t.z - tr.z) * w;
+
+            // スケールは比を乗算
+            const Vector3& s = sample.scale[i];
+            const Vector3& sr = reference.scale[i];
+            dst.scale[i].x *= 1.0f + ((sr.x != 0.0f ? s.x / sr.x : 1.0f) - 1.0f) * w;
+            dst.scale[i].y *= 1.0f + ((sr.y != 0.0f ? s.y / sr.y : 1.0f) - 1.0f) * w;
+            dst.scale[i].z *= 1.0f + ((sr.z != 0.0f ? s.z / sr.z : 1.0f) - 1.0f) * w;
+
+            // 回転は基準からの相対回転を単位回転から補間して掛ける
+            Quaternion delta = Multiply(Conjugate(reference.rotate[i]), sample.rotate[i]);
+            NlerpRotations(&delta, &identity, 1.0f - w, nullptr, 1);
+            dst.rotate[i] = NormalizeQuaternion(Multiply(dst.rotate[i], delta));
+        }
+    }
+
+    void CopyPose(const AnimationPose& src, AnimationPose& dst) {
+        // 同じジョイント数なら確保済みの領域にコピーされる
+        dst.translate = src.translate;
+        dst.rotate = src.rotate;
+        dst.scale = src.scale;
+    }
+}
+
+void AnimationBlendTree::Initialize(const AnimationPose& restPose) {
+    restPose_ = restPose;
+    layers_.clear();
+    samplePose_.Resize(restPose_.GetJointCount());
+    layerPose_.Resize(restPose_.GetJointCount());
+}
+
+uint32_t AnimationBlendTree::AddLayer(BlendMode mode, uint32_t clipCount, float weight) {
+    Layer& layer = layers_.emplace_back();
+    layer.mode = mode;
+    layer.weight = weight;
+    layer.mask.assign(GetJointCount(), 1.0f);
+    layer.slots.resize(clipCount);
+    for (ClipSlot& slot : layer.slots) {
+        slot.cursors.reserve(static_cast<size_t>(GetJointCount()) * CompiledAnimationClip::kChannelCount);
+        if (mode == BlendMode::Additive) {
+            slot.referencePose.Resize(GetJointCount());
+        }
+    }
+    return static_cast<uint32_t>(layers_.size() - 1);
+}
+
+void AnimationBlendTree::SetLayerWeight(uint32_t layer, float weight) {
+    layers_[layer].weight = std::clamp(weight, 0.0f, 1.0f);
+}
+
+void AnimationBlendTree::SetLayerMask(uint32_t layer, const float* jointWeights) {
+    Layer& target = layers_[layer];
+    target.masked = jointWeights != nullptr;
+    ++maskVersion_;
+    if (jointWeights) {
+        std::copy(jointWeights, jointWeights + GetJointCount(), target.mask.begin());
+    } else {
+        std::fill(target.mask.begin(), target.mask.end(), 1.0f);
+    }
+}
+
+void AnimationBlendTree::SetClip(uint32_t layer, uint32_t slot, const CompiledAnimationClip* clip) {
+    Layer& target = layers_[layer];
+    ClipSlot& clipSlot = target.slots[slot];
+    clipSlot.clip = clip;
+    clipSlot.time = 0.0f;
+    clipSlot.cursors.assign(clip ? clip->GetCursorCount() : 0, KeyframeCursor{});
+
+    // 加算レイヤーは時刻0のポーズを基準にする
+    if (clip && target.mode == BlendMode::Additive && clip->GetJointCount() == GetJointCount()) {
+        clip->Sample(0.0f, clipSlot.referencePose);
+    }
+}
+
+void AnimationBlendTree::SetClipWeight(uint32_t layer, uint32_t slot, float weight) {
+    layers_[layer].slots[slot].weight = std::max(weight, 0.0f);
+}
+
+void AnimationBlendTree::SetClipTime(uint32_t layer, uint32_t slot, float time) {
+    layers_[layer].slots[slot].time = time;
+}
+
+void AnimationBlendTree::SetClipLoop(uint32_t layer, uint32_t slot, bool loop) {
+    layers_[layer].slots[slot].loop = loop;
+}
+
+void AnimationBlendTree::SwapClips(uint32_t layer, uint32_t slotA, uint32_t slotB) {
+    std::swap(layers_[layer].slots[slotA], layers_[layer].slots[slotB]);
+}
+
+void AnimationBlendTree::Update(float deltaTime) {
+    for (Layer& layer : layers_) {
+        for (ClipSlot& slot : layer.slots) {
+            if (!slot.clip) {
+                continue;
+            }
+            float duration = slot.clip->GetDuration();
+            slot.time += deltaTime;
+            if (slot.loop && duration > 0.0f) {
+                slot.time = std::fmod(slot.time, duration);
+            } else {
+                slot.time = std::min(slot.time, duration);
+            }
+        }
+    }
+}
+
+bool AnimationBlendTree::IsActive(const ClipSlot& slot) const {
+    return slot.clip && slot.weight > 0.0f && slot.clip->GetJointCount() == GetJointCount();
+}
+
+bool AnimationBlendTree::EvaluateOverrideLayer(Layer& layer) {
+    float totalWeight = 0.0f;
+    uint32_t activeCount = 0;
+    for (const ClipSlot& slot : layer.slots) {
+        if (IsActive(slot)) {
+            totalWeight += slot.weight;
+            ++activeCount;
+        }
+    }
+    if (activeCount == 0) {
+        return false;
+    }
+
+    const uint32_t jointCount = GetJointCount();
+    bool first = true;
+    for (ClipSlot& slot : layer.slots) {
+        if (!IsActive(slot)) {
+            continue;
+        }
+
+        // 1つだけならそのまま書き込む
+        if (activeCount == 1) {
+            slot.clip->Sample(slot.time, layerPose_, slot.cursors.data());
+            return true;
+        }
+
+        float weight = slot.weight / totalWeight;
+        if (first) {
+            slot.clip->Sample(slot.time, layerPose_, slot.cursors.data());
+            ScaleVectors(layerPose_.translate.data(), weight, jointCount);
+            ScaleRotations(layerPose_.rotate.data(), weight, jointCount);
+            ScaleVectors(layerPose_.scale.data(), weight, jointCount);
+            first = false;
+        } else {
+            slot.clip->Sample(slot.time, samplePose_, slot.cursors.data());
+            AccumulateVectors(layerPose_.translate.data(), samplePose_.translate.data(), weight, jointCount);
+            AccumulateRotations(layerPose_.rotate.data(), samplePose_.rotate.data(), weight, jointCount);
+            AccumulateVectors(layerPose_.scale.data(), samplePose_.scale.data(), weight, jointCount);
+        }
+    }
+    NormalizeRotations(layerPose_.rotate.data(), jointCount);
+    return true;
+}
+
+void AnimationBlendTree::Evaluate(AnimationPose& outPose) {
+    const uint32_t jointCount = GetJointCount();
+    CopyPose(restPose_, outPose);
+
+    for (Layer& layer : layers_) {
+        if (layer.weight <= 0.0f) {
+            continue;
+        }
+        const float* mask = layer.masked ? layer.mask.data() : nullptr;
+
+        if (layer.mode == BlendMode::Override) {
+            if (!EvaluateOverrideLayer(layer)) {
+                continue;
+            }
+            if (layer.weight >= 1.0f && !mask) {
+                std::swap(layerPose_, outPose);
+            } else {
+                LerpVectors(outPose.translate.data(), layerPose_.translate.data(), layer.weight, mask, jointCount);
+                NlerpRotations(outPose.rotate.data(), layerPose_.rotate.data(), layer.weight, mask, jointCount);
+                LerpVectors(outPose.scale.data(), layerPose_.scale.data(), layer.weight, mask, jointCount);
+            }
+        } else {
+            for (ClipSlot& slot : layer.slots) {
+                if (!IsActive(slot)) {
+                    continue;
+                }
+                slot.clip->Sample(slot.time, samplePose_, slot.cursors.data());
+                ApplyAdditivePose(outPose, samplePose_, slot.referencePose, layer.weight * slot.weight, mask);
+            }
+        }
+    }
+}
+
+uint64_t AnimationBlendTree::MarkAnimatedJoints(std::span<uint8_t> outFlags) const {
+    const uint32_t jointCount = GetJointCount();
+    assert(outFlags.size() >= jointCount);
+    uint64_t hash = HashBytes(&maskVersion_, sizeof(maskVersion_));
+    for (const Layer& layer : layers_) {
+        hash = HashBytes(&layer.weight, sizeof(layer.weight), hash);
+        if (layer.weight <= 0.0f) {
+            continue;
+        }
+        for (const ClipSlot& slot : layer.slots) {
+            if (!IsActive(slot)) {
+                continue;
+            }
+            hash = HashBytes(&slot.clip, sizeof(slot.clip), hash);
+            hash = HashBytes(&slot.weight, sizeof(slot.weight), hash);
+            const std::vector<uint8_t>& animated = slot.clip->GetAnimatedJoints();
+            for (uint32_t joint = 0; joint < jointCount; ++joint) {
+                outFlags[joint] |= animated[joint];
+            }
+        }
+    }
+    return hash;
+}
+
+bool AnimationBlendTree::GetSingleClip(const CompiledAnimationClip*& outClip, float& outTime) const {
+    const ClipSlot* single = nullptr;
+    for (const Layer& layer : layers_) {
+        if (layer.weight <= 0.0f) {
+            continue;
+        }
+        for (const ClipSlot& slot : layer.slots) {
+            if (!IsActive(slot)) {
+                continue;
+            }
+            if (single || layer.mode != BlendMode::Override || layer.weight < 1.0f || layer.masked) {
+                return false;
+            }
+            single = &slot;
+        }
+    }
+    if (!single) {
+        return false;
+    }
+    outClip = single->clip;
+    outTime = single->time;
+    return true;
+}
+
+std::vector<float> MakeBoneMask(const Skeleton& skeleton, const std::string& rootJointName, float weight) {
+    std::vector<float> mask(skeleton.joints.size(), 0.0f);
+    auto it = skeleton.jointMap.find(rootJointName);
+    if (it == skeleton.jointMap.end()) {
+        return mask;
+    }
+
+    // 子孫をたどって重みを設定
+    std::vector<int32_t> stack = { it->second };
+    while (!stack.empty()) {
+        int32_t index = stack.back();
+        stack.pop_back();
+        mask[index] = weight;
+        for (int32_t child : skeleton.joints[index].children) {
+            stack.push_back(child);
+        }
+    }
+    return mask;
+}
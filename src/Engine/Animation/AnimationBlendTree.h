@@ -0,0 +1,98 @@
+#pragma once
+#include "CompiledAnimationClip.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// ポーズバッファを使ったN層のアニメーションブレンド
+// レイヤーを上から順に重ね、各レイヤーは複数のクリップを重み付きで合成する
+// - Override: レイヤー内のクリップを重みで正規化して合成し、下の結果にレイヤーの重みで補間する
+// - Additive: クリップの基準ポーズ（時刻0）からの差分を下の結果に加える
+// 作業用のポーズとカーソルはAddLayer/SetClipの時点で確保し、Evaluateでは確保しない
+class AnimationBlendTree {
+public:
+    // レイヤーの合成方法
+    enum class BlendMode {
+        Override,
+        Additive,
+    };
+
+    // 初期化（ポーズに含まれないジョイントやクリップのないジョイントにはrestPoseを使う）
+    void Initialize(const AnimationPose& restPose);
+
+    // レイヤーを追加して番号を返す（clipCountはレイヤー内で同時に合成するクリップの数）
+    uint32_t AddLayer(BlendMode mode, uint32_t clipCount, float weight = 1.0f);
+
+    // レイヤーの重み（0で無効）
+    void SetLayerWeight(uint32_t layer, float weight);
+    float GetLayerWeight(uint32_t layer) const { return layers_[layer].weight; }
+
+    // ジョイントごとの重み（jointWeightsはジョイント数分、nullptrで全ジョイント1）
+    void SetLayerMask(uint32_t layer, const float* jointWeights);
+
+    // クリップの設定（時刻とカーソルはリセットされる。nullptrで空きにする）
+    void SetClip(uint32_t layer, uint32_t slot, const CompiledAnimationClip* clip);
+    void SetClipWeight(uint32_t layer, uint32_t slot, float weight);
+    void SetClipTime(uint32_t layer, uint32_t slot, float time);
+    void SetClipLoop(uint32_t layer, uint32_t slot, bool loop);
+
+    // 同じレイヤー内の2つのクリップを入れ替える（クロスフェード完了時など）
+    void SwapClips(uint32_t layer, uint32_t slotA, uint32_t slotB);
+
+    const CompiledAnimationClip* GetClip(uint32_t layer, uint32_t slot) const { return layers_[layer].slots[slot].clip; }
+    float GetClipWeight(uint32_t layer, uint32_t slot) const { return layers_[layer].slots[slot].weight; }
+    float GetClipTime(uint32_t layer, uint32_t slot) const { return layers_[layer].slots[slot].time; }
+
+    // 全クリップの時刻を進める
+    void Update(float deltaTime);
+
+    // 全レイヤーを合成したポーズを書き込む（jointCount × 有効なクリップ数に比例）
+    void Evaluate(AnimationPose& outPose);
+
+    // 合成結果が1つのクリップのサンプリングそのものになる場合（有効なクリップが1つで、
+    // 重み1のマスクなしOverrideレイヤーにある場合）にそのクリップと時刻を返す
+    bool GetSingleClip(const CompiledAnimationClip*& outClip, float& outTime) const;
+
+    // 有効なクリップのどれかで値が時間とともに変わるジョイントのoutFlagsを1にする（outFlagsはジョイント数分）
+    // 戻り値は有効なクリップ・重み・マスクの組のハッシュ。これが変わったフレームは静的なジョイントの合成結果も変わりうる
+    uint64_t MarkAnimatedJoints(std::span<uint8_t> outFlags) const;
+
+    uint32_t GetJointCount() const { return restPose_.GetJointCount(); }
+    uint32_t GetLayerCount() const { return static_cast<uint32_t>(layers_.size()); }
+    uint32_t GetClipCount(uint32_t layer) const { return static_cast<uint32_t>(layers_[layer].slots.size()); }
+
+private:
+    // レイヤー内の1クリップ
+    struct ClipSlot {
+        const CompiledAnimationClip* clip = nullptr;
+        float time = 0.0f;
+        float weight = 0.0f;
+        bool loop = true;
+        std::vector<KeyframeCursor> cursors;
+        AnimationPose referencePose;  // Additiveの基準ポーズ
+    };
+
+    struct Layer {
+        BlendMode mode = BlendMode::Override;
+        float weight = 1.0f;
+        bool masked = false;
+        std::vector<float> mask;
+        std::vector<ClipSlot> slots;
+    };
+
+    // クリップをジョイント数が合うものだけ有効とする
+    bool IsActive(const ClipSlot& slot) const;
+
+    // Overrideレイヤーのクリップを合成してlayerPose_に書き込む（有効なクリップがなければfalse）
+    bool EvaluateOverrideLayer(Layer& layer);
+
+    std::vector<Layer> layers_;
+    uint32_t maskVersion_ = 0;  // SetLayerMaskのたびに増やす（MarkAnimatedJointsのハッシュに含める）
+    AnimationPose restPose_;
+    AnimationPose samplePose_;
+    AnimationPose layerPose_;
+};
+
+// rootJointName以下のジョイントをweight、それ以外を0にしたマスクを作成
+std::vector<float> MakeBoneMask(const Skeleton& skeleton, const std::string& rootJointName, float weight = 1.0f);
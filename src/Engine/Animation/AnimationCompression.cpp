@@ -0,0 +1,158 @@
+#include "AnimationCompression.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+    // smallest-threeで残す3成分の範囲は[-1/√2, 1/√2]
+    const float kComponentRange = 0.70710678f;
+    const uint32_t kComponentBits = 15;
+    const uint32_t kComponentMax = (1u << kComponentBits) - 1;
+
+    uint32_t QuantizeComponent(float value) {
+        float normalized = (value / kComponentRange) * 0.5f + 0.5f;
+        float scaled = std::round(std::clamp(normalized, 0.0f, 1.0f) * static_cast<float>(kComponentMax));
+        return static_cast<uint32_t>(scaled);
+    }
+
+    float DequantizeComponent(uint32_t value) {
+        return (static_cast<float>(value) / static_cast<float>(kComponentMax) * 2.0f - 1.0f) * kComponentRange;
+    }
+
+    uint16_t QuantizeUnit(float value, float min, float step) {
+        if (step <= 0.0f) {
+            return 0;
+        }
+        float scaled = std::round((value - min) / step);
+        return static_cast<uint16_t>(std::clamp(scaled, 0.0f, 65535.0f));
+    }
+
+    // 先頭と末尾の間を補間で埋められるキーを捨てる
+    template <typename Value, typename Interpolate>
+    std::vector<uint32_t> SelectKeysImpl(const float* times, const Value* values, const Value* decoded,
+        uint32_t count, float tolerance, uint32_t maxKeySpan, Interpolate interpolate) {
+
+        std::vector<uint32_t> keys;
+        if (count == 0) {
+            return keys;
+        }
+        keys.push_back(0);
+
+        // 全体が一定ならキー1つにする
+        bool constant = true;
+        for (uint32_t i = 0; i < count && constant; ++i) {
+            constant = CalculateMaxError(decoded[0], values[i]) <= tolerance;
+        }
+        if (constant || count == 1) {
+            return keys;
+        }
+
+        // anchorからendまでを直接補間して、間のキーがすべて許容誤差内なら次のendを試す
+        uint32_t anchor = 0;
+        for (uint32_t end = 2; end < count; ++end) {
+            bool reducible = end - anchor <= maxKeySpan && times[end] > times[anchor];
+            float duration = times[end] - times[anchor];
+            for (uint32_t i = anchor + 1; i < end && reducible; ++i) {
+                float t = (times[i] - times[anchor]) / duration;
+                reducible = CalculateMaxError(interpolate(decoded[anchor], decoded[end], t), values[i]) <= tolerance;
+            }
+            if (!reducible) {
+                anchor = end - 1;
+                keys.push_back(anchor);
+            }
+        }
+        keys.push_back(count - 1);
+        return keys;
+    }
+}
+
+PackedQuaternion PackQuaternion(const Quaternion& quaternion) {
+    float components[4] = { quaternion.x, quaternion.y, quaternion.z, quaternion.w };
+
+    // 絶対値が最大の成分を探し、それが正になるように符号をそろえる（q と -q は同じ回転）
+    uint32_t largest = 0;
+    for (uint32_t i = 1; i < 4; ++i) {
+        if (std::fabs(components[i]) > std::fabs(components[largest])) {
+            largest = i;
+        }
+    }
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint64_t bits = largest;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (i != largest) {
+            bits = (bits << kComponentBits) | QuantizeComponent(components[i] * sign);
+        }
+    }
+
+    PackedQuaternion packed;
+    packed.data[0] = static_cast<uint16_t>(bits >> 32);
+    packed.data[1] = static_cast<uint16_t>(bits >> 16);
+    packed.data[2] = static_cast<uint16_t>(bits);
+    return packed;
+}
+
+Quaternion UnpackQuaternion(const PackedQuaternion& packed) {
+    uint64_t bits = (static_cast<uint64_t>(packed.data[0]) << 32) |
+        (static_cast<uint64_t>(packed.data[1]) << 16) | static_cast<uint64_t>(packed.data[2]);
+    uint32_t largest = static_cast<uint32_t>(bits >> (kComponentBits * 3)) & 3u;
+
+    float components[4];
+    float sumSq = 0.0f;
+    uint32_t shift = kComponentBits * 3;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (i == largest) {
+            continue;
+        }
+        shift -= kComponentBits;
+        components[i] = DequantizeComponent(static_cast<uint32_t>(bits >> shift) & kComponentMax);
+        sumSq += components[i] * components[i];
+    }
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSq));
+    return { components[0], components[1], components[2], components[3] };
+}
+
+QuantizationRange MakeQuantizationRange(const Vector3* values, uint32_t count) {
+    assert(count > 0);
+    Vector3 min = values[0];
+    Vector3 max = values[0];
+    for (uint32_t i = 1; i < count; ++i) {
+        min = { std::min(min.x, values[i].x), std::min(min.y, values[i].y), std::min(min.z, values[i].z) };
+        max = { std::max(max.x, values[i].x), std::max(max.y, values[i].y), std::max(max.z, values[i].z) };
+    }
+
+    QuantizationRange range;
+    range.min = min;
+    range.step = { (max.x - min.x) / 65535.0f, (max.y - min.y) / 65535.0f, (max.z - min.z) / 65535.0f };
+    return range;
+}
+
+PackedVector3 PackVector3(const Vector3& value, const QuantizationRange& range) {
+    return {
+        QuantizeUnit(value.x, range.min.x, range.step.x),
+        QuantizeUnit(value.y, range.min.y, range.step.y),
+        QuantizeUnit(value.z, range.min.z, range.step.z),
+    };
+}
+
+std::vector<uint32_t> SelectKeys(const float* times, const Vector3* values, const Vector3* decoded,
+    uint32_t count, float tolerance, uint32_t maxKeySpan) {
+    return SelectKeysImpl(times, values, decoded, count, tolerance, maxKeySpan,
+        [](const Vector3& a, const Vector3& b, float t) { return Lerp(a, b, t); });
+}
+
+std::vector<uint32_t> SelectKeys(const float* times, const Quaternion* values, const Quaternion* decoded,
+    uint32_t count, float tolerance, uint32_t maxKeySpan) {
+    return SelectKeysImpl(times, values, decoded, count, tolerance, maxKeySpan,
+        [](const Quaternion& a, const Quaternion& b, float t) { return Slerp(a, b, t); });
+}
+
+float CalculateMaxError(const Vector3& a, const Vector3& b) {
+    return std::max({ std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z) });
+}
+
+float CalculateMaxError(const Quaternion& a, const Quaternion& b) {
+    float sign = (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w) < 0.0f ? -1.0f : 1.0f;
+    return std::max({ std::fabs(a.x - b.x * sign), std::fabs(a.y - b.y * sign),
+        std::fabs(a.z - b.z * sign), std::fabs(a.w - b.w * sign) });
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "AnimationData.h"
+#include <cstdint>
+#include <vector>
+
+// 48bitに量子化したクォータニオン（smallest-three）
+// 絶対値が最大の成分を捨てて番号（2bit）だけ残し、残り3成分を15bitずつに詰める
+struct PackedQuaternion {
+    uint16_t data[3];
+};
+
+// トラックの値の範囲に対して16bitずつに量子化したVector3
+struct PackedVector3 {
+    uint16_t x;
+    uint16_t y;
+    uint16_t z;
+};
+
+// Vector3の量子化範囲（value = min + packed * step）
+struct QuantizationRange {
+    Vector3 min;
+    Vector3 step;
+};
+
+// 圧縮の設定
+struct AnimationCompressionSettings {
+    // 間引いたキーを補間で復元したときに許す誤差（成分ごとの絶対値）
+    float translateTolerance = 1.0e-4f;
+    float rotateTolerance = 2.0e-4f;
+    float scaleTolerance = 1.0e-4f;
+    // 補間でつなぐ区間の最大キー数（圧縮にかかる時間を抑える）
+    uint32_t maxKeySpan = 256;
+};
+
+// クォータニオンの量子化・復元（復元結果は元と符号が反転していることがある）
+PackedQuaternion PackQuaternion(const Quaternion& quaternion);
+Quaternion UnpackQuaternion(const PackedQuaternion& packed);
+
+// 値の配列から量子化範囲を作成
+QuantizationRange MakeQuantizationRange(const Vector3* values, uint32_t count);
+
+// Vector3の量子化・復元
+PackedVector3 PackVector3(const Vector3& value, const QuantizationRange& range);
+inline Vector3 UnpackVector3(const PackedVector3& packed, const QuantizationRange& range) {
+    return {
+        range.min.x + static_cast<float>(packed.x) * range.step.x,
+        range.min.y + static_cast<float>(packed.y) * range.step.y,
+        range.min.z + static_cast<float>(packed.z) * range.step.z,
+    };
+}
+
+// 残すキーの番号を選ぶ（先頭と末尾は常に残す。全キーが許容誤差内で一定なら先頭の1つだけ）
+// decodedは量子化後に復元した値で、間のキーをdecodedの補間で復元した誤差がtolerance以内なら捨てる
+std::vector<uint32_t> SelectKeys(const float* times, const Vector3* values, const Vector3* decoded,
+    uint32_t count, float tolerance, uint32_t maxKeySpan);
+std::vector<uint32_t> SelectKeys(const float* times, const Quaternion* values, const Quaternion* decoded,
+    uint32_t count, float tolerance, uint32_t maxKeySpan);
+
+// 成分ごとの差の最大値（クォータニオンは符号をそろえて比較する）
+float CalculateMaxError(const Vector3& a, const Vector3& b);
+float CalculateMaxError(const Quaternion& a, const Quaternion& b);
@@ -0,0 +1,52 @@
+#include "AnimationEvent.h"
+#include <algorithm>
+
+uint32_t MakeAnimationEventId(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void AnimationEventTrack::Add(float time, uint32_t id, float payload) {
+    size_t index = std::upper_bound(times_.begin(), times_.end(), time) - times_.begin();
+    times_.insert(times_.begin() + index, time);
+    ids_.insert(ids_.begin() + index, id);
+    payloads_.insert(payloads_.begin() + index, payload);
+}
+
+void AnimationEventTrack::Clear() {
+    times_.clear();
+    ids_.clear();
+    payloads_.clear();
+}
+
+void AnimationEventTrack::Collect(float fromTime, float toTime, bool includeEnd, std::vector<AnimationEvent>& out) const {
+    auto first = std::lower_bound(times_.begin(), times_.end(), fromTime);
+    auto last = includeEnd ? std::upper_bound(first, times_.end(), toTime) : std::lower_bound(first, times_.end(), toTime);
+    for (auto it = first; it != last; ++it) {
+        size_t index = it - times_.begin();
+        out.push_back({ times_[index], ids_[index], payloads_[index] });
+    }
+}
+
+void AnimationEventTrack::CollectPlayed(float fromTime, float toTime, uint32_t loopCount, float duration, bool reachedEnd,
+    std::vector<AnimationEvent>& out) const {
+
+    if (times_.empty()) {
+        return;
+    }
+    if (loopCount == 0) {
+        Collect(fromTime, toTime, reachedEnd, out);
+        return;
+    }
+
+    // 終端まで・途中の完全なループ・先頭から現在まで
+    Collect(fromTime, duration, true, out);
+    for (uint32_t loop = 1; loop < loopCount; ++loop) {
+        Collect(0.0f, duration, true, out);
+    }
+    Collect(0.0f, toTime, false, out);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// アニメーションイベント（足音・攻撃判定などクリップの特定の時刻に起こすもの）
+struct AnimationEvent {
+    float time = 0.0f;     // 発生時刻（秒）
+    uint32_t id = 0;       // イベントの種類（MakeAnimationEventIdで名前から作る）
+    float payload = 0.0f;  // 付随する値（音量・ダメージ量など）
+};
+
+// イベント名からidを作る（32bit FNV-1a）
+uint32_t MakeAnimationEventId(std::string_view name);
+
+// クリップのイベント列（時刻順に並べた配列）
+// 時刻・id・値を別々の連続した配列に持ち、区間の検索は時刻の配列の二分探索だけで行う
+class AnimationEventTrack {
+public:
+    // 時刻順の位置に挿入する（同じ時刻は追加した順）
+    void Add(float time, uint32_t id, float payload = 0.0f);
+
+    void Clear();
+
+    // [fromTime, toTime)の区間のイベントをoutに追加する（includeEndならtoTimeちょうども含める）
+    // 検索は二分探索で、区間内のイベント数に比例する分だけコピーする
+    void Collect(float fromTime, float toTime, bool includeEnd, std::vector<AnimationEvent>& out) const;
+
+    // fromTimeからtoTimeまで再生したときに通過するイベントをoutに発生順で追加する
+    // loopCountは終端を越えた回数。終端の時刻のイベントは越えたときに、0のイベントは先頭から再生したときに起こす
+    // reachedEndはループしないクリップが終端で止まった場合（終端の時刻のイベントも起こす）
+    void CollectPlayed(float fromTime, float toTime, uint32_t loopCount, float duration, bool reachedEnd,
+        std::vector<AnimationEvent>& out) const;
+
+    bool IsEmpty() const { return times_.empty(); }
+    size_t GetCount() const { return times_.size(); }
+    AnimationEvent Get(size_t index) const { return { times_[index], ids_[index], payloads_[index] }; }
+
+private:
+    std::vector<float> times_;
+    std::vector<uint32_t> ids_;
+    std::vector<float> payloads_;
+};
@@ -0,0 +1,291 @@
+#include "AnimationIk.h"
+#include "SkeletonUpdate.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+    // クォータニオン（x, y, z, w）。スケルトン空間の回転は親の回転 * ローカルの回転
+    Quaternion Multiply(const Quaternion& a, const Quaternion& b) {
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        };
+    }
+
+    Quaternion Conjugate(const Quaternion& q) { return { -q.x, -q.y, -q.z, q.w }; }
+
+    Quaternion MakeAxisAngle(const Vector3& axis, float angle) {
+        float s = std::sin(angle * 0.5f);
+        return { axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f) };
+    }
+
+    float Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    Vector3 Cross(const Vector3& a, const Vector3& b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    float Length(const Vector3& v) { return std::sqrt(Dot(v, v)); }
+
+    // 長さが0に近ければfallbackを返す
+    Vector3 NormalizeOr(const Vector3& v, const Vector3& fallback) {
+        float length = Length(v);
+        return length > 1.0e-6f ? v / length : fallback;
+    }
+
+    float SafeAcos(float x) { return std::acos(std::clamp(x, -1.0f, 1.0f)); }
+
+    Vector3 Rotate(const Quaternion& q, const Vector3& v) {
+        Vector3 u = { q.x, q.y, q.z };
+        Vector3 t = Cross(u, v) * 2.0f;
+        return v + t * q.w + Cross(u, t);
+    }
+
+    // 点を行ベクトル規約の行列で変換
+    Vector3 TransformPoint(const Vector3& point, const Matrix4x4& m) {
+        return {
+            point.x * m.m[0][0] + point.y * m.m[1][0] + point.z * m.m[2][0] + m.m[3][0],
+            point.x * m.m[0][1] + point.y * m.m[1][1] + point.z * m.m[2][1] + m.m[3][1],
+            point.x * m.m[0][2] + point.y * m.m[1][2] + point.z * m.m[2][2] + m.m[3][2],
+        };
+    }
+
+    // ジョイントのスケルトン空間の位置と回転（スケールは各軸同じ前提で回転には含めない）
+    struct JointFrame {
+        Vector3 position;
+        Quaternion rotate;
+    };
+
+    // ルートから連鎖をたどり、offsetsの位置のジョイントの姿勢を求める
+    template <size_t N>
+    void CalculateFrames(const AnimationPose& pose, const std::vector<int32_t>& chain, const uint32_t (&offsets)[N], JointFrame (&out)[N]) {
+        Matrix4x4 matrix = MakeIdentity4x4();
+        Quaternion rotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+        size_t next = 0;
+        for (uint32_t i = 0; i < chain.size() && next < N; ++i) {
+            int32_t joint = chain[i];
+            matrix = Multiply(MakeAffineMatrix(pose.scale[joint], pose.rotate[joint], pose.translate[joint]), matrix);
+            rotate = Multiply(rotate, pose.rotate[joint]);
+            while (next < N && offsets[next] == i) {
+                out[next++] = { { matrix.m[3][0], matrix.m[3][1], matrix.m[3][2] }, rotate };
+            }
+        }
+    }
+
+    // スケルトン空間で加える回転deltaを、スケルトン空間の回転がframeRotateのジョイントのローカルの回転に掛ける
+    Quaternion ApplyModelRotation(const Quaternion& local, const Quaternion& frameRotate, const Quaternion& delta) {
+        return Normalize(Multiply(local, Multiply(Conjugate(frameRotate), Multiply(delta, frameRotate))));
+    }
+
+    // ルートから指定したジョイントまでの連鎖（親が先）
+    std::vector<int32_t> BuildChain(const Skeleton& skeleton, int32_t joint) {
+        std::vector<int32_t> chain;
+        for (std::optional<int32_t> current = joint; current; current = skeleton.joints[*current].parent) {
+            chain.push_back(*current);
+        }
+        std::reverse(chain.begin(), chain.end());
+        return chain;
+    }
+}
+
+bool TwoBoneIkSolver::Initialize(const Skeleton& skeleton, int32_t upper, int32_t middle, int32_t end) {
+    upper_ = middle_ = end_ = -1;
+    chain_.clear();
+    int32_t jointCount = static_cast<int32_t>(skeleton.joints.size());
+    if (upper < 0 || middle < 0 || end < 0 || upper >= jointCount || middle >= jointCount || end >= jointCount) {
+        return false;
+    }
+
+    // endからたどってmiddle・upperの順に現れること
+    std::vector<int32_t> chain = BuildChain(skeleton, end);
+    auto middleIt = std::find(chain.begin(), chain.end(), middle);
+    auto upperIt = std::find(chain.begin(), middleIt, upper);
+    if (middleIt == chain.end() || upperIt == middleIt || middle == end) {
+        return false;
+    }
+    upperOffset_ = static_cast<uint32_t>(upperIt - chain.begin());
+    middleOffset_ = static_cast<uint32_t>(middleIt - chain.begin());
+    chain_ = std::move(chain);
+    upper_ = upper;
+    middle_ = middle;
+    end_ = end;
+    return true;
+}
+
+Vector3 TwoBoneIkSolver::CalculateEndPosition(const AnimationPose& pose) const {
+    const uint32_t offsets[] = { static_cast<uint32_t>(chain_.size()) - 1 };
+    JointFrame frames[1];
+    CalculateFrames(pose, chain_, offsets, frames);
+    return frames[0].position;
+}
+
+void TwoBoneIkSolver::Solve(AnimationPose& pose, const Vector3& target, float weight, const Vector3* pole) const {
+    if (end_ < 0 || weight <= 0.0f) {
+        return;
+    }
+    assert(static_cast<uint32_t>(end_) < pose.GetJointCount());
+
+    const uint32_t offsets[] = { upperOffset_, middleOffset_, static_cast<uint32_t>(chain_.size()) - 1 };
+    JointFrame frames[3];
+    CalculateFrames(pose, chain_, offsets, frames);
+    const Vector3& a = frames[0].position;
+    const Vector3& b = frames[1].position;
+    const Vector3& c = frames[2].position;
+
+    // 届く範囲に収めた目標までの距離（伸ばしきると向きが決まらないので少しだけ曲げておく）
+    float lab = Length(b - a);
+    float lcb = Length(b - c);
+    float lat = std::clamp(Length(target - a), std::fabs(lab - lcb) + 1.0e-4f, (lab + lcb) * 0.9999f);
+
+    Vector3 ac = NormalizeOr(c - a, { 0.0f, -1.0f, 0.0f });
+    Vector3 ab = NormalizeOr(b - a, ac);
+    Vector3 cb = NormalizeOr(b - c, ac);
+    Vector3 at = NormalizeOr(target - a, ac);
+
+    // 今の角度と、余弦定理で求めた目標の距離での角度
+    float acAb0 = SafeAcos(Dot(ac, ab));
+    float baBc0 = SafeAcos(Dot(ab * -1.0f, cb * -1.0f));
+    float acAt0 = SafeAcos(Dot(ac, at));
+    float acAb1 = SafeAcos((lcb * lcb - lab * lab - lat * lat) / (-2.0f * lab * lat));
+    float baBc1 = SafeAcos((lat * lat - lab * lab - lcb * lcb) / (-2.0f * lab * lcb));
+
+    // 曲げる軸は今の曲がる面の法線（まっすぐならポール、それもなければ適当な水平軸）
+    Vector3 fallbackAxis = NormalizeOr(Cross(ac, { 0.0f, 1.0f, 0.0f }), { 1.0f, 0.0f, 0.0f });
+    if (pole) {
+        fallbackAxis = NormalizeOr(Cross(ac, *pole - a), fallbackAxis);
+    }
+    Vector3 axis0 = NormalizeOr(Cross(ac, ab), fallbackAxis);
+    Vector3 axis1 = NormalizeOr(Cross(ac, at), axis0);
+
+    // upper: 曲げてaからcまでの距離を合わせ、acを目標に向ける / middle: 内角を合わせる
+    Quaternion bendUpper = MakeAxisAngle(axis0, acAb1 - acAb0);
+    Quaternion bendMiddle = MakeAxisAngle(axis0, baBc1 - baBc0);
+    Quaternion swing = MakeAxisAngle(axis1, acAt0);
+    Quaternion upperDelta = Multiply(swing, bendUpper);
+
+    // ポールがあれば、目標への軸まわりにひねってmiddleをポールの側に向ける
+    if (pole) {
+        Vector3 axis = at;
+        Vector3 solvedMiddle = Rotate(upperDelta, b - a);
+        Vector3 fromDir = solvedMiddle - axis * Dot(solvedMiddle, axis);
+        Vector3 toDir = (*pole - a) - axis * Dot(*pole - a, axis);
+        if (Length(fromDir) > 1.0e-6f && Length(toDir) > 1.0e-6f) {
+            fromDir = NormalizeOr(fromDir, axis);
+            toDir = NormalizeOr(toDir, axis);
+            float angle = std::atan2(Dot(Cross(fromDir, toDir), axis), Dot(fromDir, toDir));
+            upperDelta = Multiply(MakeAxisAngle(axis, angle), upperDelta);
+        }
+    }
+
+    Quaternion upperRotate = ApplyModelRotation(pose.rotate[upper_], frames[0].rotate, upperDelta);
+    Quaternion middleRotate = ApplyModelRotation(pose.rotate[middle_], frames[1].rotate, bendMiddle);
+    if (weight < 1.0f) {
+        upperRotate = Slerp(pose.rotate[upper_], upperRotate, weight);
+        middleRotate = Slerp(pose.rotate[middle_], middleRotate, weight);
+    }
+    pose.rotate[upper_] = upperRotate;
+    pose.rotate[middle_] = middleRotate;
+}
+
+bool LookAtIkSolver::Initialize(const Skeleton& skeleton, int32_t joint, const Vector3& aimAxis, float maxAngle) {
+    joint_ = -1;
+    chain_.clear();
+    if (joint < 0 || static_cast<size_t>(joint) >= skeleton.joints.size() || Length(aimAxis) < 1.0e-6f) {
+        return false;
+    }
+    chain_ = BuildChain(skeleton, joint);
+    aimAxis_ = aimAxis / Length(aimAxis);
+    maxAngle_ = maxAngle;
+    joint_ = joint;
+    return true;
+}
+
+Vector3 LookAtIkSolver::CalculateAimDirection(const AnimationPose& pose) const {
+    const uint32_t offsets[] = { static_cast<uint32_t>(chain_.size()) - 1 };
+    JointFrame frames[1];
+    CalculateFrames(pose, chain_, offsets, frames);
+    return Rotate(frames[0].rotate, aimAxis_);
+}
+
+void LookAtIkSolver::Solve(AnimationPose& pose, const Vector3& target, float weight) const {
+    if (joint_ < 0 || weight <= 0.0f) {
+        return;
+    }
+    assert(static_cast<uint32_t>(joint_) < pose.GetJointCount());
+
+    const uint32_t offsets[] = { static_cast<uint32_t>(chain_.size()) - 1 };
+    JointFrame frames[1];
+    CalculateFrames(pose, chain_, offsets, frames);
+
+    // 今の向きから目標への最短の回転（上限の角度で止め、重みを掛ける）
+    Vector3 current = Rotate(frames[0].rotate, aimAxis_);
+    Vector3 desired = target - frames[0].position;
+    if (Length(desired) < 1.0e-6f) {
+        return;
+    }
+    desired = desired / Length(desired);
+    float angle = SafeAcos(Dot(current, desired));
+    Vector3 axis = Cross(current, desired);
+    if (Length(axis) < 1.0e-6f) {
+        // 真後ろなら向きが決まらないので、上限まで適当な軸で回す
+        if (angle < 1.0e-3f) {
+            return;
+        }
+        axis = NormalizeOr(Cross(current, { 0.0f, 1.0f, 0.0f }), { 1.0f, 0.0f, 0.0f });
+    }
+    axis = axis / Length(axis);
+    angle = std::min(angle, maxAngle_) * std::min(weight, 1.0f);
+
+    pose.rotate[joint_] = ApplyModelRotation(pose.rotate[joint_], frames[0].rotate, MakeAxisAngle(axis, angle));
+}
+
+bool FootIkRig::AddLeg(const Skeleton& skeleton, int32_t upper, int32_t middle, int32_t end) {
+    TwoBoneIkSolver leg;
+    if (!leg.Initialize(skeleton, upper, middle, end)) {
+        return false;
+    }
+    legs_.push_back(std::move(leg));
+    return true;
+}
+
+void FootIkRig::BuildGroundRays(const Skeleton& skeleton, const Matrix4x4& worldMatrix, std::span<Vector3> outOrigins) const {
+    assert(outOrigins.size() >= legs_.size());
+    for (size_t i = 0; i < legs_.size(); ++i) {
+        const Matrix4x4& footMatrix = skeleton.joints[legs_[i].GetEnd()].skeletonSpaceMatrix;
+        Vector3 foot = TransformPoint({ footMatrix.m[3][0], footMatrix.m[3][1], footMatrix.m[3][2] }, worldMatrix);
+        outOrigins[i] = { foot.x, foot.y + settings_.rayHeight, foot.z };
+    }
+}
+
+void FootIkRig::Apply(AnimationPose& pose, Skeleton& skeleton, const Matrix4x4& worldMatrix, std::span<const float> groundHeights,
+    float referenceHeight) const {
+
+    assert(groundHeights.size() >= legs_.size());
+    assert(pose.GetJointCount() == skeleton.joints.size());
+    Matrix4x4 inverseWorld = Inverse(worldMatrix);
+    for (size_t i = 0; i < legs_.size(); ++i) {
+        if (std::isnan(groundHeights[i])) {
+            continue;
+        }
+        float offset = std::clamp(groundHeights[i] - referenceHeight, -settings_.maxDrop, settings_.maxRaise);
+        if (std::fabs(offset) < 1.0e-4f) {
+            continue;
+        }
+
+        // 足首をワールドで上下させた位置をスケルトン空間に戻して目標にする
+        const TwoBoneIkSolver& leg = legs_[i];
+        const Matrix4x4& footMatrix = skeleton.joints[leg.GetEnd()].skeletonSpaceMatrix;
+        Vector3 foot = TransformPoint({ footMatrix.m[3][0], footMatrix.m[3][1], footMatrix.m[3][2] }, worldMatrix);
+        foot.y += offset;
+        leg.Solve(pose, TransformPoint(foot, inverseWorld));
+
+        // 書き換えたのは回転だけなので、upperから下の部分木だけ計算し直す
+        for (int32_t joint : { leg.GetUpper(), leg.GetMiddle() }) {
+            skeleton.joints[joint].transform.rotate = pose.rotate[joint];
+        }
+        UpdateSkeletonSubtree(skeleton, leg.GetUpper());
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "CompiledAnimationClip.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// IK（サンプリングした後、スケルトンの更新前にジョイント番号順のポーズを書き換える）
+// 位置・向きはスケルトン空間（モデル空間）で指定する
+
+// 2ボーンIK（脚・腕）
+// upper（太もも・上腕）とmiddle（ひざ・ひじ）の回転を解析的に求めて、end（足首・手首）を目標に合わせる
+class TwoBoneIkSolver {
+public:
+    // middleはupperの、endはmiddleの子孫であること（間にねじれ用のジョイントがあってもよい）
+    bool Initialize(const Skeleton& skeleton, int32_t upper, int32_t middle, int32_t end);
+
+    bool IsValid() const { return end_ >= 0; }
+    int32_t GetUpper() const { return upper_; }
+    int32_t GetMiddle() const { return middle_; }
+    int32_t GetEnd() const { return end_; }
+
+    // endを目標の位置に近づける（届かなければ伸ばしきった向きにする）。weightが1未満なら元の回転と補間する
+    // poleを指定するとひざ・ひじをその位置に向ける（nullptrなら今の曲がる向きを保つ）
+    void Solve(AnimationPose& pose, const Vector3& target, float weight = 1.0f, const Vector3* pole = nullptr) const;
+
+    // endの現在のモデル空間の位置（ルートからの連鎖だけを計算する）
+    Vector3 CalculateEndPosition(const AnimationPose& pose) const;
+
+private:
+    int32_t upper_ = -1;
+    int32_t middle_ = -1;
+    int32_t end_ = -1;
+    std::vector<int32_t> chain_;   // ルートからendまで（親が先）
+    uint32_t upperOffset_ = 0;     // chain_の中のupperとmiddleの位置
+    uint32_t middleOffset_ = 0;
+};
+
+// 注視・照準（頭・目・銃を持つ腕など）
+// ジョイントのローカルのaimAxisが目標を向くように、最短の回転をジョイントに加える
+class LookAtIkSolver {
+public:
+    // maxAngleはバインドポーズからではなく、サンプリングしたポーズから回す角度の上限（ラジアン）
+    bool Initialize(const Skeleton& skeleton, int32_t joint, const Vector3& aimAxis, float maxAngle = 3.14159265f);
+
+    bool IsValid() const { return joint_ >= 0; }
+    int32_t GetJoint() const { return joint_; }
+
+    void Solve(AnimationPose& pose, const Vector3& target, float weight = 1.0f) const;
+
+    // aimAxisの現在のモデル空間の向き
+    Vector3 CalculateAimDirection(const AnimationPose& pose) const;
+
+private:
+    int32_t joint_ = -1;
+    std::vector<int32_t> chain_;
+    Vector3 aimAxis_ = { 0.0f, 0.0f, 1.0f };
+    float maxAngle_ = 3.14159265f;
+};
+
+// 足のIKの設定（距離はワールド空間）
+struct FootIkSettings {
+    float rayHeight = 0.5f;   // 足首の真上のどこからレイを飛ばすか
+    float rayLength = 1.5f;   // レイの長さ
+    float maxRaise = 0.4f;    // 足を持ち上げる上限
+    float maxDrop = 0.4f;     // 足を下ろす上限
+};
+
+// 地面の高さに合わせて足を置く
+// 前回評価したスケルトンの足首の真上から下向きのレイを作り、呼び出し側がまとめてレイキャストした結果で
+// 足首の目標を上下させて2ボーンIKを解く。書き換えた脚の部分木だけスケルトン空間行列を計算し直す
+class FootIkRig {
+public:
+    // 脚を追加（upper・middle・endはTwoBoneIkSolverと同じ）
+    bool AddLeg(const Skeleton& skeleton, int32_t upper, int32_t middle, int32_t end);
+    void Clear() { legs_.clear(); }
+
+    uint32_t GetLegCount() const { return static_cast<uint32_t>(legs_.size()); }
+    const TwoBoneIkSolver& GetLeg(uint32_t index) const { return legs_[index]; }
+
+    void SetSettings(const FootIkSettings& settings) { settings_ = settings; }
+    const FootIkSettings& GetSettings() const { return settings_; }
+
+    // 脚ごとのレイ（ワールド空間の始点。向きは真下、長さはrayLength）をoutOriginsに書き込む
+    void BuildGroundRays(const Skeleton& skeleton, const Matrix4x4& worldMatrix, std::span<Vector3> outOrigins) const;
+
+    // groundHeightsは脚ごとの地面のワールドの高さ（当たらなければNaN）、referenceHeightはアニメーションが前提とする地面の高さ
+    // skeletonは今フレームのポーズで更新済みであること。解いた脚はポーズとスケルトンの両方に書き込む
+    void Apply(AnimationPose& pose, Skeleton& skeleton, const Matrix4x4& worldMatrix, std::span<const float> groundHeights,
+        float referenceHeight) const;
+
+private:
+    std::vector<TwoBoneIkSolver> legs_;
+    FootIkSettings settings_;
+};
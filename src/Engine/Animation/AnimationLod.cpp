@@ -0,0 +1,107 @@
+#include "AnimationLod.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+    // 行列の線形補間（評価間隔は最大4フレームのため、回転の差が小さく行列のままでも破綻しない）
+    void LerpMatrix(const Matrix4x4& a, const Matrix4x4& b, float t, Matrix4x4& out) {
+        const float* pa = &a.m[0][0];
+        const float* pb = &b.m[0][0];
+        float* po = &out.m[0][0];
+        for (int i = 0; i < 16; ++i) {
+            po[i] = pa[i] + (pb[i] - pa[i]) * t;
+        }
+    }
+}
+
+bool AnimationLodState::ShouldEvaluate(uint64_t frameIndex) const {
+    if (currentPalette.empty()) {
+        return true;
+    }
+    if (interval == 0) {
+        return false;
+    }
+    return (frameIndex + phase) % interval == 0 || framesSinceEvaluation >= interval;
+}
+
+void AnimationLodState::SetInterval(uint32_t newInterval) {
+    if (interval == 0 && newInterval != 0) {
+        resumed = true;
+    }
+    interval = newInterval;
+}
+
+void AnimationLodState::FinishEvaluation() {
+    if (resumed || previousPalette.size() != currentPalette.size()) {
+        previousPalette = currentPalette;
+        resumed = false;
+    }
+    framesSinceEvaluation = 0;
+}
+
+float AnimationLodState::GetInterpolationFactor() const {
+    if (interval <= 1 || previousPalette.empty()) {
+        return 1.0f;
+    }
+    // 評価したフレームで1/interval、interval-1フレーム後に最新のパレットに追いつく
+    return std::min(static_cast<float>(framesSinceEvaluation + 1) / static_cast<float>(interval), 1.0f);
+}
+
+float CalculateScreenSize(float radius, float distance, float fovY) {
+    float halfHeight = std::max(distance, 1.0e-4f) * std::tan(fovY * 0.5f);
+    return radius / halfHeight;
+}
+
+bool IsSphereInFrustum(const Matrix4x4& viewProjection, const Vector3& center, float radius) {
+    // 行ベクトル規約（clip = v * M）なので平面は列から取り出す
+    auto column = [&](int c) {
+        return Vector4{ viewProjection.m[0][c], viewProjection.m[1][c], viewProjection.m[2][c], viewProjection.m[3][c] };
+    };
+    Vector4 x = column(0);
+    Vector4 y = column(1);
+    Vector4 z = column(2);
+    Vector4 w = column(3);
+    const Vector4 planes[6] = {
+        { w.x + x.x, w.y + x.y, w.z + x.z, w.w + x.w },  // 左
+        { w.x - x.x, w.y - x.y, w.z - x.z, w.w - x.w },  // 右
+        { w.x + y.x, w.y + y.y, w.z + y.z, w.w + y.w },  // 下
+        { w.x - y.x, w.y - y.y, w.z - y.z, w.w - y.w },  // 上
+        z,                                               // 近（z >= 0）
+        { w.x - z.x, w.y - z.y, w.z - z.z, w.w - z.w },  // 遠
+    };
+    for (const Vector4& plane : planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+        if (distance < -radius * length) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t SelectAnimationUpdateInterval(float screenSize, bool visible, const AnimationLodSettings& settings) {
+    if (!settings.enabled) {
+        return 1;
+    }
+    if (!visible && settings.pauseOffscreen) {
+        return 0;
+    }
+    if (screenSize >= settings.fullRateScreenSize) {
+        return 1;
+    }
+    return screenSize >= settings.halfRateScreenSize ? 2 : 4;
+}
+
+void InterpolatePalette(const std::vector<WellForGPU>& previous, const std::vector<WellForGPU>& current, float t, std::span<WellForGPU> out) {
+    assert(previous.size() == current.size() && out.size() >= current.size());
+    if (t >= 1.0f) {
+        std::copy(current.begin(), current.end(), out.begin());
+        return;
+    }
+    for (size_t i = 0; i < current.size(); ++i) {
+        LerpMatrix(previous[i].skeletonSpaceMatrix, current[i].skeletonSpaceMatrix, t, out[i].skeletonSpaceMatrix);
+        LerpMatrix(previous[i].skeletonSpaceInverseTransposeMatrix, current[i].skeletonSpaceInverseTransposeMatrix, t,
+            out[i].skeletonSpaceInverseTransposeMatrix);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "AnimationData.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// アニメーションの更新頻度LOD
+// 画面上の大きさと可視判定から、毎フレーム・2フレームごと・4フレームごと・停止（画面外）を選ぶ
+// 評価しないフレームは直前に評価した2つのパレットを補間し、評価するフレームはインスタンスごとにずらして
+// 大人数でも1フレームあたりの負荷が平らになるようにする
+struct AnimationLodSettings {
+    bool enabled = true;
+    // 画面上の大きさ（バウンディング球の半径 / 画面の縦半分）がこれ以上なら毎フレーム評価
+    float fullRateScreenSize = 0.2f;
+    // これ以上なら2フレームごと、未満なら4フレームごと
+    float halfRateScreenSize = 0.08f;
+    // 画面外では評価を止めてパレットをそのまま使う
+    bool pauseOffscreen = true;
+    // スケール1のときのバウンディング球の半径（足元からの高さの中心に置く。スキニング後の範囲が求まるまで使う）
+    float boundingRadius = 1.0f;
+};
+
+// インスタンスごとのLODの状態
+struct AnimationLodState {
+    uint32_t interval = 1;               // 評価間隔（0は停止）
+    uint32_t phase = 0;                  // 評価するフレームをずらす量
+    uint32_t framesSinceEvaluation = 0;  // 最後に評価してからのフレーム数
+    bool phaseAssigned = false;
+    bool evaluate = true;                // 今フレームで評価するか（AnimationSystemが設定）
+    bool resumed = false;                // 停止（画面外）から戻ったか。次の評価で補間の履歴を捨てる
+    std::vector<WellForGPU> previousPalette;  // 1つ前に評価したパレット
+    std::vector<WellForGPU> currentPalette;   // 最後に評価したパレット
+
+    // frameIndexで評価するか（パレットがない、または間隔を超えて待っている場合は必ず評価する）
+    bool ShouldEvaluate(uint64_t frameIndex) const;
+
+    // 評価間隔を設定（停止から再開した場合はresumedを立てる）
+    void SetInterval(uint32_t newInterval);
+
+    // 評価したパレットをcurrentPaletteに書き込んだ後に呼ぶ
+    // 初回と停止からの再開では、止まる前のパレットから補間しないようにpreviousPaletteを最新のパレットにそろえる
+    void FinishEvaluation();
+
+    // 出力するパレットの補間係数（previous→current）
+    float GetInterpolationFactor() const;
+};
+
+// 画面上の大きさ（radius / (distance * tan(fovY / 2))）
+float CalculateScreenSize(float radius, float distance, float fovY);
+
+// 球が視錐台の内側にあるか（行ベクトル規約のビュープロジェクション行列、DirectXのz 0..w）
+bool IsSphereInFrustum(const Matrix4x4& viewProjection, const Vector3& center, float radius);
+
+// 画面上の大きさと可視判定から評価間隔を選ぶ（1, 2, 4、停止は0）
+uint32_t SelectAnimationUpdateInterval(float screenSize, bool visible, const AnimationLodSettings& settings);
+
+// 2つのパレットを行列の線形補間で合成してoutに書き込む（outはGPUのアップロードバッファでよい）
+void InterpolatePalette(const std::vector<WellForGPU>& previous, const std::vector<WellForGPU>& current, float t, std::span<WellForGPU> out);
@@ -1,5 +1,5 @@
 #include "AnimationPlayer.h"
-#include "AnimationUtility.h"
+#include "AnimationSampler.h"
 #include "Mymath.h"
 #include <cmath>
 #include <algorithm>
@@ -17,21 +17,30 @@ AnimationPlayer::~AnimationPlayer() {
 void AnimationPlayer::SetAnimation(const Animation& animation) {
     animation_ = animation;
     animationTime_ = 0.0f;
+    rootMotionTrack_ = nullptr;
+    rootMotionDelta_ = {};
+    firedEvents_.clear();
 }
 
 // アニメーション時刻を更新
-void AnimationPlayer::Update(float deltaTime) {
+RootMotionDelta AnimationPlayer::Update(float deltaTime) {
+    rootMotionDelta_ = {};
+    firedEvents_.clear();
     if (!isPlaying_) {
-        return;
+        return rootMotionDelta_;
     }
     
     // 時刻を進める
+    float previousTime = animationTime_;
+    uint32_t loopCount = 0;
+    bool reachedEnd = false;
     animationTime_ += deltaTime;
     
     // ループ処理またはクランプ処理
     if (isLoop_) {
-        // ループする場合は時刻をリピート
-        if (animation_.duration > 0.0f) {
+        // ループする場合は時刻をリピート（終端を越えた回数はルートモーションに使う）
+        if (animation_.duration > 0.0f && animationTime_ >= animation_.duration) {
+            loopCount = static_cast<uint32_t>(animationTime_ / animation_.duration);
             animationTime_ = std::fmod(animationTime_, animation_.duration);
         }
     } else {
@@ -39,8 +48,18 @@ void AnimationPlayer::Update(float deltaTime) {
         if (animationTime_ >= animation_.duration) {
             animationTime_ = animation_.duration;
             isPlaying_ = false; // アニメーション終了
+            reachedEnd = true;
         }
     }
+    
+    // 前回の時刻から今回の時刻までに通過したイベント（時刻順の配列を二分探索する）
+    animation_.events.CollectPlayed(previousTime, animationTime_, loopCount, animation_.duration, reachedEnd, firedEvents_);
+    
+    // 前計算した曲線の差分だけを求める（ルートを再サンプリングしない）
+    if (rootMotionTrack_) {
+        rootMotionDelta_ = rootMotionTrack_->CalculateDelta(previousTime, animationTime_, loopCount);
+    }
+    return rootMotionDelta_;
 }
 
 // 指定したノードのローカル変換行列を取得
@@ -1,5 +1,6 @@
 #pragma once
-#include "Animation.h"
+#include "AnimationData.h"
+#include "RootMotion.h"
 #include <string>
 
 // アニメーション再生クラス
@@ -14,8 +15,10 @@ public:
     // アニメーションを設定
     void SetAnimation(const Animation& animation);
     
-    // アニメーション時刻を更新
-    void Update(float deltaTime);
+    // アニメーション時刻を更新し、ルートモーションのトラックがあればこの更新での移動量を返す
+    // ループの終端を越えた場合も、越えた回数分のループの移動量をつないで返す
+    // 通過したイベントはGetFiredEventsで取得できる
+    RootMotionDelta Update(float deltaTime);
     
     // 指定したノードのローカル変換行列を取得
     Matrix4x4 GetLocalMatrix(const std::string& nodeName);
@@ -39,6 +42,16 @@ public:
     // アニメーションが再生中かを取得
     bool IsPlaying() const { return isPlaying_; }
     
+    // ルートモーションのトラック（nullptrで無効。SetAnimationで解除される）
+    void SetRootMotionTrack(const RootMotionTrack* track) { rootMotionTrack_ = track; }
+    const RootMotionTrack* GetRootMotionTrack() const { return rootMotionTrack_; }
+    
+    // 直前のUpdateでのルートの移動量
+    const RootMotionDelta& GetRootMotionDelta() const { return rootMotionDelta_; }
+    
+    // 直前のUpdateで通過したイベント（発生順。次のUpdateまで有効）
+    const std::vector<AnimationEvent>& GetFiredEvents() const { return firedEvents_; }
+    
     // アニメーション再生を開始
     void Play();
     
@@ -53,4 +66,7 @@ private:
     float animationTime_;          // 現在の時刻（秒）
     bool isPlaying_;              // 再生中フラグ
     bool isLoop_;                 // ループフラグ
+    const RootMotionTrack* rootMotionTrack_ = nullptr; // ルートモーションの前計算した曲線
+    RootMotionDelta rootMotionDelta_;                   // 直前の更新での移動量
+    std::vector<AnimationEvent> firedEvents_;           // 直前の更新で通過したイベント
 };
\ No newline at end of file
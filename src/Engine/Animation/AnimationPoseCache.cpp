@@ -0,0 +1,91 @@
+#include "AnimationPoseCache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // 表の最小サイズ（2のべき乗）
+    const size_t kMinTableSize = 64;
+
+    // 64bitの値を混ぜて表の位置に使う
+    uint64_t MixHash(uint64_t value) {
+        value ^= value >> 33;
+        value *= 0xff51afd7ed558ccdull;
+        value ^= value >> 33;
+        value *= 0xc4ceb9fe1a85ec53ull;
+        value ^= value >> 33;
+        return value;
+    }
+}
+
+uint64_t HashSkin(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices) {
+    uint64_t hash = HashBytes(inverseBindPoseMatrices.data(), inverseBindPoseMatrices.size() * sizeof(Matrix4x4));
+    for (const Joint& joint : skeleton.joints) {
+        int32_t parent = joint.parent ? *joint.parent : -1;
+        hash = HashBytes(&parent, sizeof(parent), hash);
+    }
+    return hash;
+}
+
+void AnimationPoseCache::Clear(uint32_t capacity) {
+    size_t tableSize = kMinTableSize;
+    while (tableSize < static_cast<size_t>(capacity) * 2) {
+        tableSize *= 2;
+    }
+    if (poseTable_.size() < tableSize) {
+        poseTable_.assign(tableSize, Entry{});
+        paletteTable_.assign(tableSize, Entry{});
+        generation_ = 0;
+    }
+
+    // 世代が一周したら表を消し直す
+    if (++generation_ == 0) {
+        std::fill(poseTable_.begin(), poseTable_.end(), Entry{});
+        std::fill(paletteTable_.begin(), paletteTable_.end(), Entry{});
+        generation_ = 1;
+    }
+    poseHits_ = 0;
+    paletteHits_ = 0;
+    misses_ = 0;
+}
+
+AnimationPoseCache::Entry& AnimationPoseCache::Probe(std::vector<Entry>& table, uint64_t clipHash, int64_t timeIndex,
+    uint64_t skinHash, bool matchSkin) {
+
+    uint64_t hash = clipHash ^ MixHash(static_cast<uint64_t>(timeIndex)) ^ (matchSkin ? MixHash(skinHash + 1) : 0);
+    size_t mask = table.size() - 1;
+    for (size_t index = MixHash(hash) & mask;; index = (index + 1) & mask) {
+        Entry& entry = table[index];
+        if (entry.generation != generation_) {
+            return entry;
+        }
+        if (entry.clipHash == clipHash && entry.timeIndex == timeIndex && (!matchSkin || entry.skinHash == skinHash)) {
+            return entry;
+        }
+    }
+}
+
+AnimationPoseCache::Lookup AnimationPoseCache::FindOrAdd(const CompiledAnimationClip& clip, float time, uint64_t skinHash, uint32_t owner) {
+    uint64_t clipHash = clip.GetContentHash();
+    int64_t timeIndex = timeStep_ > 0.0f ? std::llround(time / timeStep_) : 0;
+
+    Lookup lookup;
+    Entry& palette = Probe(paletteTable_, clipHash, timeIndex, skinHash, true);
+    if (palette.generation == generation_) {
+        lookup.poseOwner = palette.owner;
+        lookup.paletteOwner = palette.owner;
+        ++paletteHits_;
+        return lookup;
+    }
+    palette = { clipHash, skinHash, timeIndex, owner, generation_ };
+
+    // スキンが違ってもポーズは共有できる
+    Entry& pose = Probe(poseTable_, clipHash, timeIndex, 0, false);
+    if (pose.generation == generation_) {
+        lookup.poseOwner = pose.owner;
+        ++poseHits_;
+        return lookup;
+    }
+    pose = { clipHash, 0, timeIndex, owner, generation_ };
+    ++misses_;
+    return lookup;
+}
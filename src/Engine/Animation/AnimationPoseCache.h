@@ -0,0 +1,59 @@
+#pragma once
+#include "CompiledAnimationClip.h"
+#include <cstdint>
+#include <vector>
+
+// スケルトンの親子関係とバインドポーズの逆行列のハッシュ（同じモデルから作ったスキンは同じ値）
+uint64_t HashSkin(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices);
+
+// 同じクリップを同じ時刻で再生しているインスタンスの評価結果を1フレームの間だけ共有する
+// キーは（クリップの内容のハッシュ, 量子化した時刻）で、スキンのハッシュも一致すればパレットまで共有できる
+// - ポーズの共有: サンプリングとブレンドを省き、スケルトン空間行列とパレットは自分で計算する
+// - パレットの共有: 評価をすべて省き、共有元のパレットを使う
+// 登録と検索は評価の前にメインスレッドで行い、評価中のスレッドからは参照しない
+class AnimationPoseCache {
+public:
+    static const uint32_t kNone = UINT32_MAX;
+
+    // 検索結果（共有元の番号。なければkNone）
+    struct Lookup {
+        uint32_t poseOwner = kNone;
+        uint32_t paletteOwner = kNone;
+    };
+
+    // 時刻の量子化の幅（秒）。同じバケットに入ったインスタンスは最初の1体のポーズを使う
+    void SetTimeStep(float timeStep) { timeStep_ = timeStep; }
+    float GetTimeStep() const { return timeStep_; }
+
+    // 1フレーム分の登録を消す（capacity体分の表を確保し、以降のフレームでは確保しない）
+    void Clear(uint32_t capacity);
+
+    // 共有元を探し、なければownerを共有元として登録する
+    Lookup FindOrAdd(const CompiledAnimationClip& clip, float time, uint64_t skinHash, uint32_t owner);
+
+    // Clear以降の検索の結果
+    uint32_t GetPoseHitCount() const { return poseHits_; }
+    uint32_t GetPaletteHitCount() const { return paletteHits_; }
+    uint32_t GetMissCount() const { return misses_; }
+
+private:
+    struct Entry {
+        uint64_t clipHash = 0;
+        uint64_t skinHash = 0;
+        int64_t timeIndex = 0;
+        uint32_t owner = kNone;
+        uint32_t generation = 0;
+    };
+
+    // 開番地法の表から一致するエントリか空きを探す（skinHashを比較しない場合はポーズ用）
+    Entry& Probe(std::vector<Entry>& table, uint64_t clipHash, int64_t timeIndex, uint64_t skinHash, bool matchSkin);
+
+    float timeStep_ = 1.0f / 60.0f;
+    uint32_t generation_ = 0;  // Clearのたびに進め、古いエントリを空きとみなす
+    std::vector<Entry> poseTable_;
+    std::vector<Entry> paletteTable_;
+
+    uint32_t poseHits_ = 0;
+    uint32_t paletteHits_ = 0;
+    uint32_t misses_ = 0;
+};
@@ -0,0 +1,194 @@
+#include "AnimationRetarget.h"
+#include <cassert>
+#include <cmath>
+
+namespace {
+    const Quaternion kIdentityQuaternion = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+    // クォータニオン（x, y, z, w）。スケルトン空間の回転は親の回転 * ローカルの回転
+    Quaternion Multiply(const Quaternion& a, const Quaternion& b) {
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+        };
+    }
+
+    Quaternion Conjugate(const Quaternion& q) { return { -q.x, -q.y, -q.z, q.w }; }
+
+    Vector3 Cross(const Vector3& a, const Vector3& b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    Vector3 Rotate(const Quaternion& q, const Vector3& v) {
+        Vector3 u = { q.x, q.y, q.z };
+        Vector3 t = Cross(u, v) * 2.0f;
+        return v + t * q.w + Cross(u, t);
+    }
+
+    float Length(const Vector3& v) { return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z); }
+
+    // 0の成分は比を1にする
+    float SafeRatio(float numerator, float denominator) {
+        return std::fabs(denominator) > 1.0e-6f ? numerator / denominator : 1.0f;
+    }
+
+    // バインドポーズでの各ジョイントのモデル空間の回転（親が先の順）
+    std::vector<Quaternion> CalculateBindRotations(const Skeleton& skeleton) {
+        std::vector<Quaternion> rotations(skeleton.joints.size());
+        for (size_t i = 0; i < skeleton.joints.size(); ++i) {
+            const Joint& joint = skeleton.joints[i];
+            rotations[i] = joint.parent ? Multiply(rotations[*joint.parent], joint.transform.rotate) : joint.transform.rotate;
+        }
+        return rotations;
+    }
+}
+
+uint64_t HashSkeleton(const Skeleton& skeleton) {
+    size_t jointCount = skeleton.joints.size();
+    uint64_t hash = HashBytes(&jointCount, sizeof(jointCount));
+    for (const Joint& joint : skeleton.joints) {
+        int32_t parent = joint.parent ? *joint.parent : -1;
+        hash = HashBytes(joint.name.data(), joint.name.size(), hash);
+        hash = HashBytes(&parent, sizeof(parent), hash);
+        hash = HashBytes(&joint.transform.scale, sizeof(joint.transform.scale), hash);
+        hash = HashBytes(&joint.transform.rotate, sizeof(joint.transform.rotate), hash);
+        hash = HashBytes(&joint.transform.translate, sizeof(joint.transform.translate), hash);
+    }
+    return hash;
+}
+
+std::string_view GetRetargetJointName(std::string_view name) {
+    size_t separator = name.find_last_of(':');
+    return separator == std::string_view::npos ? name : name.substr(separator + 1);
+}
+
+void AnimationRetargetMap::Build(const Skeleton& source, const Skeleton& target) {
+    const size_t targetCount = target.joints.size();
+    joints_.assign(targetCount, JointMapping{});
+    targetNames_.resize(targetCount);
+    ReadPoseFromSkeleton(target, targetRestPose_);
+    mappedCount_ = 0;
+
+    std::unordered_map<std::string_view, int32_t> sourceJoints;
+    for (const Joint& joint : source.joints) {
+        sourceJoints.emplace(GetRetargetJointName(joint.name), joint.index);
+    }
+    std::vector<Quaternion> sourceRotations = CalculateBindRotations(source);
+    std::vector<Quaternion> targetRotations = CalculateBindRotations(target);
+
+    // frameSourceは向きの基準にする元のジョイント（対応がなければ最も近い対応する祖先。なければ-1でモデル空間）
+    // correctionはバインドポーズで 先のモデル空間の回転 = 元のモデル空間の回転 * correction となる補正
+    std::vector<int32_t> frameSource(targetCount, -1);
+    std::vector<Quaternion> correction(targetCount, kIdentityQuaternion);
+    for (size_t i = 0; i < targetCount; ++i) {
+        const Joint& joint = target.joints[i];
+        JointMapping& mapping = joints_[i];
+        targetNames_[i] = joint.name;
+        auto found = sourceJoints.find(GetRetargetJointName(joint.name));
+        mapping.source = found != sourceJoints.end() ? found->second : -1;
+
+        int32_t parentFrame = joint.parent ? frameSource[*joint.parent] : -1;
+        frameSource[i] = mapping.source >= 0 ? mapping.source : parentFrame;
+        const Quaternion& frameRotation = frameSource[i] >= 0 ? sourceRotations[frameSource[i]] : kIdentityQuaternion;
+        correction[i] = Multiply(Conjugate(frameRotation), targetRotations[i]);
+        if (mapping.source < 0) {
+            continue;
+        }
+
+        // 先の親の基準から元の親までのバインドポーズの回転（間の対応しないジョイントはバインドポーズとみなす）
+        const Joint& sourceJoint = source.joints[mapping.source];
+        const Quaternion& parentFrameRotation = parentFrame >= 0 ? sourceRotations[parentFrame] : kIdentityQuaternion;
+        const Quaternion& sourceParentRotation = sourceJoint.parent ? sourceRotations[*sourceJoint.parent] : kIdentityQuaternion;
+        Quaternion between = Multiply(Conjugate(parentFrameRotation), sourceParentRotation);
+        Quaternion parentCorrection = joint.parent ? correction[*joint.parent] : kIdentityQuaternion;
+
+        mapping.sourceName = sourceJoint.name;
+        mapping.preRotate = Multiply(Conjugate(parentCorrection), between);
+        mapping.postRotate = correction[i];
+        mapping.sourceTranslate = sourceJoint.transform.translate;
+        mapping.targetTranslate = joint.transform.translate;
+        mapping.translateScale = SafeRatio(Length(joint.transform.translate), Length(sourceJoint.transform.translate));
+        mapping.sourceScale = sourceJoint.transform.scale;
+        mapping.targetScale = joint.transform.scale;
+        ++mappedCount_;
+    }
+}
+
+Quaternion AnimationRetargetMap::RetargetRotate(const JointMapping& mapping, const Quaternion& rotate) const {
+    return Multiply(Multiply(mapping.preRotate, rotate), mapping.postRotate);
+}
+
+Vector3 AnimationRetargetMap::RetargetTranslate(const JointMapping& mapping, const Vector3& translate) const {
+    Vector3 delta = Rotate(mapping.preRotate, translate - mapping.sourceTranslate);
+    return mapping.targetTranslate + delta * mapping.translateScale;
+}
+
+Vector3 AnimationRetargetMap::RetargetScale(const JointMapping& mapping, const Vector3& scale) const {
+    return {
+        mapping.targetScale.x * SafeRatio(scale.x, mapping.sourceScale.x),
+        mapping.targetScale.y * SafeRatio(scale.y, mapping.sourceScale.y),
+        mapping.targetScale.z * SafeRatio(scale.z, mapping.sourceScale.z),
+    };
+}
+
+Animation AnimationRetargetMap::Retarget(const Animation& source) const {
+    Animation result;
+    result.duration = source.duration;
+    result.events = source.events;
+    for (size_t i = 0; i < joints_.size(); ++i) {
+        const JointMapping& mapping = joints_[i];
+        if (mapping.source < 0) {
+            continue;
+        }
+        auto it = source.nodeAnimations.find(mapping.sourceName);
+        if (it == source.nodeAnimations.end()) {
+            continue;
+        }
+
+        // キーの時刻はそのままで値だけ変換する
+        NodeAnimation& nodeAnimation = result.nodeAnimations[targetNames_[i]];
+        nodeAnimation = it->second;
+        for (KeyframeVector3& keyframe : nodeAnimation.translate) {
+            keyframe.value = RetargetTranslate(mapping, keyframe.value);
+        }
+        for (KeyframeQuaternion& keyframe : nodeAnimation.rotate) {
+            keyframe.value = RetargetRotate(mapping, keyframe.value);
+        }
+        for (KeyframeVector3& keyframe : nodeAnimation.scale) {
+            keyframe.value = RetargetScale(mapping, keyframe.value);
+        }
+    }
+    return result;
+}
+
+void AnimationRetargetMap::RetargetPose(const AnimationPose& source, AnimationPose& outTarget) const {
+    outTarget.Resize(GetTargetJointCount());
+    for (uint32_t i = 0; i < GetTargetJointCount(); ++i) {
+        const JointMapping& mapping = joints_[i];
+        if (mapping.source < 0 || static_cast<uint32_t>(mapping.source) >= source.GetJointCount()) {
+            outTarget.translate[i] = targetRestPose_.translate[i];
+            outTarget.rotate[i] = targetRestPose_.rotate[i];
+            outTarget.scale[i] = targetRestPose_.scale[i];
+            continue;
+        }
+        outTarget.translate[i] = RetargetTranslate(mapping, source.translate[mapping.source]);
+        outTarget.rotate[i] = RetargetRotate(mapping, source.rotate[mapping.source]);
+        outTarget.scale[i] = RetargetScale(mapping, source.scale[mapping.source]);
+    }
+}
+
+AnimationRetargetCache* AnimationRetargetCache::GetInstance() {
+    static AnimationRetargetCache instance;
+    return &instance;
+}
+
+const AnimationRetargetMap& AnimationRetargetCache::GetMap(const Skeleton& source, uint64_t sourceHash, const Skeleton& target, uint64_t targetHash) {
+    std::unique_ptr<AnimationRetargetMap>& map = maps_[{ sourceHash, targetHash }];
+    if (!map) {
+        map = std::make_unique<AnimationRetargetMap>();
+        map->Build(source, target);
+    }
+    return *map;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "CompiledAnimationClip.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// アニメーションだけのアセット（メッシュを持たず、クリップと作成に使ったスケルトンだけを持つ）
+// 複数のモデルで共有し、それぞれのスケルトンにリターゲットして使う
+struct AnimationClipAsset {
+    Animation animation;
+    Skeleton skeleton;
+    uint64_t skeletonHash = 0;
+};
+
+// スケルトンの名前・親子関係・バインドポーズのハッシュ（リターゲットの対応表のキーに使う）
+uint64_t HashSkeleton(const Skeleton& skeleton);
+
+// ジョイント名の比較に使う部分（"mixamorig:Hips"の"mixamorig:"のような名前空間を除く）
+std::string_view GetRetargetJointName(std::string_view name);
+
+// クリップのスケルトン（元）から別のスケルトン（先）へのリターゲットの対応表
+// 先のジョイントごとに対応する元のジョイントと、バインドポーズの向きの違いを打ち消す補正を前計算しておく
+// - 回転: 先のローカル = pre * 元のローカル * post（元と先のバインドポーズでモデル空間の向きがそろうように選ぶ）
+// - 移動: 先のバインドポーズ + 元のバインドポーズからの差（preで回し、バインドポーズの骨の長さの比で伸縮）
+// - スケール: 先のバインドポーズ * 元のバインドポーズに対する比
+// 対応する元のジョイントのない先のジョイントは先のバインドポーズのまま（トラックを作らない）
+class AnimationRetargetMap {
+public:
+    // 名前（名前空間を除く）で対応付けて補正を計算する
+    void Build(const Skeleton& source, const Skeleton& target);
+
+    // 先のジョイントに対応する元のジョイント（なければ-1）
+    int32_t GetSourceJoint(int32_t targetJoint) const { return joints_[targetJoint].source; }
+    uint32_t GetTargetJointCount() const { return static_cast<uint32_t>(joints_.size()); }
+    uint32_t GetMappedJointCount() const { return mappedCount_; }
+
+    // 元のスケルトンのノード名のアニメーションを、先のスケルトンのノード名のアニメーションに変換する
+    // 補正はキーごとの定数の回転なので、変換したキーを補間した値は元を補間して変換した値と一致する
+    Animation Retarget(const Animation& source) const;
+
+    // 元のスケルトンのジョイント番号順のポーズを、先のスケルトンのポーズに変換する
+    void RetargetPose(const AnimationPose& source, AnimationPose& outTarget) const;
+
+private:
+    struct JointMapping {
+        int32_t source = -1;
+        std::string sourceName;
+        Quaternion preRotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+        Quaternion postRotate = { 0.0f, 0.0f, 0.0f, 1.0f };
+        Vector3 sourceTranslate = {};   // 元のバインドポーズ
+        Vector3 targetTranslate = {};   // 先のバインドポーズ
+        float translateScale = 1.0f;    // 骨の長さの比
+        Vector3 sourceScale = { 1.0f, 1.0f, 1.0f };
+        Vector3 targetScale = { 1.0f, 1.0f, 1.0f };
+    };
+
+    Quaternion RetargetRotate(const JointMapping& mapping, const Quaternion& rotate) const;
+    Vector3 RetargetTranslate(const JointMapping& mapping, const Vector3& translate) const;
+    Vector3 RetargetScale(const JointMapping& mapping, const Vector3& scale) const;
+
+    std::vector<JointMapping> joints_;
+    std::vector<std::string> targetNames_;
+    AnimationPose targetRestPose_;
+    uint32_t mappedCount_ = 0;
+};
+
+// (元のスケルトン, 先のスケルトン)の組ごとの対応表のキャッシュ
+// 同じ組の2つ目以降のクリップは表を作り直さずに変換だけ行う
+class AnimationRetargetCache {
+public:
+    static AnimationRetargetCache* GetInstance();
+
+    // 組の対応表を返す（なければ作る）。ハッシュはHashSkeletonの値
+    const AnimationRetargetMap& GetMap(const Skeleton& source, uint64_t sourceHash, const Skeleton& target, uint64_t targetHash);
+
+    size_t GetMapCount() const { return maps_.size(); }
+    void Clear() { maps_.clear(); }
+
+private:
+    struct PairHash {
+        size_t operator()(const std::pair<uint64_t, uint64_t>& key) const { return static_cast<size_t>(key.first ^ (key.second * 1099511628211ull)); }
+    };
+
+    std::unordered_map<std::pair<uint64_t, uint64_t>, std::unique_ptr<AnimationRetargetMap>, PairHash> maps_;
+};
@@ -0,0 +1,121 @@
+#include "AnimationSampler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ranges>
+
+namespace {
+    // 区間探索の本体（float配列とキーフレーム配列で共通。timeAt(i)でi番目のキーの時刻を読む）
+    // times[0] < time < times[count - 1]であること。境界上の時刻は前の区間に含める
+    // cursorがあれば前回の区間、その次、ループで先頭に戻った直後の最初の区間を先に調べ、外れた場合だけ二分探索する
+    template <typename TimeAt>
+    uint32_t FindInterval(uint32_t count, float time, KeyframeCursor* cursor, TimeAt timeAt) {
+        assert(count >= 2);
+        if (cursor) {
+            uint32_t index = cursor->index;
+            if (index + 1 < count && timeAt(index) < time) {
+                if (time <= timeAt(index + 1)) {
+                    return index;
+                }
+                if (index + 2 < count && time <= timeAt(index + 2)) {
+                    cursor->index = index + 1;
+                    return index + 1;
+                }
+            } else if (time <= timeAt(1)) {
+                // 前回より前（巻き戻し・ループ）で、最初の区間に入っている
+                cursor->index = 0;
+                return 0;
+            }
+        }
+
+        // time <= timeAt(index + 1)となる最初の区間
+        auto keys = std::views::iota(1u, count);
+        uint32_t index = *std::ranges::partition_point(keys, [&](uint32_t i) { return timeAt(i) < time; }) - 1;
+        if (cursor) {
+            cursor->index = index;
+        }
+        return index;
+    }
+
+    template <typename Keyframe>
+    uint32_t FindKeyframeIndex(const std::vector<Keyframe>& keyframes, float time, KeyframeCursor* cursor) {
+        return FindInterval(static_cast<uint32_t>(keyframes.size()), time, cursor,
+            [&keyframes](uint32_t i) { return keyframes[i].time; });
+    }
+
+    // 区間内の補間係数
+    template <typename Keyframe>
+    float CalculateT(const std::vector<Keyframe>& keyframes, uint32_t index, float time) {
+        float timeDiff = keyframes[index + 1].time - keyframes[index].time;
+        assert(timeDiff > 0.0f);
+
+        float t = (time - keyframes[index].time) / timeDiff;
+        assert(!std::isnan(t));
+        assert(t >= 0.0f && t <= 1.0f);
+        return t;
+    }
+
+    Vector3 Interpolate(const std::vector<KeyframeVector3>& keyframes, uint32_t index, float time) {
+        Vector3 result = Lerp(keyframes[index].value, keyframes[index + 1].value, CalculateT(keyframes, index, time));
+        assert(!std::isnan(result.x) && !std::isnan(result.y) && !std::isnan(result.z));
+        return result;
+    }
+
+    Quaternion Interpolate(const std::vector<KeyframeQuaternion>& keyframes, uint32_t index, float time) {
+        const Quaternion& q1 = keyframes[index].value;
+        const Quaternion& q2 = keyframes[index + 1].value;
+        assert(!std::isnan(q1.x) && !std::isnan(q1.y) && !std::isnan(q1.z) && !std::isnan(q1.w));
+        assert(!std::isnan(q2.x) && !std::isnan(q2.y) && !std::isnan(q2.z) && !std::isnan(q2.w));
+
+        Quaternion result = Slerp(q1, q2, CalculateT(keyframes, index, time));
+        assert(!std::isnan(result.x) && !std::isnan(result.y) && !std::isnan(result.z) && !std::isnan(result.w));
+        return result;
+    }
+
+    // 範囲外（先頭以前・末尾以降）ならその端の値を返す
+    template <typename Keyframe>
+    const Keyframe* FindClampedKeyframe(const std::vector<Keyframe>& keyframes, float time) {
+        assert(!keyframes.empty());
+        assert(!std::isnan(time));
+
+        if (keyframes.size() == 1 || time <= keyframes.front().time) {
+            return &keyframes.front();
+        }
+        if (time >= keyframes.back().time) {
+            return &keyframes.back();
+        }
+        return nullptr;
+    }
+}
+
+uint32_t FindKeyframeInterval(const float* times, uint32_t count, float time, KeyframeCursor* cursor) {
+    return FindInterval(count, time, cursor, [times](uint32_t i) { return times[i]; });
+}
+
+Vector3 CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time) {
+    if (const KeyframeVector3* clamped = FindClampedKeyframe(keyframes, time)) {
+        return clamped->value;
+    }
+    return Interpolate(keyframes, FindKeyframeIndex(keyframes, time, nullptr), time);
+}
+
+Quaternion CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time) {
+    if (const KeyframeQuaternion* clamped = FindClampedKeyframe(keyframes, time)) {
+        return clamped->value;
+    }
+    return Interpolate(keyframes, FindKeyframeIndex(keyframes, time, nullptr), time);
+}
+
+Vector3 CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time, KeyframeCursor& cursor) {
+    if (const KeyframeVector3* clamped = FindClampedKeyframe(keyframes, time)) {
+        return clamped->value;
+    }
+    return Interpolate(keyframes, FindKeyframeIndex(keyframes, time, &cursor), time);
+}
+
+Quaternion CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time, KeyframeCursor& cursor) {
+    if (const KeyframeQuaternion* clamped = FindClampedKeyframe(keyframes, time)) {
+        return clamped->value;
+    }
+    return Interpolate(keyframes, FindKeyframeIndex(keyframes, time, &cursor), time);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "AnimationData.h"
+#include <cstdint>
+#include <vector>
+
+// キーフレーム探索の位置ヒント（トラックごとに1つ保持する）
+// 時刻が単調に進む通常の再生では前回の区間かその次に収まるため、探索がO(1)で済む
+struct KeyframeCursor {
+    uint32_t index = 0;
+};
+
+// 時刻の配列からtimeを含む区間[index, index + 1]を探す（times[0] < time < times[count - 1]であること）
+// cursorがあれば前回の区間とその次、巻き戻し・ループ後なら最初の区間を先に調べ、外れた場合だけ二分探索する
+// CalculateValueのキーフレーム配列版も同じ探索を使う
+uint32_t FindKeyframeInterval(const float* times, uint32_t count, float time, KeyframeCursor* cursor);
+
+// 指定した時刻のVector3値を計算（線形補間、二分探索）
+Vector3 CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time);
+
+// 指定した時刻のQuaternion値を計算（球面線形補間、二分探索）
+Quaternion CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time);
+
+// カーソル付き（前回の区間の近くを先に調べ、外れた場合だけ二分探索する）
+Vector3 CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time, KeyframeCursor& cursor);
+Quaternion CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time, KeyframeCursor& cursor);
@@ -0,0 +1,202 @@
+#include "AnimationSystem.h"
+#include "Camera.h"
+#include "JobSystem.h"
+#include "Object3d.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+    // 1ジョブあたりのキャラクター数（ジョイント数十体分なら数体まとめても偏りは小さい）
+    const uint32_t kInstancesPerJob = 4;
+}
+
+AnimationSystem* AnimationSystem::GetInstance() {
+    static AnimationSystem instance;
+    return &instance;
+}
+
+void AnimationSystem::Initialize() {
+    JobSystem::GetInstance()->Initialize();
+    pending_.clear();
+    pending_.reserve(512);
+    for (std::vector<Object3d*>& stage : stages_) {
+        stage.reserve(512);
+    }
+    initialized_ = true;
+}
+
+void AnimationSystem::Finalize() {
+    // 未実行の登録は破棄する（オブジェクトはシーンとともに解放済み）
+    pending_.clear();
+    JobSystem::GetInstance()->Finalize();
+    initialized_ = false;
+}
+
+void AnimationSystem::Submit(Object3d* object) {
+    if (object->IsAnimationSubmitted()) {
+        return;
+    }
+    object->SetAnimationSubmitted(true);
+    pending_.push_back(object);
+}
+
+void AnimationSystem::Cancel(Object3d* object) {
+    if (!object->IsAnimationSubmitted()) {
+        return;
+    }
+    pending_.erase(std::remove(pending_.begin(), pending_.end(), object), pending_.end());
+    object->SetAnimationSubmitted(false);
+}
+
+void AnimationSystem::ScheduleLod(Object3d* object) {
+    AnimationLodState& lod = object->GetAnimationLod();
+    if (!lod.phaseAssigned) {
+        lod.phase = nextPhase_++;
+        lod.phaseAssigned = true;
+    }
+
+    // カメラがなければ毎フレーム評価する
+    uint32_t interval = 1;
+    Camera* camera = object->GetCamera();
+    if (camera && lodSettings_.enabled) {
+        // バウンディング球はスケールの最大成分で拡大し、足元から半径分だけ上に置く
+        const Vector3& scale = object->GetScale();
+        float maxScale = std::max({ scale.x, scale.y, scale.z });
+        float radius = lodSettings_.boundingRadius * maxScale;
+        Vector3 center = object->GetPosition();
+        center.y += radius;
+
+        // 前回評価した姿勢の範囲があれば、それを囲む球を使う
+        const SkinnedBounds& bounds = object->GetSkinnedBounds();
+        if (!bounds.IsEmpty()) {
+            Vector3 localCenter = { (bounds.min.x + bounds.max.x) * 0.5f * scale.x, (bounds.min.y + bounds.max.y) * 0.5f * scale.y,
+                (bounds.min.z + bounds.max.z) * 0.5f * scale.z };
+            Vector3 extent = { bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z };
+            Matrix4x4 rotate = MakeRotateMatrix(object->GetRotation());
+            const Vector3& position = object->GetPosition();
+            center = {
+                position.x + localCenter.x * rotate.m[0][0] + localCenter.y * rotate.m[1][0] + localCenter.z * rotate.m[2][0],
+                position.y + localCenter.x * rotate.m[0][1] + localCenter.y * rotate.m[1][1] + localCenter.z * rotate.m[2][1],
+                position.z + localCenter.x * rotate.m[0][2] + localCenter.y * rotate.m[1][2] + localCenter.z * rotate.m[2][2],
+            };
+            radius = 0.5f * std::sqrt(extent.x * extent.x + extent.y * extent.y + extent.z * extent.z) * maxScale;
+        }
+
+        const Vector3& eye = camera->GetTranslate();
+        Vector3 toCenter = { center.x - eye.x, center.y - eye.y, center.z - eye.z };
+        float distance = std::sqrt(toCenter.x * toCenter.x + toCenter.y * toCenter.y + toCenter.z * toCenter.z);
+        bool visible = IsSphereInFrustum(camera->GetViewProjectionMatrix(), center, radius);
+        float screenSize = CalculateScreenSize(radius, distance, camera->GetFovY());
+        interval = SelectAnimationUpdateInterval(screenSize, visible, lodSettings_);
+    }
+    lod.SetInterval(interval);
+    lod.evaluate = lod.ShouldEvaluate(frameIndex_);
+}
+
+void AnimationSystem::CastFootIkRays() {
+    if (footIkObjects_.empty()) {
+        return;
+    }
+
+    // 全インスタンスの脚ごとのレイを1つの配列に並べる
+    footIkOrigins_.clear();
+    footIkRays_.clear();
+    footIkIgnoreObjects_.clear();
+    for (Object3d* object : footIkObjects_) {
+        uint32_t legCount = object->GetFootIkRig().GetLegCount();
+        size_t first = footIkOrigins_.size();
+        footIkOrigins_.resize(first + legCount);
+        object->BuildFootIkRays(std::span<Vector3>(footIkOrigins_).subspan(first, legCount));
+        const FootIkSettings& settings = object->GetFootIkRig().GetSettings();
+        for (uint32_t leg = 0; leg < legCount; ++leg) {
+            footIkRays_.emplace_back(footIkOrigins_[first + leg], Vector3{ 0.0f, -1.0f, 0.0f }, settings.rayLength);
+            footIkIgnoreObjects_.push_back(object);
+        }
+    }
+
+    // 当たらなければNaN（その脚は解かない）
+    footIkHits_.resize(footIkRays_.size());
+    footIkHeights_.assign(footIkRays_.size(), std::nanf(""));
+    Collision::AABBCollisionManager* collisionManager = Collision::AABBCollisionManager::GetInstance();
+    if (collisionManager) {
+        collisionManager->Raycast(footIkRays_, footIkIgnoreObjects_, footIkHits_);
+        for (size_t i = 0; i < footIkHits_.size(); ++i) {
+            if (footIkHits_[i].hit) {
+                footIkHeights_[i] = footIkHits_[i].point.y;
+            }
+        }
+    }
+
+    size_t first = 0;
+    for (Object3d* object : footIkObjects_) {
+        uint32_t legCount = object->GetFootIkRig().GetLegCount();
+        object->SetFootIkGroundHeights(std::span<const float>(footIkHeights_).subspan(first, legCount));
+        first += legCount;
+    }
+}
+
+void AnimationSystem::Execute() {
+    auto start = std::chrono::steady_clock::now();
+
+    // 評価するインスタンスを決める（評価間隔が同じインスタンスは登録順のphaseで別々のフレームに散らばる）
+    // 同じクリップ・時刻のインスタンスは共有元の評価が終わった後の段階で結果をコピーする
+    uint32_t evaluatedCount = 0;
+    poseCache_.Clear(static_cast<uint32_t>(pending_.size()));
+    for (std::vector<Object3d*>& stage : stages_) {
+        stage.clear();
+    }
+    footIkObjects_.clear();
+    for (uint32_t i = 0; i < pending_.size(); ++i) {
+        Object3d* object = pending_[i];
+        ScheduleLod(object);
+        object->SetAnimationShareSource(nullptr, false);
+
+        uint32_t stage = kEvaluateStage;
+        const CompiledAnimationClip* clip = nullptr;
+        float time = 0.0f;
+        uint64_t skinHash = 0;
+        if (object->GetAnimationLod().evaluate) {
+            ++evaluatedCount;
+            if (object->IsFootIkEnabled()) {
+                footIkObjects_.push_back(object);
+            }
+            if (poseCacheEnabled_ && object->GetSharablePose(clip, time, skinHash)) {
+                AnimationPoseCache::Lookup lookup = poseCache_.FindOrAdd(*clip, time, skinHash, i);
+                if (lookup.paletteOwner != AnimationPoseCache::kNone) {
+                    object->SetAnimationShareSource(pending_[lookup.paletteOwner], true);
+                    stage = kSharePaletteStage;
+                }
+                else if (lookup.poseOwner != AnimationPoseCache::kNone) {
+                    object->SetAnimationShareSource(pending_[lookup.poseOwner], false);
+                    stage = kSharePoseStage;
+                }
+            }
+        }
+        stages_[stage].push_back(object);
+    }
+    ++frameIndex_;
+
+    // レイキャストはコリジョンマネージャーを読むため、ジョブの前にメインスレッドで行う
+    CastFootIkRays();
+
+    // 各ジョブは自分のAnimatedModel（スケルトン・パレット）だけを書き換え、共有元は前の段階で評価済みのため、
+    // 段階内のジョブ間の同期は不要
+    for (std::vector<Object3d*>& stage : stages_) {
+        JobSystem::GetInstance()->ParallelFor(static_cast<uint32_t>(stage.size()), kInstancesPerJob,
+            [&stage](uint32_t begin, uint32_t end) {
+                for (uint32_t i = begin; i < end; ++i) {
+                    stage[i]->UpdateAnimation();
+                }
+            });
+    }
+
+    for (Object3d* object : pending_) {
+        object->SetAnimationSubmitted(false);
+    }
+    lastInstanceCount_ = static_cast<uint32_t>(pending_.size());
+    lastEvaluatedCount_ = evaluatedCount;
+    pending_.clear();
+
+    lastExecuteMilliseconds_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
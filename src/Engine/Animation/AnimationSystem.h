@@ -0,0 +1,90 @@
+#pragma once
+#include "AnimationLod.h"
+#include "AnimationPoseCache.h"
+#include "AABBCollision.h"
+#include <cstdint>
+#include <vector>
+
+class Object3d;
+
+// アニメーション付きObject3dをフレームごとに集め、ワーカースレッドでまとめて評価する
+// 1体分（サンプリング・ブレンド・ローカル→スケルトン空間・パレット書き込み）を1ジョブとし、
+// 各SkinCluster::mappedPaletteへ直接書き込む
+// Object3d::Updateで登録し、シーンの更新後にExecuteで全ジョブを実行する
+// 今フレームのスケルトンを読む処理（ジョイントに追従するカメラなど）はExecute後のIScene::PostAnimationUpdateで行う
+// 実行前にカメラからの画面上の大きさと可視判定で各インスタンスの評価間隔を決め（AnimationLod.h）、
+// 評価しないインスタンスは補間したパレットだけを書き込む
+// 同じクリップを同じ時刻で再生しているインスタンスはポーズキャッシュで1体分の評価結果を共有する
+// 足のIKを使うインスタンスの足元へのレイは、ジョブの前にまとめて1回でレイキャストする
+class AnimationSystem {
+public:
+    static AnimationSystem* GetInstance();
+
+    // 初期化（JobSystemのワーカーを使う）
+    void Initialize();
+    void Finalize();
+
+    bool IsInitialized() const { return initialized_; }
+
+    // 今フレームの評価対象に追加（同じフレームに複数回呼ばれても1回だけ評価する）
+    void Submit(Object3d* object);
+
+    // 評価前に破棄されるオブジェクトを取り除く
+    void Cancel(Object3d* object);
+
+    // 登録されたオブジェクトを並列に評価して登録をクリア
+    void Execute();
+
+    // 更新頻度LODの設定
+    void SetLodSettings(const AnimationLodSettings& settings) { lodSettings_ = settings; }
+    const AnimationLodSettings& GetLodSettings() const { return lodSettings_; }
+
+    // インスタンス間でポーズ・パレットを共有するか
+    void SetPoseCacheEnabled(bool enabled) { poseCacheEnabled_ = enabled; }
+    bool IsPoseCacheEnabled() const { return poseCacheEnabled_; }
+    AnimationPoseCache& GetPoseCache() { return poseCache_; }
+    const AnimationPoseCache& GetPoseCache() const { return poseCache_; }
+
+    // 直前のExecuteの情報
+    uint32_t GetLastInstanceCount() const { return lastInstanceCount_; }
+    uint32_t GetLastEvaluatedCount() const { return lastEvaluatedCount_; }
+    double GetLastExecuteMilliseconds() const { return lastExecuteMilliseconds_; }
+
+private:
+    // カメラから評価間隔を選び、今フレームで評価するかを決める
+    void ScheduleLod(Object3d* object);
+
+    // 足のIKを使うインスタンスの地面の高さをまとめてレイキャストして設定する
+    void CastFootIkRays();
+
+    bool initialized_ = false;
+    std::vector<Object3d*> pending_;
+
+    // 評価の段階（共有元の評価が終わってから共有先を処理する）
+    enum Stage : uint32_t {
+        kEvaluateStage,      // 自分で評価（共有元）・評価しないフレームの補間
+        kSharePoseStage,     // 共有元のポーズからパレットを計算
+        kSharePaletteStage,  // 共有元のパレットを使う（共有元はポーズ共有の場合もある）
+        kStageCount,
+    };
+    std::vector<Object3d*> stages_[kStageCount];
+
+    // 足のIKのレイキャスト（毎フレーム使い回す）
+    std::vector<Object3d*> footIkObjects_;
+    std::vector<Vector3> footIkOrigins_;
+    std::vector<Collision::Ray> footIkRays_;
+    std::vector<const Object3d*> footIkIgnoreObjects_;
+    std::vector<Collision::RaycastHit> footIkHits_;
+    std::vector<float> footIkHeights_;
+
+    AnimationPoseCache poseCache_;
+    bool poseCacheEnabled_ = true;
+
+    AnimationLodSettings lodSettings_;
+    uint64_t frameIndex_ = 0;
+    uint32_t nextPhase_ = 0;  // 登録順に割り当てて評価するフレームをずらす
+
+    uint32_t lastInstanceCount_ = 0;
+    uint32_t lastEvaluatedCount_ = 0;
+    double lastExecuteMilliseconds_ = 0.0;
+};
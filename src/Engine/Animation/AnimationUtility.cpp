@@ -2,6 +2,7 @@
 #include <cassert>
 #include <cmath>
 #include <algorithm>
+#include <optional>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -9,71 +10,81 @@
 #include <string>
 #include "Mymath.h"
 
-Vector3 CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time) {
-    assert(!keyframes.empty());
-    assert(!std::isnan(time));
-    
-    if (keyframes.size() == 1 || time <= keyframes[0].time) {
-        const Vector3& value = keyframes[0].value;
-        assert(!std::isnan(value.x) && !std::isnan(value.y) && !std::isnan(value.z));
-        return value;
-    }
-    
-    for (size_t index = 0; index < keyframes.size() - 1; ++index) {
-        size_t nextIndex = index + 1;
-        if (keyframes[index].time <= time && time <= keyframes[nextIndex].time) {
-            float timeDiff = keyframes[nextIndex].time - keyframes[index].time;
-            assert(timeDiff > 0.0f);
-            
-            float t = (time - keyframes[index].time) / timeDiff;
-            assert(!std::isnan(t));
-            assert(t >= 0.0f && t <= 1.0f);
-            
-            Vector3 result = Lerp(keyframes[index].value, keyframes[nextIndex].value, t);
-            assert(!std::isnan(result.x) && !std::isnan(result.y) && !std::isnan(result.z));
-            return result;
+namespace {
+    int32_t CreateJoint(const Node& node, std::optional<int32_t> parent, std::vector<Joint>& joints) {
+        Joint joint;
+        joint.name = node.name;
+        joint.localMatrix = node.localMatrix;
+        joint.skeletonSpaceMatrix = MakeIdentity4x4();
+        joint.transform.scale = node.transform.scale;
+        joint.transform.rotate = node.transform.rotate;
+        joint.transform.translate = node.transform.translate;
+        joint.index = int32_t(joints.size());
+        joint.parent = parent;
+
+        joints.push_back(joint);
+
+        for (const Node& child : node.children) {
+            int32_t childIndex = CreateJoint(child, joint.index, joints);
+            joints[joint.index].children.push_back(childIndex);
         }
+
+        return joint.index;
     }
-    
-    const Vector3& value = keyframes.back().value;
-    assert(!std::isnan(value.x) && !std::isnan(value.y) && !std::isnan(value.z));
-    return value;
 }
 
-Quaternion CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time) {
-    assert(!keyframes.empty());
-    assert(!std::isnan(time));
-    
-    if (keyframes.size() == 1 || time <= keyframes[0].time) {
-        const Quaternion& value = keyframes[0].value;
-        assert(!std::isnan(value.x) && !std::isnan(value.y) && !std::isnan(value.z) && !std::isnan(value.w));
-        return value;
-    }
-    
-    for (size_t index = 0; index < keyframes.size() - 1; ++index) {
-        size_t nextIndex = index + 1;
-        if (keyframes[index].time <= time && time <= keyframes[nextIndex].time) {
-            float timeDiff = keyframes[nextIndex].time - keyframes[index].time;
-            assert(timeDiff > 0.0f);
-            
-            float t = (time - keyframes[index].time) / timeDiff;
-            assert(!std::isnan(t));
-            assert(t >= 0.0f && t <= 1.0f);
-            
-            const Quaternion& q1 = keyframes[index].value;
-            const Quaternion& q2 = keyframes[nextIndex].value;
-            assert(!std::isnan(q1.x) && !std::isnan(q1.y) && !std::isnan(q1.z) && !std::isnan(q1.w));
-            assert(!std::isnan(q2.x) && !std::isnan(q2.y) && !std::isnan(q2.z) && !std::isnan(q2.w));
-            
-            Quaternion result = Slerp(q1, q2, t);
-            assert(!std::isnan(result.x) && !std::isnan(result.y) && !std::isnan(result.z) && !std::isnan(result.w));
-            return result;
+// assimpのアニメーションを変換（右手座標系→左手座標系）
+Animation ConvertAssimpAnimation(const aiAnimation* assimpAnimation) {
+    Animation animation;
+
+    // アニメーション時間を設定
+    animation.duration = static_cast<float>(assimpAnimation->mDuration / assimpAnimation->mTicksPerSecond);
+    animation.nodeAnimations.clear();
+
+    // 各ノードアニメーションチャンネルを処理
+    for (unsigned int i = 0; i < assimpAnimation->mNumChannels; i++) {
+        const aiNodeAnim* nodeAnim = assimpAnimation->mChannels[i];
+        std::string nodeName = nodeAnim->mNodeName.C_Str();
+
+        NodeAnimation& nodeAnimation = animation.nodeAnimations[nodeName];
+
+        // 位置キーフレーム（右手座標系→左手座標系：X座標を反転）
+        for (unsigned int j = 0; j < nodeAnim->mNumPositionKeys; j++) {
+            const aiVectorKey& key = nodeAnim->mPositionKeys[j];
+            KeyframeVector3 keyframe;
+            keyframe.time = static_cast<float>(key.mTime / assimpAnimation->mTicksPerSecond);
+            keyframe.value = {-key.mValue.x, key.mValue.y, key.mValue.z};
+            nodeAnimation.translate.push_back(keyframe);
+        }
+
+        // 回転キーフレーム（右手座標系→左手座標系）
+        for (unsigned int j = 0; j < nodeAnim->mNumRotationKeys; j++) {
+            const aiQuatKey& key = nodeAnim->mRotationKeys[j];
+            KeyframeQuaternion keyframe;
+            keyframe.time = static_cast<float>(key.mTime / assimpAnimation->mTicksPerSecond);
+
+            // Y,Z成分を反転
+            keyframe.value = {key.mValue.x, -key.mValue.y, -key.mValue.z, key.mValue.w};
+            nodeAnimation.rotate.push_back(keyframe);
+        }
+
+        // スケールキーフレーム（スケールは座標系に依存しない）
+        for (unsigned int j = 0; j < nodeAnim->mNumScalingKeys; j++) {
+            const aiVectorKey& key = nodeAnim->mScalingKeys[j];
+            KeyframeVector3 keyframe;
+            keyframe.time = static_cast<float>(key.mTime / assimpAnimation->mTicksPerSecond);
+            keyframe.value = {key.mValue.x, key.mValue.y, key.mValue.z};
+            nodeAnimation.scale.push_back(keyframe);
         }
+
+        ///OutputDebugStringA(("LoadAnimationFile: Node " + nodeName + " - Position keys: " + std::to_string(nodeAnimation.translate.size()) + 
+        ///                  ", Rotation keys: " + std::to_string(nodeAnimation.rotate.size()) + 
+        ///                  ", Scale keys: " + std::to_string(nodeAnimation.scale.size()) + "\n").c_str());
     }
-    
-    const Quaternion& value = keyframes.back().value;
-    assert(!std::isnan(value.x) && !std::isnan(value.y) && !std::isnan(value.z) && !std::isnan(value.w));
-    return value;
+
+    ///OutputDebugStringA(("LoadAnimationFile: Animation duration: " + std::to_string(animation.duration) + " seconds\n").c_str());
+
+    return animation;
 }
 
 // アニメーション読み込み関数
@@ -111,57 +122,52 @@ Animation LoadAnimationFile(const std::string& directoryPath, const std::string&
     }
     
     // 最初のアニメーションを処理
-    const aiAnimation* assimpAnimation = scene->mAnimations[0];
-    
-    OutputDebugStringA(("LoadAnimationFile: Processing animation with " + std::to_string(assimpAnimation->mNumChannels) + " channels\n").c_str());
-    
-    // アニメーション時間を設定
-    animation.duration = static_cast<float>(assimpAnimation->mDuration / assimpAnimation->mTicksPerSecond);
-    animation.nodeAnimations.clear();
-    
-    // 各ノードアニメーションチャンネルを処理
-    for (unsigned int i = 0; i < assimpAnimation->mNumChannels; i++) {
-        const aiNodeAnim* nodeAnim = assimpAnimation->mChannels[i];
-        std::string nodeName = nodeAnim->mNodeName.C_Str();
-        
-        NodeAnimation& nodeAnimation = animation.nodeAnimations[nodeName];
-        
-        // 位置キーフレーム（右手座標系→左手座標系：X座標を反転）
-        for (unsigned int j = 0; j < nodeAnim->mNumPositionKeys; j++) {
-            const aiVectorKey& key = nodeAnim->mPositionKeys[j];
-            KeyframeVector3 keyframe;
-            keyframe.time = static_cast<float>(key.mTime / assimpAnimation->mTicksPerSecond);
-            keyframe.value = {-key.mValue.x, key.mValue.y, key.mValue.z};  
-            nodeAnimation.translate.push_back(keyframe);
-        }
-        
-        // 回転キーフレーム（右手座標系→左手座標系）
-        for (unsigned int j = 0; j < nodeAnim->mNumRotationKeys; j++) {
-            const aiQuatKey& key = nodeAnim->mRotationKeys[j];
-            KeyframeQuaternion keyframe;
-            keyframe.time = static_cast<float>(key.mTime / assimpAnimation->mTicksPerSecond);
-            
+    OutputDebugStringA(("LoadAnimationFile: Processing animation with " + std::to_string(scene->mAnimations[0]->mNumChannels) + " channels\n").c_str());
+    return ConvertAssimpAnimation(scene->mAnimations[0]);
+}
 
-            // Y,Z成分を反転
-            keyframe.value = {key.mValue.x, -key.mValue.y, -key.mValue.z, key.mValue.w};
-            nodeAnimation.rotate.push_back(keyframe);
-        }
-        
-        // スケールキーフレーム（スケールは座標系に依存しない）
-        for (unsigned int j = 0; j < nodeAnim->mNumScalingKeys; j++) {
-            const aiVectorKey& key = nodeAnim->mScalingKeys[j];
-            KeyframeVector3 keyframe;
-            keyframe.time = static_cast<float>(key.mTime / assimpAnimation->mTicksPerSecond);
-            keyframe.value = {key.mValue.x, key.mValue.y, key.mValue.z};
-            nodeAnimation.scale.push_back(keyframe);
-        }
-        
-       ///OutputDebugStringA(("LoadAnimationFile: Node " + nodeName + " - Position keys: " + std::to_string(nodeAnimation.translate.size()) + 
-       ///                  ", Rotation keys: " + std::to_string(nodeAnimation.rotate.size()) + 
-       ///                  ", Scale keys: " + std::to_string(nodeAnimation.scale.size()) + "\n").c_str());
+Node ReadAssimpNode(const aiNode* node) {
+    Node result;
+    aiVector3D scale, translate;
+    aiQuaternion rotation;
+
+    node->mTransformation.Decompose(scale, rotation, translate);
+    result.transform.scale = { scale.x, scale.y, scale.z };
+    result.transform.rotate = { rotation.x, -rotation.y, -rotation.z, rotation.w };
+    result.transform.translate = { -translate.x, translate.y, translate.z };
+    result.localMatrix = MakeAffineMatrix(result.transform.scale, result.transform.rotate, result.transform.translate);
+    result.name = node->mName.C_Str();
+    result.children.resize(node->mNumChildren);
+    for (uint32_t childIndex = 0; childIndex < node->mNumChildren; ++childIndex) {
+        result.children[childIndex] = ReadAssimpNode(node->mChildren[childIndex]);
     }
-    
-    ///OutputDebugStringA(("LoadAnimationFile: Animation duration: " + std::to_string(animation.duration) + " seconds\n").c_str());
-    
-    return animation;
-}
\ No newline at end of file
+    return result;
+}
+
+Skeleton CreateSkeleton(const Node& rootNode) {
+    Skeleton skeleton;
+    skeleton.root = CreateJoint(rootNode, {}, skeleton.joints);
+    for (const Joint& joint : skeleton.joints) {
+        skeleton.jointMap.emplace(joint.name, joint.index);
+    }
+    return skeleton;
+}
+
+bool LoadAnimationClipAsset(const std::string& directoryPath, const std::string& filename, AnimationClipAsset& outAsset) {
+    // メッシュは使わないので後処理（三角形化など）はしない
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(directoryPath + "/" + filename, 0);
+    if (!scene || !scene->mRootNode) {
+        OutputDebugStringA(("LoadAnimationClipAsset: Error loading file: " + std::string(importer.GetErrorString()) + "\n").c_str());
+        return false;
+    }
+    if (scene->mNumAnimations == 0) {
+        OutputDebugStringA(("LoadAnimationClipAsset: No animations found in " + filename + "\n").c_str());
+        return false;
+    }
+
+    outAsset.animation = ConvertAssimpAnimation(scene->mAnimations[0]);
+    outAsset.skeleton = CreateSkeleton(ReadAssimpNode(scene->mRootNode));
+    outAsset.skeletonHash = HashSkeleton(outAsset.skeleton);
+    return true;
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "Animation.h"
+#include "AnimationSampler.h"
+#include "AnimationRetarget.h"
 #include "Mymath.h"
 #include <string>
 #include <vector>
@@ -7,11 +9,23 @@
 // アニメーション読み込み関数
 Animation LoadAnimationFile(const std::string& directoryPath, const std::string& filename);
 
-// 指定した時刻のVector3値を計算（線形補間）
-Vector3 CalculateValue(const std::vector<KeyframeVector3>& keyframes, float time);
+struct aiNode;
+struct aiAnimation;
 
-// 指定した時刻のQuaternion値を計算（球面線形補間）
-Quaternion CalculateValue(const std::vector<KeyframeQuaternion>& keyframes, float time);
+// assimpのノード階層を読み込む（右手座標系→左手座標系）
+Node ReadAssimpNode(const aiNode* node);
+
+// assimpのアニメーションを変換（右手座標系→左手座標系）
+Animation ConvertAssimpAnimation(const aiAnimation* assimpAnimation);
+
+// ノード階層からスケルトンを作成（親が先の順にジョイントを並べる）
+Skeleton CreateSkeleton(const Node& rootNode);
+
+// アニメーションと、それを作ったスケルトンだけを読み込む（メッシュ・マテリアル・GPUのリソースは作らない）
+// 複数のモデルで共有し、AnimatedModel::AddRetargetedAnimationで各モデルのスケルトンに合わせて使う
+bool LoadAnimationClipAsset(const std::string& directoryPath, const std::string& filename, AnimationClipAsset& outAsset);
+
+// キーフレームのサンプリング（CalculateValue）はAnimationSampler.hで定義
 
 // 線形補間関数
 Vector3 Lerp(const Vector3& start, const Vector3& end, float t);
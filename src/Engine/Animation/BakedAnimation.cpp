@@ -0,0 +1,254 @@
+#include "BakedAnimation.h"
+#include "SkeletonUpdate.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // 1ジョイント分の要素数（3列 × 4）
+    const uint32_t kFloatsPerJoint = BakedAnimationTable::kTexelsPerJoint * 4;
+
+    // 3列（各列は行列の列 = m[0..3][c]）から行列と法線用の逆転置行列を復元
+    void DecodeJoint(const float* columns, WellForGPU& out) {
+        Matrix4x4 matrix{};
+        for (int c = 0; c < 3; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                matrix.m[r][c] = columns[c * 4 + r];
+            }
+        }
+        matrix.m[3][3] = 1.0f;
+
+        // 逆転置行列の3x3は余因子行列/行列式、4列目は-t・余因子行/行列式（アフィン変換のみ）
+        const float* a0 = matrix.m[0];
+        const float* a1 = matrix.m[1];
+        const float* a2 = matrix.m[2];
+        float cofactor[3][3] = {
+            { a1[1] * a2[2] - a1[2] * a2[1], a1[2] * a2[0] - a1[0] * a2[2], a1[0] * a2[1] - a1[1] * a2[0] },
+            { a2[1] * a0[2] - a2[2] * a0[1], a2[2] * a0[0] - a2[0] * a0[2], a2[0] * a0[1] - a2[1] * a0[0] },
+            { a0[1] * a1[2] - a0[2] * a1[1], a0[2] * a1[0] - a0[0] * a1[2], a0[0] * a1[1] - a0[1] * a1[0] },
+        };
+        float determinant = a0[0] * cofactor[0][0] + a0[1] * cofactor[0][1] + a0[2] * cofactor[0][2];
+        float inverseDeterminant = std::fabs(determinant) > 1.0e-12f ? 1.0f / determinant : 0.0f;
+        const float* t = matrix.m[3];
+
+        Matrix4x4 inverseTranspose{};
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                inverseTranspose.m[r][c] = cofactor[r][c] * inverseDeterminant;
+            }
+            inverseTranspose.m[r][3] = -(t[0] * cofactor[r][0] + t[1] * cofactor[r][1] + t[2] * cofactor[r][2]) * inverseDeterminant;
+        }
+        inverseTranspose.m[3][3] = 1.0f;
+
+        out.skeletonSpaceMatrix = matrix;
+        out.skeletonSpaceInverseTransposeMatrix = inverseTranspose;
+    }
+}
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t exponent = (bits >> 23) & 0xffu;
+    uint32_t mantissa = bits & 0x7fffffu;
+
+    // NaN・無限大
+    if (exponent == 0xffu) {
+        return static_cast<uint16_t>(sign | 0x7c00u | (mantissa ? 0x200u : 0u));
+    }
+    int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+    if (halfExponent >= 0x1f) {
+        return static_cast<uint16_t>(sign | 0x7c00u);
+    }
+    if (halfExponent <= 0) {
+        // 非正規化数（小さすぎれば0）
+        if (halfExponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1fffu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        ++half;  // 繰り上がりで指数が増えても正しい値（最大なら無限大）になる
+    }
+    return static_cast<uint16_t>(sign | half);
+}
+
+float HalfToFloat(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1fu;
+    uint32_t mantissa = value & 0x3ffu;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // 非正規化数を正規化する
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400u) == 0) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+        }
+    } else if (exponent == 0x1fu) {
+        bits = sign | 0x7f800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+void BakedAnimationTable::Initialize(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices, BakedPaletteFormat format) {
+    assert(inverseBindPoseMatrices.size() >= skeleton.joints.size());
+    format_ = format;
+    skeleton_ = skeleton;
+    inverseBindPoseMatrices_ = inverseBindPoseMatrices;
+    clips_.clear();
+    rowCount_ = 0;
+    floatRows_.clear();
+    halfRows_.clear();
+}
+
+uint32_t BakedAnimationTable::AddClip(const CompiledAnimationClip& clip, float sampleRate) {
+    assert(clip.GetJointCount() == GetJointCount());
+    assert(sampleRate > 0.0f);
+
+    ClipRange range;
+    range.firstRow = rowCount_;
+    range.sampleRate = sampleRate;
+    range.duration = clip.GetDuration();
+    range.frameCount = static_cast<uint32_t>(std::ceil(range.duration * sampleRate)) + 1;
+
+    size_t rowFloats = static_cast<size_t>(GetJointCount()) * kFloatsPerJoint;
+    if (format_ == BakedPaletteFormat::Float3x4) {
+        floatRows_.reserve(floatRows_.size() + rowFloats * range.frameCount);
+    } else {
+        halfRows_.reserve(halfRows_.size() + rowFloats * range.frameCount);
+    }
+
+    // 実行時のObject3d::SkeletonUpdate / SkinClusterUpdateと同じ計算で各フレームのパレットを作る
+    Skeleton skeleton = skeleton_;
+    AnimationPose pose;
+    std::vector<WellForGPU> palette(GetJointCount());
+    for (uint32_t frame = 0; frame < range.frameCount; ++frame) {
+        float time = std::min(static_cast<float>(frame) / sampleRate, range.duration);
+        clip.Sample(time, pose);
+        ApplyPoseToSkeleton(pose, skeleton);
+        UpdateSkeletonSpaceMatrices(skeleton);
+        UpdateSkinPalette(skeleton, inverseBindPoseMatrices_, palette);
+        AppendRow(palette);
+    }
+
+    clips_.push_back(range);
+    return static_cast<uint32_t>(clips_.size() - 1);
+}
+
+void BakedAnimationTable::AppendRow(const std::vector<WellForGPU>& palette) {
+    for (const WellForGPU& well : palette) {
+        const Matrix4x4& matrix = well.skeletonSpaceMatrix;
+        for (int c = 0; c < 3; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                if (format_ == BakedPaletteFormat::Float3x4) {
+                    floatRows_.push_back(matrix.m[r][c]);
+                } else {
+                    halfRows_.push_back(FloatToHalf(matrix.m[r][c]));
+                }
+            }
+        }
+    }
+    ++rowCount_;
+}
+
+uint32_t BakedAnimationTable::GetRow(uint32_t clipIndex, float time, bool loop) const {
+    const ClipRange& range = clips_[clipIndex];
+    int64_t frame = std::llround(time * range.sampleRate);
+    if (loop && range.frameCount > 1) {
+        // 最後のフレームは先頭と同じ時刻なので折り返しは frameCount - 1 で行う
+        int64_t period = range.frameCount - 1;
+        frame %= period;
+        if (frame < 0) {
+            frame += period;
+        }
+    }
+    frame = std::clamp<int64_t>(frame, 0, range.frameCount - 1);
+    return range.firstRow + static_cast<uint32_t>(frame);
+}
+
+void BakedAnimationTable::LoadColumns(uint32_t row, uint32_t joint, float* out) const {
+    size_t offset = (static_cast<size_t>(row) * GetJointCount() + joint) * kFloatsPerJoint;
+    if (format_ == BakedPaletteFormat::Float3x4) {
+        std::memcpy(out, &floatRows_[offset], kFloatsPerJoint * sizeof(float));
+    } else {
+        for (uint32_t i = 0; i < kFloatsPerJoint; ++i) {
+            out[i] = HalfToFloat(halfRows_[offset + i]);
+        }
+    }
+}
+
+void BakedAnimationTable::DecodeRow(uint32_t row, std::span<WellForGPU> out) const {
+    assert(row < rowCount_ && out.size() >= GetJointCount());
+    float columns[kFloatsPerJoint];
+    for (uint32_t joint = 0; joint < GetJointCount(); ++joint) {
+        LoadColumns(row, joint, columns);
+        // 書き込み結合メモリを読み戻さないよう、ローカルで復元してから書き込む
+        WellForGPU well;
+        DecodeJoint(columns, well);
+        out[joint] = well;
+    }
+}
+
+void BakedAnimationTable::SamplePalette(uint32_t clipIndex, float time, bool loop, std::span<WellForGPU> out) const {
+    const ClipRange& range = clips_[clipIndex];
+    float position = time * range.sampleRate;
+    if (loop && range.frameCount > 1) {
+        float period = static_cast<float>(range.frameCount - 1);
+        position = std::fmod(position, period);
+        if (position < 0.0f) {
+            position += period;
+        }
+    }
+    position = std::clamp(position, 0.0f, static_cast<float>(range.frameCount - 1));
+    uint32_t frame = std::min(static_cast<uint32_t>(position), range.frameCount - 1);
+    uint32_t nextFrame = std::min(frame + 1, range.frameCount - 1);
+    float t = position - static_cast<float>(frame);
+
+    float columns[kFloatsPerJoint];
+    float nextColumns[kFloatsPerJoint];
+    for (uint32_t joint = 0; joint < GetJointCount(); ++joint) {
+        LoadColumns(range.firstRow + frame, joint, columns);
+        LoadColumns(range.firstRow + nextFrame, joint, nextColumns);
+        for (uint32_t i = 0; i < kFloatsPerJoint; ++i) {
+            columns[i] += (nextColumns[i] - columns[i]) * t;
+        }
+        WellForGPU well;
+        DecodeJoint(columns, well);
+        out[joint] = well;
+    }
+}
+
+size_t BakedAnimationTable::GetRowPitch() const {
+    size_t elementSize = format_ == BakedPaletteFormat::Float3x4 ? sizeof(float) : sizeof(uint16_t);
+    return static_cast<size_t>(GetJointCount()) * kFloatsPerJoint * elementSize;
+}
+
+const void* BakedAnimationTable::GetData() const {
+    if (format_ == BakedPaletteFormat::Float3x4) {
+        return floatRows_.data();
+    }
+    return halfRows_.data();
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "CompiledAnimationClip.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 焼き込んだパレットの形式
+enum class BakedPaletteFormat {
+    Float3x4,  // 3x4のfloat（1ジョイント48バイト）
+    Half3x4,   // 3x4のhalf（1ジョイント24バイト。移動量が大きいと精度が落ちる）
+};
+
+// クリップを一定間隔でサンプリングし、各フレームのパレットを表に焼き込む
+// 実行時は（クリップ, フレーム）から行を選んで読むだけで、サンプリングとスケルトンの評価を行わない
+// 1行が1フレームで、ジョイントごとにスケルトン空間行列の3列をRGBA 3テクセル分並べる
+// （R32G32B32A32_FLOAT / R16G16B16A16_FLOATのテクスチャにそのままアップロードできる配置）
+// 法線用の逆転置行列は持たず、復元時に3x3部分から計算する
+class BakedAnimationTable {
+public:
+    // 焼き込んだ1クリップ分の行の範囲
+    struct ClipRange {
+        uint32_t firstRow = 0;
+        uint32_t frameCount = 0;
+        float sampleRate = 0.0f;
+        float duration = 0.0f;
+    };
+
+    // スケルトン（親子関係と、クリップにないジョイントの変換）とバインドポーズの逆行列を設定して表を空にする
+    void Initialize(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices,
+        BakedPaletteFormat format = BakedPaletteFormat::Float3x4);
+
+    // クリップを1/sampleRate秒ごと（最後は終端）にサンプリングして追加し、クリップの番号を返す
+    uint32_t AddClip(const CompiledAnimationClip& clip, float sampleRate = 30.0f);
+
+    // 時刻に最も近いフレームの行（loopなら長さで折り返し、そうでなければ端で止める）
+    uint32_t GetRow(uint32_t clipIndex, float time, bool loop = false) const;
+
+    // 1行分をパレットに復元（outはGPUのアップロードバッファでよい）
+    void DecodeRow(uint32_t row, std::span<WellForGPU> out) const;
+
+    // 時刻の前後のフレームを補間してパレットに復元
+    void SamplePalette(uint32_t clipIndex, float time, bool loop, std::span<WellForGPU> out) const;
+
+    uint32_t GetClipCount() const { return static_cast<uint32_t>(clips_.size()); }
+    const ClipRange& GetClip(uint32_t clipIndex) const { return clips_[clipIndex]; }
+    uint32_t GetJointCount() const { return static_cast<uint32_t>(skeleton_.joints.size()); }
+    uint32_t GetRowCount() const { return rowCount_; }
+    BakedPaletteFormat GetFormat() const { return format_; }
+
+    // 1行のテクセル数（ジョイント数 × 3）とバイト数
+    uint32_t GetRowTexelCount() const { return GetJointCount() * kTexelsPerJoint; }
+    size_t GetRowPitch() const;
+
+    // 表の先頭（Float3x4ならfloat、Half3x4ならuint16_tの配列）と全体のバイト数
+    const void* GetData() const;
+    size_t GetMemorySize() const { return GetRowPitch() * rowCount_; }
+
+    static const uint32_t kTexelsPerJoint = 3;
+
+private:
+    // パレットの1行を末尾に追加
+    void AppendRow(const std::vector<WellForGPU>& palette);
+
+    // 1ジョイント分の3列（12要素）をfloatで取り出す
+    void LoadColumns(uint32_t row, uint32_t joint, float* out) const;
+
+    BakedPaletteFormat format_ = BakedPaletteFormat::Float3x4;
+    Skeleton skeleton_;
+    std::vector<Matrix4x4> inverseBindPoseMatrices_;
+    std::vector<ClipRange> clips_;
+    uint32_t rowCount_ = 0;
+
+    std::vector<float> floatRows_;
+    std::vector<uint16_t> halfRows_;
+};
+
+// floatとhalf（IEEE 754 binary16）の変換（丸めは最近接偶数）
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
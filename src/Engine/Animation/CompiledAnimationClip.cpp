@@ -0,0 +1,437 @@
+#include "CompiledAnimationClip.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+namespace {
+    // キーの配列上のtimeの位置（index == nextなら補間せずにそのキーの値を使う）
+    struct KeyPosition {
+        uint32_t index = 0;
+        uint32_t next = 0;
+        float t = 0.0f;
+    };
+
+    // timeを含む区間を探す（範囲外は端のキー）
+    KeyPosition FindKeyPosition(const float* times, uint32_t count, float time, KeyframeCursor* cursor) {
+        if (count == 1 || time <= times[0]) {
+            return {};
+        }
+        if (time >= times[count - 1]) {
+            return { count - 1, count - 1, 0.0f };
+        }
+
+        uint32_t index = FindKeyframeInterval(times, count, time, cursor);
+        float t = (time - times[index]) / (times[index + 1] - times[index]);
+        return { index, index + 1, t };
+    }
+
+    // positionの値を計算（loadはキー番号から値を取り出す。圧縮時は復元する）
+    template <typename Load, typename Interpolate>
+    auto SampleAt(const KeyPosition& position, Load load, Interpolate interpolate) {
+        if (position.index == position.next) {
+            return load(position.index);
+        }
+        return interpolate(load(position.index), load(position.next), position.t);
+    }
+
+    Vector3 LerpVector3(const Vector3& a, const Vector3& b, float t) { return Lerp(a, b, t); }
+    Quaternion SlerpQuaternion(const Quaternion& a, const Quaternion& b, float t) { return Slerp(a, b, t); }
+
+    // Sampleで読む配列
+    // ループの途中で補間の関数を呼ぶたびにメンバーを読み直さないよう、先にローカルに取り出しておく
+    struct PoseSource {
+        uint32_t jointCount;
+        const CompiledAnimationClip::TrackRange* tracks;
+        const uint8_t* timeChannels;
+        const float* times[CompiledAnimationClip::kChannelCount];
+        const AnimationPose* restPose;
+    };
+
+    // 全ジョイントのポーズを計算する（load*はジョイント番号と全体でのキー番号から値を取り出す）
+    // 区間の探索は時刻の配列ごとに1回（同じ時刻のチャンネルは結果を使い回し、値の変わらないチャンネルは探さない）
+    // 探索と補間を1ジョイントずつ交互に行うと遅いため、数ジョイント分の区間を先に探してからまとめて補間する
+    template <typename LoadTranslate, typename LoadRotate, typename LoadScale>
+    void SamplePose(const PoseSource& source, float time, KeyframeCursor* cursors, AnimationPose& outPose,
+        LoadTranslate loadTranslate, LoadRotate loadRotate, LoadScale loadScale) {
+
+        const uint32_t kChannelCount = CompiledAnimationClip::kChannelCount;
+        const uint32_t kBlockJointCount = 16;
+        Vector3* outTranslate = outPose.translate.data();
+        Quaternion* outRotate = outPose.rotate.data();
+        Vector3* outScale = outPose.scale.data();
+        KeyPosition positions[kBlockJointCount][kChannelCount];
+        for (uint32_t first = 0; first < source.jointCount; first += kBlockJointCount) {
+            const uint32_t last = std::min(first + kBlockJointCount, source.jointCount);
+
+            for (uint32_t joint = first; joint < last; ++joint) {
+                const CompiledAnimationClip::TrackRange* range = &source.tracks[joint * kChannelCount];
+                const uint8_t* timeChannel = &source.timeChannels[joint * kChannelCount];
+                KeyframeCursor* cursor = cursors ? &cursors[joint * kChannelCount] : nullptr;
+                KeyPosition* position = positions[joint - first];
+                for (uint32_t channel = 0; channel < kChannelCount; ++channel) {
+                    uint32_t timeSource = timeChannel[channel];
+                    if (timeSource == channel) {
+                        position[channel] = FindKeyPosition(source.times[channel] + range[channel].offset, range[channel].count, time,
+                            cursor ? &cursor[channel] : nullptr);
+                    } else if (timeSource != kChannelCount) {
+                        position[channel] = position[timeSource];
+                    } else {
+                        position[channel] = {};
+                    }
+                }
+            }
+
+            for (uint32_t joint = first; joint < last; ++joint) {
+                const CompiledAnimationClip::TrackRange* range = &source.tracks[joint * kChannelCount];
+                const KeyPosition* position = positions[joint - first];
+                const uint32_t translateOffset = range[CompiledAnimationClip::kTranslate].offset;
+                const uint32_t rotateOffset = range[CompiledAnimationClip::kRotate].offset;
+                const uint32_t scaleOffset = range[CompiledAnimationClip::kScale].offset;
+                outTranslate[joint] = range[CompiledAnimationClip::kTranslate].count ?
+                    SampleAt(position[CompiledAnimationClip::kTranslate], [&](uint32_t i) { return loadTranslate(joint, translateOffset + i); }, LerpVector3) :
+                    source.restPose->translate[joint];
+                outRotate[joint] = range[CompiledAnimationClip::kRotate].count ?
+                    SampleAt(position[CompiledAnimationClip::kRotate], [&](uint32_t i) { return loadRotate(rotateOffset + i); }, SlerpQuaternion) :
+                    source.restPose->rotate[joint];
+                outScale[joint] = range[CompiledAnimationClip::kScale].count ?
+                    SampleAt(position[CompiledAnimationClip::kScale], [&](uint32_t i) { return loadScale(joint, scaleOffset + i); }, LerpVector3) :
+                    source.restPose->scale[joint];
+            }
+        }
+    }
+
+    // 1トラック分を量子化し、残したキーだけを追加する
+    CompiledAnimationClip::TrackRange CompressVector3Track(
+        const float* times, const Vector3* values, uint32_t count, float tolerance, uint32_t maxKeySpan,
+        QuantizationRange& outRange, std::vector<float>& outTimes, std::vector<PackedVector3>& outValues) {
+
+        outRange = MakeQuantizationRange(values, count);
+        std::vector<PackedVector3> packed(count);
+        std::vector<Vector3> decoded(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            packed[i] = PackVector3(values[i], outRange);
+            decoded[i] = UnpackVector3(packed[i], outRange);
+        }
+
+        CompiledAnimationClip::TrackRange range;
+        range.offset = static_cast<uint32_t>(outTimes.size());
+        for (uint32_t key : SelectKeys(times, values, decoded.data(), count, tolerance, maxKeySpan)) {
+            outTimes.push_back(times[key]);
+            outValues.push_back(packed[key]);
+        }
+        range.count = static_cast<uint32_t>(outTimes.size()) - range.offset;
+        return range;
+    }
+
+    CompiledAnimationClip::TrackRange CompressQuaternionTrack(
+        const float* times, const Quaternion* values, uint32_t count, float tolerance, uint32_t maxKeySpan,
+        std::vector<float>& outTimes, std::vector<PackedQuaternion>& outValues) {
+
+        std::vector<PackedQuaternion> packed(count);
+        std::vector<Quaternion> decoded(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            packed[i] = PackQuaternion(values[i]);
+            decoded[i] = UnpackQuaternion(packed[i]);
+        }
+
+        CompiledAnimationClip::TrackRange range;
+        range.offset = static_cast<uint32_t>(outTimes.size());
+        for (uint32_t key : SelectKeys(times, values, decoded.data(), count, tolerance, maxKeySpan)) {
+            outTimes.push_back(times[key]);
+            outValues.push_back(packed[key]);
+        }
+        range.count = static_cast<uint32_t>(outTimes.size()) - range.offset;
+        return range;
+    }
+
+    template <typename T>
+    size_t GetVectorSize(const std::vector<T>& values) {
+        return values.size() * sizeof(T);
+    }
+
+    template <typename T>
+    uint64_t HashVector(const std::vector<T>& values, uint64_t seed) {
+        return HashBytes(values.data(), GetVectorSize(values), seed);
+    }
+
+    // キーフレーム配列をチャンネルの配列に追加
+    template <typename Keyframe, typename Value>
+    CompiledAnimationClip::TrackRange AppendTrack(const std::vector<Keyframe>& keyframes, std::vector<float>& times, std::vector<Value>& values) {
+        CompiledAnimationClip::TrackRange range;
+        range.offset = static_cast<uint32_t>(times.size());
+        range.count = static_cast<uint32_t>(keyframes.size());
+        for (const Keyframe& keyframe : keyframes) {
+            times.push_back(keyframe.time);
+            values.push_back(keyframe.value);
+        }
+        return range;
+    }
+
+    // 最初のキーと値が違うキーがあるか（ビット単位で比べる。少しでも違えば変化するとみなす）
+    template <typename Value>
+    bool IsTrackVarying(const std::vector<Value>& values, const CompiledAnimationClip::TrackRange& range) {
+        for (uint32_t i = 1; i < range.count; ++i) {
+            if (std::memcmp(&values[range.offset + i], &values[range.offset], sizeof(Value)) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+void AnimationPose::Resize(uint32_t jointCount) {
+    translate.resize(jointCount);
+    rotate.resize(jointCount);
+    scale.resize(jointCount);
+}
+
+void ReadPoseFromSkeleton(const Skeleton& skeleton, AnimationPose& outPose) {
+    outPose.Resize(static_cast<uint32_t>(skeleton.joints.size()));
+    for (size_t i = 0; i < skeleton.joints.size(); ++i) {
+        const Joint& joint = skeleton.joints[i];
+        outPose.translate[i] = joint.transform.translate;
+        outPose.rotate[i] = joint.transform.rotate;
+        outPose.scale[i] = joint.transform.scale;
+    }
+}
+
+void ApplyPoseToSkeleton(const AnimationPose& pose, Skeleton& skeleton) {
+    assert(pose.GetJointCount() == skeleton.joints.size());
+    for (size_t i = 0; i < skeleton.joints.size(); ++i) {
+        Joint& joint = skeleton.joints[i];
+        joint.transform.translate = pose.translate[i];
+        joint.transform.rotate = pose.rotate[i];
+        joint.transform.scale = pose.scale[i];
+    }
+}
+
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void CompiledAnimationClip::Compile(const Animation& animation, const Skeleton& skeleton) {
+    duration_ = animation.duration;
+    jointCount_ = static_cast<uint32_t>(skeleton.joints.size());
+    tracks_.assign(static_cast<size_t>(jointCount_) * kChannelCount, TrackRange{});
+    animatedJoints_.assign(jointCount_, 0);
+    timeChannels_.assign(static_cast<size_t>(jointCount_) * kChannelCount, kChannelCount);
+    for (std::vector<float>& times : times_) {
+        times.clear();
+    }
+    translateValues_.clear();
+    rotateValues_.clear();
+    scaleValues_.clear();
+    compressed_ = false;
+    packedTranslateValues_.clear();
+    packedRotateValues_.clear();
+    packedScaleValues_.clear();
+    translateRanges_.clear();
+    scaleRanges_.clear();
+    ReadPoseFromSkeleton(skeleton, restPose_);
+
+    // ジョイント番号順に詰める（文字列での検索はここだけ）
+    for (const Joint& joint : skeleton.joints) {
+        auto it = animation.nodeAnimations.find(joint.name);
+        if (it == animation.nodeAnimations.end()) {
+            continue;
+        }
+        const NodeAnimation& nodeAnimation = it->second;
+        TrackRange* range = &tracks_[static_cast<size_t>(joint.index) * kChannelCount];
+        range[kTranslate] = AppendTrack(nodeAnimation.translate, times_[kTranslate], translateValues_);
+        range[kRotate] = AppendTrack(nodeAnimation.rotate, times_[kRotate], rotateValues_);
+        range[kScale] = AppendTrack(nodeAnimation.scale, times_[kScale], scaleValues_);
+        uint8_t* timeChannel = &timeChannels_[static_cast<size_t>(joint.index) * kChannelCount];
+        timeChannel[kTranslate] = IsTrackVarying(translateValues_, range[kTranslate]) ? kTranslate : kChannelCount;
+        timeChannel[kRotate] = IsTrackVarying(rotateValues_, range[kRotate]) ? kRotate : kChannelCount;
+        timeChannel[kScale] = IsTrackVarying(scaleValues_, range[kScale]) ? kScale : kChannelCount;
+        animatedJoints_[joint.index] = timeChannel[kTranslate] != kChannelCount || timeChannel[kRotate] != kChannelCount ||
+            timeChannel[kScale] != kChannelCount;
+    }
+    LinkSharedTimes();
+    UpdateContentHash();
+}
+
+void CompiledAnimationClip::Compress(const AnimationCompressionSettings& settings) {
+    if (compressed_) {
+        return;
+    }
+
+    std::vector<float> times[kChannelCount];
+    translateRanges_.assign(jointCount_, QuantizationRange{});
+    scaleRanges_.assign(jointCount_, QuantizationRange{});
+
+    for (uint32_t joint = 0; joint < jointCount_; ++joint) {
+        TrackRange* range = &tracks_[static_cast<size_t>(joint) * kChannelCount];
+        if (range[kTranslate].count > 0) {
+            uint32_t offset = range[kTranslate].offset;
+            range[kTranslate] = CompressVector3Track(&times_[kTranslate][offset], &translateValues_[offset], range[kTranslate].count,
+                settings.translateTolerance, settings.maxKeySpan, translateRanges_[joint], times[kTranslate], packedTranslateValues_);
+        }
+        if (range[kRotate].count > 0) {
+            uint32_t offset = range[kRotate].offset;
+            range[kRotate] = CompressQuaternionTrack(&times_[kRotate][offset], &rotateValues_[offset], range[kRotate].count,
+                settings.rotateTolerance, settings.maxKeySpan, times[kRotate], packedRotateValues_);
+        }
+        if (range[kScale].count > 0) {
+            uint32_t offset = range[kScale].offset;
+            range[kScale] = CompressVector3Track(&times_[kScale][offset], &scaleValues_[offset], range[kScale].count,
+                settings.scaleTolerance, settings.maxKeySpan, scaleRanges_[joint], times[kScale], packedScaleValues_);
+        }
+    }
+
+    // 元の値は解放する
+    for (uint32_t channel = 0; channel < kChannelCount; ++channel) {
+        times[channel].shrink_to_fit();
+        times_[channel] = std::move(times[channel]);
+    }
+    std::vector<Vector3>().swap(translateValues_);
+    std::vector<Quaternion>().swap(rotateValues_);
+    std::vector<Vector3>().swap(scaleValues_);
+    packedTranslateValues_.shrink_to_fit();
+    packedRotateValues_.shrink_to_fit();
+    packedScaleValues_.shrink_to_fit();
+    compressed_ = true;
+    LinkSharedTimes();
+    UpdateContentHash();
+}
+
+void CompiledAnimationClip::LinkSharedTimes() {
+    for (uint32_t joint = 0; joint < jointCount_; ++joint) {
+        const TrackRange* range = &tracks_[static_cast<size_t>(joint) * kChannelCount];
+        uint8_t* timeChannel = &timeChannels_[static_cast<size_t>(joint) * kChannelCount];
+        for (uint32_t channel = 0; channel < kChannelCount; ++channel) {
+            if (timeChannel[channel] == kChannelCount) {
+                continue;
+            }
+            // 前のチャンネルと時刻の配列が同じなら、そのチャンネルの区間を使う（キーを間引いた後は一致しないことが多い）
+            timeChannel[channel] = static_cast<uint8_t>(channel);
+            for (uint32_t source = 0; source < channel; ++source) {
+                if (timeChannel[source] == source && range[source].count == range[channel].count &&
+                    std::memcmp(&times_[source][range[source].offset], &times_[channel][range[channel].offset],
+                        sizeof(float) * range[channel].count) == 0) {
+                    timeChannel[channel] = static_cast<uint8_t>(source);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void CompiledAnimationClip::UpdateContentHash() {
+    uint64_t hash = HashBytes(&duration_, sizeof(duration_));
+    hash = HashBytes(&jointCount_, sizeof(jointCount_), hash);
+    hash = HashVector(tracks_, hash);
+    for (const std::vector<float>& times : times_) {
+        hash = HashVector(times, hash);
+    }
+    hash = HashVector(translateValues_, hash);
+    hash = HashVector(rotateValues_, hash);
+    hash = HashVector(scaleValues_, hash);
+    hash = HashVector(packedTranslateValues_, hash);
+    hash = HashVector(packedRotateValues_, hash);
+    hash = HashVector(packedScaleValues_, hash);
+    hash = HashVector(translateRanges_, hash);
+    hash = HashVector(scaleRanges_, hash);
+    hash = HashVector(restPose_.translate, hash);
+    hash = HashVector(restPose_.rotate, hash);
+    contentHash_ = HashVector(restPose_.scale, hash);
+}
+
+size_t CompiledAnimationClip::GetMemorySize() const {
+    size_t size = GetVectorSize(tracks_) + GetVectorSize(animatedJoints_) + GetVectorSize(timeChannels_);
+    for (const std::vector<float>& times : times_) {
+        size += GetVectorSize(times);
+    }
+    size += GetVectorSize(translateValues_) + GetVectorSize(rotateValues_) + GetVectorSize(scaleValues_);
+    size += GetVectorSize(packedTranslateValues_) + GetVectorSize(packedRotateValues_) + GetVectorSize(packedScaleValues_);
+    size += GetVectorSize(translateRanges_) + GetVectorSize(scaleRanges_);
+    return size;
+}
+
+uint32_t CompiledAnimationClip::GetSampleKeyCount(uint32_t joint, Channel channel) const {
+    // 値の変わらないトラックは最初のキーをそのまま返す（同じ値の補間で誤差が出ると、毎フレーム同じ値にならない）
+    return timeChannels_[joint * kChannelCount + channel] != kChannelCount ? GetTrack(joint, channel).count : 1;
+}
+
+Vector3 CompiledAnimationClip::SampleTranslate(uint32_t joint, float time, KeyframeCursor* cursor) const {
+    const TrackRange& range = GetTrack(joint, kTranslate);
+    if (range.count == 0) {
+        return restPose_.translate[joint];
+    }
+    KeyPosition position = FindKeyPosition(&times_[kTranslate][range.offset], GetSampleKeyCount(joint, kTranslate), time, cursor);
+    if (compressed_) {
+        const PackedVector3* values = &packedTranslateValues_[range.offset];
+        const QuantizationRange& quantization = translateRanges_[joint];
+        return SampleAt(position, [&](uint32_t i) { return UnpackVector3(values[i], quantization); }, LerpVector3);
+    }
+    const Vector3* values = &translateValues_[range.offset];
+    return SampleAt(position, [&](uint32_t i) { return values[i]; }, LerpVector3);
+}
+
+Quaternion CompiledAnimationClip::SampleRotate(uint32_t joint, float time, KeyframeCursor* cursor) const {
+    const TrackRange& range = GetTrack(joint, kRotate);
+    if (range.count == 0) {
+        return restPose_.rotate[joint];
+    }
+    KeyPosition position = FindKeyPosition(&times_[kRotate][range.offset], GetSampleKeyCount(joint, kRotate), time, cursor);
+    if (compressed_) {
+        const PackedQuaternion* values = &packedRotateValues_[range.offset];
+        return SampleAt(position, [&](uint32_t i) { return UnpackQuaternion(values[i]); }, SlerpQuaternion);
+    }
+    const Quaternion* values = &rotateValues_[range.offset];
+    return SampleAt(position, [&](uint32_t i) { return values[i]; }, SlerpQuaternion);
+}
+
+Vector3 CompiledAnimationClip::SampleScale(uint32_t joint, float time, KeyframeCursor* cursor) const {
+    const TrackRange& range = GetTrack(joint, kScale);
+    if (range.count == 0) {
+        return restPose_.scale[joint];
+    }
+    KeyPosition position = FindKeyPosition(&times_[kScale][range.offset], GetSampleKeyCount(joint, kScale), time, cursor);
+    if (compressed_) {
+        const PackedVector3* values = &packedScaleValues_[range.offset];
+        const QuantizationRange& quantization = scaleRanges_[joint];
+        return SampleAt(position, [&](uint32_t i) { return UnpackVector3(values[i], quantization); }, LerpVector3);
+    }
+    const Vector3* values = &scaleValues_[range.offset];
+    return SampleAt(position, [&](uint32_t i) { return values[i]; }, LerpVector3);
+}
+
+uint32_t CompiledAnimationClip::GetAnimatedJointCount() const {
+    uint32_t count = 0;
+    for (uint8_t animated : animatedJoints_) {
+        count += animated;
+    }
+    return count;
+}
+
+void CompiledAnimationClip::Sample(float time, AnimationPose& outPose, KeyframeCursor* cursors) const {
+    outPose.Resize(jointCount_);
+    PoseSource source = { jointCount_, tracks_.data(), timeChannels_.data(),
+        { times_[kTranslate].data(), times_[kRotate].data(), times_[kScale].data() }, &restPose_ };
+    if (compressed_) {
+        const PackedVector3* translateValues = packedTranslateValues_.data();
+        const PackedQuaternion* rotateValues = packedRotateValues_.data();
+        const PackedVector3* scaleValues = packedScaleValues_.data();
+        const QuantizationRange* translateRanges = translateRanges_.data();
+        const QuantizationRange* scaleRanges = scaleRanges_.data();
+        SamplePose(source, time, cursors, outPose,
+            [=](uint32_t joint, uint32_t key) { return UnpackVector3(translateValues[key], translateRanges[joint]); },
+            [=](uint32_t key) { return UnpackQuaternion(rotateValues[key]); },
+            [=](uint32_t joint, uint32_t key) { return UnpackVector3(scaleValues[key], scaleRanges[joint]); });
+        return;
+    }
+    const Vector3* translateValues = translateValues_.data();
+    const Quaternion* rotateValues = rotateValues_.data();
+    const Vector3* scaleValues = scaleValues_.data();
+    SamplePose(source, time, cursors, outPose,
+        [=](uint32_t, uint32_t key) { return translateValues[key]; },
+        [=](uint32_t key) { return rotateValues[key]; },
+        [=](uint32_t, uint32_t key) { return scaleValues[key]; });
+}
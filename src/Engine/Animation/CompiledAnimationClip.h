@@ -0,0 +1,135 @@
+#pragma once
+#include "AnimationCompression.h"
+#include "AnimationData.h"
+#include "AnimationSampler.h"
+#include <cstdint>
+#include <vector>
+
+// ジョイント番号順のポーズ（チャンネルごとの連続した配列）
+struct AnimationPose {
+    std::vector<Vector3> translate;
+    std::vector<Quaternion> rotate;
+    std::vector<Vector3> scale;
+
+    // ジョイント数に合わせて確保（同じ数なら何もしない）
+    void Resize(uint32_t jointCount);
+
+    uint32_t GetJointCount() const { return static_cast<uint32_t>(rotate.size()); }
+};
+
+// スケルトンのジョイントの現在の変換をポーズに読み込む
+void ReadPoseFromSkeleton(const Skeleton& skeleton, AnimationPose& outPose);
+
+// ポーズをスケルトンのジョイントに書き込む
+void ApplyPoseToSkeleton(const AnimationPose& pose, Skeleton& skeleton);
+
+// バイト列のハッシュ（64bit FNV-1a。seedに前の結果を渡して連結できる）
+uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
+
+// スケルトンに結び付けてコンパイルしたアニメーションクリップ
+// ジョイント番号順・チャンネルごとに時刻と値を連続した配列に詰めておき、
+// 実行時のサンプリングは文字列の検索なしに添字だけで行う
+class CompiledAnimationClip {
+public:
+    // チャンネルの種類
+    enum Channel : uint32_t {
+        kTranslate,
+        kRotate,
+        kScale,
+        kChannelCount,
+    };
+
+    // ジョイント1チャンネル分のキーの範囲（countが0ならアニメーションなし）
+    struct TrackRange {
+        uint32_t offset = 0;
+        uint32_t count = 0;
+    };
+
+    // アニメーションをスケルトンに結び付けてコンパイル
+    // スケルトンにないノードのトラックは捨て、アニメーションのないジョイントはスケルトンの現在の変換を使う
+    void Compile(const Animation& animation, const Skeleton& skeleton);
+
+    // キーを間引き、回転を48bit・移動とスケールをトラックごとの範囲で16bitに量子化する
+    // 圧縮後は元の値の配列を解放し、サンプリングは量子化した値から復元して行う
+    void Compress(const AnimationCompressionSettings& settings = {});
+
+    // 指定時刻のポーズをジョイント番号順に書き込む
+    // cursorsはGetCursorCount()個の配列（nullptrなら毎回二分探索）
+    void Sample(float time, AnimationPose& outPose, KeyframeCursor* cursors = nullptr) const;
+
+    // 1ジョイント・1チャンネル分の値を計算
+    Vector3 SampleTranslate(uint32_t joint, float time, KeyframeCursor* cursor = nullptr) const;
+    Quaternion SampleRotate(uint32_t joint, float time, KeyframeCursor* cursor = nullptr) const;
+    Vector3 SampleScale(uint32_t joint, float time, KeyframeCursor* cursor = nullptr) const;
+
+    // 情報の取得
+    float GetDuration() const { return duration_; }
+    uint32_t GetJointCount() const { return jointCount_; }
+    uint32_t GetCursorCount() const { return jointCount_ * kChannelCount; }
+    bool IsEmpty() const { return jointCount_ == 0; }
+    const TrackRange& GetTrack(uint32_t joint, Channel channel) const { return tracks_[joint * kChannelCount + channel]; }
+    bool IsAnimated(uint32_t joint, Channel channel) const { return GetTrack(joint, channel).count > 1; }
+
+    // ジョイントの値が時間とともに変わるか（どれかのチャンネルに最初のキーと違うキーがある）
+    // キーが複数あってもすべて同じ値のトラック（指・顔などの静止したジョイント）は変わらないとみなす
+    bool IsJointAnimated(uint32_t joint) const { return animatedJoints_[joint] != 0; }
+    const std::vector<uint8_t>& GetAnimatedJoints() const { return animatedJoints_; }
+    uint32_t GetAnimatedJointCount() const;
+    const AnimationPose& GetRestPose() const { return restPose_; }
+    bool IsCompressed() const { return compressed_; }
+
+    // キーと付随データが使用するメモリ量（バイト）
+    size_t GetMemorySize() const;
+
+    // キーと基準ポーズの内容のハッシュ（同じファイルを同じスケルトンに結び付けたクリップは同じ値）
+    // 別のAnimatedModelが持つクリップ同士でポーズを共有するときのキーに使う
+    uint64_t GetContentHash() const { return contentHash_; }
+
+    // キーの配列（TrackRangeのoffsetから参照する。値の配列は圧縮後は空）
+    const std::vector<float>& GetTimes(Channel channel) const { return times_[channel]; }
+    const std::vector<Vector3>& GetTranslateValues() const { return translateValues_; }
+    const std::vector<Quaternion>& GetRotateValues() const { return rotateValues_; }
+    const std::vector<Vector3>& GetScaleValues() const { return scaleValues_; }
+
+private:
+    // 現在のキーからcontentHash_を計算
+    void UpdateContentHash();
+
+    // サンプリングで見るキーの数（値の変わらないトラックは1）
+    uint32_t GetSampleKeyCount(uint32_t joint, Channel channel) const;
+
+    // 同じジョイントで時刻の配列が同じチャンネルを結び付ける（Compile・Compressの後に呼ぶ）
+    void LinkSharedTimes();
+
+    float duration_ = 0.0f;
+    uint32_t jointCount_ = 0;
+    uint64_t contentHash_ = 0;
+
+    // ジョイント×チャンネルごとのキーの範囲
+    std::vector<TrackRange> tracks_;
+
+    // ジョイントごとに値が時間とともに変わるなら1（コンパイル時の元のキーで判定し、圧縮後もそのまま使う）
+    std::vector<uint8_t> animatedJoints_;
+
+    // ジョイント×チャンネルごとに区間を探す時刻の配列のチャンネル
+    // 自分のチャンネルなら自分で探し、前のチャンネルなら同じ時刻の配列なのでその区間を使う
+    // kChannelCountなら値が変わらないので最初のキーをそのまま使う
+    std::vector<uint8_t> timeChannels_;
+
+    // チャンネルごとの時刻と値（全ジョイント分を連結）
+    std::vector<float> times_[kChannelCount];
+    std::vector<Vector3> translateValues_;
+    std::vector<Quaternion> rotateValues_;
+    std::vector<Vector3> scaleValues_;
+
+    // 圧縮後の値（移動・スケールの量子化範囲はジョイントごと）
+    bool compressed_ = false;
+    std::vector<PackedVector3> packedTranslateValues_;
+    std::vector<PackedQuaternion> packedRotateValues_;
+    std::vector<PackedVector3> packedScaleValues_;
+    std::vector<QuantizationRange> translateRanges_;
+    std::vector<QuantizationRange> scaleRanges_;
+
+    // アニメーションのないジョイントに使う変換
+    AnimationPose restPose_;
+};
@@ -0,0 +1,171 @@
+#include "CpuSkinning.h"
+#include "DualQuaternionSkinning.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// x64ではSSE2が常に使えるため、行列の1行を1レジスタで処理する
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CPU_SKINNING_SSE2
+#endif
+
+namespace {
+    // 範囲（中心と半分の大きさ）を行ベクトル規約の行列で変換したAABB
+    // 中心は行列で変換し、半分の大きさは3x3部分の絶対値で広げる
+    SkinnedBounds TransformBounds(const SkinnedBounds& bounds, const Matrix4x4& matrix) {
+        Vector3 center = { (bounds.min.x + bounds.max.x) * 0.5f, (bounds.min.y + bounds.max.y) * 0.5f, (bounds.min.z + bounds.max.z) * 0.5f };
+        Vector3 extent = { (bounds.max.x - bounds.min.x) * 0.5f, (bounds.max.y - bounds.min.y) * 0.5f, (bounds.max.z - bounds.min.z) * 0.5f };
+
+        float newCenter[4];
+        float newExtent[4];
+#ifdef CPU_SKINNING_SSE2
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 row0 = _mm_loadu_ps(matrix.m[0]);
+        __m128 row1 = _mm_loadu_ps(matrix.m[1]);
+        __m128 row2 = _mm_loadu_ps(matrix.m[2]);
+        __m128 c = _mm_loadu_ps(matrix.m[3]);
+        c = _mm_add_ps(c, _mm_mul_ps(row0, _mm_set1_ps(center.x)));
+        c = _mm_add_ps(c, _mm_mul_ps(row1, _mm_set1_ps(center.y)));
+        c = _mm_add_ps(c, _mm_mul_ps(row2, _mm_set1_ps(center.z)));
+        __m128 e = _mm_mul_ps(_mm_andnot_ps(signMask, row0), _mm_set1_ps(extent.x));
+        e = _mm_add_ps(e, _mm_mul_ps(_mm_andnot_ps(signMask, row1), _mm_set1_ps(extent.y)));
+        e = _mm_add_ps(e, _mm_mul_ps(_mm_andnot_ps(signMask, row2), _mm_set1_ps(extent.z)));
+        _mm_storeu_ps(newCenter, c);
+        _mm_storeu_ps(newExtent, e);
+#else
+        for (int k = 0; k < 3; ++k) {
+            newCenter[k] = center.x * matrix.m[0][k] + center.y * matrix.m[1][k] + center.z * matrix.m[2][k] + matrix.m[3][k];
+            newExtent[k] = extent.x * std::fabs(matrix.m[0][k]) + extent.y * std::fabs(matrix.m[1][k]) + extent.z * std::fabs(matrix.m[2][k]);
+        }
+#endif
+        SkinnedBounds result;
+        result.min = { newCenter[0] - newExtent[0], newCenter[1] - newExtent[1], newCenter[2] - newExtent[2] };
+        result.max = { newCenter[0] + newExtent[0], newCenter[1] + newExtent[1], newCenter[2] + newExtent[2] };
+        return result;
+    }
+}
+
+void SkinnedBounds::Expand(const Vector3& point) {
+    min = { std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z) };
+    max = { std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z) };
+}
+
+void SkinnedBounds::Merge(const SkinnedBounds& other) {
+    if (other.IsEmpty()) {
+        return;
+    }
+    Expand(other.min);
+    Expand(other.max);
+}
+
+void SkinVertices(std::span<const WellForGPU> palette, std::span<const VertexInfluence> influences,
+    std::span<const VertexData> vertices, std::span<Vector3> outPositions, std::span<Vector3> outNormals) {
+
+    assert(influences.size() >= vertices.size());
+    assert(outPositions.size() >= vertices.size() && outNormals.size() >= vertices.size());
+
+#ifdef CPU_SKINNING_SSE2
+    // 法線は3成分だけを使う（4列目には平行移動の逆変換が入っている）
+    const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    for (size_t v = 0; v < vertices.size(); ++v) {
+        const VertexInfluence& influence = influences[v];
+
+        // 重みで合成した位置用の4行と法線用の3行
+        __m128 row0 = _mm_setzero_ps();
+        __m128 row1 = _mm_setzero_ps();
+        __m128 row2 = _mm_setzero_ps();
+        __m128 row3 = _mm_setzero_ps();
+        __m128 normalRow0 = _mm_setzero_ps();
+        __m128 normalRow1 = _mm_setzero_ps();
+        __m128 normalRow2 = _mm_setzero_ps();
+        for (uint32_t i = 0; i < kNumMaxInfluence; ++i) {
+            float weight = influence.weights[i];
+            if (weight == 0.0f) {
+                continue;
+            }
+            const WellForGPU& well = palette[influence.jointIndices[i]];
+            const __m128 w = _mm_set1_ps(weight);
+            row0 = _mm_add_ps(row0, _mm_mul_ps(_mm_loadu_ps(well.skeletonSpaceMatrix.m[0]), w));
+            row1 = _mm_add_ps(row1, _mm_mul_ps(_mm_loadu_ps(well.skeletonSpaceMatrix.m[1]), w));
+            row2 = _mm_add_ps(row2, _mm_mul_ps(_mm_loadu_ps(well.skeletonSpaceMatrix.m[2]), w));
+            row3 = _mm_add_ps(row3, _mm_mul_ps(_mm_loadu_ps(well.skeletonSpaceMatrix.m[3]), w));
+            normalRow0 = _mm_add_ps(normalRow0, _mm_mul_ps(_mm_loadu_ps(well.skeletonSpaceInverseTransposeMatrix.m[0]), w));
+            normalRow1 = _mm_add_ps(normalRow1, _mm_mul_ps(_mm_loadu_ps(well.skeletonSpaceInverseTransposeMatrix.m[1]), w));
+            normalRow2 = _mm_add_ps(normalRow2, _mm_mul_ps(_mm_loadu_ps(well.skeletonSpaceInverseTransposeMatrix.m[2]), w));
+        }
+
+        const VertexData& vertex = vertices[v];
+        __m128 position = _mm_mul_ps(row0, _mm_set1_ps(vertex.position.x));
+        position = _mm_add_ps(position, _mm_mul_ps(row1, _mm_set1_ps(vertex.position.y)));
+        position = _mm_add_ps(position, _mm_mul_ps(row2, _mm_set1_ps(vertex.position.z)));
+        position = _mm_add_ps(position, _mm_mul_ps(row3, _mm_set1_ps(vertex.position.w)));
+
+        __m128 normal = _mm_mul_ps(normalRow0, _mm_set1_ps(vertex.normal.x));
+        normal = _mm_add_ps(normal, _mm_mul_ps(normalRow1, _mm_set1_ps(vertex.normal.y)));
+        normal = _mm_add_ps(normal, _mm_mul_ps(normalRow2, _mm_set1_ps(vertex.normal.z)));
+        normal = _mm_and_ps(normal, xyzMask);
+        __m128 lengthSq = _mm_mul_ps(normal, normal);
+        lengthSq = _mm_add_ps(lengthSq, _mm_shuffle_ps(lengthSq, lengthSq, _MM_SHUFFLE(2, 3, 0, 1)));
+        lengthSq = _mm_add_ps(lengthSq, _mm_shuffle_ps(lengthSq, lengthSq, _MM_SHUFFLE(1, 0, 3, 2)));
+        // 長さ0の法線は0のまま返す（GPUではNaNになる）
+        normal = _mm_div_ps(normal, _mm_sqrt_ps(_mm_max_ps(lengthSq, _mm_set1_ps(1.0e-24f))));
+
+        float p[4];
+        float n[4];
+        _mm_storeu_ps(p, position);
+        _mm_storeu_ps(n, normal);
+        outPositions[v] = { p[0], p[1], p[2] };
+        outNormals[v] = { n[0], n[1], n[2] };
+    }
+#else
+    for (size_t v = 0; v < vertices.size(); ++v) {
+        const VertexData& vertex = vertices[v];
+        SkinVertexLinear(palette, influences[v], { vertex.position.x, vertex.position.y, vertex.position.z }, vertex.normal,
+            outPositions[v], outNormals[v]);
+    }
+#endif
+}
+
+std::vector<SkinnedBounds> CalculateJointBounds(std::span<const VertexInfluence> influences,
+    std::span<const VertexData> vertices, size_t jointCount, float minWeight) {
+
+    std::vector<SkinnedBounds> jointBounds(jointCount);
+    size_t count = std::min(influences.size(), vertices.size());
+    for (size_t v = 0; v < count; ++v) {
+        const VertexData& vertex = vertices[v];
+        Vector3 position = { vertex.position.x, vertex.position.y, vertex.position.z };
+        for (uint32_t i = 0; i < kNumMaxInfluence; ++i) {
+            int32_t joint = influences[v].jointIndices[i];
+            if (influences[v].weights[i] > minWeight && joint >= 0 && static_cast<size_t>(joint) < jointCount) {
+                jointBounds[joint].Expand(position);
+            }
+        }
+    }
+    return jointBounds;
+}
+
+SkinnedBounds CalculateSkinnedBounds(std::span<const WellForGPU> palette, std::span<const SkinnedBounds> jointBounds) {
+    SkinnedBounds result;
+    size_t count = std::min(palette.size(), jointBounds.size());
+    for (size_t joint = 0; joint < count; ++joint) {
+        if (!jointBounds[joint].IsEmpty()) {
+            result.Merge(TransformBounds(jointBounds[joint], palette[joint].skeletonSpaceMatrix));
+        }
+    }
+    return result;
+}
+
+SkinnedBounds CalculateSkinnedBounds(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices,
+    std::span<const SkinnedBounds> jointBounds) {
+
+    SkinnedBounds result;
+    size_t count = std::min({ skeleton.joints.size(), inverseBindPoseMatrices.size(), jointBounds.size() });
+    for (size_t joint = 0; joint < count; ++joint) {
+        if (!jointBounds[joint].IsEmpty()) {
+            Matrix4x4 matrix = Multiply(inverseBindPoseMatrices[joint], skeleton.joints[joint].skeletonSpaceMatrix);
+            result.Merge(TransformBounds(jointBounds[joint], matrix));
+        }
+    }
+    return result;
+}
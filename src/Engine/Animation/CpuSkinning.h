@@ -0,0 +1,36 @@
+#pragma once
+#include "AnimationData.h"
+#include <limits>
+#include <span>
+#include <vector>
+
+// スキニング後の頂点の範囲（モデル空間のAABB。空ならmin > max）
+struct SkinnedBounds {
+    static constexpr float kMaxFloat = (std::numeric_limits<float>::max)();
+    Vector3 min = { kMaxFloat, kMaxFloat, kMaxFloat };
+    Vector3 max = { -kMaxFloat, -kMaxFloat, -kMaxFloat };
+
+    bool IsEmpty() const { return min.x > max.x; }
+
+    // 点・範囲を含むように広げる
+    void Expand(const Vector3& point);
+    void Merge(const SkinnedBounds& other);
+};
+
+// 全頂点をCPUでスキニングして位置と法線を書き込む（SkinningObject3d.VS.hlslと同じ計算）
+// 頂点ごとに重み付きの行列を先に合成し、位置と法線を1回ずつ変換する（SSE2では行列の1行を1レジスタで処理）
+void SkinVertices(std::span<const WellForGPU> palette, std::span<const VertexInfluence> influences,
+    std::span<const VertexData> vertices, std::span<Vector3> outPositions, std::span<Vector3> outNormals);
+
+// 各ジョイントに重みを持つ頂点の、バインドポーズでの範囲（モデルの読み込み時に1回だけ計算する）
+// minWeight以下の重みは無視する（0なら重みを持つすべての頂点を含み、結果は必ず保守的になる）
+std::vector<SkinnedBounds> CalculateJointBounds(std::span<const VertexInfluence> influences,
+    std::span<const VertexData> vertices, size_t jointCount, float minWeight = 0.0f);
+
+// ジョイントごとの範囲をパレットで変換して合わせる（頂点数によらずジョイント数に比例する）
+// 頂点は各ジョイントで変換した位置の重み付き平均（重みは非負で合計1）なので、結果はすべての頂点を含む
+SkinnedBounds CalculateSkinnedBounds(std::span<const WellForGPU> palette, std::span<const SkinnedBounds> jointBounds);
+
+// パレットを作らずにスケルトンから計算する（デュアルクォータニオンのパレットを使う場合）
+SkinnedBounds CalculateSkinnedBounds(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices,
+    std::span<const SkinnedBounds> jointBounds);
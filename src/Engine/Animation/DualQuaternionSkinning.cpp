@@ -0,0 +1,152 @@
+#include "DualQuaternionSkinning.h"
+#include <cassert>
+#include <cmath>
+
+namespace {
+    Vector3 Cross3(const Vector3& a, const Vector3& b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    float Dot3(const Vector3& a, const Vector3& b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    Vector3 Normalize3(const Vector3& v) {
+        float length = std::sqrt(Dot3(v, v));
+        return length > 0.0f ? Vector3{ v.x / length, v.y / length, v.z / length } : v;
+    }
+
+    // 単位クォータニオンでベクトルを回転（v + 2r×(r×v + w v)）
+    Vector3 Rotate(const Quaternion& q, const Vector3& v) {
+        Vector3 r = { q.x, q.y, q.z };
+        Vector3 c = Cross3(r, v);
+        c = { c.x + q.w * v.x, c.y + q.w * v.y, c.z + q.w * v.z };
+        Vector3 d = Cross3(r, c);
+        return { v.x + 2.0f * d.x, v.y + 2.0f * d.y, v.z + 2.0f * d.z };
+    }
+
+    // 回転行列（行ベクトル規約の3x3、スケールなし）からクォータニオン
+    Quaternion MakeQuaternionFromRows(const Vector3& row0, const Vector3& row1, const Vector3& row2) {
+        // 列ベクトル規約の回転行列 R = M^T で考える（R[i][j] = row_j[i]）
+        float r00 = row0.x, r11 = row1.y, r22 = row2.z;
+        float r21 = row1.z, r12 = row2.y;  // R[2][1] = M[1][2], R[1][2] = M[2][1]
+        float r02 = row2.x, r20 = row0.z;  // R[0][2] = M[2][0], R[2][0] = M[0][2]
+        float r10 = row0.y, r01 = row1.x;  // R[1][0] = M[0][1], R[0][1] = M[1][0]
+
+        Quaternion q;
+        float trace = r00 + r11 + r22;
+        if (trace > 0.0f) {
+            float s = std::sqrt(trace + 1.0f) * 2.0f;
+            q = { (r21 - r12) / s, (r02 - r20) / s, (r10 - r01) / s, 0.25f * s };
+        } else if (r00 > r11 && r00 > r22) {
+            float s = std::sqrt(1.0f + r00 - r11 - r22) * 2.0f;
+            q = { 0.25f * s, (r01 + r10) / s, (r02 + r20) / s, (r21 - r12) / s };
+        } else if (r11 > r22) {
+            float s = std::sqrt(1.0f + r11 - r00 - r22) * 2.0f;
+            q = { (r01 + r10) / s, 0.25f * s, (r12 + r21) / s, (r02 - r20) / s };
+        } else {
+            float s = std::sqrt(1.0f + r22 - r00 - r11) * 2.0f;
+            q = { (r02 + r20) / s, (r12 + r21) / s, 0.25f * s, (r10 - r01) / s };
+        }
+        float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        return { q.x / length, q.y / length, q.z / length, q.w / length };
+    }
+}
+
+DualQuaternion MakeDualQuaternion(const Matrix4x4& matrix) {
+    Vector3 row0 = Normalize3({ matrix.m[0][0], matrix.m[0][1], matrix.m[0][2] });
+    Vector3 row1 = Normalize3({ matrix.m[1][0], matrix.m[1][1], matrix.m[1][2] });
+    Vector3 row2 = Normalize3({ matrix.m[2][0], matrix.m[2][1], matrix.m[2][2] });
+    Quaternion real = MakeQuaternionFromRows(row0, row1, row2);
+
+    // dual = 0.5 * (t, 0) * real
+    Vector3 t = { matrix.m[3][0], matrix.m[3][1], matrix.m[3][2] };
+    Vector3 r = { real.x, real.y, real.z };
+    Vector3 c = Cross3(t, r);
+    DualQuaternion result;
+    result.real = real;
+    result.dual = {
+        0.5f * (real.w * t.x + c.x),
+        0.5f * (real.w * t.y + c.y),
+        0.5f * (real.w * t.z + c.z),
+        -0.5f * Dot3(t, r),
+    };
+    return result;
+}
+
+void UpdateDualQuaternionPalette(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices, std::span<DualQuaternion> palette) {
+    assert(palette.size() >= skeleton.joints.size());
+    for (size_t jointIndex = 0; jointIndex < skeleton.joints.size(); ++jointIndex) {
+        assert(jointIndex < inverseBindPoseMatrices.size());
+        // 書き込み結合メモリを読み戻さないよう、ローカルで計算してから書き込む
+        DualQuaternion dualQuaternion = MakeDualQuaternion(Multiply(inverseBindPoseMatrices[jointIndex], skeleton.joints[jointIndex].skeletonSpaceMatrix));
+        palette[jointIndex] = dualQuaternion;
+    }
+}
+
+void SkinVertexDualQuaternion(std::span<const DualQuaternion> palette, const VertexInfluence& influence,
+    const Vector3& position, const Vector3& normal, Vector3& outPosition, Vector3& outNormal) {
+
+    // 最初のインフルエンスと同じ半球にそろえて合成する（q と -q は同じ回転）
+    const Quaternion& pivot = palette[influence.jointIndices[0]].real;
+    Quaternion real = {};
+    Quaternion dual = {};
+    for (uint32_t i = 0; i < kNumMaxInfluence; ++i) {
+        float weight = influence.weights[i];
+        if (weight == 0.0f) {
+            continue;
+        }
+        const DualQuaternion& dq = palette[influence.jointIndices[i]];
+        float sign = (pivot.x * dq.real.x + pivot.y * dq.real.y + pivot.z * dq.real.z + pivot.w * dq.real.w) < 0.0f ? -1.0f : 1.0f;
+        float w = weight * sign;
+        real = { real.x + dq.real.x * w, real.y + dq.real.y * w, real.z + dq.real.z * w, real.w + dq.real.w * w };
+        dual = { dual.x + dq.dual.x * w, dual.y + dq.dual.y * w, dual.z + dq.dual.z * w, dual.w + dq.dual.w * w };
+    }
+
+    float length = std::sqrt(real.x * real.x + real.y * real.y + real.z * real.z + real.w * real.w);
+    if (length <= 0.0f) {
+        outPosition = position;
+        outNormal = normal;
+        return;
+    }
+    float inverseLength = 1.0f / length;
+    real = { real.x * inverseLength, real.y * inverseLength, real.z * inverseLength, real.w * inverseLength };
+    dual = { dual.x * inverseLength, dual.y * inverseLength, dual.z * inverseLength, dual.w * inverseLength };
+
+    // 移動 = 2 * dual * conj(real)
+    Vector3 r = { real.x, real.y, real.z };
+    Vector3 d = { dual.x, dual.y, dual.z };
+    Vector3 c = Cross3(r, d);
+    Vector3 translate = {
+        2.0f * (real.w * d.x - dual.w * r.x + c.x),
+        2.0f * (real.w * d.y - dual.w * r.y + c.y),
+        2.0f * (real.w * d.z - dual.w * r.z + c.z),
+    };
+
+    Vector3 rotated = Rotate(real, position);
+    outPosition = { rotated.x + translate.x, rotated.y + translate.y, rotated.z + translate.z };
+    outNormal = Normalize3(Rotate(real, normal));
+}
+
+void SkinVertexLinear(std::span<const WellForGPU> palette, const VertexInfluence& influence,
+    const Vector3& position, const Vector3& normal, Vector3& outPosition, Vector3& outNormal) {
+
+    Vector3 skinnedPosition = {};
+    Vector3 skinnedNormal = {};
+    for (uint32_t i = 0; i < kNumMaxInfluence; ++i) {
+        float weight = influence.weights[i];
+        if (weight == 0.0f) {
+            continue;
+        }
+        const Matrix4x4& m = palette[influence.jointIndices[i]].skeletonSpaceMatrix;
+        const Matrix4x4& n = palette[influence.jointIndices[i]].skeletonSpaceInverseTransposeMatrix;
+        skinnedPosition.x += (position.x * m.m[0][0] + position.y * m.m[1][0] + position.z * m.m[2][0] + m.m[3][0]) * weight;
+        skinnedPosition.y += (position.x * m.m[0][1] + position.y * m.m[1][1] + position.z * m.m[2][1] + m.m[3][1]) * weight;
+        skinnedPosition.z += (position.x * m.m[0][2] + position.y * m.m[1][2] + position.z * m.m[2][2] + m.m[3][2]) * weight;
+        skinnedNormal.x += (normal.x * n.m[0][0] + normal.y * n.m[1][0] + normal.z * n.m[2][0]) * weight;
+        skinnedNormal.y += (normal.x * n.m[0][1] + normal.y * n.m[1][1] + normal.z * n.m[2][1]) * weight;
+        skinnedNormal.z += (normal.x * n.m[0][2] + normal.y * n.m[1][2] + normal.z * n.m[2][2]) * weight;
+    }
+    outPosition = skinnedPosition;
+    outNormal = Normalize3(skinnedNormal);
+}
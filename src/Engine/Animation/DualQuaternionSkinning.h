@@ -0,0 +1,30 @@
+#pragma once
+#include "AnimationData.h"
+#include <span>
+#include <vector>
+
+// デュアルクォータニオン（回転real + 移動dual。1ジョイント32バイト）
+// 行列パレット（WellForGPU、128バイト）の代わりにGPUへ送ると、計算・転送量が1/4になり、
+// ねじれるジョイントで線形ブレンドスキニングのように体積が潰れない
+// スケールは表現できないため、パレットの作成時に取り除く
+struct DualQuaternion {
+    Quaternion real;
+    Quaternion dual;
+};
+static_assert(sizeof(DualQuaternion) == 32, "DualQuaternionはGPUのStructuredBufferと同じ32バイト");
+
+// 剛体変換の行列（行ベクトル規約）からデュアルクォータニオンを作る（各行を正規化してスケールを除く）
+DualQuaternion MakeDualQuaternion(const Matrix4x4& matrix);
+
+// スケルトン空間行列にバインドポーズの逆行列を掛け、デュアルクォータニオンのパレットに書き込む
+// UpdateSkinPaletteと同じ入力で、逆行列の計算が不要な分だけ安い
+void UpdateDualQuaternionPalette(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices, std::span<DualQuaternion> palette);
+
+// 1頂点のスキニング（CPUでの検証用。SkinningObject3dDQ.VS.hlslと同じ計算）
+// 重みで合成したデュアルクォータニオンを正規化してから位置と法線を変換する
+void SkinVertexDualQuaternion(std::span<const DualQuaternion> palette, const VertexInfluence& influence,
+    const Vector3& position, const Vector3& normal, Vector3& outPosition, Vector3& outNormal);
+
+// 1頂点の線形ブレンドスキニング（CPUでの検証用。SkinningObject3d.VS.hlslと同じ計算）
+void SkinVertexLinear(std::span<const WellForGPU> palette, const VertexInfluence& influence,
+    const Vector3& position, const Vector3& normal, Vector3& outPosition, Vector3& outNormal);
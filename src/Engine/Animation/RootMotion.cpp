@@ -0,0 +1,242 @@
+#include "RootMotion.h"
+#include "DualQuaternionSkinning.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr float kPi = 3.14159265358979f;
+
+    // 角度を[-π, π]に収める
+    float WrapAngle(float angle) {
+        return std::remainder(angle, 2.0f * kPi);
+    }
+
+    // 点を行ベクトル規約の行列で変換
+    Vector3 TransformPoint(const Vector3& point, const Matrix4x4& m) {
+        return {
+            point.x * m.m[0][0] + point.y * m.m[1][0] + point.z * m.m[2][0] + m.m[3][0],
+            point.x * m.m[0][1] + point.y * m.m[1][1] + point.z * m.m[2][1] + m.m[3][1],
+            point.x * m.m[0][2] + point.y * m.m[1][2] + point.z * m.m[2][2] + m.m[3][2],
+        };
+    }
+
+    Matrix4x4 MakeLocalMatrix(const AnimationPose& pose, int32_t joint) {
+        return MakeAffineMatrix(pose.scale[joint], pose.rotate[joint], pose.translate[joint]);
+    }
+}
+
+void RootMotionDelta::Append(const RootMotionDelta& next) {
+    Vector3 rotated = RotateYaw(next.translate, yaw);
+    translate = { translate.x + rotated.x, translate.y + rotated.y, translate.z + rotated.z };
+    yaw += next.yaw;
+}
+
+RootMotionDelta BlendRootMotion(const RootMotionDelta& a, const RootMotionDelta& b, float t) {
+    RootMotionDelta result;
+    result.translate = Lerp(a.translate, b.translate, t);
+    result.yaw = a.yaw + (b.yaw - a.yaw) * t;
+    return result;
+}
+
+Vector3 RotateYaw(const Vector3& v, float yaw) {
+    float c = std::cos(yaw);
+    float s = std::sin(yaw);
+    return { v.x * c + v.z * s, v.y, -v.x * s + v.z * c };
+}
+
+void RootMotionBinding::Initialize(const Skeleton& skeleton, int32_t jointIndex, const RootMotionSettings& settings) {
+    joint_ = -1;
+    chain_.clear();
+    settings_ = settings;
+    if (jointIndex < 0 || static_cast<size_t>(jointIndex) >= skeleton.joints.size()) {
+        return;
+    }
+
+    // ルートまでさかのぼってから親が先になるように並べ替える
+    for (std::optional<int32_t> joint = jointIndex; joint; joint = skeleton.joints[*joint].parent) {
+        chain_.push_back(*joint);
+    }
+    std::reverse(chain_.begin(), chain_.end());
+    joint_ = jointIndex;
+
+    // バインドポーズでの位置を固定先とし、最も水平に近い軸を向きの計算に使う
+    AnimationPose restPose;
+    ReadPoseFromSkeleton(skeleton, restPose);
+    Matrix4x4 modelMatrix = CalculateModelMatrix(restPose);
+    referencePosition_ = { modelMatrix.m[3][0], modelMatrix.m[3][1], modelMatrix.m[3][2] };
+    float bestHorizontal = -1.0f;
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        const float* row = modelMatrix.m[axis];
+        float length = std::sqrt(row[0] * row[0] + row[1] * row[1] + row[2] * row[2]);
+        float horizontal = length > 0.0f ? std::sqrt(row[0] * row[0] + row[2] * row[2]) / length : 0.0f;
+        if (horizontal > bestHorizontal) {
+            bestHorizontal = horizontal;
+            headingAxis_ = axis;
+        }
+    }
+    referenceHeading_ = CalculateHeading(modelMatrix);
+}
+
+Matrix4x4 RootMotionBinding::CalculateModelMatrix(const AnimationPose& pose) const {
+    Matrix4x4 modelMatrix = MakeIdentity4x4();
+    for (int32_t joint : chain_) {
+        modelMatrix = Multiply(MakeLocalMatrix(pose, joint), modelMatrix);
+    }
+    return modelMatrix;
+}
+
+float RootMotionBinding::CalculateHeading(const Matrix4x4& modelMatrix) const {
+    const float* row = modelMatrix.m[headingAxis_];
+    return std::atan2(row[0], row[2]);
+}
+
+void RootMotionBinding::RemoveRootMotion(AnimationPose& pose) const {
+    if (joint_ < 0 || static_cast<uint32_t>(joint_) >= pose.GetJointCount()) {
+        return;
+    }
+
+    Matrix4x4 parentMatrix = MakeIdentity4x4();
+    for (size_t i = 0; i + 1 < chain_.size(); ++i) {
+        parentMatrix = Multiply(MakeLocalMatrix(pose, chain_[i]), parentMatrix);
+    }
+    Matrix4x4 inverseParent = Inverse(parentMatrix);
+
+    // モデル空間で水平位置（と高さ）を基準に固定する
+    Matrix4x4 modelMatrix = Multiply(MakeLocalMatrix(pose, joint_), parentMatrix);
+    Vector3 pinned = {
+        referencePosition_.x,
+        settings_.extractVertical ? referencePosition_.y : modelMatrix.m[3][1],
+        referencePosition_.z,
+    };
+
+    if (!settings_.extractYaw) {
+        pose.translate[joint_] = TransformPoint(pinned, inverseParent);
+        return;
+    }
+
+    // 固定した位置を中心に、基準の向きからずれた分だけ鉛直軸まわりに戻す
+    float yaw = WrapAngle(CalculateHeading(modelMatrix) - referenceHeading_);
+    for (uint32_t axis = 0; axis < 3; ++axis) {
+        Vector3 row = RotateYaw({ modelMatrix.m[axis][0], modelMatrix.m[axis][1], modelMatrix.m[axis][2] }, -yaw);
+        modelMatrix.m[axis][0] = row.x;
+        modelMatrix.m[axis][1] = row.y;
+        modelMatrix.m[axis][2] = row.z;
+    }
+    modelMatrix.m[3][0] = pinned.x;
+    modelMatrix.m[3][1] = pinned.y;
+    modelMatrix.m[3][2] = pinned.z;
+
+    // ローカル行列に戻して回転と移動を取り出す（スケールはそのまま）
+    Matrix4x4 localMatrix = Multiply(modelMatrix, inverseParent);
+    Quaternion rotate = MakeDualQuaternion(localMatrix).real;
+    const Quaternion& original = pose.rotate[joint_];
+    if (rotate.x * original.x + rotate.y * original.y + rotate.z * original.z + rotate.w * original.w < 0.0f) {
+        rotate = { -rotate.x, -rotate.y, -rotate.z, -rotate.w };
+    }
+    pose.rotate[joint_] = rotate;
+    pose.translate[joint_] = { localMatrix.m[3][0], localMatrix.m[3][1], localMatrix.m[3][2] };
+}
+
+void RootMotionTrack::Build(const CompiledAnimationClip& clip, const RootMotionBinding& binding) {
+    positions_.clear();
+    yaws_.clear();
+    loopDelta_ = {};
+    duration_ = clip.GetDuration();
+    if (!binding.IsValid() || static_cast<uint32_t>(binding.GetJoint()) >= clip.GetJointCount()) {
+        return;
+    }
+
+    // 終端がちょうどサンプルに乗るように間隔を決める
+    const RootMotionSettings& settings = binding.GetSettings();
+    uint32_t sampleCount = 1;
+    if (duration_ > 0.0f) {
+        sampleCount = std::max(2u, static_cast<uint32_t>(std::ceil(duration_ * settings.sampleRate)) + 1);
+    }
+    sampleRate_ = duration_ > 0.0f ? static_cast<float>(sampleCount - 1) / duration_ : 0.0f;
+
+    // 連鎖のジョイントだけをサンプリングする（他のジョイントは使わない）
+    AnimationPose pose;
+    pose.Resize(clip.GetJointCount());
+    positions_.resize(sampleCount);
+    yaws_.resize(sampleCount);
+    Vector3 firstPosition = {};
+    float previousHeading = 0.0f;
+    for (uint32_t i = 0; i < sampleCount; ++i) {
+        float time = (i + 1 == sampleCount) ? duration_ : static_cast<float>(i) / sampleRate_;
+        for (int32_t joint : binding.GetChain()) {
+            pose.translate[joint] = clip.SampleTranslate(joint, time);
+            pose.rotate[joint] = clip.SampleRotate(joint, time);
+            pose.scale[joint] = clip.SampleScale(joint, time);
+        }
+        Matrix4x4 modelMatrix = binding.CalculateModelMatrix(pose);
+        Vector3 position = { modelMatrix.m[3][0], modelMatrix.m[3][1], modelMatrix.m[3][2] };
+        float heading = binding.CalculateHeading(modelMatrix);
+        if (i == 0) {
+            firstPosition = position;
+            previousHeading = heading;
+        }
+
+        positions_[i] = { position.x - firstPosition.x, settings.extractVertical ? position.y - firstPosition.y : 0.0f, position.z - firstPosition.z };
+
+        // 向きは前のサンプルからの差を積み重ねて連続にする（±πを越えても飛ばない）
+        yaws_[i] = (i == 0 || !settings.extractYaw) ? 0.0f : yaws_[i - 1] + WrapAngle(heading - previousHeading);
+        previousHeading = heading;
+    }
+
+    loopDelta_ = CalculateSegment(0.0f, duration_);
+}
+
+uint32_t RootMotionTrack::FindSample(float time, float& outT) const {
+    uint32_t lastInterval = static_cast<uint32_t>(positions_.size()) - 2;
+    float position = std::clamp(time, 0.0f, duration_) * sampleRate_;
+    uint32_t index = std::min(static_cast<uint32_t>(position), lastInterval);
+    outT = std::clamp(position - static_cast<float>(index), 0.0f, 1.0f);
+    return index;
+}
+
+Vector3 RootMotionTrack::SamplePosition(float time) const {
+    if (positions_.size() < 2) {
+        return positions_.empty() ? Vector3{ 0.0f, 0.0f, 0.0f } : positions_[0];
+    }
+    float t = 0.0f;
+    uint32_t index = FindSample(time, t);
+    return Lerp(positions_[index], positions_[index + 1], t);
+}
+
+float RootMotionTrack::SampleYaw(float time) const {
+    if (yaws_.size() < 2) {
+        return yaws_.empty() ? 0.0f : yaws_[0];
+    }
+    float t = 0.0f;
+    uint32_t index = FindSample(time, t);
+    return yaws_[index] + (yaws_[index + 1] - yaws_[index]) * t;
+}
+
+RootMotionDelta RootMotionTrack::CalculateSegment(float fromTime, float toTime) const {
+    Vector3 from = SamplePosition(fromTime);
+    Vector3 to = SamplePosition(toTime);
+    float fromYaw = SampleYaw(fromTime);
+
+    // 区間の始めの向きを基準にする
+    RootMotionDelta delta;
+    delta.translate = RotateYaw({ to.x - from.x, to.y - from.y, to.z - from.z }, -fromYaw);
+    delta.yaw = SampleYaw(toTime) - fromYaw;
+    return delta;
+}
+
+RootMotionDelta RootMotionTrack::CalculateDelta(float fromTime, float toTime, uint32_t loopCount) const {
+    if (positions_.empty()) {
+        return {};
+    }
+    if (loopCount == 0) {
+        return CalculateSegment(fromTime, toTime);
+    }
+
+    // 終端までと、途中の完全なループと、先頭から現在までをつなぐ
+    RootMotionDelta delta = CalculateSegment(fromTime, duration_);
+    for (uint32_t loop = 1; loop < loopCount; ++loop) {
+        delta.Append(loopDelta_);
+    }
+    delta.Append(CalculateSegment(0.0f, toTime));
+    return delta;
+}
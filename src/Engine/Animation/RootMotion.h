@@ -0,0 +1,93 @@
+#pragma once
+#include "CompiledAnimationClip.h"
+#include <cstdint>
+#include <vector>
+
+// ルートモーションの抽出設定
+struct RootMotionSettings {
+    float sampleRate = 60.0f;      // 移動量の曲線を前計算する間隔（1秒あたりのサンプル数）
+    bool extractVertical = false;  // 上下の移動もオブジェクトに移す（falseなら上下の揺れはポーズに残す）
+    bool extractYaw = false;       // 鉛直軸まわりの回転もオブジェクトに移す（腰から取り出すと揺れも移るため既定は無効）
+};
+
+// 1回の更新でのルートの移動量
+// translateは更新開始時のキャラクターの向きを基準にしたモデル空間の移動、yawは鉛直軸まわりの回転（ラジアン）
+// yawはatan2(x, z)で表した向きが増える方向を正とする（MakeRotateYMatrixと同じ向き）
+struct RootMotionDelta {
+    Vector3 translate = { 0.0f, 0.0f, 0.0f };
+    float yaw = 0.0f;
+
+    // 続けて起きた移動を後ろに継ぎ足す（nextのtranslateはここまでの回転後の向きで加える）
+    void Append(const RootMotionDelta& next);
+};
+
+// 2つの移動量の線形補間（クロスフェード中の合成）
+RootMotionDelta BlendRootMotion(const RootMotionDelta& a, const RootMotionDelta& b, float t);
+
+// ベクトルを鉛直軸まわりにyawだけ回転
+Vector3 RotateYaw(const Vector3& v, float yaw);
+
+// ルートモーションを取り出すジョイント（スケルトンごとに1つ）
+// ジョイントの親の連鎖と、固定先の基準の位置・向きを持つ
+class RootMotionBinding {
+public:
+    // jointIndexのジョイント（通常は腰）から取り出す。基準はスケルトンの現在の変換（バインドポーズ）から求める
+    void Initialize(const Skeleton& skeleton, int32_t jointIndex, const RootMotionSettings& settings = {});
+
+    bool IsValid() const { return joint_ >= 0; }
+    int32_t GetJoint() const { return joint_; }
+    const RootMotionSettings& GetSettings() const { return settings_; }
+    const std::vector<int32_t>& GetChain() const { return chain_; }
+
+    // ポーズでのジョイントのモデル空間の行列（ルートからの連鎖だけを計算する）
+    Matrix4x4 CalculateModelMatrix(const AnimationPose& pose) const;
+
+    // モデル空間の行列の向き（atan2(x, z)）
+    float CalculateHeading(const Matrix4x4& modelMatrix) const;
+
+    // 取り出した分の移動（と回転）をポーズから除き、ジョイントを基準の位置（と向き）に固定する
+    void RemoveRootMotion(AnimationPose& pose) const;
+
+private:
+    int32_t joint_ = -1;
+    std::vector<int32_t> chain_;      // ルートから取り出すジョイントまで（親が先）
+    RootMotionSettings settings_;
+    Vector3 referencePosition_ = { 0.0f, 0.0f, 0.0f };
+    float referenceHeading_ = 0.0f;
+    uint32_t headingAxis_ = 2;        // 向きの計算に使う行（バインドポーズで最も水平に近い軸）
+};
+
+// クリップごとに前計算したルートの移動量の曲線
+// 一定間隔でサンプリングしたモデル空間の位置と向きを持ち、再生中はルートを再サンプリングせずに差分を求める
+class RootMotionTrack {
+public:
+    // クリップのルートの移動を前計算する（位置と向きは最初のサンプルからの相対値）
+    void Build(const CompiledAnimationClip& clip, const RootMotionBinding& binding);
+
+    // fromTimeからtoTimeまでの移動量（loopCountはその間にクリップの終端を越えた回数）
+    RootMotionDelta CalculateDelta(float fromTime, float toTime, uint32_t loopCount = 0) const;
+
+    // 時刻の位置と向き（サンプルの線形補間）
+    Vector3 SamplePosition(float time) const;
+    float SampleYaw(float time) const;
+
+    // 1ループ分の移動量
+    const RootMotionDelta& GetLoopDelta() const { return loopDelta_; }
+
+    float GetDuration() const { return duration_; }
+    bool IsEmpty() const { return positions_.empty(); }
+    size_t GetMemorySize() const { return positions_.size() * sizeof(Vector3) + yaws_.size() * sizeof(float); }
+
+private:
+    // 1ループ内の区間の移動量
+    RootMotionDelta CalculateSegment(float fromTime, float toTime) const;
+
+    // 時刻をサンプル番号と補間係数に変換
+    uint32_t FindSample(float time, float& outT) const;
+
+    float duration_ = 0.0f;
+    float sampleRate_ = 60.0f;
+    std::vector<Vector3> positions_;
+    std::vector<float> yaws_;
+    RootMotionDelta loopDelta_;
+};
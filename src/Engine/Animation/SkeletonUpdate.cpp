@@ -0,0 +1,83 @@
+#include "SkeletonUpdate.h"
+#include <algorithm>
+#include <cassert>
+
+void UpdateSkeletonSpaceMatrices(Skeleton& skeleton) {
+    // 親が若いので通常ループで処理可能になっている
+    for (Joint& joint : skeleton.joints) {
+        joint.localMatrix = MakeAffineMatrix(joint.transform.scale, joint.transform.rotate, joint.transform.translate);
+        if (joint.parent) {
+            joint.skeletonSpaceMatrix = Multiply(joint.localMatrix, skeleton.joints[*joint.parent].skeletonSpaceMatrix);
+        } else {
+            joint.skeletonSpaceMatrix = joint.localMatrix;
+        }
+    }
+}
+
+void UpdateSkeletonSubtree(Skeleton& skeleton, int32_t jointIndex) {
+    assert(jointIndex >= 0 && static_cast<size_t>(jointIndex) < skeleton.joints.size());
+    Joint& joint = skeleton.joints[jointIndex];
+    joint.localMatrix = MakeAffineMatrix(joint.transform.scale, joint.transform.rotate, joint.transform.translate);
+    if (joint.parent) {
+        joint.skeletonSpaceMatrix = Multiply(joint.localMatrix, skeleton.joints[*joint.parent].skeletonSpaceMatrix);
+    } else {
+        joint.skeletonSpaceMatrix = joint.localMatrix;
+    }
+    for (int32_t child : joint.children) {
+        UpdateSkeletonSubtree(skeleton, child);
+    }
+}
+
+void IncrementalSkeletonUpdate::SetAnimatedJoints(const Skeleton& skeleton, std::span<const uint8_t> animatedJoints) {
+    assert(animatedJoints.size() >= skeleton.joints.size());
+    size_t jointCount = skeleton.joints.size();
+    if (animatedJoints_.size() == jointCount && std::equal(animatedJoints_.begin(), animatedJoints_.end(), animatedJoints.begin())) {
+        return;
+    }
+    animatedJoints_.assign(animatedJoints.begin(), animatedJoints.begin() + jointCount);
+    valid_ = false;
+
+    // 親が先なので、親が更新リストにあるかを見るだけで子孫も拾える
+    std::vector<uint8_t> dirty(jointCount, 0);
+    updateList_.clear();
+    for (size_t i = 0; i < jointCount; ++i) {
+        const Joint& joint = skeleton.joints[i];
+        dirty[i] = animatedJoints_[i] || (joint.parent && dirty[*joint.parent]);
+        if (dirty[i]) {
+            updateList_.push_back(static_cast<int32_t>(i));
+        }
+    }
+}
+
+uint32_t IncrementalSkeletonUpdate::Update(Skeleton& skeleton) {
+    if (!valid_ || animatedJoints_.size() != skeleton.joints.size()) {
+        UpdateSkeletonSpaceMatrices(skeleton);
+        valid_ = animatedJoints_.size() == skeleton.joints.size();
+        return static_cast<uint32_t>(skeleton.joints.size());
+    }
+
+    // 静的なジョイントのローカル行列と、静的な部分木のスケルトン空間行列は前回のまま
+    for (int32_t index : updateList_) {
+        Joint& joint = skeleton.joints[index];
+        if (animatedJoints_[index]) {
+            joint.localMatrix = MakeAffineMatrix(joint.transform.scale, joint.transform.rotate, joint.transform.translate);
+        }
+        if (joint.parent) {
+            joint.skeletonSpaceMatrix = Multiply(joint.localMatrix, skeleton.joints[*joint.parent].skeletonSpaceMatrix);
+        } else {
+            joint.skeletonSpaceMatrix = joint.localMatrix;
+        }
+    }
+    return static_cast<uint32_t>(updateList_.size());
+}
+
+void UpdateSkinPalette(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices, std::span<WellForGPU> palette) {
+    assert(palette.size() >= skeleton.joints.size());
+    for (size_t jointIndex = 0; jointIndex < skeleton.joints.size(); ++jointIndex) {
+        assert(jointIndex < inverseBindPoseMatrices.size());
+        // 書き込み結合メモリを読み戻さないよう、ローカルで計算してから書き込む
+        Matrix4x4 skeletonSpaceMatrix = Multiply(inverseBindPoseMatrices[jointIndex], skeleton.joints[jointIndex].skeletonSpaceMatrix);
+        palette[jointIndex].skeletonSpaceMatrix = skeletonSpaceMatrix;
+        palette[jointIndex].skeletonSpaceInverseTransposeMatrix = Transpose(Inverse(skeletonSpaceMatrix));
+    }
+}
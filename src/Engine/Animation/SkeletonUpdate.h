@@ -0,0 +1,40 @@
+#pragma once
+#include "AnimationData.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// ジョイントのローカル行列とスケルトン空間行列を更新（親のindexが子より小さい前提）
+void UpdateSkeletonSpaceMatrices(Skeleton& skeleton);
+
+// jointとその子孫だけローカル行列とスケルトン空間行列を更新（jointの親は更新済みの前提）
+// IKなどで一部のジョイントだけ書き換えたときに、スケルトン全体を計算し直さずに済ませる
+void UpdateSkeletonSubtree(Skeleton& skeleton, int32_t joint);
+
+// 値が変わるジョイントとその子孫だけを計算し直すスケルトンの更新
+// 変わるジョイント（クリップで時間とともに値が変わるもの）を設定すると、それらと子孫を親が先の順に並べた更新リストを作っておき、
+// それ以外の静的な部分木（指・顔など）は前回の行列をそのまま使う。アニメーションするジョイントの割合に比例して計算が減る
+class IncrementalSkeletonUpdate {
+public:
+    // 変わるジョイントを設定する（animatedJointsはジョイント数分で、0以外が変わるもの）
+    // 前回と同じなら何もしない。違えば更新リストを作り直し、静的なジョイントの値も変わりうるので次回は全体を計算する
+    void SetAnimatedJoints(const Skeleton& skeleton, std::span<const uint8_t> animatedJoints);
+
+    // 次回の更新で全ジョイントを計算する（ポーズの出どころや合成するクリップの組が変わったときなど）
+    void Invalidate() { valid_ = false; }
+
+    // ローカル行列とスケルトン空間行列を更新して、スケルトン空間行列を計算したジョイント数を返す
+    // 変わるジョイントを設定していなければ毎回全体を計算する
+    uint32_t Update(Skeleton& skeleton);
+
+    uint32_t GetUpdateJointCount() const { return static_cast<uint32_t>(updateList_.size()); }
+
+private:
+    std::vector<uint8_t> animatedJoints_;
+    std::vector<int32_t> updateList_;  // 変わるジョイントとその子孫（親が先）
+    bool valid_ = false;
+};
+
+// スケルトン空間行列にバインドポーズの逆行列を掛けてパレットに書き込む
+// paletteはGPUのアップロードバッファを直接指してよい（書き込みのみ行う）
+void UpdateSkinPalette(const Skeleton& skeleton, const std::vector<Matrix4x4>& inverseBindPoseMatrices, std::span<WellForGPU> palette);
@@ -0,0 +1,157 @@
+#include "SkinWeightImport.h"
+#include "../Resource/MeshOptimizer.h"
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+namespace {
+    // 頂点に影響するジョイントの候補
+    struct InfluenceCandidate {
+        float weight;
+        int32_t joint;
+    };
+}
+
+std::vector<uint64_t> BuildWeightSetKeys(std::span<const std::vector<VertexWeightData>> jointWeights, size_t vertexCount) {
+    // 頂点ごとに(ボーン番号, 重みのビット)を並べる（ボーンの順に入れるので、同じ組なら同じ並びになる）
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (const std::vector<VertexWeightData>& weights : jointWeights) {
+        for (const VertexWeightData& vertexWeight : weights) {
+            if (vertexWeight.vectorIndex < vertexCount) {
+                ++offsets[vertexWeight.vectorIndex + 1];
+            }
+        }
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<uint64_t> entries(offsets[vertexCount]);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t joint = 0; joint < jointWeights.size(); ++joint) {
+        for (const VertexWeightData& vertexWeight : jointWeights[joint]) {
+            if (vertexWeight.vectorIndex < vertexCount) {
+                entries[cursor[vertexWeight.vectorIndex]++] = (static_cast<uint64_t>(joint) << 32) | std::bit_cast<uint32_t>(vertexWeight.weight);
+            }
+        }
+    }
+
+    // 並びで頂点をソートし、同じ並びの頂点に同じ番号を付ける
+    auto less = [&](uint32_t a, uint32_t b) {
+        return std::lexicographical_compare(entries.begin() + offsets[a], entries.begin() + offsets[a + 1],
+            entries.begin() + offsets[b], entries.begin() + offsets[b + 1]);
+    };
+    std::vector<uint32_t> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), less);
+    std::vector<uint64_t> keys(vertexCount);
+    uint64_t key = 0;
+    for (size_t i = 0; i < vertexCount; ++i) {
+        if (i > 0 && less(order[i - 1], order[i])) {
+            ++key;
+        }
+        keys[order[i]] = key;
+    }
+    return keys;
+}
+
+void DropWeldedDuplicates(std::vector<uint32_t>& vertexRemap) {
+    std::vector<bool> seen;
+    for (uint32_t& vertex : vertexRemap) {
+        if (vertex == kUnusedVertex) {
+            continue;
+        }
+        if (vertex >= seen.size()) {
+            seen.resize(vertex + 1, false);
+        }
+        if (seen[vertex]) {
+            vertex = kUnusedVertex;
+        } else {
+            seen[vertex] = true;
+        }
+    }
+}
+
+void RemapVertexWeights(std::vector<VertexWeightData>& vertexWeights, size_t first, std::span<const uint32_t> vertexRemap) {
+    // 残すウェイトを前に詰めながら番号を付け替える（順序は保つ）
+    size_t kept = first;
+    for (size_t i = first; i < vertexWeights.size(); ++i) {
+        uint32_t vertexId = vertexWeights[i].vectorIndex;
+        if (vertexId >= vertexRemap.size() || vertexRemap[vertexId] == kUnusedVertex) {
+            continue;
+        }
+        vertexWeights[kept++] = { vertexWeights[i].weight, vertexRemap[vertexId] };
+    }
+    vertexWeights.resize(kept);
+}
+
+void BuildVertexInfluences(const std::map<std::string, JointWeightData>& skinClusterData,
+    const std::map<std::string, int32_t>& jointMap, std::span<VertexInfluence> out) {
+
+    const size_t vertexCount = out.size();
+
+    // スケルトンにあるジョイントだけを番号に直す（名前の検索はジョイントごとに1回）
+    std::vector<std::pair<const JointWeightData*, int32_t>> joints;
+    joints.reserve(skinClusterData.size());
+    for (const auto& [name, jointWeight] : skinClusterData) {
+        auto it = jointMap.find(name);
+        if (it != jointMap.end()) {
+            joints.emplace_back(&jointWeight, it->second);
+        }
+    }
+
+    // 頂点ごとの候補数を数え、累積和で候補の配列の開始位置を決める
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (const auto& [jointWeight, joint] : joints) {
+        for (const VertexWeightData& vertexWeight : jointWeight->vertexWeights) {
+            if (vertexWeight.vectorIndex < vertexCount && vertexWeight.weight > 0.0f) {
+                ++offsets[vertexWeight.vectorIndex + 1];
+            }
+        }
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<InfluenceCandidate> candidates(offsets[vertexCount]);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (const auto& [jointWeight, joint] : joints) {
+        for (const VertexWeightData& vertexWeight : jointWeight->vertexWeights) {
+            if (vertexWeight.vectorIndex < vertexCount && vertexWeight.weight > 0.0f) {
+                candidates[cursor[vertexWeight.vectorIndex]++] = { vertexWeight.weight, joint };
+            }
+        }
+    }
+
+    for (size_t v = 0; v < vertexCount; ++v) {
+        InfluenceCandidate* first = candidates.data() + offsets[v];
+        InfluenceCandidate* last = candidates.data() + offsets[v + 1];
+        size_t count = static_cast<size_t>(last - first);
+
+        // 上限を超える分は重みの大きい順に上位だけを並べる（全体はソートしない）
+        size_t selected = std::min<size_t>(count, kNumMaxInfluence);
+        if (count > kNumMaxInfluence) {
+            std::partial_sort(first, first + selected, last,
+                [](const InfluenceCandidate& a, const InfluenceCandidate& b) { return a.weight > b.weight; });
+        }
+
+        VertexInfluence influence{};
+        float totalWeight = 0.0f;
+        for (size_t i = 0; i < selected; ++i) {
+            influence.weights[i] = first[i].weight;
+            influence.jointIndices[i] = first[i].joint;
+            totalWeight += first[i].weight;
+        }
+
+        // 正規化（合計が1になるように）
+        if (totalWeight > 0.0f) {
+            float inverseTotal = 1.0f / totalWeight;
+            for (size_t i = 0; i < selected; ++i) {
+                influence.weights[i] *= inverseTotal;
+            }
+        } else {
+            // ウェイトが設定されていない頂点はルートジョイントに100%バインド
+            influence.weights[0] = 1.0f;
+            influence.jointIndices[0] = 0;
+        }
+        out[v] = influence;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "AnimationData.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 溶接の前に、元の頂点ごとのボーンウェイトの組に番号を付ける（OptimizeMeshのweldKeysに渡す）
+// jointWeights[j]はメッシュのj番目のボーンのウェイト（vectorIndexは元の頂点番号）。ジョイントと重みが全て同じ頂点は同じ番号になる
+// 組が違う頂点はまとめないので、溶接してもスキニングの結果は変わらない
+std::vector<uint64_t> BuildWeightSetKeys(std::span<const std::vector<VertexWeightData>> jointWeights, size_t vertexCount);
+
+// 溶接で同じ頂点にまとまった元の頂点のうち、最初のもの以外をkUnusedVertexにする（RemapVertexWeightsの前に使う）
+// まとまった頂点はウェイトの組が同じなので1つ分だけ付け替える（全部付け替えると同じウェイトが重なる）
+void DropWeldedDuplicates(std::vector<uint32_t>& vertexRemap);
+
+// OptimizeMeshで頂点を並べ直した後に、元の頂点番号で付いたボーンウェイトを新しい番号に付け替える
+// vertexRemap[元の番号]が新しい番号。どの三角形にも使われない頂点（kUnusedVertex）と範囲外の番号のウェイトは除く
+// vertexWeightsのfirst番目以降だけを書き換える（同じジョイントの前のメッシュの分はそのまま残す）
+void RemapVertexWeights(std::vector<VertexWeightData>& vertexWeights, size_t first, std::span<const uint32_t> vertexRemap);
+
+// ジョイントごとの頂点ウェイトを頂点ごとに集め、重みの大きい順にkNumMaxInfluence個を選んで正規化する
+// 各頂点の結果はローカルで作ってから1回だけ書き込む（outはGPUのアップロードバッファでよい）
+// ウェイトのない頂点はルートジョイントに100%割り当てる。スケルトンにないジョイントは無視する
+void BuildVertexInfluences(const std::map<std::string, JointWeightData>& skinClusterData,
+    const std::map<std::string, int32_t>& jointMap, std::span<VertexInfluence> out);
@@ -102,6 +102,39 @@ namespace Collision {
                (a.min.z <= b.max.z && a.max.z >= b.min.z);
     }
 
+    // レイとAABBの交差判定
+    bool IntersectRayAABB(const Ray& ray, const AABB& aabb, float& outDistance) {
+        const float origin[3] = { ray.origin.x, ray.origin.y, ray.origin.z };
+        const float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+        const float boxMin[3] = { aabb.min.x, aabb.min.y, aabb.min.z };
+        const float boxMax[3] = { aabb.max.x, aabb.max.y, aabb.max.z };
+
+        // 各軸の2平面に挟まれた区間の共通部分を求める
+        float tMin = 0.0f;
+        float tMax = ray.maxDistance;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (std::fabs(direction[axis]) < 1.0e-8f) {
+                if (origin[axis] < boxMin[axis] || origin[axis] > boxMax[axis]) {
+                    return false;
+                }
+                continue;
+            }
+            float inverse = 1.0f / direction[axis];
+            float t0 = (boxMin[axis] - origin[axis]) * inverse;
+            float t1 = (boxMax[axis] - origin[axis]) * inverse;
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+            if (tMin > tMax) {
+                return false;
+            }
+        }
+        outDistance = tMin;
+        return true;
+    }
+
     // GLTFモデルのアクセサーからAABBを抽出
     AABB AABBExtractor::ExtractFromGLTF(const void* gltfModelPtr, int meshIndex, int primitiveIndex) {
         const tinygltf::Model* gltfModel = static_cast<const tinygltf::Model*>(gltfModelPtr);
@@ -260,9 +293,16 @@ namespace Collision {
         Vector3 position = object_->GetPosition();
         Vector3 scale = object_->GetScale();
 
+        // アニメーションするモデルは最後に評価した姿勢の範囲を使う（バインドポーズの範囲では姿勢の変化に追従しない）
+        AABB localAABB = localAABB_;
+        const SkinnedBounds& skinnedBounds = object_->GetSkinnedBounds();
+        if (useSkinnedBounds_ && !skinnedBounds.IsEmpty()) {
+            localAABB = AABB(skinnedBounds.min, skinnedBounds.max);
+        }
+
         // 回転は今回は考慮しない(AABBは軸並行のため)
         // より正確な衝突判定が必要な場合はOBB(Oriented Bounding Box)を使用する
-        worldAABB_ = TransformAABB(localAABB_, position, scale);
+        worldAABB_ = TransformAABB(localAABB, position, scale);
     }
 
     // AABBCollisionManagerの実装
@@ -308,6 +348,7 @@ namespace Collision {
         for (size_t i = 0; i < localAABBs.size(); ++i) {
             std::string meshName = name + "_Mesh" + std::to_string(i);
             auto collisionObj = std::make_shared<CollisionObject3D>(object, localAABBs[i], meshName);
+            collisionObj->SetUseSkinnedBounds(false);
             collisionObj->SetEnabled(enabled);
             collisionObjects_.push_back(collisionObj);
         }
@@ -367,6 +408,39 @@ namespace Collision {
         }
     }
 
+    void AABBCollisionManager::Raycast(std::span<const Ray> rays, std::span<const Object3d* const> ignoreObjects, std::span<RaycastHit> outHits) const {
+        assert(outHits.size() >= rays.size());
+        assert(ignoreObjects.empty() || ignoreObjects.size() >= rays.size());
+        // これ以下の距離の当たりは始点が内側にあるものとして除く
+        const float kMinHitDistance = 1.0e-4f;
+        for (size_t i = 0; i < rays.size(); ++i) {
+            outHits[i] = RaycastHit{};
+        }
+
+        // AABBを1つずつ読み、全レイと判定する（レイごとに全オブジェクトを走査するよりAABBの読み込みが少ない）
+        for (const auto& obj : collisionObjects_) {
+            if (!obj->IsEnabled()) continue;
+            const AABB& worldAABB = obj->GetWorldAABB();
+            for (size_t i = 0; i < rays.size(); ++i) {
+                if (!ignoreObjects.empty() && ignoreObjects[i] == obj->GetObject()) continue;
+
+                float distance = 0.0f;
+                if (IntersectRayAABB(rays[i], worldAABB, distance) && distance > kMinHitDistance &&
+                    (!outHits[i].hit || distance < outHits[i].distance)) {
+                    outHits[i].hit = true;
+                    outHits[i].distance = distance;
+                    outHits[i].object = obj->GetObject();
+                }
+            }
+        }
+
+        for (size_t i = 0; i < rays.size(); ++i) {
+            if (outHits[i].hit) {
+                outHits[i].point = rays[i].origin + rays[i].direction * outHits[i].distance;
+            }
+        }
+    }
+
     std::shared_ptr<CollisionObject3D> AABBCollisionManager::FindCollisionObject(Object3d* object) {
         auto it = std::find_if(collisionObjects_.begin(), collisionObjects_.end(),
             [object](const std::shared_ptr<CollisionObject3D>& obj) {
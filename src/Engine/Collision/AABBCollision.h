@@ -1,8 +1,10 @@
 #pragma once
 #include "Mymath.h"
+#include "CollisionPrimitive.h"
 #include <vector>
 #include <memory>
 #include <functional>
+#include <span>
 #include <string>
 
 // 前方宣言
@@ -36,6 +38,17 @@ namespace Collision {
     // AABB同士の衝突判定
     bool CheckAABBCollision(const AABB& a, const AABB& b);
 
+    // レイとAABBの交差判定（スラブ法）。当たれば始点からの距離をoutDistanceに入れる（始点が内側なら0）
+    bool IntersectRayAABB(const Ray& ray, const AABB& aabb, float& outDistance);
+
+    // レイキャストの結果
+    struct RaycastHit {
+        bool hit = false;
+        float distance = 0.0f;
+        Vector3 point = { 0.0f, 0.0f, 0.0f };
+        Object3d* object = nullptr;
+    };
+
     // GLTFモデルからAABBを抽出するヘルパー
     class AABBExtractor {
     public:
@@ -73,12 +86,16 @@ namespace Collision {
         void SetLocalAABB(const AABB& aabb) { localAABB_ = aabb; }
         void SetName(const std::string& name) { name_ = name; }
 
+        // アニメーション中はスキニング後の範囲をローカルAABBとして使うか（メッシュごとのAABBでは使わない）
+        void SetUseSkinnedBounds(bool use) { useSkinnedBounds_ = use; }
+
     private:
         Object3d* object_;      // 参照するObject3d
         AABB localAABB_;        // ローカル座標系でのAABB
         AABB worldAABB_;        // ワールド座標系でのAABB
         bool enabled_;          // 有効フラグ
         std::string name_;      // デバッグ用名前
+        bool useSkinnedBounds_ = true; // スキニング後の範囲を使うか
     };
 
     // AABBコリジョンマネージャー
@@ -103,6 +120,12 @@ namespace Collision {
         // 更新(全オブジェクトのワールドAABB更新と衝突判定)
         void Update();
 
+        // 複数のレイをまとめて判定し、レイごとに最も近い当たりをoutHitsに書き込む
+        // オブジェクトごとに全レイを調べる（ワールドAABBはUpdateで計算したもの）
+        // ignoreObjectsはレイごとに無視するオブジェクト（自分の足元へのレイなど。空なら無視しない）
+        // 始点が内側にあるAABBには当たらない（距離0の当たりで足のIKが地面を始点の高さと誤認しないように）
+        void Raycast(std::span<const Ray> rays, std::span<const Object3d* const> ignoreObjects, std::span<RaycastHit> outHits) const;
+
         // 衝突コールバック設定
         using CollisionCallback = std::function<void(Object3d*, Object3d*)>;
         void SetCollisionCallback(CollisionCallback callback) { collisionCallback_ = callback; }
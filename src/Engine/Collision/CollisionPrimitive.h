@@ -22,6 +22,19 @@ namespace Collision {
         Segment(const Vector3& start, const Vector3& end) : start(start), end(end) {}
     };
 
+    // レイ（directionは正規化済み）
+    struct Ray {
+        Vector3 origin;     // 始点
+        Vector3 direction;  // 向き
+        float maxDistance;  // 判定する長さ
+
+        // コンストラクタ
+        Ray() : origin({ 0.0f, 0.0f, 0.0f }), direction({ 0.0f, -1.0f, 0.0f }), maxDistance(1.0f) {}
+        Ray(const Vector3& origin, const Vector3& direction, float maxDistance)
+            : origin(origin), direction(direction), maxDistance(maxDistance) {
+        }
+    };
+
     // カプセル
     struct Capsule {
         Segment segment; // 中心の線分
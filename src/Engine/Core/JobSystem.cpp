@@ -0,0 +1,106 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+JobSystem* JobSystem::GetInstance() {
+    static JobSystem instance;
+    return &instance;
+}
+
+void JobSystem::Initialize(uint32_t workerCount) {
+    if (initialized_) {
+        return;
+    }
+    if (workerCount == 0) {
+        uint32_t hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+
+    quit_ = false;
+    workers_.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        workers_.emplace_back(&JobSystem::WorkerMain, this);
+    }
+    initialized_ = true;
+}
+
+void JobSystem::Finalize() {
+    if (!initialized_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quit_ = true;
+    }
+    wakeCondition_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    initialized_ = false;
+}
+
+void JobSystem::Run(uint32_t count, uint32_t grainSize, RangeFunction function, const void* context) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = std::max(grainSize, 1u);
+
+    // 1範囲に収まる、またはワーカーがなければその場で実行
+    if (workers_.empty() || count <= grainSize) {
+        function(context, 0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        function_ = function;
+        context_ = context;
+        count_ = count;
+        grainSize_ = grainSize;
+        next_.store(0, std::memory_order_relaxed);
+        busyWorkers_ = static_cast<uint32_t>(workers_.size());
+        ++generation_;
+    }
+    wakeCondition_.notify_all();
+
+    // 呼び出し元も処理に加わる
+    ProcessRanges();
+
+    // 全ワーカーが現在のジョブから抜けるまで待つ（contextは呼び出し元のスタックにあるため）
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCondition_.wait(lock, [this] { return busyWorkers_ == 0; });
+    function_ = nullptr;
+    context_ = nullptr;
+}
+
+void JobSystem::ProcessRanges() {
+    while (true) {
+        uint32_t begin = next_.fetch_add(grainSize_, std::memory_order_relaxed);
+        if (begin >= count_) {
+            break;
+        }
+        function_(context_, begin, std::min(begin + grainSize_, count_));
+    }
+}
+
+void JobSystem::WorkerMain() {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeCondition_.wait(lock, [&] { return quit_ || generation_ != seenGeneration; });
+            if (quit_) {
+                return;
+            }
+            seenGeneration = generation_;
+        }
+
+        ProcessRanges();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --busyWorkers_;
+        }
+        doneCondition_.notify_one();
+    }
+}
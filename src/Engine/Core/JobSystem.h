@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ワーカースレッドで範囲を分割して並列実行する
+// ParallelForは呼び出し元のスレッドも処理に加わり、全範囲が終わるまで戻らない
+class JobSystem {
+public:
+    static JobSystem* GetInstance();
+
+    // workerCountが0ならハードウェアスレッド数-1（呼び出し元の分を除く）
+    void Initialize(uint32_t workerCount = 0);
+    void Finalize();
+
+    bool IsInitialized() const { return initialized_; }
+
+    // 呼び出し元を含めた並列数
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers_.size()) + 1; }
+
+    // [0, count)をgrainSize個ずつに分けてfunc(begin, end)を並列に呼ぶ
+    // 初期化前やワーカーがない場合は呼び出し元でそのまま実行する
+    template <typename Func>
+    void ParallelFor(uint32_t count, uint32_t grainSize, const Func& func) {
+        Run(count, grainSize, [](const void* context, uint32_t begin, uint32_t end) {
+            (*static_cast<const Func*>(context))(begin, end);
+        }, &func);
+    }
+
+private:
+    using RangeFunction = void (*)(const void* context, uint32_t begin, uint32_t end);
+
+    // 型を消した関数で実行（std::functionを使わずメモリ確保をしない）
+    void Run(uint32_t count, uint32_t grainSize, RangeFunction function, const void* context);
+
+    // 現在のジョブから範囲を取り出して処理
+    void ProcessRanges();
+
+    void WorkerMain();
+
+    bool initialized_ = false;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeCondition_;
+    std::condition_variable doneCondition_;
+    uint64_t generation_ = 0;   // ジョブを投入するたびに進める
+    uint32_t busyWorkers_ = 0;  // 現在のジョブを処理中のワーカー数
+    bool quit_ = false;
+
+    // 現在のジョブ
+    RangeFunction function_ = nullptr;
+    const void* context_ = nullptr;
+    uint32_t count_ = 0;
+    uint32_t grainSize_ = 1;
+    std::atomic<uint32_t> next_{ 0 };
+};
@@ -385,6 +385,7 @@ void DirectXCommon::End()
 	fenceValue++;
 	//GPUがここまでたどりついた時に、Fenceの値を指定したあたいにC:\Program Files\Blender Foundation\Blender 4.4\4.4\scripts\addons_core\level_editor.py代入するようにsignalを送る
 	commandQueue->Signal(fence.Get(), fenceValue);
+	frameEndFenceValue = fenceValue;
 	//Fenceの値が指定したSignal値にたどり着いているか確認する
 		//GetCompletebValueの初期値はFence作成時に渡した初期値
 	if (fence->GetCompletedValue() < fenceValue) {
@@ -641,6 +642,16 @@ DirectX::ScratchImage DirectXCommon::LoadTexture(const std::string& filePath)
 	return mipImages;
 }
 
+void DirectXCommon::WaitForFenceValue(uint64_t value)
+{
+	//まだSignalしていない値は待てない
+	assert(value <= fenceValue);
+	if (fence->GetCompletedValue() < value) {
+		fence->SetEventOnCompletion(value, fenceEvent);
+		WaitForSingleObject(fenceEvent, INFINITE);
+	}
+}
+
 void DirectXCommon::CommandKick()
 {
 	hr = commandList->Close();
@@ -72,6 +72,15 @@ public:
 	ID3D12GraphicsCommandList* GetCommandList()const { return commandList.Get(); }
 	UINT GetBackBufferIndex() const { return swapChain->GetCurrentBackBufferIndex(); }
 
+	// GPUが完了したフェンス値
+	uint64_t GetCompletedFenceValue() const { return fence->GetCompletedValue(); }
+	// 次にSignalされるフェンス値（いま記録中のコマンドの完了を表す）
+	uint64_t GetNextFenceValue() const { return fenceValue + 1; }
+	// 直前のフレームの終了（End）でSignalしたフェンス値（そのフレームの途中でCommandKickした分も含めた完了を表す）
+	uint64_t GetFrameEndFenceValue() const { return frameEndFenceValue; }
+	// 指定したフェンス値にGPUが到達するまで待つ（到達済みなら何もしない）
+	void WaitForFenceValue(uint64_t value);
+
 	IDxcBlob* CompileShader(
 		//ComilerするSahaderファイルへのパス
 		const std::wstring& filePath,
@@ -136,6 +145,7 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12Fence> fence = nullptr;
 	HANDLE fenceEvent = nullptr;
 	uint64_t fenceValue = 0;
+	uint64_t frameEndFenceValue = 0;
 
 	D3D12_VIEWPORT viewport{};
 
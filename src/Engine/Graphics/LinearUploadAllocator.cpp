@@ -0,0 +1,136 @@
+#include "LinearUploadAllocator.h"
+#include "DirectXCommon.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+void LinearUploadAllocator::Initialize(DirectXCommon* dxCommon, size_t sizePerFrame, uint32_t frameCount) {
+    assert(dxCommon);
+    assert(sizePerFrame > 0 && frameCount > 0);
+
+    Finalize();
+    dxCommon_ = dxCommon;
+    frames_.resize(frameCount);
+
+    // フレーム数分のバッファを作成し、解放まで常時マップしておく
+    for (uint32_t i = 0; i < frameCount; ++i) {
+        CreateFrameBuffer(i, sizePerFrame);
+    }
+
+    frameIndex_ = 0;
+    offset_ = 0;
+    stallCount_ = 0;
+    growCount_ = 0;
+}
+
+void LinearUploadAllocator::Finalize() {
+    // GPUが使用中のバッファは解放できないので待つ（まだ実行していないコマンドの分は待てない）
+    for (FrameBuffer& frame : frames_) {
+        ResolveRetireFence(frame);
+        if (dxCommon_ && frame.fenceValue > 0) {
+            dxCommon_->WaitForFenceValue(std::min(frame.fenceValue, dxCommon_->GetNextFenceValue() - 1));
+        }
+    }
+
+    for (FrameBuffer& frame : frames_) {
+        if (frame.resource && frame.mappedData) {
+            frame.resource->Unmap(0, nullptr);
+        }
+        frame.mappedData = nullptr;
+        frame.resource.Reset();
+        frame.retiredResources.clear();
+    }
+    frames_.clear();
+    offset_ = 0;
+}
+
+bool LinearUploadAllocator::CreateFrameBuffer(uint32_t index, size_t size) {
+    FrameBuffer& frame = frames_[index];
+    if (frame.resource && frame.mappedData) {
+        frame.resource->Unmap(0, nullptr);
+    }
+    frame.mappedData = nullptr;
+    frame.size = 0;
+
+    frame.resource = dxCommon_->CreateBufferResource(size);
+    if (!frame.resource) {
+        Logger::Log("LinearUploadAllocator: Failed to create a " + std::to_string(size) + " byte upload buffer\n");
+        return false;
+    }
+    frame.resource->Map(0, nullptr, reinterpret_cast<void**>(&frame.mappedData));
+    frame.size = size;
+    return true;
+}
+
+void LinearUploadAllocator::ResolveRetireFence(FrameBuffer& frame) {
+    if (!frame.retirePending || !dxCommon_) {
+        return;
+    }
+
+    // EndFrameの後にEndが済んでいれば、その値が途中のCommandKickも含めたフレームの完了を表す
+    // まだEndしていなければ、記録済みのコマンドはすべて次のSignalで完了する
+    uint64_t frameEndFence = dxCommon_->GetFrameEndFenceValue();
+    frame.fenceValue = (frameEndFence >= frame.fenceValue) ? frameEndFence : dxCommon_->GetNextFenceValue();
+    frame.retirePending = false;
+}
+
+void LinearUploadAllocator::BeginFrame() {
+    assert(!frames_.empty());
+
+    // 前のフレームの終了のフェンス値を記録してから、リングの次のバッファへ
+    ResolveRetireFence(frames_[frameIndex_]);
+    frameIndex_ = (frameIndex_ + 1) % static_cast<uint32_t>(frames_.size());
+    offset_ = 0;
+
+    // 前回このバッファを使ったフレームをGPUが読み終えるまで待つ
+    FrameBuffer& frame = frames_[frameIndex_];
+    ResolveRetireFence(frame);
+    if (frame.fenceValue > dxCommon_->GetCompletedFenceValue()) {
+        stallCount_++;
+        dxCommon_->WaitForFenceValue(std::min(frame.fenceValue, dxCommon_->GetNextFenceValue() - 1));
+    }
+
+    // 前回の途中で拡張する前のバッファは、読み終わったので解放する
+    frame.retiredResources.clear();
+}
+
+void LinearUploadAllocator::EndFrame() {
+    assert(!frames_.empty());
+    // 下限として今の値を入れておき、フレームの終了のフェンス値は次のBeginFrameで記録する
+    FrameBuffer& frame = frames_[frameIndex_];
+    frame.fenceValue = dxCommon_->GetNextFenceValue();
+    frame.retirePending = true;
+}
+
+LinearUploadAllocator::Allocation LinearUploadAllocator::Allocate(size_t size, size_t alignment) {
+    assert(!frames_.empty());
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    Allocation allocation;
+    FrameBuffer& frame = frames_[frameIndex_];
+    size_t alignedOffset = (offset_ + alignment - 1) & ~(alignment - 1);
+    if (alignedOffset + size > frame.size) {
+        // 容量不足：倍々で大きくしたバッファに切り替え、このフレームの残りはそちらに確保する
+        // 切り替え前のバッファはこのフレームのコマンドが参照しているので、GPUが読み終わるまで残す
+        size_t newSize = std::max<size_t>(frame.size, 1) * 2;
+        while (newSize < size + alignment) {
+            newSize *= 2;
+        }
+        if (frame.resource) {
+            frame.retiredResources.push_back(frame.resource);
+        }
+        if (!CreateFrameBuffer(frameIndex_, newSize)) {
+            return allocation;
+        }
+        growCount_++;
+        Logger::Log("LinearUploadAllocator: Grew upload buffer to " + std::to_string(newSize) + " bytes\n");
+        alignedOffset = 0;
+    }
+
+    allocation.cpuAddress = frame.mappedData + alignedOffset;
+    allocation.gpuAddress = frame.resource->GetGPUVirtualAddress() + alignedOffset;
+    allocation.size = size;
+    offset_ = alignedOffset + size;
+    return allocation;
+}
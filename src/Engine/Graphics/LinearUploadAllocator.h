@@ -0,0 +1,76 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <cstdint>
+#include <vector>
+
+class DirectXCommon;
+
+// フレームごとに使い捨てるアップロードバッファの線形アロケータ
+// フレーム数分のバッファを常時マップしておき、リングとして順番に使い回す
+// 各バッファには使用したフレームの終了（DirectXCommon::End）のフェンス値を記録し、GPUが読み終わるまでは再利用しない
+// フレームの途中で容量が足りなくなった場合は、大きいバッファに切り替えて確保し直す（古いバッファはGPUが読み終わるまで残す）
+class LinearUploadAllocator {
+public:
+    // 確保結果（cpuAddressがnullptrならバッファを作れなかった）
+    struct Allocation {
+        void* cpuAddress = nullptr;
+        D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;
+        size_t size = 0;
+    };
+
+    // 初期化（sizePerFrameはフレームあたりの初期容量、frameCountは同時に使えるフレーム数）
+    void Initialize(DirectXCommon* dxCommon, size_t sizePerFrame, uint32_t frameCount = 3);
+
+    // 終了処理
+    void Finalize();
+
+    // フレームの開始（次のバッファに進み、GPUが読み終わっていなければ待つ）
+    void BeginFrame();
+
+    // フレームの終了（このフレームの確保を締め切る）
+    // フェンス値はこのフレームのEndでSignalした値を次のBeginFrameで記録する（途中のCommandKickより後の値になる）
+    void EndFrame();
+
+    // 確保（alignmentは2のべき乗、CBVなら256）
+    Allocation Allocate(size_t size, size_t alignment = 16);
+
+    // 今フレームの使用量と容量
+    size_t GetUsedSize() const { return offset_; }
+    size_t GetSizePerFrame() const { return frames_.empty() ? 0 : frames_[frameIndex_].size; }
+
+    // GPU待ちが発生した回数（フレームの先行が詰まっているかの目安）
+    uint32_t GetStallCount() const { return stallCount_; }
+
+    // フレームの途中でバッファを拡張した回数（初期容量が足りているかの目安）
+    uint32_t GetGrowCount() const { return growCount_; }
+
+private:
+    // フレームごとのバッファ
+    struct FrameBuffer {
+        Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+        uint8_t* mappedData = nullptr;
+        size_t size = 0;
+        // 最後に使用したフレームのフェンス値
+        uint64_t fenceValue = 0;
+        // EndFrame後、フレームの終了のフェンス値をまだ記録していない
+        bool retirePending = false;
+        // フレームの途中で拡張する前のバッファ（このフレームのコマンドが参照しているので、GPUが読み終わるまで残す）
+        std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> retiredResources;
+    };
+    std::vector<FrameBuffer> frames_;
+
+    // バッファの作成とマップ（falseなら作成に失敗）
+    bool CreateFrameBuffer(uint32_t index, size_t size);
+
+    // EndFrameしたバッファに、そのフレームの終了のフェンス値を記録する
+    void ResolveRetireFence(FrameBuffer& frame);
+
+    DirectXCommon* dxCommon_ = nullptr;
+
+    // 現在のフレームと書き込み位置
+    uint32_t frameIndex_ = 0;
+    size_t offset_ = 0;
+    uint32_t stallCount_ = 0;
+    uint32_t growCount_ = 0;
+};
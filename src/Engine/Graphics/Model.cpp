@@ -1,10 +1,10 @@
 // src/Engine/Graphics/Model.cpp
 #include "Model.h"
 #include "TextureManager.h"
-#include <fstream>
-#include <sstream>
+#include "../Resource/MeshOptimizer.h"
+#include "../Resource/ModelCache.h"
+#include "../Resource/ObjParser.h"
 #include <cassert>
-#include <unordered_map>
 #include <cmath>
 #include <cstdio>
 
@@ -31,6 +31,18 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+namespace {
+	// メッシュの最適化の前後の頂点キャッシュの効率をログに出す
+	void LogMeshOptimize(const std::string& name, const MeshOptimizeStatistics& statistics) {
+		char message[256];
+		std::snprintf(message, sizeof(message),
+			"Model: Optimized %s - %u triangles, vertices %u -> %u, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %u clusters\n",
+			name.c_str(), statistics.triangleCount, statistics.inputVertexCount, statistics.outputVertexCount,
+			statistics.before.acmr, statistics.after.acmr, statistics.before.atvr, statistics.after.atvr, statistics.clusterCount);
+		OutputDebugStringA(message);
+	}
+}
+
 Model::Model() : dxCommon_(nullptr) {}
 
 Model::~Model() {
@@ -49,9 +61,11 @@ void Model::LoadFromObj(const std::string& directoryPath, const std::string& fil
 	// モデルデータの読み込み
 	modelData_ = LoadObjFile(directoryPath, filename);
 
-	// モデルデータを最適化（UV球などの表示品質向上のため）
-	// ファイル名も渡すように修正
-	// OptimizeTriangles(modelData_, filename);  // パフォーマンス向上のため一時的に無効化
+	// 頂点キャッシュとオーバードローのために三角形を並べ替え、使う順に頂点を並べ直す（頂点はObjParserでまとめ済み）
+	MeshOptimizeSettings optimizeSettings;
+	optimizeSettings.weld = false;
+	MeshOptimizeStatistics optimizeStatistics = OptimizeMesh(modelData_.vertices, modelData_.indices, optimizeSettings);
+	LogMeshOptimize(filename, optimizeStatistics);
 
 	// テクスチャの読み込み
 	if (!modelData_.material.textureFilePath.empty()) {
@@ -122,13 +136,42 @@ void Model::LoadFromObj(const std::string& directoryPath, const std::string& fil
 	std::memcpy(vertexData, modelData_.vertices.data(), sizeof(VertexData) * modelData_.vertices.size());
 	vertexResource_->Unmap(0, nullptr);
 
+	// インデックスバッファの作成
+	if (!modelData_.indices.empty()) {
+		indexResource_ = dxCommon_->CreateBufferResource(sizeof(uint32_t) * modelData_.indices.size());
+
+		// インデックスバッファビューの設定
+		indexBufferView_.BufferLocation = indexResource_->GetGPUVirtualAddress();
+		indexBufferView_.SizeInBytes = static_cast<UINT>(sizeof(uint32_t) * modelData_.indices.size());
+		indexBufferView_.Format = DXGI_FORMAT_R32_UINT;
+
+		// インデックスデータの書き込み
+		uint32_t* indexData = nullptr;
+		indexResource_->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
+		std::memcpy(indexData, modelData_.indices.data(), sizeof(uint32_t) * modelData_.indices.size());
+		indexResource_->Unmap(0, nullptr);
+	}
+
 	// デバッグ情報
-	OutputDebugStringA(("Model: Loaded " + std::to_string(modelData_.vertices.size()) + " vertices from " + filename + "\n").c_str());
+	OutputDebugStringA(("Model: Loaded " + std::to_string(modelData_.vertices.size()) + " vertices, " +
+		std::to_string(modelData_.indices.size()) + " indices from " + filename + "\n").c_str());
 }
 
 void Model::LoadFromGltf(const std::string& directoryPath, const std::string& filename) {
-	// モデルデータの読み込み
-	modelData_ = LoadGltfFile(directoryPath, filename);
+	// モデルデータの読み込み（元ファイルが変わっていなければインポート済みのキャッシュを使う）
+	uint64_t sourceHash = HashModelSource(directoryPath, filename);
+	std::string cachePath = GetModelCachePath(directoryPath, filename, ModelCacheKind::StaticMesh);
+	if (sourceHash != 0 && ReadModelCache(cachePath, ModelCacheKind::StaticMesh, sourceHash, modelData_)) {
+		LoadMaterialTextures();
+		OutputDebugStringA(("Model: Loaded from cache " + cachePath + "\n").c_str());
+	}
+	else {
+		modelData_ = LoadGltfFile(directoryPath, filename);
+		// 読み込みに失敗して代わりのOBJを読んだ場合はキャッシュしない
+		if (sourceHash != 0 && !modelData_.matVertexData.empty()) {
+			WriteModelCache(cachePath, ModelCacheKind::StaticMesh, sourceHash, modelData_);
+		}
+	}
 
 	// マルチマテリアル対応の頂点バッファとインデックスバッファを作成
 	if (!modelData_.matVertexData.empty()) {
@@ -184,6 +227,14 @@ void Model::LoadFromGltf(const std::string& directoryPath, const std::string& fi
 	}
 }
 
+void Model::LoadMaterialTextures() {
+	for (const MaterialData& material : modelData_.materials) {
+		if (!material.textureFilePath.empty()) {
+			TextureManager::GetInstance()->LoadTexture(material.textureFilePath);
+		}
+	}
+}
+
 // 頂点バッファの作成（継承クラス用）
 void Model::CreateVertexBuffer() {
 	assert(dxCommon_);
@@ -201,6 +252,8 @@ void Model::CreateVertexBuffer() {
 
 		vertexResources_.clear();
 		vertexBufferViews_.clear();
+		indexResources_.clear();
+		indexBufferViews_.clear();
 
 		for (const auto& matData : modelData_.matVertexData) {
 			const MaterialVertexData& matVertexData = matData.second;
@@ -229,6 +282,23 @@ void Model::CreateVertexBuffer() {
 			vertexResources_.push_back(vertexResource);
 			vertexBufferViews_.push_back(vertexBufferView);
 
+			// インデックスバッファ（なければ空のビューを入れて頂点バッファと番号を揃える）
+			Microsoft::WRL::ComPtr<ID3D12Resource> indexResource;
+			D3D12_INDEX_BUFFER_VIEW indexBufferView{};
+			if (!matVertexData.indices.empty()) {
+				indexResource = dxCommon_->CreateBufferResource(sizeof(uint32_t) * matVertexData.indices.size());
+				indexBufferView.BufferLocation = indexResource->GetGPUVirtualAddress();
+				indexBufferView.SizeInBytes = static_cast<UINT>(sizeof(uint32_t) * matVertexData.indices.size());
+				indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+
+				uint32_t* indexDataPtr = nullptr;
+				indexResource->Map(0, nullptr, reinterpret_cast<void**>(&indexDataPtr));
+				std::memcpy(indexDataPtr, matVertexData.indices.data(), sizeof(uint32_t) * matVertexData.indices.size());
+				indexResource->Unmap(0, nullptr);
+			}
+			indexResources_.push_back(indexResource);
+			indexBufferViews_.push_back(indexBufferView);
+
 			OutputDebugStringA(("Model::CreateVertexBuffer - Created buffer with " +
 				std::to_string(matVertexData.vertices.size()) + " vertices\n").c_str());
 		}
@@ -256,389 +326,56 @@ void Model::CreateVertexBuffer() {
 	}
 }
 
-// UV球などの表示品質を向上させるためのモデルデータ最適化関数
-void Model::OptimizeTriangles(ModelData& modelData, const std::string& filename) {
-	// 最適化前の頂点数を保存
-	size_t originalVertexCount = modelData.vertices.size();
-
-	// 重複頂点の検出と削除のためのデータ構造
-	std::vector<VertexData> optimizedVertices;
-	std::vector<uint32_t> indices;
-	std::unordered_map<std::string, uint32_t> vertexMap;
-
-	// 各頂点を処理
-	for (const auto& vertex : modelData.vertices) {
-		// 頂点のハッシュキーを作成（類似頂点の統合を強化）
-		// 精度を大幅に下げて頂点統合を促進（小数点以下2桁に制限）
-		char buffer[256];
-		snprintf(buffer, sizeof(buffer), "%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f",
-			vertex.position.x, vertex.position.y, vertex.position.z,
-			vertex.normal.x, vertex.normal.y, vertex.normal.z,
-			vertex.texcoord.x, vertex.texcoord.y);
-		std::string key = buffer;
-
-		// この頂点がまだ追加されていなければ追加する
-		if (vertexMap.find(key) == vertexMap.end()) {
-			vertexMap[key] = static_cast<uint32_t>(optimizedVertices.size());
-
-			// 法線を正規化して品質を向上
-			VertexData normalizedVertex = vertex;
-			float length = std::sqrt(
-				normalizedVertex.normal.x * normalizedVertex.normal.x +
-				normalizedVertex.normal.y * normalizedVertex.normal.y +
-				normalizedVertex.normal.z * normalizedVertex.normal.z
-			);
-
-			if (length > 0.0001f) {
-				normalizedVertex.normal.x /= length;
-				normalizedVertex.normal.y /= length;
-				normalizedVertex.normal.z /= length;
-			}
-
-			optimizedVertices.push_back(normalizedVertex);
-		}
-
-		// インデックスを追加
-		indices.push_back(vertexMap[key]);
-	}
-
-	// 法線平均化処理を追加（共有頂点の法線を平均化して滑らかにする）
-	std::vector<Vector3> smoothedNormals(optimizedVertices.size(), { 0.0f, 0.0f, 0.0f });
-	std::vector<int> normalCount(optimizedVertices.size(), 0);
-
-	// 各三角形の法線を集計
-	for (size_t i = 0; i < indices.size(); i += 3) {
-		if (i + 2 < indices.size()) {
-			// 三角形の頂点インデックス
-			uint32_t idx0 = indices[i];
-			uint32_t idx1 = indices[i + 1];
-			uint32_t idx2 = indices[i + 2];
-
-			// 三角形の辺ベクトル
-			Vector3 edge1 = {
-				optimizedVertices[idx1].position.x - optimizedVertices[idx0].position.x,
-				optimizedVertices[idx1].position.y - optimizedVertices[idx0].position.y,
-				optimizedVertices[idx1].position.z - optimizedVertices[idx0].position.z
-			};
-
-			Vector3 edge2 = {
-				optimizedVertices[idx2].position.x - optimizedVertices[idx0].position.x,
-				optimizedVertices[idx2].position.y - optimizedVertices[idx0].position.y,
-				optimizedVertices[idx2].position.z - optimizedVertices[idx0].position.z
-			};
-
-			// 外積で面法線を計算
-			Vector3 faceNormal = {
-				edge1.y * edge2.z - edge1.z * edge2.y,
-				edge1.z * edge2.x - edge1.x * edge2.z,
-				edge1.x * edge2.y - edge1.y * edge2.x
-			};
-
-			// 法線の長さを計算
-			float length = std::sqrt(
-				faceNormal.x * faceNormal.x +
-				faceNormal.y * faceNormal.y +
-				faceNormal.z * faceNormal.z
-			);
-
-			// 法線を正規化
-			if (length > 0.0001f) {
-				faceNormal.x /= length;
-				faceNormal.y /= length;
-				faceNormal.z /= length;
-
-				// 各頂点に面法線を加算
-				smoothedNormals[idx0].x += faceNormal.x;
-				smoothedNormals[idx0].y += faceNormal.y;
-				smoothedNormals[idx0].z += faceNormal.z;
-				normalCount[idx0]++;
-
-				smoothedNormals[idx1].x += faceNormal.x;
-				smoothedNormals[idx1].y += faceNormal.y;
-				smoothedNormals[idx1].z += faceNormal.z;
-				normalCount[idx1]++;
-
-				smoothedNormals[idx2].x += faceNormal.x;
-				smoothedNormals[idx2].y += faceNormal.y;
-				smoothedNormals[idx2].z += faceNormal.z;
-				normalCount[idx2]++;
-			}
-		}
-	}
-
-	// 法線を平均化
-	for (size_t i = 0; i < optimizedVertices.size(); i++) {
-		if (normalCount[i] > 0) {
-			smoothedNormals[i].x /= normalCount[i];
-			smoothedNormals[i].y /= normalCount[i];
-			smoothedNormals[i].z /= normalCount[i];
-
-			// 長さを正規化
-			float length = std::sqrt(
-				smoothedNormals[i].x * smoothedNormals[i].x +
-				smoothedNormals[i].y * smoothedNormals[i].y +
-				smoothedNormals[i].z * smoothedNormals[i].z
-			);
-
-			if (length > 0.0001f) {
-				smoothedNormals[i].x /= length;
-				smoothedNormals[i].y /= length;
-				smoothedNormals[i].z /= length;
-			}
-
-			// 平滑化された法線を適用
-			optimizedVertices[i].normal = smoothedNormals[i];
-		}
-	}
-
-	// UV球の場合は特別な処理（UV座標から理論的な法線を計算）
-	bool isSphere = (filename.find("sphere") != std::string::npos) ||
-		(filename.find("ball") != std::string::npos) ||
-		(filename.find("globe") != std::string::npos);
-
-	if (isSphere) {
-		for (size_t i = 0; i < optimizedVertices.size(); i++) {
-			// UV座標から球面上の位置を計算
-			float u = optimizedVertices[i].texcoord.x;
-			float v = optimizedVertices[i].texcoord.y;
-
-			// 球面座標
-			float phi = u * 2.0f * 3.14159265f;  // 0～2π
-			float theta = v * 3.14159265f;       // 0～π
-
-			// 球面座標から理論的な法線を計算
-			Vector3 theoreticalNormal;
-			theoreticalNormal.x = std::sin(theta) * std::cos(phi);
-			theoreticalNormal.y = std::cos(theta);
-			theoreticalNormal.z = std::sin(theta) * std::sin(phi);
-
-			// 99%理論的な法線を使用して完全な球面を強制
-			Vector3 blendedNormal;
-			blendedNormal.x = 0.99f * theoreticalNormal.x + 0.01f * optimizedVertices[i].normal.x;
-			blendedNormal.y = 0.99f * theoreticalNormal.y + 0.01f * optimizedVertices[i].normal.y;
-			blendedNormal.z = 0.99f * theoreticalNormal.z + 0.01f * optimizedVertices[i].normal.z;
-
-			// 長さを正規化
-			float length = std::sqrt(
-				blendedNormal.x * blendedNormal.x +
-				blendedNormal.y * blendedNormal.y +
-				blendedNormal.z * blendedNormal.z
-			);
-
-			if (length > 0.0001f) {
-				blendedNormal.x /= length;
-				blendedNormal.y /= length;
-				blendedNormal.z /= length;
-			}
-
-			// 混合された法線を適用
-			optimizedVertices[i].normal = blendedNormal;
-		}
-	}
-
-	// インデックスリストから頂点配列を再構築
-	std::vector<VertexData> rebuiltVertices;
-	for (size_t i = 0; i < indices.size(); i += 3) {
-		// 三角形の頂点を追加（順序を維持）
-		if (i + 2 < indices.size()) {
-			rebuiltVertices.push_back(optimizedVertices[indices[i + 2]]);
-			rebuiltVertices.push_back(optimizedVertices[indices[i + 1]]);
-			rebuiltVertices.push_back(optimizedVertices[indices[i]]);
-		}
-	}
-
-	// 最適化された頂点配列で元の配列を置き換え
-	if (!rebuiltVertices.empty()) {
-		modelData.vertices = rebuiltVertices;
-	}
-}
-
 ModelData Model::LoadObjFile(const std::string& directoryPath, const std::string& filename) {
 	ModelData modelData; // 構築するModelData
-	std::vector<Vector4> positions; // 位置
-	std::vector<Vector3> normals; // 法線
-	std::vector<Vector2> texcoords; // テクスチャ座標
-	std::string line; // ファイルから読んだ1行を格納するもの
 
-	// ファイル読み込み
-	std::ifstream file(directoryPath + "/" + filename); // fileを開く
-	assert(file.is_open()); // 開けなかったら止める
+	// ファイルをメモリにマップして解析する（同じ位置・UV・法線の頂点はまとめてインデックスで参照する）
+	ObjMeshData mesh;
+	bool loaded = LoadObjMesh(directoryPath + "/" + filename, mesh);
+	assert(loaded); // 開けなかったら止める
+	(void)loaded;
 
 	OutputDebugStringA(("Model: Loading OBJ file: " + directoryPath + "/" + filename + "\n").c_str());
+	if (mesh.skippedFaceCount > 0) {
+		OutputDebugStringA(("WARNING: Skipped " + std::to_string(mesh.skippedFaceCount) + " faces with invalid indices\n").c_str());
+	}
 
-	while (std::getline(file, line)) {
-		std::string identifier;
-		std::istringstream s(line);
-		s >> identifier; // 先頭の識別子を読む
-
-		if (identifier == "v") {
-			Vector4 position;
-			s >> position.x >> position.y >> position.z;
-			position.w = 1.0f;
-			position.x *= -1;
-			positions.push_back(position);
-		}
-		else if (identifier == "vt") {
-			Vector2 texcoord;
-			s >> texcoord.x >> texcoord.y;
-			texcoord.y = 1 - texcoord.y;
-			texcoords.push_back(texcoord);
-		}
-		else if (identifier == "vn") {
-			Vector3 normal;
-			s >> normal.x >> normal.y >> normal.z;
-			normal.x *= -1;
-			normals.push_back(normal);
-		}
-		else if (identifier == "f") {
-			VertexData triangle[3];
-			// 面は三角形限定。その他は未対応
-			for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
-				std::string vertexDefinition;
-				s >> vertexDefinition;
-				// 頂点の要素へのIndexは「位置・UV・法線」で格納されているので、分解してIndexを取得する
-				std::istringstream v(vertexDefinition);
-				uint32_t elementIndices[3];
-				for (int32_t element = 0; element < 3; ++element) {
-					std::string index;
-					std::getline(v, index, '/'); // 区切りでインデックスを読んでいく
-					elementIndices[element] = std::stoi(index);
-				}
-				// 要素へのIndexから、実際の要素の値を取得して、頂点を構築する
-				Vector4 position = positions[elementIndices[0] - 1];
-				Vector2 texcoord = texcoords[elementIndices[1] - 1];
-				Vector3 normal = normals[elementIndices[2] - 1];
-
-				triangle[faceVertex] = { position, texcoord, normal };
-			}
-			// 頂点を逆順で登録することで、周り順を逆にする
-			modelData.vertices.push_back(triangle[2]);
-			modelData.vertices.push_back(triangle[1]);
-			modelData.vertices.push_back(triangle[0]);
-		}
-		else if (identifier == "mtllib") {
-			// materialTemplateLibraryファイルの名前を取得する
-			std::string materialFilename;
-			s >> materialFilename;
+	modelData.vertices = std::move(mesh.vertices);
+	modelData.indices = std::move(mesh.indices);
 
-			// MTLファイル名をログに出力
-			OutputDebugStringA(("Model: Found MTL reference: " + materialFilename + "\n").c_str());
+	if (!mesh.materialLibrary.empty()) {
+		// MTLファイル名をログに出力
+		OutputDebugStringA(("Model: Found MTL reference: " + mesh.materialLibrary + "\n").c_str());
 
-			// 基本的にobjファイルと同一階層にmtlは存在させるので、ディレクトリ名とファイル名を渡す
-			modelData.material = LoadMaterialTemplateFile(directoryPath, materialFilename);
-		}
+		// 基本的にobjファイルと同一階層にmtlは存在させるので、ディレクトリ名とファイル名を渡す
+		modelData.material = LoadMaterialTemplateFile(directoryPath, mesh.materialLibrary);
 	}
 	return modelData;
 }
 
 MaterialData Model::LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
 	MaterialData materialData; // 構築するMaterialData
-	std::string line; // ファイルから読んだ1行を格納するもの
 
 	// ファイルのフルパス
 	std::string mtlPath = directoryPath + "/" + filename;
-	std::ifstream file(mtlPath); // ファイルを開く
+	MappedFile file;
 
 	// ファイルが開けなかった場合は警告を出力して、デフォルト値を返す
-	if (!file.is_open()) {
+	if (!file.Open(mtlPath)) {
 		OutputDebugStringA(("WARNING: Failed to open MTL file - " + mtlPath + "\n").c_str());
 		return materialData;
 	}
 
 	OutputDebugStringA(("Model: Successfully opened MTL file - " + mtlPath + "\n").c_str());
 
-	while (std::getline(file, line)) {
-		std::string identifier;
-		std::stringstream s(line);
-		s >> identifier;
-
-		// identifierの応じた処理
-		if (identifier == "map_Kd") {
-			std::string token;
-			std::string textureFilename;
-
-			// オプション引数（-s, -o, -t など）を解析してファイル名を見つける
-			while (s >> token) {
-				if (token[0] == '-') {
-					// オプション引数の場合
-					if (token == "-s") {
-						// スケールオプション：3つの値を読み取る
-						float scaleU, scaleV, scaleW;
-						s >> scaleU >> scaleV >> scaleW;
-						materialData.textureScale.x = scaleU;
-						materialData.textureScale.y = scaleV;
-						OutputDebugStringA(("MTL Parser: Texture scale: " + std::to_string(scaleU) + ", " + std::to_string(scaleV) + "\n").c_str());
-					}
-					else if (token == "-o") {
-						// オフセットオプション：3つの値を読み取る
-						float offsetU, offsetV, offsetW;
-						s >> offsetU >> offsetV >> offsetW;
-						materialData.textureOffset.x = offsetU;
-						materialData.textureOffset.y = offsetV;
-						OutputDebugStringA(("MTL Parser: Texture offset: " + std::to_string(offsetU) + ", " + std::to_string(offsetV) + "\n").c_str());
-					}
-					else if (token == "-t") {
-						// タービュレンスオプション：3つの値をスキップ
-						std::string dummy1, dummy2, dummy3;
-						s >> dummy1 >> dummy2 >> dummy3;
-					}
-					else if (token == "-mm") {
-						// -mmオプションは2つの値をスキップ
-						std::string dummy1, dummy2;
-						s >> dummy1 >> dummy2;
-					}
-					else {
-						// その他のオプションは1つの値をスキップ
-						std::string dummy;
-						s >> dummy;
-					}
-				}
-				else {
-					// オプションではない場合、これがテクスチャファイル名
-					textureFilename = token;
-					break;
-				}
-			}
-
-			// テクスチャファイル名をログに出力
-			OutputDebugStringA(("MTL Parser: Found texture reference: " + textureFilename + "\n").c_str());
+	std::span<const uint8_t> bytes = file.GetBytes();
+	ParseMaterialTemplate(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()), directoryPath, materialData);
 
-			// 連結してファイルパスにする
-			materialData.textureFilePath = directoryPath + "/" + textureFilename;
-
-			// フルパスをログに出力
-			OutputDebugStringA(("MTL Parser: Full texture path constructed: " + materialData.textureFilePath + "\n").c_str());
-		}
-		else if (identifier == "Ka") {
-			// ambient color
-			s >> materialData.ambient.x >> materialData.ambient.y >> materialData.ambient.z;
-			materialData.ambient.w = 1.0f;
-		}
-		else if (identifier == "Kd") {
-			// diffuse color
-			s >> materialData.diffuse.x >> materialData.diffuse.y >> materialData.diffuse.z;
-			materialData.diffuse.w = 1.0f;
-		}
-		else if (identifier == "Ks") {
-			// specular color
-			s >> materialData.specular.x >> materialData.specular.y >> materialData.specular.z;
-			materialData.specular.w = 1.0f;
-		}
-		else if (identifier == "Ns") {
-			// shininess
-			s >> materialData.shininess;
-		}
-		else if (identifier == "d" || identifier == "Tr") {
-			// transparency (d) or transparency inverted (Tr)
-			if (identifier == "d") {
-				s >> materialData.alpha;
-			}
-			else { // Tr (transparency inverted)
-				float tr;
-				s >> tr;
-				materialData.alpha = 1.0f - tr;
-			}
-		}
+	if (!materialData.textureFilePath.empty()) {
+		// フルパスをログに出力
+		OutputDebugStringA(("MTL Parser: Full texture path constructed: " + materialData.textureFilePath + "\n").c_str());
+		OutputDebugStringA(("MTL Parser: Texture scale: " + std::to_string(materialData.textureScale.x) + ", " + std::to_string(materialData.textureScale.y) + "\n").c_str());
+		OutputDebugStringA(("MTL Parser: Texture offset: " + std::to_string(materialData.textureOffset.x) + ", " + std::to_string(materialData.textureOffset.y) + "\n").c_str());
 	}
 
 	return materialData;
@@ -668,7 +405,7 @@ ModelData Model::LoadGltfFile(const std::string& directoryPath, const std::strin
 	Assimp::Importer importer;
 	std::string filePath = directoryPath + "/" + filename;
 	const aiScene* scene = importer.ReadFile(filePath.c_str(),
-		aiProcess_FlipWindingOrder | aiProcess_FlipUVs | aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
+		aiProcess_FlipWindingOrder | aiProcess_FlipUVs | aiProcess_Triangulate);
 
 	if (!scene || !scene->HasMeshes()) {
 		OutputDebugStringA(("ERROR: Failed to load GLTF file: " + filePath + "\n").c_str());
@@ -712,9 +449,6 @@ ModelData Model::LoadGltfFile(const std::string& directoryPath, const std::strin
 			matVertexData.vertices[vertexIndex].position = { -position.x, position.y, position.z, 1.0f };
 			matVertexData.vertices[vertexIndex].normal = { -normal.x, normal.y, normal.z };
 			matVertexData.vertices[vertexIndex].texcoord = { texcoord.x, texcoord.y };
-
-			// 全体の頂点リストにも追加
-			modelData.vertices.push_back(matVertexData.vertices[vertexIndex]);
 		}
 
 		// インデックスの解析
@@ -728,10 +462,18 @@ ModelData Model::LoadGltfFile(const std::string& directoryPath, const std::strin
 			for (uint32_t element = 0; element < face.mNumIndices; ++element) {
 				uint32_t vertexIndex = face.mIndices[element];
 				matVertexData.indices.push_back(vertexIndex);
-				modelData.indices.push_back(vertexIndex);
 			}
 		}
 
+		// 同じ頂点を溶接し、頂点キャッシュとオーバードローのためにメッシュごとに並べ替える
+		// （使うのは位置・法線・UVだけなので、AssimpのJoinIdenticalVerticesの代わりにVertexWelderでまとめる）
+		MeshOptimizeStatistics optimizeStatistics = OptimizeMesh(matVertexData.vertices, matVertexData.indices);
+		LogMeshOptimize(utf8, optimizeStatistics);
+
+		// 全体の頂点リストにも追加
+		modelData.vertices.insert(modelData.vertices.end(), matVertexData.vertices.begin(), matVertexData.vertices.end());
+		modelData.indices.insert(modelData.indices.end(), matVertexData.indices.begin(), matVertexData.indices.end());
+
 		modelData.matVertexData[meshName] = matVertexData;
 	}
 
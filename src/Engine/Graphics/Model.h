@@ -28,22 +28,27 @@ public:
     const MaterialData& GetMaterial() const { return modelData_.material; }
     const std::string& GetTextureFilePath() const { return modelData_.material.textureFilePath; }
     const D3D12_VERTEX_BUFFER_VIEW& GetVBView() const { return vertexBufferView_; }
+    // インデックスバッファ（OBJのように頂点をまとめて読み込んだモデルのみ。なければ頂点を順に描画する）
+    bool HasIndexBuffer() const { return indexResource_ != nullptr; }
+    const D3D12_INDEX_BUFFER_VIEW& GetIBView() const { return indexBufferView_; }
+    uint32_t GetIndexCount() const { return static_cast<uint32_t>(modelData_.indices.size()); }
     ID3D12Resource* GetVertexResource() const { return vertexResource_.Get(); }
     const ModelData& GetModelData() const { return modelData_; }
     
     // マルチマテリアル対応のためのパブリックアクセサ
     ModelData& GetModelDataInternal() { return modelData_; }
     const std::vector<D3D12_VERTEX_BUFFER_VIEW>& GetVertexBufferViews() const { return vertexBufferViews_; }
+    // メッシュごとのインデックスバッファ（GetVertexBufferViewsと同じ番号。インデックスのないメッシュはSizeInBytesが0）
+    const std::vector<D3D12_INDEX_BUFFER_VIEW>& GetIndexBufferViews() const { return indexBufferViews_; }
 
     // 頂点バッファの作成（マルチマテリアル対応）
     void CreateVertexBuffer();
 
 protected:
+    // マテリアルのテクスチャを読み込む（キャッシュから読んだときはインポートの代わりにここで読む）
+    void LoadMaterialTextures();
 
 private:
-    // モデルデータの最適化（UV球など改善のため）
-    void OptimizeTriangles(ModelData& modelData, const std::string& filename);
-
     // モデルデータの読み込み
     ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename);
     ModelData LoadGltfFile(const std::string& directoryPath, const std::string& filename);
@@ -56,6 +61,10 @@ private:
     Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource_;
     // 頂点バッファビュー
     D3D12_VERTEX_BUFFER_VIEW vertexBufferView_{};
+    // インデックスバッファ
+    Microsoft::WRL::ComPtr<ID3D12Resource> indexResource_;
+    // インデックスバッファビュー
+    D3D12_INDEX_BUFFER_VIEW indexBufferView_{};
     // DirectXCommon
     DirectXCommon* dxCommon_;
 
@@ -7,10 +7,24 @@
 #include "Animation.h"
 #include "AnimatedModel.h"
 #include "AnimationUtility.h"
+#include "AnimationSystem.h"
+#include "SkeletonUpdate.h"
 #include "UnoEngine.h"
 #include "AABBCollision.h"
+#include <algorithm>
 #include <unordered_set>
 
+namespace {
+	// 点を行ベクトル規約の行列で変換
+	Vector3 TransformPoint(const Vector3& point, const Matrix4x4& m) {
+		return {
+			point.x * m.m[0][0] + point.y * m.m[1][0] + point.z * m.m[2][0] + m.m[3][0],
+			point.x * m.m[0][1] + point.y * m.m[1][1] + point.z * m.m[2][1] + m.m[3][1],
+			point.x * m.m[0][2] + point.y * m.m[1][2] + point.z * m.m[2][2] + m.m[3][2],
+		};
+	}
+}
+
 
 Object3d::Object3d() : model_(nullptr), dxCommon_(nullptr), spriteCommon_(nullptr),
 materialData_(nullptr), transformationMatrixData_(nullptr), directionalLightData_(nullptr),
@@ -25,6 +39,13 @@ spotLightData_(nullptr), cameraData_(nullptr), camera_(nullptr) {
 }
 
 Object3d::~Object3d() {
+	// 評価待ちのまま破棄される場合は登録を取り消す
+	AnimationSystem::GetInstance()->Cancel(this);
+
+	// パレットの共有を解除（自分のバッファで描画しているインスタンスは、それぞれのバッファに戻す）
+	ReleaseAnimationShare();
+	DetachPaletteBorrowers();
+
 	// ComPtrリソースの解放（Unmapは不要 - これらは永続的にマップされている）
 	if (materialResource_) {
 		materialResource_.Reset();
@@ -314,58 +335,18 @@ void Object3d::Update() {
 
 	// アニメーション処理
 	if (animatedModel_) {
-		Skeleton& skeleton = animatedModel_->GetSkeleton();
-		SkinCluster& skinCluster = animatedModel_->GetSkinCluster();
-
-		// デバッグ出力用
-		static int frameCount = 0;
-
-		// ブレンド対応のアニメーション適用
-		if (animatedModel_->IsBlending()) {
-			// ブレンド中は各ジョイントに対してブレンドされた変換を適用
-			for (Joint& joint : skeleton.joints) {
-				// 初期ジョイント変換を使用（前フレームの値ではなく）
-				JointTransform originalTransform;
-				auto initialIt = animatedModel_->GetInitialJointTransforms().find(joint.name);
-				if (initialIt != animatedModel_->GetInitialJointTransforms().end()) {
-					originalTransform = initialIt->second;
-				}
-				else {
-					// 初期変換が見つからない場合は現在の値を使用
-					originalTransform.scale = joint.transform.scale;
-					originalTransform.rotate = joint.transform.rotate;
-					originalTransform.translate = joint.transform.translate;
-				}
-
-				// ブレンドされた変換を取得
-				auto blendedTransform = animatedModel_->GetBlendedTransform(joint.name, originalTransform);
-
-				// デバッグ: スケール値を確認
-				if (frameCount % 60 == 0 && joint.name == skeleton.joints[0].name) {
-					OutputDebugStringA(("Object3d::Update - Joint " + joint.name +
-						" original scale: (" + std::to_string(originalTransform.scale.x) + ", " +
-						std::to_string(originalTransform.scale.y) + ", " +
-						std::to_string(originalTransform.scale.z) + ")" +
-						" blended scale: (" + std::to_string(blendedTransform.scale.x) + ", " +
-						std::to_string(blendedTransform.scale.y) + ", " +
-						std::to_string(blendedTransform.scale.z) + ")\n").c_str());
-				}
-
-				joint.transform.scale = blendedTransform.scale;
-				joint.transform.rotate = blendedTransform.rotate;
-				joint.transform.translate = blendedTransform.translate;
-			}
+		// パレットの共有はフレームごとにAnimationSystemが決め直す
+		ReleaseAnimationShare();
+
+		// AnimationSystemが有効ならシーン更新後にまとめて並列評価する
+		AnimationSystem* animationSystem = AnimationSystem::GetInstance();
+		if (animationSystem->IsInitialized()) {
+			animationSystem->Submit(this);
 		}
 		else {
-			// 通常のアニメーション適用
-			const Animation& currentAnimation = animatedModel_->GetAnimationPlayer().GetAnimation();
-			float animationTime = animatedModel_->GetAnimationPlayer().GetTime();
-			ApplyAnimation(skeleton, currentAnimation, animationTime);
+			UpdateAnimation();
 		}
 
-		SkeletonUpdate(skeleton);
-		SkinClusterUpdate(skinCluster, skeleton);
-
 		// アニメーション行列は単位行列のままにする（スキニングで頂点変換するため）
 		animationMatrix_ = MakeIdentity4x4();
 
@@ -381,6 +362,13 @@ void Object3d::Update() {
 		noAnimCount++;
 	}
 
+	UpdateTransformationMatrix();
+}
+
+// 行列だけを現在のカメラで計算し直す（アニメーションは登録しない）
+void Object3d::UpdateTransformationMatrix() {
+	assert(transformationMatrixData_);
+
 	// カメラが設定されている場合のみ処理
 	if (!camera_) {
 		// カメラが設定されていない場合は何もしない
@@ -424,13 +412,21 @@ void Object3d::Draw() {
 	}
 	
 	bool useAnimation = enableAnimation_ && animatedModel_;
+	// デュアルクォータニオンのパレットは専用の頂点シェーダーで読む
+	bool useDualQuaternion = useAnimation && animatedModel_->GetSkinningMethod() == SkinningMethod::DualQuaternion;
 	
-	if (usePBR && useAnimation) {
+	if (usePBR && useDualQuaternion) {
+		dxCommon_->GetCommandList()->SetPipelineState(spriteCommon_->GetPBRDualQuaternionSkinningPipelineState().Get());
+	}
+	else if (usePBR && useAnimation) {
 		dxCommon_->GetCommandList()->SetPipelineState(spriteCommon_->GetPBRSkinningPipelineState().Get());
 	}
 	else if (usePBR) {
 		dxCommon_->GetCommandList()->SetPipelineState(spriteCommon_->GetPBRPipelineState().Get());
 	}
+	else if (useDualQuaternion) {
+		dxCommon_->GetCommandList()->SetPipelineState(spriteCommon_->GetDualQuaternionSkinningPipelineState().Get());
+	}
 	else if (useAnimation) {
 		dxCommon_->GetCommandList()->SetPipelineState(spriteCommon_->GetSkinningPipelineState().Get());
 	}
@@ -526,11 +522,14 @@ void Object3d::Draw() {
 	// パレットSRVの設定（アニメーション用）
 	if (useAnimation) {
 		AnimatedModel* animModel = static_cast<AnimatedModel*>(animatedModel_);
-		const SkinCluster& skinCluster = animModel->GetSkinCluster();
+		// 同じポーズのインスタンスとパレットを共有している場合は共有元のバッファを使う
+		const SkinCluster& skinCluster = sharedSkinCluster_ ? *sharedSkinCluster_ : animModel->GetSkinCluster();
+
+		const auto& paletteSrvHandle = useDualQuaternion ? skinCluster.dualQuaternionPaletteSrvHandle : skinCluster.paletteSrvHandle;
 
-		if (skinCluster.paletteSrvHandle.second.ptr != 0) {
+		if (paletteSrvHandle.second.ptr != 0) {
 			// パレットSRVをセット
-			dxCommon_->GetCommandList()->SetGraphicsRootDescriptorTable(4, skinCluster.paletteSrvHandle.second);
+			dxCommon_->GetCommandList()->SetGraphicsRootDescriptorTable(4, paletteSrvHandle.second);
 		}
 		else {
 			// パレットSRVが無効な場合は警告
@@ -546,6 +545,7 @@ void Object3d::Draw() {
 	if (isMultiMaterial) {
 		// マルチマテリアルモード
 		const std::vector<D3D12_VERTEX_BUFFER_VIEW>& vbViews = model_->GetVertexBufferViews();
+		const std::vector<D3D12_INDEX_BUFFER_VIEW>& ibViews = model_->GetIndexBufferViews();
 		size_t meshIndex = 0;
 
 		for (const auto& matDataPair : modelData.matVertexData) {
@@ -602,76 +602,322 @@ void Object3d::Draw() {
 			}
 			drawCount++;
 
-			// このメッシュの頂点を描画
-			uint32_t vertexCount = static_cast<uint32_t>(matVertexData.vertices.size());
-			dxCommon_->GetCommandList()->DrawInstanced(vertexCount, 1, 0, 0);
+			// このメッシュを描画（インデックスバッファがあれば使う）
+			if (meshIndex < ibViews.size() && ibViews[meshIndex].SizeInBytes != 0) {
+				uint32_t indexCount = static_cast<uint32_t>(matVertexData.indices.size());
+				dxCommon_->GetCommandList()->IASetIndexBuffer(&ibViews[meshIndex]);
+				dxCommon_->GetCommandList()->DrawIndexedInstanced(indexCount, 1, 0, 0, 0);
+			}
+			else {
+				uint32_t vertexCount = static_cast<uint32_t>(matVertexData.vertices.size());
+				dxCommon_->GetCommandList()->DrawInstanced(vertexCount, 1, 0, 0);
+			}
 
 			meshIndex++;
 		}
 	}
 	else {
-		// シングルマテリアルモード（従来通り）
-		dxCommon_->GetCommandList()->DrawInstanced(model_->GetVertexCount(), 1, 0, 0);
+		// シングルマテリアルモード（インデックスバッファがあれば使う）
+		if (model_->HasIndexBuffer()) {
+			dxCommon_->GetCommandList()->IASetIndexBuffer(&model_->GetIBView());
+			dxCommon_->GetCommandList()->DrawIndexedInstanced(model_->GetIndexCount(), 1, 0, 0, 0);
+		}
+		else {
+			dxCommon_->GetCommandList()->DrawInstanced(model_->GetVertexCount(), 1, 0, 0);
+		}
 	}
 }
 
-void Object3d::SkeletonUpdate(Skeleton& skeleton)
+void Object3d::UpdateAnimation()
 {
-	// ← ここでサイズを合わせるのが絶対必要！！
-	skeletonPose_.resize(skeleton.joints.size());
-	//すべてのjointを更新。親が若いので通常ループで処理可能になっている
-	for (Joint& joint : skeleton.joints)
-	{
-		joint.localMatrix = MakeAffineMatrix(joint.transform.scale, joint.transform.rotate, joint.transform.translate);
-		if (joint.parent)
-		{
-			joint.skeletonSpaceMatrix = Multiply(joint.localMatrix, skeleton.joints[*joint.parent].skeletonSpaceMatrix);
+	if (!animatedModel_) {
+		return;
+	}
+	Skeleton& skeleton = animatedModel_->GetSkeleton();
+	SkinCluster& skinCluster = animatedModel_->GetSkinCluster();
+	AnimationLodState& lod = animationLod_;
+
+	bool dualQuaternion = animatedModel_->GetSkinningMethod() == SkinningMethod::DualQuaternion;
 
+	// 評価しないフレームは直前に評価した2つのパレットを補間する（停止中と補間し終えた後は書き込まない）
+	// デュアルクォータニオンは線形補間できないため、直前のパレットをそのまま使う
+	if (!lod.evaluate) {
+		if (dualQuaternion) {
+			return;
 		}
-		else
-		{
-			joint.skeletonSpaceMatrix = joint.localMatrix;
+		++lod.framesSinceEvaluation;
+		if (lod.framesSinceEvaluation < lod.interval || mappedPaletteStale_) {
+			InterpolatePalette(lod.previousPalette, lod.currentPalette, lod.GetInterpolationFactor(), skinCluster.mappedPalette);
+			mappedPaletteStale_ = false;
+		}
+		return;
+	}
+
+	// 同じクリップ・時刻・スキンのインスタンスが評価したパレットを履歴に加える（サンプリングから省く）
+	if (animationShareSource_ && animationSharePalette_) {
+		const AnimationLodState& sourceLod = animationShareSource_->animationLod_;
+		std::swap(lod.previousPalette, lod.currentPalette);
+		lod.currentPalette = sourceLod.currentPalette;
+		lod.FinishEvaluation();
+		UpdateSkinnedBounds(CalculateSkinnedBounds(lod.currentPalette, animatedModel_->GetJointBounds()));
+
+		// どちらも最新のパレットをそのまま使うなら、共有元のバッファで描画してアップロードを省く
+		if (lod.GetInterpolationFactor() >= 1.0f && sourceLod.GetInterpolationFactor() >= 1.0f) {
+			sharedSkinCluster_ = &animationShareSource_->animatedModel_->GetSkinCluster();
+			mappedPaletteStale_ = true;
+		}
+		else {
+			InterpolatePalette(lod.previousPalette, lod.currentPalette, lod.GetInterpolationFactor(), skinCluster.mappedPalette);
+			mappedPaletteStale_ = false;
+		}
+		return;
+	}
+
+	// 焼き込み済みのクリップは表の行を読むだけにする（サンプリングとスケルトンの評価を省く）
+	// IKでポーズを書き換える場合は表を使わない
+	bool useIk = IsFootIkEnabled() || (lookAtSolver_.IsValid() && lookAtWeight_ > 0.0f);
+	uint32_t bakedRow = 0;
+	bool baked = !dualQuaternion && !useIk && animatedModel_->GetBakedRow(bakedRow);
+
+	if (!baked) {
+		bool posed = false;
+		// 同じクリップ・時刻のインスタンスのポーズを使う（スキンが違うのでパレットは自分で計算する）
+		bool shared = animationShareSource_ != nullptr;
+		if (shared) {
+			animationPose_ = animationShareSource_->animationPose_;
+			ApplyPoseToSkeleton(animationPose_, skeleton);
+		}
+		// ブレンドツリーでクロスフェードや追加レイヤーを合成したポーズを適用（文字列の検索なし）
+		else if (animatedModel_->EvaluatePose(animationPose_)) {
+			posed = true;
+		}
+		else {
+			// スケルトンに結び付けていないアニメーションはノード名で適用
+			const Animation& currentAnimation = animatedModel_->GetAnimationPlayer().GetAnimation();
+			float animationTime = animatedModel_->GetAnimationPlayer().GetTime();
+			ApplyAnimation(skeleton, currentAnimation, animationTime);
+		}
+
+		Matrix4x4 worldMatrix = useIk ? CalculateWorldMatrix() : MakeIdentity4x4();
+		if (posed) {
+			// 注視はスケルトンの更新前にポーズを書き換える
+			if (lookAtSolver_.IsValid() && lookAtWeight_ > 0.0f) {
+				lookAtSolver_.Solve(animationPose_, TransformPoint(lookAtTarget_, Inverse(worldMatrix)), lookAtWeight_);
+			}
+			ApplyPoseToSkeleton(animationPose_, skeleton);
+		}
+		if (posed || shared) {
+			UpdateAnimatedSkeleton(skeleton);
+		}
+		else {
+			skeletonUpdate_.Invalidate();
+			SkeletonUpdate(skeleton);
+		}
+
+		// 足のIKは更新したスケルトンの足首の位置から目標を決め、書き換えた脚の部分木だけ計算し直す
+		if (posed && IsFootIkEnabled() && footIkGroundHeights_.size() == footIkRig_.GetLegCount()) {
+			footIkRig_.Apply(animationPose_, skeleton, worldMatrix, footIkGroundHeights_, transform_.translate.y);
+		}
+	}
+
+	if (dualQuaternion) {
+		UpdateDualQuaternionPalette(skeleton, skinCluster.inverseBindPoseMatrices, skinCluster.mappedDualQuaternionPalette);
+		skinnedBounds_ = CalculateSkinnedBounds(skeleton, skinCluster.inverseBindPoseMatrices, animatedModel_->GetJointBounds());
+		paletteBounds_ = skinnedBounds_;
+		return;
+	}
+
+	// 評価したパレットを履歴に残してから出力する（間隔が1なら最新のパレットをそのまま書き込む）
+	std::swap(lod.previousPalette, lod.currentPalette);
+	lod.currentPalette.resize(skeleton.joints.size());
+	if (baked) {
+		animatedModel_->GetBakedAnimationTable().DecodeRow(bakedRow, lod.currentPalette);
+	}
+	else {
+		UpdateSkinPalette(skeleton, skinCluster.inverseBindPoseMatrices, lod.currentPalette);
+	}
+	lod.FinishEvaluation();
+	UpdateSkinnedBounds(CalculateSkinnedBounds(lod.currentPalette, animatedModel_->GetJointBounds()));
+	InterpolatePalette(lod.previousPalette, lod.currentPalette, lod.GetInterpolationFactor(), skinCluster.mappedPalette);
+	mappedPaletteStale_ = false;
+}
+
+void Object3d::UpdateSkinnedBounds(const SkinnedBounds& paletteBounds)
+{
+	// 補間中は直前と最新のパレットの間の姿勢になるので、両方の範囲を合わせる
+	skinnedBounds_ = paletteBounds;
+	if (animationLod_.GetInterpolationFactor() < 1.0f) {
+		skinnedBounds_.Merge(paletteBounds_);
+	}
+	paletteBounds_ = paletteBounds;
+}
+
+void Object3d::UpdateAnimatedSkeleton(Skeleton& skeleton)
+{
+	// クリップで値が変わるジョイントに、毎フレーム書き換えるルートモーション・IKのジョイントを加える
+	animatedJoints_.assign(skeleton.joints.size(), 0);
+	uint64_t clipsHash = animatedModel_->MarkAnimatedJoints(animatedJoints_);
+	if (lookAtSolver_.IsValid() && lookAtWeight_ > 0.0f) {
+		animatedJoints_[lookAtSolver_.GetJoint()] = 1;
+	}
+	if (IsFootIkEnabled()) {
+		for (uint32_t i = 0; i < footIkRig_.GetLegCount(); ++i) {
+			animatedJoints_[footIkRig_.GetLeg(i).GetUpper()] = 1;
+			animatedJoints_[footIkRig_.GetLeg(i).GetMiddle()] = 1;
 		}
-		skeletonPose_[joint.index] = joint.skeletonSpaceMatrix;
 	}
 
+	// 合成するクリップや重みが変わったフレームは、静的なジョイントの値も変わりうるので全体を計算する
+	if (clipsHash != animatedClipsHash_) {
+		animatedClipsHash_ = clipsHash;
+		skeletonUpdate_.Invalidate();
+	}
+	skeletonUpdate_.SetAnimatedJoints(skeleton, animatedJoints_);
+	skeletonUpdate_.Update(skeleton);
+}
+
+bool Object3d::GetSharablePose(const CompiledAnimationClip*& outClip, float& outTime, uint64_t& outSkinHash) const
+{
+	// 焼き込み済みのモデルは表を読むだけなので共有しない（ポーズを計算しないため共有元にもなれない）
+	// デュアルクォータニオンのパレットは行列パレットと形式が違うので共有しない
+	// IKで書き換えたポーズはインスタンスごとに違うので共有しない
+	if (!animatedModel_ || animatedModel_->IsAnimationBaked() || IsFootIkEnabled() || (lookAtSolver_.IsValid() && lookAtWeight_ > 0.0f) ||
+		animatedModel_->GetSkinningMethod() == SkinningMethod::DualQuaternion ||
+		!animatedModel_->GetSharablePose(outClip, outTime)) {
+		return false;
+	}
+	outSkinHash = animatedModel_->GetSkinHash();
+	return true;
+}
+
+void Object3d::SetAnimationShareSource(Object3d* source, bool sharePalette)
+{
+	ReleaseAnimationShare();
+	animationShareSource_ = source;
+	animationSharePalette_ = sharePalette;
+	// パレットのバッファを借りるので、共有元が先に破棄されたら解除してもらう
+	if (source && sharePalette) {
+		source->paletteBorrowers_.push_back(this);
+	}
+}
+
+void Object3d::ReleaseAnimationShare()
+{
+	if (animationShareSource_ && animationSharePalette_) {
+		std::vector<Object3d*>& borrowers = animationShareSource_->paletteBorrowers_;
+		borrowers.erase(std::remove(borrowers.begin(), borrowers.end(), this), borrowers.end());
+	}
+	animationShareSource_ = nullptr;
+	animationSharePalette_ = false;
+	sharedSkinCluster_ = nullptr;
+}
+
+void Object3d::DetachPaletteBorrowers()
+{
+	for (Object3d* borrower : paletteBorrowers_) {
+		borrower->DetachAnimationShareSource();
+	}
+	paletteBorrowers_.clear();
+}
+
+void Object3d::DetachAnimationShareSource()
+{
+	animationShareSource_ = nullptr;
+	animationSharePalette_ = false;
+	if (!sharedSkinCluster_) {
+		return;
+	}
+	sharedSkinCluster_ = nullptr;
+
+	// 共有時に最新のパレットは履歴にコピー済みなので、それを自分のバッファに書き込む
+	AnimationLodState& lod = animationLod_;
+	if (animatedModel_ && !lod.currentPalette.empty()) {
+		InterpolatePalette(lod.previousPalette, lod.currentPalette, lod.GetInterpolationFactor(), animatedModel_->GetSkinCluster().mappedPalette);
+		mappedPaletteStale_ = false;
+	}
+}
+
+bool Object3d::AddFootIkLeg(const std::string& upperName, const std::string& middleName, const std::string& endName)
+{
+	if (!animatedModel_) {
+		return false;
+	}
+	const Skeleton& skeleton = animatedModel_->GetSkeleton();
+	auto upper = skeleton.jointMap.find(upperName);
+	auto middle = skeleton.jointMap.find(middleName);
+	auto end = skeleton.jointMap.find(endName);
+	if (upper == skeleton.jointMap.end() || middle == skeleton.jointMap.end() || end == skeleton.jointMap.end()) {
+		return false;
+	}
+	footIkGroundHeights_.clear();
+	return footIkRig_.AddLeg(skeleton, upper->second, middle->second, end->second);
+}
+
+void Object3d::ClearFootIk()
+{
+	footIkRig_.Clear();
+	footIkGroundHeights_.clear();
+}
+
+void Object3d::BuildFootIkRays(std::span<Vector3> outOrigins) const
+{
+	footIkRig_.BuildGroundRays(animatedModel_->GetSkeleton(), CalculateWorldMatrix(), outOrigins);
+}
+
+void Object3d::SetFootIkGroundHeights(std::span<const float> heights)
+{
+	footIkGroundHeights_.assign(heights.begin(), heights.end());
+}
+
+bool Object3d::EnableLookAt(const std::string& jointName, const Vector3& aimAxis, float maxAngle)
+{
+	if (!animatedModel_) {
+		return false;
+	}
+	const Skeleton& skeleton = animatedModel_->GetSkeleton();
+	auto it = skeleton.jointMap.find(jointName);
+	if (it == skeleton.jointMap.end()) {
+		return false;
+	}
+	return lookAtSolver_.Initialize(skeleton, it->second, aimAxis, maxAngle);
+}
+
+void Object3d::SkeletonUpdate(Skeleton& skeleton)
+{
+	UpdateSkeletonSpaceMatrices(skeleton);
 }
 
 void Object3d::ApplyAnimation(Skeleton& skeleton, const Animation& animation, float animationTime)
 {
-	static int applyCount = 0;
-	bool shouldDebug = (applyCount % 300 == 0); // 5秒ごとに出力
-	applyCount++;
+	// 前フレームの区間を探索の起点にする（クリップが変わっても範囲外なら二分探索に戻るだけ）
+	animationCursors_.resize(skeleton.joints.size() * CompiledAnimationClip::kChannelCount);
 
 	for (Joint& joint : skeleton.joints) {
 		// 対象のJointのAnimationがあれば、値の適用を行う。
 		// 下記のif文はC++17から可能になった初期化付きif文。
 		if (auto it = animation.nodeAnimations.find(joint.name); it != animation.nodeAnimations.end()) {
 			const NodeAnimation& nodeAnimation = it->second;
+			KeyframeCursor* cursor = &animationCursors_[joint.index * CompiledAnimationClip::kChannelCount];
 
-			joint.transform.translate = ::CalculateValue(nodeAnimation.translate, animationTime);
-			joint.transform.rotate = ::CalculateValue(nodeAnimation.rotate, animationTime);
-			joint.transform.scale = ::CalculateValue(nodeAnimation.scale, animationTime);
+			joint.transform.translate = ::CalculateValue(nodeAnimation.translate, animationTime, cursor[CompiledAnimationClip::kTranslate]);
+			joint.transform.rotate = ::CalculateValue(nodeAnimation.rotate, animationTime, cursor[CompiledAnimationClip::kRotate]);
+			joint.transform.scale = ::CalculateValue(nodeAnimation.scale, animationTime, cursor[CompiledAnimationClip::kScale]);
 		}
 	}
 }
 
 void Object3d::SkinClusterUpdate(SkinCluster& skinCluster, const Skeleton& skeleton)
 {
-	for (size_t jointIndex = 0; jointIndex < skeleton.joints.size(); ++jointIndex)
-	{
-		assert(jointIndex < skinCluster.inverseBindPoseMatrices.size());
-		skinCluster.mappedPalette[jointIndex].skeletonSpaceMatrix =
-			Multiply(skinCluster.inverseBindPoseMatrices[jointIndex], skeleton.joints[jointIndex].skeletonSpaceMatrix);
-		skinCluster.mappedPalette[jointIndex].skeletonSpaceInverseTransposeMatrix =
-			Transpose(Inverse(skinCluster.mappedPalette[jointIndex].skeletonSpaceMatrix));
-	}
+	UpdateSkinPalette(skeleton, skinCluster.inverseBindPoseMatrices, skinCluster.mappedPalette);
 }
 
 // CalculateValue関数はAnimationUtilityから使用するため、Object3dクラスからは削除
 
 void Object3d::SetAnimatedModel(class AnimatedModel* animatedModel)
 {
+	// 共有していたパレットは前のモデルのバッファなので、共有をやめる
+	ReleaseAnimationShare();
+	DetachPaletteBorrowers();
 	animatedModel_ = animatedModel;
 }
 
@@ -4,10 +4,16 @@
 #include "math.h"
 #include "Camera.h"
 #include "Animation.h"
+#include "CompiledAnimationClip.h"
+#include "AnimationLod.h"
+#include "AnimationIk.h"
+#include "SkeletonUpdate.h"
+#include "CpuSkinning.h"
 
 #include <d3d12.h>
 #include <wrl.h>
 #include <memory>
+#include <span>
 
 class DirectXCommon;
 class SpriteCommon;
@@ -37,6 +43,9 @@ public:
     // カメラを使用するUpdateメソッド
     void Update();
 
+    // 行列だけを現在のカメラで計算し直す（アニメーション評価後にカメラを動かしたとき用）
+    void UpdateTransformationMatrix();
+
     // 座標の設定
     void SetPosition(const Vector3& position) { transform_.translate = position; }
     const Vector3& GetPosition() const { return transform_.translate; }
@@ -80,6 +89,8 @@ public:
     const Matrix4x4& GetAnimationMatrix() const { return animationMatrix_; }
     
     // スキニング関連メソッド
+    // ポーズの評価からパレットの書き込みまでを行う（AnimationSystemからワーカースレッドで呼ばれる）
+    void UpdateAnimation();
     void SkeletonUpdate(Skeleton& skeleton);
     void ApplyAnimation(Skeleton& skeleton, const Animation& animation, float animationTime);
     void SkinClusterUpdate(SkinCluster& skinCluster, const Skeleton& skeleton);
@@ -93,7 +104,60 @@ public:
     float GetAnimationTime() const;
     void SetAnimationTime(float time);
 
+    // AnimationSystemに今フレームの評価を登録済みか
+    bool IsAnimationSubmitted() const { return animationSubmitted_; }
+    void SetAnimationSubmitted(bool submitted) { animationSubmitted_ = submitted; }
+
+    // アニメーションの更新頻度LOD（AnimationSystemが評価するフレームを決める）
+    AnimationLodState& GetAnimationLod() { return animationLod_; }
+
+    // ポーズキャッシュのキー（ポーズが1つのクリップのサンプリングそのものでなければfalse）
+    bool GetSharablePose(const CompiledAnimationClip*& outClip, float& outTime, uint64_t& outSkinHash) const;
+    // 今フレームのポーズの共有元を設定（sharePaletteならパレットも共有して評価を省く。nullptrで自分で評価）
+    // パレットを共有したフレームはスケルトンを更新しない
+    // パレットを共有する場合は共有元に登録し、共有元が先に破棄されたら自分のバッファに戻す
+    void SetAnimationShareSource(Object3d* source, bool sharePalette);
+
+    // 最後に評価したパレットでスキニングした頂点のモデル空間の範囲（スケルトンがなければ空）
+    // ジョイントごとの範囲から求めるため頂点数によらず安く、コリジョンと更新頻度LODの視錐台判定に使う
+    const SkinnedBounds& GetSkinnedBounds() const { return skinnedBounds_; }
+
+    // 足のIK（地面の高さに合わせて脚を曲げる）。脚ごとに太もも・ひざ・足首のジョイント名を指定する
+    // AnimationSystemが評価する全インスタンスの足元へのレイをまとめてレイキャストし、結果の高さで解く
+    // 有効な間はポーズがインスタンスごとに変わるため、ポーズキャッシュと焼き込み済みの表は使わない
+    bool AddFootIkLeg(const std::string& upperName, const std::string& middleName, const std::string& endName);
+    void ClearFootIk();
+    void SetFootIkEnabled(bool enabled) { footIkEnabled_ = enabled; }
+    bool IsFootIkEnabled() const { return footIkEnabled_ && footIkRig_.GetLegCount() > 0; }
+    FootIkRig& GetFootIkRig() { return footIkRig_; }
+
+    // 前回評価したスケルトンの足首の真上からのレイの始点（ワールド空間。脚の数だけ書き込む）
+    void BuildFootIkRays(std::span<Vector3> outOrigins) const;
+    // 脚ごとの地面の高さ（当たらなければNaN）。次のUpdateAnimationで使う
+    void SetFootIkGroundHeights(std::span<const float> heights);
+
+    // 注視（jointNameのジョイントのローカルのaimAxisをワールドの目標に向ける。maxAngleはラジアン）
+    bool EnableLookAt(const std::string& jointName, const Vector3& aimAxis, float maxAngle);
+    void DisableLookAt() { lookAtSolver_ = {}; }
+    void SetLookAtTarget(const Vector3& target, float weight = 1.0f) { lookAtTarget_ = target; lookAtWeight_ = weight; }
+
 private:
+    // ワールド行列（アニメーション行列を含まない）
+    Matrix4x4 CalculateWorldMatrix() const { return MakeAffineMatrix(transform_.scale, transform_.rotate, transform_.translate); }
+
+    // 評価したパレットの範囲からスキニング後の範囲を更新
+    void UpdateSkinnedBounds(const SkinnedBounds& paletteBounds);
+
+    // クリップから評価したポーズを適用したスケルトンを、値が変わるジョイントの部分木だけ更新
+    void UpdateAnimatedSkeleton(Skeleton& skeleton);
+
+    // 共有元への参照と登録を解除
+    void ReleaseAnimationShare();
+    // 自分のパレットバッファを借りているインスタンスの共有を解除（破棄とモデルの差し替えの前に呼ぶ）
+    void DetachPaletteBorrowers();
+    // 共有元が破棄されるときに呼ばれる（借りていたパレットを自分のバッファに書き込む）
+    void DetachAnimationShareSource();
+
     // モデル
     Model* model_;
 
@@ -136,8 +200,38 @@ private:
     // アニメーション行列
     Matrix4x4 animationMatrix_;
     
-    // スキニング関連
-    std::vector<Matrix4x4> skeletonPose_;
+    // ノード名で適用する場合のジョイント×チャンネルごとのキーフレーム探索位置
+    std::vector<KeyframeCursor> animationCursors_;
+
+    // ブレンドツリーの評価結果のポーズ（毎フレーム使い回す）
+    AnimationPose animationPose_;
+    // 値が変わるジョイントの部分木だけ計算し直すスケルトンの更新と、その印（クリップ・ルートモーション・IK）
+    IncrementalSkeletonUpdate skeletonUpdate_;
+    std::vector<uint8_t> animatedJoints_;
+    uint64_t animatedClipsHash_ = 0;
+    bool animationSubmitted_ = false;
+    // 更新頻度LODの状態と、評価したパレットの履歴
+    AnimationLodState animationLod_;
+    // ポーズキャッシュの共有元（AnimationSystemがフレームごとに設定）
+    Object3d* animationShareSource_ = nullptr;
+    bool animationSharePalette_ = false;
+    // 共有元のパレットバッファで描画する（今フレームのDrawまで有効。Updateと共有元の破棄で解除）
+    const SkinCluster* sharedSkinCluster_ = nullptr;
+    // 自分をパレットの共有元に設定しているインスタンス
+    std::vector<Object3d*> paletteBorrowers_;
+    // 自分のパレットバッファが最新でない（共有元のバッファで描画した後）
+    bool mappedPaletteStale_ = false;
+    // スキニング後の範囲（補間中の姿勢を含む）と、最新のパレットだけの範囲
+    SkinnedBounds skinnedBounds_;
+    SkinnedBounds paletteBounds_;
+    // 足のIKと、AnimationSystemが設定した脚ごとの地面の高さ
+    FootIkRig footIkRig_;
+    bool footIkEnabled_ = true;
+    std::vector<float> footIkGroundHeights_;
+    // 注視
+    LookAtIkSolver lookAtSolver_;
+    Vector3 lookAtTarget_ = { 0.0f, 0.0f, 0.0f };
+    float lookAtWeight_ = 0.0f;
     
 
     float animationTime_ = 0.0f;
@@ -16,6 +16,12 @@ SpriteCommon::~SpriteCommon() {
 	if (pbrSkinningPipelineState) {
 		pbrSkinningPipelineState.Reset();
 	}
+	if (dualQuaternionSkinningPipelineState) {
+		dualQuaternionSkinningPipelineState.Reset();
+	}
+	if (pbrDualQuaternionSkinningPipelineState) {
+		pbrDualQuaternionSkinningPipelineState.Reset();
+	}
 	if (rootSignature) {
 		rootSignature.Reset();
 	}
@@ -25,9 +31,11 @@ void SpriteCommon::Initialize(DirectXCommon* dxCommon)
 {
 	dxCommon_ = dxCommon;
 	GraphicsPipelineInitialize();
-	SkinningPipelineInitialize();
+	SkinningPipelineInitialize(L"Resources/shaders/SkinningObject3d.VS.hlsl", skinningPipelineState);
+	SkinningPipelineInitialize(L"Resources/shaders/SkinningObject3dDQ.VS.hlsl", dualQuaternionSkinningPipelineState);
 	PBRPipelineInitialize();
-	PBRSkinningPipelineInitialize();
+	PBRSkinningPipelineInitialize(L"Resources/shaders/PBRSkinningObject3d.VS.hlsl", pbrSkinningPipelineState);
+	PBRSkinningPipelineInitialize(L"Resources/shaders/PBRSkinningObject3dDQ.VS.hlsl", pbrDualQuaternionSkinningPipelineState);
 }
 
 
@@ -244,7 +252,7 @@ void SpriteCommon::GraphicsPipelineInitialize()
 	}
 }
 
-void SpriteCommon::SkinningPipelineInitialize()
+void SpriteCommon::SkinningPipelineInitialize(const wchar_t* vertexShaderPath, Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipelineState)
 {
 	// スキニング用のInputLayout
 	D3D12_INPUT_ELEMENT_DESC inputElementDescs[5] = {};
@@ -286,8 +294,8 @@ void SpriteCommon::SkinningPipelineInitialize()
 	rasterizerDesc.CullMode = D3D12_CULL_MODE_BACK;
 	rasterizerDesc.FillMode = D3D12_FILL_MODE_SOLID;
 	
-	// スキニング用シェーダーをコンパイル
-	IDxcBlob* vertexshaderBlob = dxCommon_->CompileShader(L"Resources/shaders/SkinningObject3d.VS.hlsl",
+	// スキニング用シェーダーをコンパイル（頂点シェーダーはパレットの形式ごとに切り替える）
+	IDxcBlob* vertexshaderBlob = dxCommon_->CompileShader(vertexShaderPath,
 		L"vs_6_0");
 	assert(vertexshaderBlob != nullptr);
 	IDxcBlob* pixelShaderBlob = dxCommon_->CompileShader(L"Resources/shaders/Object3D.PS.hlsl",
@@ -320,7 +328,7 @@ void SpriteCommon::SkinningPipelineInitialize()
 	
 	// スキニング用パイプラインステートを生成
 	HRESULT hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc,
-		IID_PPV_ARGS(&skinningPipelineState));
+		IID_PPV_ARGS(&pipelineState));
 	assert(SUCCEEDED(hr));
 	
 	// シェーダーBlobの解放
@@ -416,7 +424,7 @@ void SpriteCommon::PBRPipelineInitialize()
 	OutputDebugStringA("SpriteCommon::PBRPipelineInitialize - PBR pipeline created successfully\n");
 }
 
-void SpriteCommon::PBRSkinningPipelineInitialize()
+void SpriteCommon::PBRSkinningPipelineInitialize(const wchar_t* vertexShaderPath, Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipelineState)
 {
 	// PBRスキニング用のInputLayout（スキニング + PBR）
 	D3D12_INPUT_ELEMENT_DESC inputElementDescs[5] = {};
@@ -459,7 +467,7 @@ void SpriteCommon::PBRSkinningPipelineInitialize()
 	rasterizerDesc.FillMode = D3D12_FILL_MODE_SOLID;
 	
 	// PBRスキニング用シェーダーをコンパイル（専用の頂点シェーダーとPBRピクセルシェーダー）
-	IDxcBlob* vertexshaderBlob = dxCommon_->CompileShader(L"Resources/shaders/PBRSkinningObject3d.VS.hlsl",
+	IDxcBlob* vertexshaderBlob = dxCommon_->CompileShader(vertexShaderPath,
 		L"vs_6_0");
 	assert(vertexshaderBlob != nullptr);
 	IDxcBlob* pixelShaderBlob = dxCommon_->CompileShader(L"Resources/shaders/PBRObject3d.PS.hlsl",
@@ -495,7 +503,7 @@ void SpriteCommon::PBRSkinningPipelineInitialize()
 	graphicsPipelineStateDesc.DepthStencilState = depthStencilDesc;
 	graphicsPipelineStateDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
 	//実際に生成
-	HRESULT hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&pbrSkinningPipelineState));
+	HRESULT hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc, IID_PPV_ARGS(&pipelineState));
 	assert(SUCCEEDED(hr));
 	
 	// シェーダーBlobの解放
@@ -34,6 +34,12 @@ public:
 	// PBRスキニングパイプラインを取得
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> GetPBRSkinningPipelineState() const { return pbrSkinningPipelineState; }
 
+	// デュアルクォータニオンスキニング用パイプラインを取得
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> GetDualQuaternionSkinningPipelineState() const { return dualQuaternionSkinningPipelineState; }
+
+	// PBRデュアルクォータニオンスキニング用パイプラインを取得
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> GetPBRDualQuaternionSkinningPipelineState() const { return pbrDualQuaternionSkinningPipelineState; }
+
 private:
 	// ルートシグネチャの作成
 	void RootSignatureInitialize();
@@ -41,14 +47,14 @@ private:
 	// グラフィックスパイプライン
 	void GraphicsPipelineInitialize();
 	
-	// スキニング用パイプライン
-	void SkinningPipelineInitialize();
+	// スキニング用パイプライン（頂点シェーダーで行列パレットとデュアルクォータニオンを切り替える）
+	void SkinningPipelineInitialize(const wchar_t* vertexShaderPath, Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipelineState);
 	
 	// PBR用パイプライン
 	void PBRPipelineInitialize();
 	
 	// PBRスキニング用パイプライン
-	void PBRSkinningPipelineInitialize();
+	void PBRSkinningPipelineInitialize(const wchar_t* vertexShaderPath, Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipelineState);
 
 private:
 	DirectXCommon* dxCommon_ = nullptr;
@@ -57,4 +63,6 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> skinningPipelineState = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> pbrPipelineState = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> pbrSkinningPipelineState = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> dualQuaternionSkinningPipelineState = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> pbrDualQuaternionSkinningPipelineState = nullptr;
 };
\ No newline at end of file
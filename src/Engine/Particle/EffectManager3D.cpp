@@ -1,48 +1,101 @@
 #include "EffectManager3D.h"
+#include "Particle3DManager.h"
 #include <algorithm>
+#include <cassert>
 #include <sstream>
 #include <random>
 #include <cmath>
 
+namespace {
+    // デバッグ表示用のタイプ名
+    const char* kEffectTypeNames[EffectManager3D::kEffectTypeCount] = {
+        "Normal", "Critical", "Impact", "Explosion", "Lightning"
+    };
+
+    // 無効なスロット
+    const uint32_t kInvalidSlot = UINT32_MAX;
+}
+
 void EffectManager3D::Initialize() {
+    Initialize(PoolConfig{});
+}
+
+void EffectManager3D::Initialize(const PoolConfig& config) {
+    config_ = config;
+    config_.maxCapacity = (std::max)(config_.maxCapacity, 1u);
+    config_.initialCapacity = (std::min)(config_.initialCapacity, config_.maxCapacity);
+    config_.growthStep = (std::max)(config_.growthStep, 1u);
+
+    // 全インスタンスで共有する3Dパーティクルグループを作成（effect.objを使用）
+    Particle3DManager::GetInstance()->CreateParticle3DGroup("HitEffect", "effect.obj");
+
     // エフェクトプールの初期化
-    hitEffectPool_.resize(POOL_SIZE);
-    
-    for (uint32_t i = 0; i < POOL_SIZE; ++i) {
-        hitEffectPool_[i] = std::make_unique<HitEffect3D>();
-        hitEffectPool_[i]->Initialize();
+    for (uint32_t i = 0; i < kEffectTypeCount; ++i) {
+        pools_[i] = EffectPool{};
+        pools_[i].slots.reserve(config_.maxCapacity);
+        pools_[i].freeList.reserve(config_.maxCapacity);
+        pools_[i].activeList.reserve(config_.maxCapacity);
+        GrowPool(static_cast<HitEffect3D::EffectType>(i), config_.initialCapacity);
+        // 初期確保は拡張回数に含めない
+        pools_[i].stats.growCount = 0;
     }
 
-    nextEffectIndex_ = 0;
+    nextSequence_ = 0;
 }
 
 void EffectManager3D::Finalize() {
     // すべてのエフェクトを停止
     StopAllEffects();
-    
+
     // エフェクトプールのクリア
-    hitEffectPool_.clear();
-    
-    nextEffectIndex_ = 0;
+    for (auto& pool : pools_) {
+        pool = EffectPool{};
+    }
+
+    nextSequence_ = 0;
 }
 
 void EffectManager3D::Update() {
-    // 全エフェクトの更新
-    for (auto& effect : hitEffectPool_) {
-        if (effect) {
+    // 再生中のエフェクトのみ更新し、終了したものは空きリストに戻す
+    for (auto& pool : pools_) {
+        for (size_t i = 0; i < pool.activeList.size(); ) {
+            uint32_t slotIndex = pool.activeList[i];
+            HitEffect3D* effect = pool.slots[slotIndex].effect.get();
             effect->Update();
+
+            if (!effect->IsPlaying()) {
+                // 末尾と入れ替えて削除するため、同じ位置をもう一度見る
+                ReleaseSlot(pool, slotIndex);
+                continue;
+            }
+            ++i;
         }
     }
 }
 
-void EffectManager3D::TriggerHitEffect(const Vector3& position, HitEffect3D::EffectType type) {
+void EffectManager3D::Prewarm(HitEffect3D::EffectType type, uint32_t count) {
+    uint32_t typeIndex = static_cast<uint32_t>(type);
+    if (typeIndex >= kEffectTypeCount) {
+        return;
+    }
+
+    EffectPool& pool = pools_[typeIndex];
+    uint32_t capacity = static_cast<uint32_t>(pool.slots.size());
+    if (count > capacity) {
+        GrowPool(type, count - capacity);
+    }
+}
+
+bool EffectManager3D::TriggerHitEffect(const Vector3& position, HitEffect3D::EffectType type, int32_t priority) {
     // 使用可能なエフェクトを取得
-    HitEffect3D* effect = GetAvailableEffect();
-    
-    if (effect) {
-        // エフェクトを発生
-        effect->TriggerHitEffect(position, type);
+    uint32_t slotIndex = AcquireSlot(type, priority);
+    if (slotIndex == kInvalidSlot) {
+        return false;
     }
+
+    // エフェクトを発生
+    pools_[static_cast<uint32_t>(type)].slots[slotIndex].effect->TriggerHitEffect(position, type);
+    return true;
 }
 
 void EffectManager3D::PlayNormalHit(const Vector3& position) {
@@ -66,16 +119,18 @@ void EffectManager3D::PlayLightningHit(const Vector3& position) {
 }
 
 void EffectManager3D::StopAllEffects() {
-    for (auto& effect : hitEffectPool_) {
-        if (effect) {
-            effect->Stop();
+    for (auto& pool : pools_) {
+        while (!pool.activeList.empty()) {
+            uint32_t slotIndex = pool.activeList.back();
+            pool.slots[slotIndex].effect->Stop();
+            ReleaseSlot(pool, slotIndex);
         }
     }
 }
 
 bool EffectManager3D::IsAnyEffectPlaying() const {
-    for (const auto& effect : hitEffectPool_) {
-        if (effect && effect->IsPlaying()) {
+    for (const auto& pool : pools_) {
+        if (!pool.activeList.empty()) {
             return true;
         }
     }
@@ -84,52 +139,152 @@ bool EffectManager3D::IsAnyEffectPlaying() const {
 
 uint32_t EffectManager3D::GetActiveEffectCount() const {
     uint32_t count = 0;
-    for (const auto& effect : hitEffectPool_) {
-        if (effect && effect->IsPlaying()) {
-            count++;
-        }
+    for (const auto& pool : pools_) {
+        count += static_cast<uint32_t>(pool.activeList.size());
     }
     return count;
 }
 
+const EffectManager3D::PoolStats& EffectManager3D::GetPoolStats(HitEffect3D::EffectType type) const {
+    uint32_t typeIndex = static_cast<uint32_t>(type);
+    assert(typeIndex < kEffectTypeCount);
+    return pools_[typeIndex].stats;
+}
+
+void EffectManager3D::ResetPoolStats() {
+    for (auto& pool : pools_) {
+        PoolStats& stats = pool.stats;
+        stats.peakActive = stats.active;
+        stats.acquireCount = 0;
+        stats.growCount = 0;
+        stats.stealCount = 0;
+        stats.dropCount = 0;
+    }
+}
+
 std::string EffectManager3D::GetDebugInfo() const {
     std::ostringstream oss;
     oss << "EffectManager3D Debug Info:\n";
-    oss << "Pool Size: " << POOL_SIZE << "\n";
+    oss << "Pool Capacity: " << config_.initialCapacity << " -> " << config_.maxCapacity
+        << " (step " << config_.growthStep << ")\n";
     oss << "Active Effects: " << GetActiveEffectCount() << "\n";
-    oss << "Next Index: " << nextEffectIndex_ << "\n";
     oss << "Any Playing: " << (IsAnyEffectPlaying() ? "Yes" : "No") << "\n";
-    
-    // 各エフェクトの状態
-    for (uint32_t i = 0; i < hitEffectPool_.size(); ++i) {
-        if (hitEffectPool_[i]) {
-            oss << "Effect[" << i << "]: " 
-                << (hitEffectPool_[i]->IsPlaying() ? "Playing" : "Stopped") << "\n";
-        }
+
+    // 各タイプのプールの状態
+    for (uint32_t i = 0; i < kEffectTypeCount; ++i) {
+        const PoolStats& stats = pools_[i].stats;
+        oss << kEffectTypeNames[i] << ": "
+            << stats.active << "/" << stats.capacity
+            << " peak " << stats.peakActive
+            << " acquire " << stats.acquireCount
+            << " grow " << stats.growCount
+            << " steal " << stats.stealCount
+            << " drop " << stats.dropCount << "\n";
     }
-    
+
     return oss.str();
 }
 
-HitEffect3D* EffectManager3D::GetAvailableEffect() {
-    // まず停止中のエフェクトを探す
-    for (auto& effect : hitEffectPool_) {
-        if (effect && !effect->IsPlaying()) {
-            return effect.get();
+uint32_t EffectManager3D::GrowPool(HitEffect3D::EffectType type, uint32_t count) {
+    EffectPool& pool = pools_[static_cast<uint32_t>(type)];
+    uint32_t capacity = static_cast<uint32_t>(pool.slots.size());
+    uint32_t addCount = (std::min)(count, config_.maxCapacity - (std::min)(capacity, config_.maxCapacity));
+
+    for (uint32_t i = 0; i < addCount; ++i) {
+        // タイプ専用のエミッターのみを持つインスタンスを作成
+        EffectSlot slot;
+        slot.effect = std::make_unique<HitEffect3D>();
+        slot.effect->Initialize(type);
+        pool.slots.push_back(std::move(slot));
+        pool.freeList.push_back(capacity + i);
+    }
+
+    if (addCount > 0) {
+        pool.stats.capacity = static_cast<uint32_t>(pool.slots.size());
+        pool.stats.growCount++;
+    }
+    return addCount;
+}
+
+uint32_t EffectManager3D::AcquireSlot(HitEffect3D::EffectType type, int32_t priority) {
+    uint32_t typeIndex = static_cast<uint32_t>(type);
+    if (typeIndex >= kEffectTypeCount) {
+        return kInvalidSlot;  // 無効なタイプ
+    }
+
+    EffectPool& pool = pools_[typeIndex];
+
+    // 空きがなければ設定に従ってプールを拡張
+    if (pool.freeList.empty()) {
+        GrowPool(type, config_.growthStep);
+    }
+
+    // 空きスロットを取得
+    if (!pool.freeList.empty()) {
+        uint32_t slotIndex = pool.freeList.back();
+        pool.freeList.pop_back();
+        ActivateSlot(pool, slotIndex, priority);
+        pool.stats.acquireCount++;
+        return slotIndex;
+    }
+
+    // 拡張できない場合は優先度が最も低く、最も古いエフェクトを奪う
+    uint32_t victim = kInvalidSlot;
+    for (uint32_t slotIndex : pool.activeList) {
+        const EffectSlot& slot = pool.slots[slotIndex];
+        if (victim == kInvalidSlot) {
+            victim = slotIndex;
+            continue;
+        }
+        const EffectSlot& best = pool.slots[victim];
+        if (slot.priority < best.priority ||
+            (slot.priority == best.priority && slot.sequence < best.sequence)) {
+            victim = slotIndex;
         }
     }
 
-    // 停止中のエフェクトがない場合は、ラウンドロビン方式で選択
-    HitEffect3D* effect = hitEffectPool_[nextEffectIndex_].get();
-    
-    // 既に再生中の場合は強制停止
-    if (effect && effect->IsPlaying()) {
-        effect->Stop();
+    // 自分より優先度の高いエフェクトしかない場合は見送る
+    if (victim == kInvalidSlot || pool.slots[victim].priority > priority) {
+        pool.stats.dropCount++;
+        return kInvalidSlot;
     }
 
-    // 次のインデックスに進める（循環）
-    nextEffectIndex_ = (nextEffectIndex_ + 1) % POOL_SIZE;
+    // 再生中のエフェクトを停止して再利用
+    EffectSlot& slot = pool.slots[victim];
+    slot.effect->Stop();
+    slot.sequence = nextSequence_++;
+    slot.priority = priority;
+    pool.stats.acquireCount++;
+    pool.stats.stealCount++;
+    return victim;
+}
+
+void EffectManager3D::ActivateSlot(EffectPool& pool, uint32_t slotIndex, int32_t priority) {
+    EffectSlot& slot = pool.slots[slotIndex];
+    slot.sequence = nextSequence_++;
+    slot.priority = priority;
+    slot.activeIndex = static_cast<uint32_t>(pool.activeList.size());
+    slot.active = true;
+    pool.activeList.push_back(slotIndex);
 
-    return effect;
+    pool.stats.active = static_cast<uint32_t>(pool.activeList.size());
+    pool.stats.peakActive = (std::max)(pool.stats.peakActive, pool.stats.active);
 }
 
+void EffectManager3D::ReleaseSlot(EffectPool& pool, uint32_t slotIndex) {
+    EffectSlot& slot = pool.slots[slotIndex];
+    if (!slot.active) {
+        return;
+    }
+
+    // 末尾の要素と入れ替えてO(1)で削除
+    uint32_t lastSlot = pool.activeList.back();
+    pool.activeList[slot.activeIndex] = lastSlot;
+    pool.slots[lastSlot].activeIndex = slot.activeIndex;
+    pool.activeList.pop_back();
+
+    slot.active = false;
+    pool.freeList.push_back(slotIndex);
+
+    pool.stats.active = static_cast<uint32_t>(pool.activeList.size());
+}
@@ -2,6 +2,7 @@
 
 #include "HitEffect3D.h"
 #include "Mymath.h"
+#include <array>
 #include <memory>
 #include <vector>
 #include <string>
@@ -18,6 +19,28 @@ private:
     // デストラクタ
     ~EffectManager3D() = default;
 
+public:
+    // エフェクトタイプ数
+    static const uint32_t kEffectTypeCount = static_cast<uint32_t>(HitEffect3D::EffectType::Lightning) + 1;
+
+    // プール設定（エフェクトタイプごとに適用）
+    struct PoolConfig {
+        uint32_t initialCapacity = 2;   // 初期化時に確保するインスタンス数
+        uint32_t maxCapacity = 16;      // 拡張できる最大インスタンス数
+        uint32_t growthStep = 2;        // 空きがない時に一度に追加するインスタンス数
+    };
+
+    // プール統計（プールの逼迫度の確認用）
+    struct PoolStats {
+        uint32_t capacity = 0;      // 確保済みインスタンス数
+        uint32_t active = 0;        // 再生中のインスタンス数
+        uint32_t peakActive = 0;    // 再生中インスタンス数の最大値
+        uint32_t acquireCount = 0;  // 取得回数
+        uint32_t growCount = 0;     // プール拡張回数
+        uint32_t stealCount = 0;    // 再生中のエフェクトを奪った回数
+        uint32_t dropCount = 0;     // 優先度不足で発生を見送った回数
+    };
+
 public:
     // シングルトンインスタンスの取得
     static EffectManager3D* GetInstance() {
@@ -27,16 +50,22 @@ public:
 
     // 初期化
     void Initialize();
-    
+    void Initialize(const PoolConfig& config);
+
     // 終了処理
     void Finalize();
 
     // 更新
     void Update();
 
-    // ヒットエフェクトの発生
-    void TriggerHitEffect(const Vector3& position, 
-                         HitEffect3D::EffectType type = HitEffect3D::EffectType::Normal);
+    // 指定タイプのインスタンスを事前に確保（シーン読み込み時に呼ぶ）
+    void Prewarm(HitEffect3D::EffectType type, uint32_t count);
+
+    // ヒットエフェクトの発生（priorityが高いほど奪われにくい）
+    // プールが満杯かつ自分より優先度の低い再生中エフェクトがない場合はfalse
+    bool TriggerHitEffect(const Vector3& position,
+                         HitEffect3D::EffectType type = HitEffect3D::EffectType::Normal,
+                         int32_t priority = 0);
 
     // 特定座標にエフェクト発生（簡単なインターフェース）
     void PlayNormalHit(const Vector3& position);
@@ -54,21 +83,56 @@ public:
     // アクティブなエフェクト数の取得
     uint32_t GetActiveEffectCount() const;
 
+    // プール設定の取得
+    const PoolConfig& GetPoolConfig() const { return config_; }
+
+    // プール統計の取得
+    const PoolStats& GetPoolStats(HitEffect3D::EffectType type) const;
+
+    // プール統計のリセット（容量・再生数以外）
+    void ResetPoolStats();
+
     // デバッグ情報の取得
     std::string GetDebugInfo() const;
 
     // 特別な雷撃エフェクトは削除し、通常のPlayLightningHitのみ使用
 
 private:
-    // ヒットエフェクトのプール
-    std::vector<std::unique_ptr<HitEffect3D>> hitEffectPool_;
-
-    // プールサイズ
-    static const uint32_t POOL_SIZE = 10;
-
-    // 次に使用するエフェクトのインデックス
-    uint32_t nextEffectIndex_ = 0;
-
-    // 使用可能なエフェクトを取得
-    HitEffect3D* GetAvailableEffect();
+    // プール内の1インスタンス
+    struct EffectSlot {
+        std::unique_ptr<HitEffect3D> effect;
+        uint64_t sequence = 0;      // 発生順（小さいほど古い）
+        int32_t priority = 0;       // 発生時の優先度
+        uint32_t activeIndex = 0;   // activeList内の位置
+        bool active = false;        // 再生中か
+    };
+
+    // エフェクトタイプごとのプール
+    struct EffectPool {
+        std::vector<EffectSlot> slots;
+        std::vector<uint32_t> freeList;     // 空きスロットのスタック
+        std::vector<uint32_t> activeList;   // 再生中スロットの一覧
+        PoolStats stats;
+    };
+
+    // プールを拡張（追加できた数を返す）
+    uint32_t GrowPool(HitEffect3D::EffectType type, uint32_t count);
+
+    // 使用可能なエフェクトを取得（取得できなければUINT32_MAX）
+    uint32_t AcquireSlot(HitEffect3D::EffectType type, int32_t priority);
+
+    // スロットを再生中にする
+    void ActivateSlot(EffectPool& pool, uint32_t slotIndex, int32_t priority);
+
+    // スロットを空きリストに戻す
+    void ReleaseSlot(EffectPool& pool, uint32_t slotIndex);
+
+    // プール設定
+    PoolConfig config_;
+
+    // ヒットエフェクトのプール（タイプごと）
+    std::array<EffectPool, kEffectTypeCount> pools_;
+
+    // 発生順カウンタ
+    uint64_t nextSequence_ = 0;
 };
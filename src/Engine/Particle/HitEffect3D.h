@@ -1,5 +1,6 @@
 #pragma once
 
+#include "HitEffectSettings.h"
 #include "Particle3DEmitter.h"
 #include "Mymath.h"
 #include <memory>
@@ -9,13 +10,7 @@
 class HitEffect3D {
 public:
     // エフェクトの種類
-    enum class EffectType {
-        Normal,     // 通常のヒット
-        Critical,   // クリティカルヒット
-        Impact,     // 衝撃
-        Explosion,  // 爆発
-        Lightning   // 雷撃
-    };
+    using EffectType = HitEffectType;
 
     // コンストラクタ
     HitEffect3D();
@@ -23,9 +18,12 @@ public:
     // デストラクタ
     ~HitEffect3D() = default;
 
-    // 初期化
+    // 初期化（全タイプのエミッターを作成）
     void Initialize();
 
+    // 初期化（指定タイプのエミッターのみ作成、プール用。"HitEffect"グループは呼び出し側で作成しておく）
+    void Initialize(EffectType type);
+
     // 更新
     void Update();
 
@@ -45,30 +43,14 @@ public:
 
 private:
     // エフェクト設定構造体
-    struct EffectSettings {
-        Vector3 velocityMin;
-        Vector3 velocityMax;
-        Vector3 accelMin;
-        Vector3 accelMax;
-        Vector3 startScaleMin;
-        Vector3 startScaleMax;
-        Vector3 endScaleMin;
-        Vector3 endScaleMax;
-        Vector4 startColorMin;
-        Vector4 startColorMax;
-        Vector4 endColorMin;
-        Vector4 endColorMax;
-        Vector3 rotationVelocityMin;
-        Vector3 rotationVelocityMax;
-        float lifeTimeMin;
-        float lifeTimeMax;
-        uint32_t particleCount;
-        float emitRate;
-    };
+    using EffectSettings = HitEffectSettings;
 
     // エフェクト設定の初期化
     void InitializeEffectSettings();
 
+    // 指定タイプのエミッターを作成
+    void CreateEmitter(EffectType type);
+
     // エミッター
     std::vector<std::unique_ptr<Particle3DEmitter>> emitters_;
 
@@ -0,0 +1,145 @@
+#include "HitEffectSettings.h"
+
+std::vector<HitEffectSettings> BuildHitEffectSettings() {
+    std::vector<HitEffectSettings> result(kHitEffectTypeCount);
+
+    // Normal（通常ヒット）
+    {
+        auto& settings = result[static_cast<size_t>(HitEffectType::Normal)];
+        settings.velocityMin = Vector3{-2.0f, -1.0f, -2.0f};
+        settings.velocityMax = Vector3{2.0f, 3.0f, 2.0f};
+        settings.accelMin = Vector3{0.0f, -9.8f, 0.0f};
+        settings.accelMax = Vector3{0.0f, -9.8f, 0.0f};
+        settings.startScaleMin = Vector3{0.1f, 0.1f, 0.1f};     // 小さく開始
+        settings.startScaleMax = Vector3{0.2f, 0.2f, 0.2f};     // 小さく開始
+        settings.endScaleMin = Vector3{0.3f, 0.3f, 0.3f};
+        settings.endScaleMax = Vector3{0.6f, 0.6f, 0.6f};
+        settings.startColorMin = Vector4{1.0f, 0.8f, 0.0f, 0.5f};  // 半透明から開始
+        settings.startColorMax = Vector4{1.0f, 1.0f, 0.2f, 0.5f};
+        settings.endColorMin = Vector4{1.0f, 0.3f, 0.0f, 0.0f};    // オレンジでフェードアウト
+        settings.endColorMax = Vector4{1.0f, 0.5f, 0.0f, 0.0f};
+        settings.rotationVelocityMin = Vector3{-3.14f, -3.14f, -3.14f};
+        settings.rotationVelocityMax = Vector3{3.14f, 3.14f, 3.14f};
+        settings.lifeTimeMin = 0.3f;
+        settings.lifeTimeMax = 0.8f;
+        settings.particleCount = 8;
+        settings.emitRate = 100.0f;  // バーストモード
+    }
+
+    // Critical（クリティカルヒット）
+    {
+        auto& settings = result[static_cast<size_t>(HitEffectType::Critical)];
+        settings.velocityMin = Vector3{-4.0f, -2.0f, -4.0f};
+        settings.velocityMax = Vector3{4.0f, 6.0f, 4.0f};
+        settings.accelMin = Vector3{0.0f, -12.0f, 0.0f};
+        settings.accelMax = Vector3{0.0f, -12.0f, 0.0f};
+        settings.startScaleMin = Vector3{0.5f, 0.5f, 0.5f};
+        settings.startScaleMax = Vector3{1.0f, 1.0f, 1.0f};
+        settings.endScaleMin = Vector3{0.1f, 0.1f, 0.1f};
+        settings.endScaleMax = Vector3{0.3f, 0.3f, 0.3f};
+        settings.startColorMin = Vector4{1.0f, 0.2f, 0.2f, 1.0f};  // 赤色
+        settings.startColorMax = Vector4{1.0f, 0.4f, 0.4f, 1.0f};
+        settings.endColorMin = Vector4{0.8f, 0.0f, 0.0f, 0.0f};    // 深い赤でフェードアウト
+        settings.endColorMax = Vector4{1.0f, 0.1f, 0.1f, 0.0f};
+        settings.rotationVelocityMin = Vector3{-6.28f, -6.28f, -6.28f};
+        settings.rotationVelocityMax = Vector3{6.28f, 6.28f, 6.28f};
+        settings.lifeTimeMin = 0.5f;
+        settings.lifeTimeMax = 1.2f;
+        settings.particleCount = 15;
+        settings.emitRate = 100.0f;  // バーストモード
+    }
+
+    // Impact（衝撃）
+    {
+        auto& settings = result[static_cast<size_t>(HitEffectType::Impact)];
+        settings.velocityMin = Vector3{-6.0f, -3.0f, -6.0f};
+        settings.velocityMax = Vector3{6.0f, 8.0f, 6.0f};
+        settings.accelMin = Vector3{0.0f, -15.0f, 0.0f};
+        settings.accelMax = Vector3{0.0f, -15.0f, 0.0f};
+        settings.startScaleMin = Vector3{0.4f, 0.4f, 0.4f};
+        settings.startScaleMax = Vector3{0.8f, 0.8f, 0.8f};
+        settings.endScaleMin = Vector3{0.2f, 0.2f, 0.2f};
+        settings.endScaleMax = Vector3{0.4f, 0.4f, 0.4f};
+        settings.startColorMin = Vector4{0.2f, 0.4f, 1.0f, 1.0f};  // 青色
+        settings.startColorMax = Vector4{0.4f, 0.6f, 1.0f, 1.0f};
+        settings.endColorMin = Vector4{0.0f, 0.2f, 0.8f, 0.0f};    // 深い青でフェードアウト
+        settings.endColorMax = Vector4{0.1f, 0.3f, 1.0f, 0.0f};
+        settings.rotationVelocityMin = Vector3{-9.42f, -9.42f, -9.42f};
+        settings.rotationVelocityMax = Vector3{9.42f, 9.42f, 9.42f};
+        settings.lifeTimeMin = 0.4f;
+        settings.lifeTimeMax = 1.0f;
+        settings.particleCount = 12;
+        settings.emitRate = 100.0f;  // バーストモード
+    }
+
+    // Explosion（爆発）
+    {
+        auto& settings = result[static_cast<size_t>(HitEffectType::Explosion)];
+        settings.velocityMin = Vector3{-8.0f, -4.0f, -8.0f};
+        settings.velocityMax = Vector3{8.0f, 10.0f, 8.0f};
+        settings.accelMin = Vector3{0.0f, -20.0f, 0.0f};
+        settings.accelMax = Vector3{0.0f, -20.0f, 0.0f};
+        settings.startScaleMin = Vector3{0.8f, 0.8f, 0.8f};
+        settings.startScaleMax = Vector3{1.5f, 1.5f, 1.5f};
+        settings.endScaleMin = Vector3{0.1f, 0.1f, 0.1f};
+        settings.endScaleMax = Vector3{0.5f, 0.5f, 0.5f};
+        settings.startColorMin = Vector4{1.0f, 0.5f, 0.0f, 1.0f};  // オレンジ色
+        settings.startColorMax = Vector4{1.0f, 0.7f, 0.2f, 1.0f};
+        settings.endColorMin = Vector4{0.5f, 0.0f, 0.0f, 0.0f};    // 暗い赤でフェードアウト
+        settings.endColorMax = Vector4{0.8f, 0.2f, 0.0f, 0.0f};
+        settings.rotationVelocityMin = Vector3{-12.56f, -12.56f, -12.56f};
+        settings.rotationVelocityMax = Vector3{12.56f, 12.56f, 12.56f};
+        settings.lifeTimeMin = 0.8f;
+        settings.lifeTimeMax = 1.8f;
+        settings.particleCount = 25;
+        settings.emitRate = 100.0f;  // バーストモード
+    }
+
+    // Lightning（雷撃）
+    {
+        auto& settings = result[static_cast<size_t>(HitEffectType::Lightning)];
+        settings.velocityMin = Vector3{-6.0f, 0.0f, -6.0f};     // 横方向の拡散
+        settings.velocityMax = Vector3{6.0f, 1.0f, 6.0f};       // ほぼ横に広がる
+        settings.accelMin = Vector3{0.0f, -1.0f, 0.0f};         // 軽い重力
+        settings.accelMax = Vector3{0.0f, -1.0f, 0.0f};
+        settings.startScaleMin = Vector3{0.001f, 0.001f, 0.001f};  // 完全に見えないサイズから
+        settings.startScaleMax = Vector3{0.001f, 0.001f, 0.001f};  // 完全に見えないサイズから
+        settings.endScaleMin = Vector3{0.2f, 2.0f, 0.2f};       // 細長い電撃に成長
+        settings.endScaleMax = Vector3{0.4f, 4.0f, 0.4f};       // 縦長の電撃に成長
+        settings.startColorMin = Vector4{1.0f, 1.0f, 1.0f, 0.0f};   // 完全に透明から
+        settings.startColorMax = Vector4{1.0f, 1.0f, 1.0f, 0.0f};   // 完全に透明から
+        settings.endColorMin = Vector4{0.6f, 0.8f, 1.0f, 0.8f};     // 青白い電撃色
+        settings.endColorMax = Vector4{0.8f, 0.9f, 1.0f, 1.0f};     // 明るい電撃色
+        settings.rotationVelocityMin = Vector3{-10.0f, -10.0f, -10.0f};
+        settings.rotationVelocityMax = Vector3{10.0f, 10.0f, 10.0f};
+        settings.lifeTimeMin = 0.15f; // 短めの寿命
+        settings.lifeTimeMax = 0.4f;
+        settings.particleCount = 12;  // パーティクル数を調整
+        settings.emitRate = 100.0f;   // バーストモード
+    }
+
+    return result;
+}
+
+Particle3DEmitParams MakeHitEffectEmitParams(const HitEffectSettings& settings) {
+    Particle3DEmitParams params;
+    params.velocityMin = settings.velocityMin;
+    params.velocityMax = settings.velocityMax;
+    params.accelMin = settings.accelMin;
+    params.accelMax = settings.accelMax;
+    params.startScaleMin = settings.startScaleMin;
+    params.startScaleMax = settings.startScaleMax;
+    params.endScaleMin = settings.endScaleMin;
+    params.endScaleMax = settings.endScaleMax;
+    params.startColorMin = settings.startColorMin;
+    params.startColorMax = settings.startColorMax;
+    params.endColorMin = settings.endColorMin;
+    params.endColorMax = settings.endColorMax;
+    params.rotationMin = Vector3{ 0.0f, 0.0f, 0.0f };
+    params.rotationMax = Vector3{ 0.0f, 0.0f, 0.0f };
+    params.rotationVelocityMin = settings.rotationVelocityMin;
+    params.rotationVelocityMax = settings.rotationVelocityMax;
+    params.lifeTimeMin = settings.lifeTimeMin;
+    params.lifeTimeMax = settings.lifeTimeMax;
+    return params;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Mymath.h"
+#include "Particle3DEmission.h"
+#include <cstdint>
+#include <vector>
+
+// ヒットエフェクトの種類
+enum class HitEffectType {
+    Normal,     // 通常のヒット
+    Critical,   // クリティカルヒット
+    Impact,     // 衝撃
+    Explosion,  // 爆発
+    Lightning   // 雷撃
+};
+
+const uint32_t kHitEffectTypeCount = static_cast<uint32_t>(HitEffectType::Lightning) + 1;
+
+// ヒットエフェクトの発生設定（各値は最小～最大の範囲で乱数決定）
+// DirectXに依存しないので、ベンチマークもゲームと同じ値で計測できる
+struct HitEffectSettings {
+    Vector3 velocityMin;
+    Vector3 velocityMax;
+    Vector3 accelMin;
+    Vector3 accelMax;
+    Vector3 startScaleMin;
+    Vector3 startScaleMax;
+    Vector3 endScaleMin;
+    Vector3 endScaleMax;
+    Vector4 startColorMin;
+    Vector4 startColorMax;
+    Vector4 endColorMin;
+    Vector4 endColorMax;
+    Vector3 rotationVelocityMin;
+    Vector3 rotationVelocityMax;
+    float lifeTimeMin;
+    float lifeTimeMax;
+    uint32_t particleCount;
+    float emitRate;
+};
+
+// 既定の設定を作る（HitEffectTypeの順にkHitEffectTypeCount個）
+std::vector<HitEffectSettings> BuildHitEffectSettings();
+
+// エミッターに渡す発生パラメータ（初期の回転は0）
+Particle3DEmitParams MakeHitEffectEmitParams(const HitEffectSettings& settings);
@@ -95,6 +95,21 @@ void Particle3DDemo::DrawImGui() {
             ImGui::Text("Active Effects: %u", activeCount);
             ImGui::Text("Any Playing: %s", anyPlaying ? "Yes" : "No");
 
+            // プールの逼迫度
+            if (ImGui::TreeNode("Pool Stats")) {
+                for (uint32_t i = 0; i < EffectManager3D::kEffectTypeCount; ++i) {
+                    const auto& stats = EffectManager3D::GetInstance()->GetPoolStats(
+                        static_cast<HitEffect3D::EffectType>(i));
+                    ImGui::Text("%-9s %u/%u peak:%u grow:%u steal:%u drop:%u",
+                        effectTypes[i], stats.active, stats.capacity, stats.peakActive,
+                        stats.growCount, stats.stealCount, stats.dropCount);
+                }
+                if (ImGui::Button("Reset Stats")) {
+                    EffectManager3D::GetInstance()->ResetPoolStats();
+                }
+                ImGui::TreePop();
+            }
+
             // 詳細デバッグ情報
             if (ImGui::TreeNode("Detailed Debug")) {
                 std::string debugInfo = EffectManager3D::GetInstance()->GetDebugInfo();
@@ -0,0 +1,142 @@
+#include "Particle3DEmission.h"
+#include <utility>
+
+namespace {
+    // 1フレームの時間の逆数（60FPS想定）
+    const float kFrameRate = 60.0f;
+
+    void SortMinMax(float& min, float& max) {
+        if (min > max) {
+            std::swap(min, max);
+        }
+    }
+
+    void SortMinMax(Vector3& min, Vector3& max) {
+        SortMinMax(min.x, max.x);
+        SortMinMax(min.y, max.y);
+        SortMinMax(min.z, max.z);
+    }
+
+    void SortMinMax(Vector4& min, Vector4& max) {
+        SortMinMax(min.x, max.x);
+        SortMinMax(min.y, max.y);
+        SortMinMax(min.z, max.z);
+        SortMinMax(min.w, max.w);
+    }
+
+    float RandomRange(float min, float max, std::mt19937& random) {
+        return std::uniform_real_distribution<float>(min, max)(random);
+    }
+
+    Vector3 RandomRange(const Vector3& min, const Vector3& max, std::mt19937& random) {
+        // 引数の評価順に依存しないように1成分ずつ引く
+        Vector3 result;
+        result.x = RandomRange(min.x, max.x, random);
+        result.y = RandomRange(min.y, max.y, random);
+        result.z = RandomRange(min.z, max.z, random);
+        return result;
+    }
+
+    Vector4 RandomRange(const Vector4& min, const Vector4& max, std::mt19937& random) {
+        Vector4 result;
+        result.x = RandomRange(min.x, max.x, random);
+        result.y = RandomRange(min.y, max.y, random);
+        result.z = RandomRange(min.z, max.z, random);
+        result.w = RandomRange(min.w, max.w, random);
+        return result;
+    }
+}
+
+void ValidateParticle3DEmitParams(Particle3DEmitParams& params) {
+    SortMinMax(params.velocityMin, params.velocityMax);
+    SortMinMax(params.accelMin, params.accelMax);
+    SortMinMax(params.startScaleMin, params.startScaleMax);
+    SortMinMax(params.endScaleMin, params.endScaleMax);
+    SortMinMax(params.startColorMin, params.startColorMax);
+    SortMinMax(params.endColorMin, params.endColorMax);
+    SortMinMax(params.rotationMin, params.rotationMax);
+    SortMinMax(params.rotationVelocityMin, params.rotationVelocityMax);
+    SortMinMax(params.lifeTimeMin, params.lifeTimeMax);
+}
+
+void EmitParticle3D(Particle3DState& particle, const Vector3& position, const Particle3DEmitParams& params, std::mt19937& random) {
+    particle.position = position;
+    particle.velocity = RandomRange(params.velocityMin, params.velocityMax, random);
+    particle.accel = RandomRange(params.accelMin, params.accelMax, random);
+
+    particle.startScale = RandomRange(params.startScaleMin, params.startScaleMax, random);
+    particle.endScale = RandomRange(params.endScaleMin, params.endScaleMax, random);
+    particle.scale = particle.startScale;
+
+    particle.startColor = RandomRange(params.startColorMin, params.startColorMax, random);
+    particle.endColor = RandomRange(params.endColorMin, params.endColorMax, random);
+    particle.color = particle.startColor;
+
+    particle.rotation = RandomRange(params.rotationMin, params.rotationMax, random);
+    particle.rotationVelocity = RandomRange(params.rotationVelocityMin, params.rotationVelocityMax, random);
+
+    particle.lifeTimeMax = RandomRange(params.lifeTimeMin, params.lifeTimeMax, random);
+    particle.lifeTime = 0.0f;
+}
+
+bool UpdateParticle3D(Particle3DState& particle) {
+    // 寿命チェック
+    particle.lifeTime += 1.0f / kFrameRate;
+    if (particle.lifeTime >= particle.lifeTimeMax) {
+        return false;
+    }
+
+    // 速度に加速度を加算
+    particle.velocity.x += particle.accel.x / kFrameRate;
+    particle.velocity.y += particle.accel.y / kFrameRate;
+    particle.velocity.z += particle.accel.z / kFrameRate;
+
+    // 位置に速度を加算
+    particle.position.x += particle.velocity.x / kFrameRate;
+    particle.position.y += particle.velocity.y / kFrameRate;
+    particle.position.z += particle.velocity.z / kFrameRate;
+
+    // 回転を更新
+    particle.rotation.x += particle.rotationVelocity.x / kFrameRate;
+    particle.rotation.y += particle.rotationVelocity.y / kFrameRate;
+    particle.rotation.z += particle.rotationVelocity.z / kFrameRate;
+
+    // 線形補間でスケールと色を更新
+    float t = particle.lifeTime / particle.lifeTimeMax;
+    particle.scale.x = (1.0f - t) * particle.startScale.x + t * particle.endScale.x;
+    particle.scale.y = (1.0f - t) * particle.startScale.y + t * particle.endScale.y;
+    particle.scale.z = (1.0f - t) * particle.startScale.z + t * particle.endScale.z;
+
+    particle.color.x = (1.0f - t) * particle.startColor.x + t * particle.endColor.x;
+    particle.color.y = (1.0f - t) * particle.startColor.y + t * particle.endColor.y;
+    particle.color.z = (1.0f - t) * particle.startColor.z + t * particle.endColor.z;
+    particle.color.w = (1.0f - t) * particle.startColor.w + t * particle.endColor.w;
+    return true;
+}
+
+bool Particle3DEmitTimer::Advance(float emitRate) {
+    // 発生フラグがOFFなら処理しない
+    if (!isEmitting_) {
+        return false;
+    }
+
+    currentTime_ += 1.0f / kFrameRate;
+
+    // 高い発生頻度（100.0f以上）の場合はバーストモード：一度だけ発生して止まる
+    if (emitRate >= 100.0f) {
+        if (burstFired_) {
+            return false;
+        }
+        burstFired_ = true;
+        isEmitting_ = false;
+        return true;
+    }
+
+    // 通常モード：発生タイミングを超えていたら発生し、余剰分を残して経過時間を戻す
+    float interval = 1.0f / emitRate;
+    if (currentTime_ >= interval) {
+        currentTime_ -= interval;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Mymath.h"
+#include <cstdint>
+#include <random>
+
+// 3Dパーティクル（モデルを1粒ずつ描くパーティクル）の発生と更新
+// 描画用のObject3dから切り離してあるので、Particle3DManager・Particle3DEmitterとベンチマークで同じ処理を使う
+
+// 3Dパーティクルの発生パラメータ（各値は最小～最大の範囲で乱数決定）
+struct Particle3DEmitParams {
+    Vector3 velocityMin = { -1.0f, -1.0f, -1.0f };
+    Vector3 velocityMax = { 1.0f, 1.0f, 1.0f };
+    Vector3 accelMin = { 0.0f, 0.0f, 0.0f };
+    Vector3 accelMax = { 0.0f, -9.8f, 0.0f };
+    Vector3 startScaleMin = { 0.5f, 0.5f, 0.5f };
+    Vector3 startScaleMax = { 1.0f, 1.0f, 1.0f };
+    Vector3 endScaleMin = { 0.0f, 0.0f, 0.0f };
+    Vector3 endScaleMax = { 0.0f, 0.0f, 0.0f };
+    Vector4 startColorMin = { 1.0f, 1.0f, 1.0f, 1.0f };
+    Vector4 startColorMax = { 1.0f, 1.0f, 1.0f, 1.0f };
+    Vector4 endColorMin = { 1.0f, 1.0f, 1.0f, 0.0f };
+    Vector4 endColorMax = { 1.0f, 1.0f, 1.0f, 0.0f };
+    Vector3 rotationMin = { 0.0f, 0.0f, 0.0f };
+    Vector3 rotationMax = { 0.0f, 0.0f, 0.0f };
+    Vector3 rotationVelocityMin = { 0.0f, 0.0f, 0.0f };
+    Vector3 rotationVelocityMax = { 0.0f, 0.0f, 0.0f };
+    float lifeTimeMin = 1.0f;
+    float lifeTimeMax = 3.0f;
+};
+
+// 3Dパーティクル1粒の状態
+struct Particle3DState {
+    // 座標
+    Vector3 position;
+    // 速度
+    Vector3 velocity;
+    // 加速度
+    Vector3 accel;
+    // 回転
+    Vector3 rotation;
+    // 回転速度
+    Vector3 rotationVelocity;
+    // スケール
+    Vector3 scale;
+    // 初期スケール
+    Vector3 startScale;
+    // 最終スケール
+    Vector3 endScale;
+    // 色
+    Vector4 color;
+    // 初期色
+    Vector4 startColor;
+    // 最終色
+    Vector4 endColor;
+    // 経過時間
+    float lifeTime;
+    // 寿命
+    float lifeTimeMax;
+};
+
+// 最小と最大が逆になっている要素を入れ替える
+void ValidateParticle3DEmitParams(Particle3DEmitParams& params);
+
+// 1粒を発生させる（paramsはValidateParticle3DEmitParams済みのもの）
+void EmitParticle3D(Particle3DState& particle, const Vector3& position, const Particle3DEmitParams& params, std::mt19937& random);
+
+// 1粒を1フレーム分（60FPS想定）更新する。寿命が尽きたらfalseを返す（呼び出し側で削除する）
+bool UpdateParticle3D(Particle3DState& particle);
+
+// エミッターの発生タイミング
+// emitRate（秒間の発生回数）が100以上ならバースト：開始後の最初のフレームで1回だけ発生して止まる
+class Particle3DEmitTimer {
+public:
+    // 発生の開始・停止（開始時は経過時間とバーストの状態を戻す）
+    void SetEmitting(bool isEmitting) {
+        isEmitting_ = isEmitting;
+        if (isEmitting) {
+            currentTime_ = 0.0f;
+            burstFired_ = false;
+        }
+    }
+    bool IsEmitting() const { return isEmitting_; }
+
+    // 1フレーム分（60FPS想定）時間を進め、このフレームで発生させるならtrueを返す
+    bool Advance(float emitRate);
+
+private:
+    bool isEmitting_ = true;
+    bool burstFired_ = false;
+    float currentTime_ = 0.0f;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Particle3DEmission.h"
 #include "Particle3DManager.h"
 #include "Mymath.h"
 #include "Mymath.h"
@@ -34,24 +35,21 @@ public:
         float lifeTimeMax = 3.0f
     );
 
+    // コンストラクタ（発生パラメータをまとめて渡す）
+    Particle3DEmitter(const std::string& name, const Vector3& position, uint32_t emitCount, float emitRate,
+        const Particle3DEmitParams& params);
+
     // デストラクタ
     ~Particle3DEmitter() = default;
 
     // 更新
     void Update();
 
-    // 発生フラグ設定
-    void SetEmitting(bool isEmitting) { 
-        isEmitting_ = isEmitting;
-        if (isEmitting) {
-            // 発生開始時にタイマーをリセット
-            currentTime_ = 0.0f;
-            burstFired_ = false; // バーストフラグをリセット
-        }
-    }
+    // 発生フラグ設定（発生開始時にタイマーとバーストフラグをリセット）
+    void SetEmitting(bool isEmitting) { timer_.SetEmitting(isEmitting); }
 
     // 発生フラグ取得
-    bool IsEmitting() const { return isEmitting_; }
+    bool IsEmitting() const { return timer_.IsEmitting(); }
 
     // 座標設定
     void SetPosition(const Vector3& position) { transform_.translate = position; }
@@ -75,18 +73,12 @@ private:
     // パーティクルグループ名
     std::string name_;
 
-    // 発生フラグ
-    bool isEmitting_ = true;
-
-    // バーストフラグ（一度だけ発生するため）
-    bool burstFired_ = false;
+    // 発生タイミング（発生フラグ・経過時間・バーストフラグ）
+    Particle3DEmitTimer timer_;
 
     // 座標・回転・スケール
     Transform transform_;
 
-    // 経過時間
-    float currentTime_ = 0.0f;
-
     // 発生するパーティクル数
     uint32_t emitCount_;
 
@@ -94,22 +86,5 @@ private:
     float emitRate_;
 
     // パーティクル設定
-    Vector3 velocityMin_;
-    Vector3 velocityMax_;
-    Vector3 accelMin_;
-    Vector3 accelMax_;
-    Vector3 startScaleMin_;
-    Vector3 startScaleMax_;
-    Vector3 endScaleMin_;
-    Vector3 endScaleMax_;
-    Vector4 startColorMin_;
-    Vector4 startColorMax_;
-    Vector4 endColorMin_;
-    Vector4 endColorMax_;
-    Vector3 rotationMin_;
-    Vector3 rotationMax_;
-    Vector3 rotationVelocityMin_;
-    Vector3 rotationVelocityMax_;
-    float lifeTimeMin_;
-    float lifeTimeMax_;
+    Particle3DEmitParams params_;
 };
@@ -77,9 +77,8 @@ void Particle3DManager::Update(const Camera* camera) {
     for (auto& [name, group] : particle3DGroups) {
         // 各パーティクルの更新
         for (auto it = group.particles.begin(); it != group.particles.end(); ) {
-            // 寿命チェック
-            it->lifeTime += 1.0f / 60.0f; // 60FPS想定
-            if (it->lifeTime >= it->lifeTimeMax) {
+            // 寿命・位置・回転・スケール・色の更新
+            if (!UpdateParticle3D(*it)) {
                 // 寿命が尽きたら削除
                 it = group.particles.erase(it);
                 continue;
@@ -89,36 +88,6 @@ void Particle3DManager::Update(const Camera* camera) {
             if (it->isDead) {
                 it->isDead = false;
             }
-            
-            // パーティクルの更新
-            // 速度に加速度を加算
-            it->velocity.x += it->accel.x / 60.0f;
-            it->velocity.y += it->accel.y / 60.0f;
-            it->velocity.z += it->accel.z / 60.0f;
-
-            // 位置に速度を加算
-            it->position.x += it->velocity.x / 60.0f;
-            it->position.y += it->velocity.y / 60.0f;
-            it->position.z += it->velocity.z / 60.0f;
-
-            // 回転を更新
-            it->rotation.x += it->rotationVelocity.x / 60.0f;
-            it->rotation.y += it->rotationVelocity.y / 60.0f;
-            it->rotation.z += it->rotationVelocity.z / 60.0f;
-
-            // 線形補間でスケールと色を更新
-            float t = it->lifeTime / it->lifeTimeMax;
-            
-            // スケールの補間
-            it->scale.x = (1.0f - t) * it->startScale.x + t * it->endScale.x;
-            it->scale.y = (1.0f - t) * it->startScale.y + t * it->endScale.y;
-            it->scale.z = (1.0f - t) * it->startScale.z + t * it->endScale.z;
-
-            // 色の補間
-            it->color.x = (1.0f - t) * it->startColor.x + t * it->endColor.x;
-            it->color.y = (1.0f - t) * it->startColor.y + t * it->endColor.y;
-            it->color.z = (1.0f - t) * it->startColor.z + t * it->endColor.z;
-            it->color.w = (1.0f - t) * it->startColor.w + t * it->endColor.w;
 
             // Object3Dの更新（カメラのビュープロジェクション行列を使用）
             if (it->object3d && camera) {
@@ -188,110 +157,36 @@ void Particle3DManager::Emit3D(
     float lifeTimeMin,
     float lifeTimeMax) {
 
+    Particle3DEmitParams params;
+    params.velocityMin = velocityMin;
+    params.velocityMax = velocityMax;
+    params.accelMin = accelMin;
+    params.accelMax = accelMax;
+    params.startScaleMin = startScaleMin;
+    params.startScaleMax = startScaleMax;
+    params.endScaleMin = endScaleMin;
+    params.endScaleMax = endScaleMax;
+    params.startColorMin = startColorMin;
+    params.startColorMax = startColorMax;
+    params.endColorMin = endColorMin;
+    params.endColorMax = endColorMax;
+    params.rotationMin = rotationMin;
+    params.rotationMax = rotationMax;
+    params.rotationVelocityMin = rotationVelocityMin;
+    params.rotationVelocityMax = rotationVelocityMax;
+    params.lifeTimeMin = lifeTimeMin;
+    params.lifeTimeMax = lifeTimeMax;
+    Emit3D(name, position, count, params);
+}
+
+void Particle3DManager::Emit3D(const std::string& name, const Vector3& position, uint32_t count, const Particle3DEmitParams& params) {
     // 指定された名前の3Dパーティクルグループが存在するか確認
     auto it = particle3DGroups.find(name);
     assert(it != particle3DGroups.end());
 
     // パラメータのバリデーション（最小値 <= 最大値であることを確認）
-    auto clampMinMax = [](float& min, float& max) {
-        if (min > max) {
-            std::swap(min, max);
-        }
-    };
-    
-    // ローカル変数でコピーしてバリデーション
-    Vector3 validVelocityMin = velocityMin;
-    Vector3 validVelocityMax = velocityMax;
-    Vector3 validAccelMin = accelMin;
-    Vector3 validAccelMax = accelMax;
-    Vector3 validStartScaleMin = startScaleMin;
-    Vector3 validStartScaleMax = startScaleMax;
-    Vector3 validEndScaleMin = endScaleMin;
-    Vector3 validEndScaleMax = endScaleMax;
-    Vector4 validStartColorMin = startColorMin;
-    Vector4 validStartColorMax = startColorMax;
-    Vector4 validEndColorMin = endColorMin;
-    Vector4 validEndColorMax = endColorMax;
-    Vector3 validRotationMin = rotationMin;
-    Vector3 validRotationMax = rotationMax;
-    Vector3 validRotationVelocityMin = rotationVelocityMin;
-    Vector3 validRotationVelocityMax = rotationVelocityMax;
-    float validLifeTimeMin = lifeTimeMin;
-    float validLifeTimeMax = lifeTimeMax;
-    
-    // バリデーションと修正
-    clampMinMax(validVelocityMin.x, validVelocityMax.x);
-    clampMinMax(validVelocityMin.y, validVelocityMax.y);
-    clampMinMax(validVelocityMin.z, validVelocityMax.z);
-    
-    clampMinMax(validAccelMin.x, validAccelMax.x);
-    clampMinMax(validAccelMin.y, validAccelMax.y);
-    clampMinMax(validAccelMin.z, validAccelMax.z);
-    
-    clampMinMax(validStartScaleMin.x, validStartScaleMax.x);
-    clampMinMax(validStartScaleMin.y, validStartScaleMax.y);
-    clampMinMax(validStartScaleMin.z, validStartScaleMax.z);
-    
-    clampMinMax(validEndScaleMin.x, validEndScaleMax.x);
-    clampMinMax(validEndScaleMin.y, validEndScaleMax.y);
-    clampMinMax(validEndScaleMin.z, validEndScaleMax.z);
-    
-    clampMinMax(validStartColorMin.x, validStartColorMax.x);
-    clampMinMax(validStartColorMin.y, validStartColorMax.y);
-    clampMinMax(validStartColorMin.z, validStartColorMax.z);
-    clampMinMax(validStartColorMin.w, validStartColorMax.w);
-    
-    clampMinMax(validEndColorMin.x, validEndColorMax.x);
-    clampMinMax(validEndColorMin.y, validEndColorMax.y);
-    clampMinMax(validEndColorMin.z, validEndColorMax.z);
-    clampMinMax(validEndColorMin.w, validEndColorMax.w);
-    
-    clampMinMax(validRotationMin.x, validRotationMax.x);
-    clampMinMax(validRotationMin.y, validRotationMax.y);
-    clampMinMax(validRotationMin.z, validRotationMax.z);
-    
-    clampMinMax(validRotationVelocityMin.x, validRotationVelocityMax.x);
-    clampMinMax(validRotationVelocityMin.y, validRotationVelocityMax.y);
-    clampMinMax(validRotationVelocityMin.z, validRotationVelocityMax.z);
-    
-    clampMinMax(validLifeTimeMin, validLifeTimeMax);
-
-    // 均等分布乱数生成器
-    std::uniform_real_distribution<float> velocityDistX(validVelocityMin.x, validVelocityMax.x);
-    std::uniform_real_distribution<float> velocityDistY(validVelocityMin.y, validVelocityMax.y);
-    std::uniform_real_distribution<float> velocityDistZ(validVelocityMin.z, validVelocityMax.z);
-
-    std::uniform_real_distribution<float> accelDistX(validAccelMin.x, validAccelMax.x);
-    std::uniform_real_distribution<float> accelDistY(validAccelMin.y, validAccelMax.y);
-    std::uniform_real_distribution<float> accelDistZ(validAccelMin.z, validAccelMax.z);
-
-    std::uniform_real_distribution<float> startScaleDistX(validStartScaleMin.x, validStartScaleMax.x);
-    std::uniform_real_distribution<float> startScaleDistY(validStartScaleMin.y, validStartScaleMax.y);
-    std::uniform_real_distribution<float> startScaleDistZ(validStartScaleMin.z, validStartScaleMax.z);
-
-    std::uniform_real_distribution<float> endScaleDistX(validEndScaleMin.x, validEndScaleMax.x);
-    std::uniform_real_distribution<float> endScaleDistY(validEndScaleMin.y, validEndScaleMax.y);
-    std::uniform_real_distribution<float> endScaleDistZ(validEndScaleMin.z, validEndScaleMax.z);
-
-    std::uniform_real_distribution<float> startColorDistR(validStartColorMin.x, validStartColorMax.x);
-    std::uniform_real_distribution<float> startColorDistG(validStartColorMin.y, validStartColorMax.y);
-    std::uniform_real_distribution<float> startColorDistB(validStartColorMin.z, validStartColorMax.z);
-    std::uniform_real_distribution<float> startColorDistA(validStartColorMin.w, validStartColorMax.w);
-
-    std::uniform_real_distribution<float> endColorDistR(validEndColorMin.x, validEndColorMax.x);
-    std::uniform_real_distribution<float> endColorDistG(validEndColorMin.y, validEndColorMax.y);
-    std::uniform_real_distribution<float> endColorDistB(validEndColorMin.z, validEndColorMax.z);
-    std::uniform_real_distribution<float> endColorDistA(validEndColorMin.w, validEndColorMax.w);
-
-    std::uniform_real_distribution<float> rotationDistX(validRotationMin.x, validRotationMax.x);
-    std::uniform_real_distribution<float> rotationDistY(validRotationMin.y, validRotationMax.y);
-    std::uniform_real_distribution<float> rotationDistZ(validRotationMin.z, validRotationMax.z);
-
-    std::uniform_real_distribution<float> rotationVelocityDistX(validRotationVelocityMin.x, validRotationVelocityMax.x);
-    std::uniform_real_distribution<float> rotationVelocityDistY(validRotationVelocityMin.y, validRotationVelocityMax.y);
-    std::uniform_real_distribution<float> rotationVelocityDistZ(validRotationVelocityMin.z, validRotationVelocityMax.z);
-
-    std::uniform_real_distribution<float> lifeTimeDist(validLifeTimeMin, validLifeTimeMax);
+    Particle3DEmitParams validParams = params;
+    ValidateParticle3DEmitParams(validParams);
 
     // 指定された数の3Dパーティクルを生成
     for (uint32_t i = 0; i < count; ++i) {
@@ -299,62 +194,9 @@ void Particle3DManager::Emit3D(
         it->second.particles.emplace_back();
         Particle3D& particle = it->second.particles.back();
 
-        // 座標
-        particle.position = position;
-
-        // 速度（ランダム）
-        particle.velocity.x = velocityDistX(randomEngine_);
-        particle.velocity.y = velocityDistY(randomEngine_);
-        particle.velocity.z = velocityDistZ(randomEngine_);
-
-        // 加速度（ランダム）
-        particle.accel.x = accelDistX(randomEngine_);
-        particle.accel.y = accelDistY(randomEngine_);
-        particle.accel.z = accelDistZ(randomEngine_);
-
-        // スケール（ランダム）
-        particle.startScale.x = startScaleDistX(randomEngine_);
-        particle.startScale.y = startScaleDistY(randomEngine_);
-        particle.startScale.z = startScaleDistZ(randomEngine_);
-
-        particle.endScale.x = endScaleDistX(randomEngine_);
-        particle.endScale.y = endScaleDistY(randomEngine_);
-        particle.endScale.z = endScaleDistZ(randomEngine_);
-
-        // Lightningエフェクトの場合は極小スケールから開始
-        if (particle.startScale.x < 0.01f && particle.startScale.y < 0.01f && particle.startScale.z < 0.01f) {
-            particle.scale = particle.startScale;
-        } else {
-            // その他のエフェクトは通常のstartScale
-            particle.scale = particle.startScale;
-        }
-
-        // 色（ランダム）
-        particle.startColor.x = startColorDistR(randomEngine_);
-        particle.startColor.y = startColorDistG(randomEngine_);
-        particle.startColor.z = startColorDistB(randomEngine_);
-        particle.startColor.w = startColorDistA(randomEngine_);
-
-        particle.endColor.x = endColorDistR(randomEngine_);
-        particle.endColor.y = endColorDistG(randomEngine_);
-        particle.endColor.z = endColorDistB(randomEngine_);
-        particle.endColor.w = endColorDistA(randomEngine_);
-
-        particle.color = particle.startColor;
-
-        // 回転（ランダム）
-        particle.rotation.x = rotationDistX(randomEngine_);
-        particle.rotation.y = rotationDistY(randomEngine_);
-        particle.rotation.z = rotationDistZ(randomEngine_);
-
-        particle.rotationVelocity.x = rotationVelocityDistX(randomEngine_);
-        particle.rotationVelocity.y = rotationVelocityDistY(randomEngine_);
-        particle.rotationVelocity.z = rotationVelocityDistZ(randomEngine_);
+        // 座標・速度・加速度・スケール・色・回転・寿命（ランダム）
+        EmitParticle3D(particle, position, validParams, randomEngine_);
 
-        // 寿命（ランダム）
-        particle.lifeTimeMax = lifeTimeDist(randomEngine_);
-        particle.lifeTime = 0.0f;
-        
         // 最初のフレームは描画しないフラグ（初期化完了まで非表示）
         particle.isDead = true;
 
@@ -12,38 +12,13 @@
 #include "Camera.h"
 #include "Model.h"
 #include "Object3d.h"
+#include "Particle3DEmission.h"
 
 // 前方宣言
 class SpriteCommon;
 
-// 3Dパーティクル1粒の情報
-struct Particle3D {
-    // 座標
-    Vector3 position;
-    // 速度
-    Vector3 velocity;
-    // 加速度
-    Vector3 accel;
-    // 回転
-    Vector3 rotation;
-    // 回転速度
-    Vector3 rotationVelocity;
-    // スケール
-    Vector3 scale;
-    // 初期スケール
-    Vector3 startScale;
-    // 最終スケール
-    Vector3 endScale;
-    // 色
-    Vector4 color;
-    // 初期色
-    Vector4 startColor;
-    // 最終色
-    Vector4 endColor;
-    // 経過時間
-    float lifeTime;
-    // 寿命
-    float lifeTimeMax;
+// 3Dパーティクル1粒の情報（状態はParticle3DStateで、描画用のObject3dを持つ）
+struct Particle3D : Particle3DState {
     // 生存フラグ
     bool isDead = false;
     // Object3D
@@ -58,38 +33,14 @@ struct Particle3D {
 
     // ムーブコンストラクタとムーブ代入演算子
     Particle3D(Particle3D&& other) noexcept
-        : position(other.position)
-        , velocity(other.velocity)
-        , accel(other.accel)
-        , rotation(other.rotation)
-        , rotationVelocity(other.rotationVelocity)
-        , scale(other.scale)
-        , startScale(other.startScale)
-        , endScale(other.endScale)
-        , color(other.color)
-        , startColor(other.startColor)
-        , endColor(other.endColor)
-        , lifeTime(other.lifeTime)
-        , lifeTimeMax(other.lifeTimeMax)
+        : Particle3DState(other)
         , isDead(other.isDead)
         , object3d(std::move(other.object3d)) {
     }
 
     Particle3D& operator=(Particle3D&& other) noexcept {
         if (this != &other) {
-            position = other.position;
-            velocity = other.velocity;
-            accel = other.accel;
-            rotation = other.rotation;
-            rotationVelocity = other.rotationVelocity;
-            scale = other.scale;
-            startScale = other.startScale;
-            endScale = other.endScale;
-            color = other.color;
-            startColor = other.startColor;
-            endColor = other.endColor;
-            lifeTime = other.lifeTime;
-            lifeTimeMax = other.lifeTimeMax;
+            Particle3DState::operator=(other);
             isDead = other.isDead;
             object3d = std::move(other.object3d);
         }
@@ -184,6 +135,9 @@ public:
         float lifeTimeMin = 1.0f,
         float lifeTimeMax = 3.0f);
 
+    // 3Dパーティクルの発生（パラメータをまとめて渡す）
+    void Emit3D(const std::string& name, const Vector3& position, uint32_t count, const Particle3DEmitParams& params);
+
     // デバッグ用：パーティクル数の取得
     uint32_t GetParticle3DCount(const std::string& name) {
         auto it = particle3DGroups.find(name);
@@ -0,0 +1,241 @@
+#include "ParticleForceField.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    // 負の値にも対応した剰余
+    int32_t WrapIndex(int32_t index, int32_t size) {
+        int32_t result = index % size;
+        return (result < 0) ? result + size : result;
+    }
+
+    // xorshift32（生成結果を実装に依存させないため）
+    float NextSignedRandom(uint32_t& state) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    }
+
+    // 線形補間（毎パーティクル呼ばれるため、検証付きのLerpを避ける）
+    inline Vector3 LerpFast(const Vector3& v1, const Vector3& v2, float t) {
+        return Vector3{
+            v1.x + t * (v2.x - v1.x),
+            v1.y + t * (v2.y - v1.y),
+            v1.z + t * (v2.z - v1.z) };
+    }
+
+    // ファイルから読み込むベクトル場の上限（壊れたファイルで巨大な確保をしないように）
+    const uint32_t kMaxFileGridSize = 256;                 // 1軸あたりの格子数
+    const size_t kMaxFileGridCells = 128 * 128 * 128 * 2;  // 格子数の合計（約50MB）
+    const size_t kMaxFileBytesPerCell = 3 * 32;            // 1格子の文字数の上限（3成分、区切りを含む）
+
+    // 3次エルミート補間の重み
+    float SmoothStep(float t) {
+        return t * t * (3.0f - 2.0f * t);
+    }
+}
+
+void ParticleVectorField::Initialize(uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ) {
+    sizeX_ = sizeX;
+    sizeY_ = sizeY;
+    sizeZ_ = sizeZ;
+    data_.assign(static_cast<size_t>(sizeX) * sizeY * sizeZ, Vector3{ 0.0f, 0.0f, 0.0f });
+    SetBounds(Vector3{ 0.0f, 0.0f, 0.0f },
+        Vector3{ static_cast<float>(sizeX), static_cast<float>(sizeY), static_cast<float>(sizeZ) });
+}
+
+void ParticleVectorField::SetBounds(const Vector3& boundsMin, const Vector3& boundsMax) {
+    boundsMin_ = boundsMin;
+    boundsMax_ = boundsMax;
+
+    // 格子点は範囲の両端を含むため、(size - 1)分割
+    auto scale = [](uint32_t size, float min, float max) {
+        float extent = max - min;
+        return (size > 1 && extent > 0.0f) ? static_cast<float>(size - 1) / extent : 0.0f;
+    };
+    worldToGrid_ = {
+        scale(sizeX_, boundsMin.x, boundsMax.x),
+        scale(sizeY_, boundsMin.y, boundsMax.y),
+        scale(sizeZ_, boundsMin.z, boundsMax.z) };
+}
+
+void ParticleVectorField::GenerateCurlNoise(uint32_t size, uint32_t latticeSize, uint32_t seed) {
+    assert(size > 0 && latticeSize > 0);
+    Initialize(size, size, size);
+
+    // ポテンシャル場用のランダムな格子（3成分、ループする）
+    const uint32_t latticeCount = latticeSize * latticeSize * latticeSize;
+    std::vector<Vector3> lattice(latticeCount);
+    uint32_t state = (seed != 0) ? seed : 0x9E3779B9u;
+    for (Vector3& value : lattice) {
+        value = { NextSignedRandom(state), NextSignedRandom(state), NextSignedRandom(state) };
+    }
+
+    auto latticeAt = [&](int32_t x, int32_t y, int32_t z) -> const Vector3& {
+        const int32_t n = static_cast<int32_t>(latticeSize);
+        return lattice[(WrapIndex(z, n) * n + WrapIndex(y, n)) * n + WrapIndex(x, n)];
+    };
+
+    // ポテンシャル場（格子を滑らかに補間、sizeで1周するのでタイル可能）
+    std::vector<Vector3> potential(data_.size());
+    const float cellsPerLattice = static_cast<float>(latticeSize) / static_cast<float>(size);
+    for (uint32_t z = 0; z < size; ++z) {
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                float u = x * cellsPerLattice;
+                float v = y * cellsPerLattice;
+                float w = z * cellsPerLattice;
+                int32_t x0 = static_cast<int32_t>(std::floor(u));
+                int32_t y0 = static_cast<int32_t>(std::floor(v));
+                int32_t z0 = static_cast<int32_t>(std::floor(w));
+                float tx = SmoothStep(u - x0);
+                float ty = SmoothStep(v - y0);
+                float tz = SmoothStep(w - z0);
+
+                Vector3 c00 = LerpFast(latticeAt(x0, y0, z0), latticeAt(x0 + 1, y0, z0), tx);
+                Vector3 c10 = LerpFast(latticeAt(x0, y0 + 1, z0), latticeAt(x0 + 1, y0 + 1, z0), tx);
+                Vector3 c01 = LerpFast(latticeAt(x0, y0, z0 + 1), latticeAt(x0 + 1, y0, z0 + 1), tx);
+                Vector3 c11 = LerpFast(latticeAt(x0, y0 + 1, z0 + 1), latticeAt(x0 + 1, y0 + 1, z0 + 1), tx);
+                potential[Index(x, y, z)] = LerpFast(LerpFast(c00, c10, ty), LerpFast(c01, c11, ty), tz);
+            }
+        }
+    }
+
+    // ポテンシャルの回転（curl）を中心差分で計算（発散がないため渦を巻く流れになる）
+    const int32_t n = static_cast<int32_t>(size);
+    auto potentialAt = [&](int32_t x, int32_t y, int32_t z) -> const Vector3& {
+        return potential[Index(WrapIndex(x, n), WrapIndex(y, n), WrapIndex(z, n))];
+    };
+    float maxLength = 0.0f;
+    for (int32_t z = 0; z < n; ++z) {
+        for (int32_t y = 0; y < n; ++y) {
+            for (int32_t x = 0; x < n; ++x) {
+                const Vector3 dx = potentialAt(x + 1, y, z) - potentialAt(x - 1, y, z);
+                const Vector3 dy = potentialAt(x, y + 1, z) - potentialAt(x, y - 1, z);
+                const Vector3 dz = potentialAt(x, y, z + 1) - potentialAt(x, y, z - 1);
+                Vector3 curl = {
+                    dy.z - dz.y,
+                    dz.x - dx.z,
+                    dx.y - dy.x };
+                data_[Index(x, y, z)] = curl;
+                maxLength = (std::max)(maxLength, std::sqrt(curl.x * curl.x + curl.y * curl.y + curl.z * curl.z));
+            }
+        }
+    }
+
+    // 最大の長さが1になるように正規化
+    if (maxLength > 0.0f) {
+        for (Vector3& value : data_) {
+            value *= 1.0f / maxLength;
+        }
+    }
+}
+
+bool ParticleVectorField::LoadFromFile(const std::string& filePath) {
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    // 上限の格子数で書ける大きさを超えるファイルは読まない
+    std::streamoff fileSize = file.tellg();
+    if (fileSize < 0 || static_cast<size_t>(fileSize) > kMaxFileGridCells * kMaxFileBytesPerCell) {
+        return false;
+    }
+    file.seekg(0);
+
+    // FGA形式: "nx,ny,nz," "minX,minY,minZ," "maxX,maxY,maxZ," 以降 "vx,vy,vz," がx→y→zの順に並ぶ
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+    std::replace(text.begin(), text.end(), ',', ' ');
+
+    const char* cursor = text.c_str();
+    auto next = [&cursor](float& value) {
+        char* end = nullptr;
+        value = std::strtof(cursor, &end);
+        if (end == cursor) {
+            return false;
+        }
+        cursor = end;
+        return true;
+    };
+
+    float header[9] = {};
+    for (float& value : header) {
+        if (!next(value)) {
+            return false;
+        }
+    }
+    // 格子数は1～kMaxFileGridSize（NaNも弾く）。合計が上限を超える場合も読まない
+    uint32_t size[3] = {};
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!(header[axis] >= 1.0f && header[axis] <= static_cast<float>(kMaxFileGridSize))) {
+            return false;
+        }
+        size[axis] = static_cast<uint32_t>(header[axis]);
+    }
+    if (static_cast<size_t>(size[0]) * size[1] * size[2] > kMaxFileGridCells) {
+        return false;
+    }
+
+    Initialize(size[0], size[1], size[2]);
+    for (Vector3& value : data_) {
+        if (!next(value.x) || !next(value.y) || !next(value.z)) {
+            data_.clear();
+            return false;
+        }
+    }
+    SetBounds(Vector3{ header[3], header[4], header[5] }, Vector3{ header[6], header[7], header[8] });
+    return true;
+}
+
+Vector3 ParticleVectorField::Sample(float gridX, float gridY, float gridZ, bool wrap) const {
+    if (data_.empty()) {
+        return Vector3{ 0.0f, 0.0f, 0.0f };
+    }
+
+    // 1軸分の2つの格子インデックスと補間係数を求める
+    auto axis = [wrap](float grid, uint32_t size, uint32_t& i0, uint32_t& i1, float& t) {
+        const int32_t n = static_cast<int32_t>(size);
+        if (!wrap) {
+            grid = (std::min)((std::max)(grid, 0.0f), static_cast<float>(n - 1));
+        }
+        float cell = std::floor(grid);
+        t = grid - cell;
+        int32_t index = static_cast<int32_t>(cell);
+        if (wrap) {
+            i0 = static_cast<uint32_t>(WrapIndex(index, n));
+            i1 = static_cast<uint32_t>(WrapIndex(index + 1, n));
+        } else {
+            i0 = static_cast<uint32_t>(index);
+            i1 = static_cast<uint32_t>((std::min)(index + 1, n - 1));
+        }
+    };
+
+    uint32_t x0, x1, y0, y1, z0, z1;
+    float tx, ty, tz;
+    axis(gridX, sizeX_, x0, x1, tx);
+    axis(gridY, sizeY_, y0, y1, ty);
+    axis(gridZ, sizeZ_, z0, z1, tz);
+
+    // トライリニア補間
+    const Vector3 c00 = LerpFast(At(x0, y0, z0), At(x1, y0, z0), tx);
+    const Vector3 c10 = LerpFast(At(x0, y1, z0), At(x1, y1, z0), tx);
+    const Vector3 c01 = LerpFast(At(x0, y0, z1), At(x1, y0, z1), tx);
+    const Vector3 c11 = LerpFast(At(x0, y1, z1), At(x1, y1, z1), tx);
+    return LerpFast(LerpFast(c00, c10, ty), LerpFast(c01, c11, ty), tz);
+}
+
+Vector3 ParticleVectorField::SampleWorld(const Vector3& position, bool wrap) const {
+    return Sample(
+        (position.x - boundsMin_.x) * worldToGrid_.x,
+        (position.y - boundsMin_.y) * worldToGrid_.y,
+        (position.z - boundsMin_.z) * worldToGrid_.z,
+        wrap);
+}
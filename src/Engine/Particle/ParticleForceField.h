@@ -0,0 +1,91 @@
+#pragma once
+
+#include "Mymath.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 3次元ベクトル場（格子状のベクトルをトライリニア補間で参照する）
+// カールノイズのボリュームや、外部ツールで焼いたベクトル場に使用する
+class ParticleVectorField {
+public:
+    // 指定サイズで初期化（全要素0）
+    void Initialize(uint32_t sizeX, uint32_t sizeY, uint32_t sizeZ);
+
+    // タイル可能なカールノイズのボリュームを生成
+    // latticeSizeは1タイル内のノイズ格子数（sizeの約数）
+    void GenerateCurlNoise(uint32_t size, uint32_t latticeSize, uint32_t seed);
+
+    // FGA形式（Fluid Grid ASCII）のベクトル場を読み込み（1軸256・合計約420万格子を超えるものは読まない）
+    bool LoadFromFile(const std::string& filePath);
+
+    // 格子座標でのトライリニア補間（wrapがtrueなら端でループ、falseなら端の値を使用）
+    Vector3 Sample(float gridX, float gridY, float gridZ, bool wrap) const;
+
+    // ワールド座標でのサンプリング（範囲はboundsMin～boundsMax）
+    Vector3 SampleWorld(const Vector3& position, bool wrap) const;
+
+    // 格子の値の取得・設定
+    const Vector3& At(uint32_t x, uint32_t y, uint32_t z) const { return data_[Index(x, y, z)]; }
+    void Set(uint32_t x, uint32_t y, uint32_t z, const Vector3& value) { data_[Index(x, y, z)] = value; }
+
+    // 範囲の設定・取得（ファイル読み込み時はファイルの値が設定される）
+    void SetBounds(const Vector3& boundsMin, const Vector3& boundsMax);
+    const Vector3& GetBoundsMin() const { return boundsMin_; }
+    const Vector3& GetBoundsMax() const { return boundsMax_; }
+
+    // 格子の値の配列（xが最も内側）とワールド座標から格子座標への変換係数（4パーティクルずつまとめて補間する場合に使用）
+    const Vector3* GetData() const { return data_.data(); }
+    const Vector3& GetWorldToGrid() const { return worldToGrid_; }
+
+    // サイズの取得
+    uint32_t GetSizeX() const { return sizeX_; }
+    uint32_t GetSizeY() const { return sizeY_; }
+    uint32_t GetSizeZ() const { return sizeZ_; }
+    bool IsEmpty() const { return data_.empty(); }
+
+private:
+    // 要素のインデックス（xが最も内側）
+    size_t Index(uint32_t x, uint32_t y, uint32_t z) const {
+        return (static_cast<size_t>(z) * sizeY_ + y) * sizeX_ + x;
+    }
+
+    uint32_t sizeX_ = 0;
+    uint32_t sizeY_ = 0;
+    uint32_t sizeZ_ = 0;
+    std::vector<Vector3> data_;
+
+    // ワールド座標での範囲と、ワールド座標から格子座標への変換係数
+    Vector3 boundsMin_ = { 0.0f, 0.0f, 0.0f };
+    Vector3 boundsMax_ = { 1.0f, 1.0f, 1.0f };
+    Vector3 worldToGrid_ = { 1.0f, 1.0f, 1.0f };
+};
+
+// パーティクルに働く力
+struct ParticleForceField {
+    // 力の種類
+    enum class Type {
+        GravityWell,    // 中心に引き寄せる（strengthが負なら反発）
+        Drag,           // 速度に比例した抵抗
+        Vortex,         // axis周りの渦
+        CurlNoise,      // タイル可能なカールノイズ（ボリュームをループして参照）
+        VectorField,    // 焼き込んだベクトル場（範囲外では働かない）
+    };
+
+    Type type = Type::GravityWell;
+    // 強さ（加速度の大きさ、Dragは1秒あたりの減衰率）
+    float strength = 1.0f;
+    // 中心座標（GravityWell、Vortex）
+    Vector3 position = { 0.0f, 0.0f, 0.0f };
+    // 渦の軸（Vortex、正規化済み）
+    Vector3 axis = { 0.0f, 1.0f, 0.0f };
+    // 影響半径（0以下なら無制限。GravityWell、Vortexは外側に向かって減衰）
+    float radius = 0.0f;
+    // ノイズの周波数（CurlNoise、1ワールド単位あたりの格子数）
+    float frequency = 1.0f;
+    // ノイズのスクロール速度（CurlNoise、格子単位/秒）
+    Vector3 scroll = { 0.0f, 0.0f, 0.0f };
+    // 参照するボリューム（CurlNoise、VectorField）
+    std::shared_ptr<const ParticleVectorField> volume;
+};
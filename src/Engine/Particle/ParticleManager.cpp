@@ -23,14 +23,7 @@ void ParticleManager::Finalize() {
 }
 
 ParticleManager::~ParticleManager() {
-    // 全パーティクルグループのリソース解放
-    for (auto& [name, group] : particleGroups) {
-        if (group.instanceResource && group.instanceData) {
-            group.instanceResource->Unmap(0, nullptr);
-            group.instanceData = nullptr;
-        }
-        group.instanceResource.Reset();
-    }
+    // 全パーティクルグループの解放
     particleGroups.clear();
 
     // その他のマップされたリソースの解放
@@ -50,6 +43,9 @@ ParticleManager::~ParticleManager() {
         vertexResource.Reset();
     }
 
+    // アップロードバッファの解放
+    uploadAllocator_.Finalize();
+
     // パイプラインステートとルートシグネチャの解放
     if (pipelineState) {
         pipelineState.Reset();
@@ -74,6 +70,10 @@ void ParticleManager::Initialize(DirectXCommon* dxCommon, SrvManager* srvManager
 
     // グラフィックスパイプラインの初期化
     InitializeGraphicsPipeline();
+    InitializeRibbonPipeline();
+
+    // インスタンシングデータ・リボン用のアップロードバッファ
+    uploadAllocator_.Initialize(dxCommon_, kUploadBufferSize, kUploadFrameCount);
 
     // 頂点データの作成（四角形ポリゴン）
     std::vector<VertexData> vertices = {
@@ -215,16 +215,10 @@ void ParticleManager::InitializeGraphicsPipeline() {
     rootParameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
     // インスタンシングデータ用（t0, VS）
-    D3D12_DESCRIPTOR_RANGE instanceRange{};
-    instanceRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
-    instanceRange.NumDescriptors = 1;
-    instanceRange.BaseShaderRegister = 0;
-    instanceRange.RegisterSpace = 0;
-    instanceRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
-    rootParameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    rootParameters[3].DescriptorTable.NumDescriptorRanges = 1;
-    rootParameters[3].DescriptorTable.pDescriptorRanges = &instanceRange;
+    // フレームごとにアップロードバッファ内の位置が変わるため、ディスクリプタを使わずアドレスを直接渡す
+    rootParameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    rootParameters[3].Descriptor.ShaderRegister = 0;
+    rootParameters[3].Descriptor.RegisterSpace = 0;
     rootParameters[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
 
     // サンプラーの設定
@@ -283,6 +277,141 @@ void ParticleManager::InitializeGraphicsPipeline() {
     assert(SUCCEEDED(hr));
 }
 
+void ParticleManager::InitializeRibbonPipeline() {
+    // ピクセルシェーダーはビルボードと共通
+    Microsoft::WRL::ComPtr<IDxcBlob> vsBlob = dxCommon_->CompileShader(
+        L"Resources/shaders/ParticleRibbon.VS.hlsl", L"vs_6_0");
+    Microsoft::WRL::ComPtr<IDxcBlob> psBlob = dxCommon_->CompileShader(
+        L"Resources/shaders/Particle.PS.hlsl", L"ps_6_0");
+
+    // 頂点レイアウト（RibbonVertexに合わせる）
+    D3D12_INPUT_ELEMENT_DESC inputElementDescs[3] = {};
+    inputElementDescs[0].SemanticName = "POSITION";
+    inputElementDescs[0].SemanticIndex = 0;
+    inputElementDescs[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+    inputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+    inputElementDescs[0].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+
+    inputElementDescs[1].SemanticName = "TEXCOORD";
+    inputElementDescs[1].SemanticIndex = 0;
+    inputElementDescs[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+    inputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+    inputElementDescs[1].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+
+    inputElementDescs[2].SemanticName = "COLOR";
+    inputElementDescs[2].SemanticIndex = 0;
+    inputElementDescs[2].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    inputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+    inputElementDescs[2].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+
+    D3D12_INPUT_LAYOUT_DESC inputLayoutDesc{};
+    inputLayoutDesc.pInputElementDescs = inputElementDescs;
+    inputLayoutDesc.NumElements = _countof(inputElementDescs);
+
+    // ブレンド設定（ビルボードと同じ加算合成）
+    D3D12_BLEND_DESC blendDesc{};
+    blendDesc.RenderTarget[0].BlendEnable = true;
+    blendDesc.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+    blendDesc.RenderTarget[0].DestBlend = D3D12_BLEND_ONE;
+    blendDesc.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+    blendDesc.RenderTarget[0].SrcBlendAlpha = D3D12_BLEND_ONE;
+    blendDesc.RenderTarget[0].DestBlendAlpha = D3D12_BLEND_ZERO;
+    blendDesc.RenderTarget[0].BlendOpAlpha = D3D12_BLEND_OP_ADD;
+    blendDesc.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+    // ラスタライザー設定（リボンは裏返るので両面描画）
+    D3D12_RASTERIZER_DESC rasterizerDesc{};
+    rasterizerDesc.CullMode = D3D12_CULL_MODE_NONE;
+    rasterizerDesc.FillMode = D3D12_FILL_MODE_SOLID;
+
+    // 深度設定
+    D3D12_DEPTH_STENCIL_DESC depthStencilDesc{};
+    depthStencilDesc.DepthEnable = false;
+
+    // ルートパラメータ（0～2はビルボードと共通、3は変換行列）
+    D3D12_ROOT_PARAMETER rootParameters[4] = {};
+
+    // マテリアル用（b0, PS）
+    rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    rootParameters[0].Descriptor.ShaderRegister = 0;
+    rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    // ディレクショナルライト用（b1, PS）
+    rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    rootParameters[1].Descriptor.ShaderRegister = 1;
+    rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    // テクスチャ用（t0, PS）
+    D3D12_DESCRIPTOR_RANGE textureRange{};
+    textureRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    textureRange.NumDescriptors = 1;
+    textureRange.BaseShaderRegister = 0;
+    textureRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+    rootParameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    rootParameters[2].DescriptorTable.NumDescriptorRanges = 1;
+    rootParameters[2].DescriptorTable.pDescriptorRanges = &textureRange;
+    rootParameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    // ビュープロジェクション行列用（b0, VS）
+    rootParameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    rootParameters[3].Descriptor.ShaderRegister = 0;
+    rootParameters[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+
+    // サンプラーの設定
+    D3D12_STATIC_SAMPLER_DESC staticSamplerDesc{};
+    staticSamplerDesc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+    staticSamplerDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    staticSamplerDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    staticSamplerDesc.AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+    staticSamplerDesc.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+    staticSamplerDesc.MaxLOD = D3D12_FLOAT32_MAX;
+    staticSamplerDesc.ShaderRegister = 0;
+    staticSamplerDesc.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+
+    // ルートシグネチャの設定
+    D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc{};
+    rootSignatureDesc.NumParameters = _countof(rootParameters);
+    rootSignatureDesc.pParameters = rootParameters;
+    rootSignatureDesc.NumStaticSamplers = 1;
+    rootSignatureDesc.pStaticSamplers = &staticSamplerDesc;
+    rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+    Microsoft::WRL::ComPtr<ID3DBlob> rootSignatureBlob;
+    Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+    HRESULT hr = D3D12SerializeRootSignature(
+        &rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0,
+        rootSignatureBlob.GetAddressOf(), errorBlob.GetAddressOf());
+    assert(SUCCEEDED(hr));
+
+    hr = dxCommon_->GetDevice()->CreateRootSignature(
+        0, rootSignatureBlob->GetBufferPointer(), rootSignatureBlob->GetBufferSize(),
+        IID_PPV_ARGS(ribbonRootSignature.GetAddressOf()));
+    assert(SUCCEEDED(hr));
+
+    // パイプラインステートの生成
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineDesc{};
+    pipelineDesc.InputLayout = inputLayoutDesc;
+    pipelineDesc.pRootSignature = ribbonRootSignature.Get();
+    pipelineDesc.VS.pShaderBytecode = vsBlob->GetBufferPointer();
+    pipelineDesc.VS.BytecodeLength = vsBlob->GetBufferSize();
+    pipelineDesc.PS.pShaderBytecode = psBlob->GetBufferPointer();
+    pipelineDesc.PS.BytecodeLength = psBlob->GetBufferSize();
+    pipelineDesc.BlendState = blendDesc;
+    pipelineDesc.RasterizerState = rasterizerDesc;
+    pipelineDesc.DepthStencilState = depthStencilDesc;
+    pipelineDesc.NumRenderTargets = 1;
+    pipelineDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    pipelineDesc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+    pipelineDesc.SampleDesc.Count = 1;
+    pipelineDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    pipelineDesc.SampleMask = 0xffffffff;
+
+    hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
+        &pipelineDesc, IID_PPV_ARGS(ribbonPipelineState.GetAddressOf()));
+    assert(SUCCEEDED(hr));
+}
+
 void ParticleManager::CreateParticleGroup(const std::string& name, const std::string& textureFilePath) {
     // 既に同名のグループが存在する場合は処理をスキップ
     if (particleGroups.find(name) != particleGroups.end()) {
@@ -301,23 +430,14 @@ void ParticleManager::CreateParticleGroup(const std::string& name, const std::st
     // テクスチャのSRVインデックスを取得
     group.textureSrvIndex = TextureManager::GetInstance()->GetSrvIndex(textureFilePath);
 
-    // インスタンシング用リソースの作成（最大10000パーティクル）
-    const uint32_t kMaxInstanceCount = 10000;
-    group.instanceResource = dxCommon_->CreateBufferResource(sizeof(ParticleForGPU) * kMaxInstanceCount);
-
-    // マップしてポインタを取得
-    group.instanceResource->Map(0, nullptr, reinterpret_cast<void**>(&group.instanceData));
-
-    // インスタンシング用SRVの作成
-    group.instanceSrvIndex = srvManager_->Allocate();
-    srvManager_->CreateSRVForStructuredBuffer(
-        group.instanceSrvIndex,
-        group.instanceResource,
-        kMaxInstanceCount,
-        sizeof(ParticleForGPU));
+    // インスタンシングデータは毎フレームアップロードバッファから確保する（Update参照）
 
     // パーティクルグループを登録
-    particleGroups[name] = group;
+    ParticleGroup& registered = particleGroups[name];
+    registered = group;
+
+    // シミュレーションの初期化（グループあたりの最大数）
+    registered.simulation.Initialize(kMaxInstanceCount, static_cast<uint32_t>(randomEngine_()));
 
     // 登録成功をデバッグ出力
     OutputDebugStringA(("ParticleManager: Created particle group - " + name + "\n").c_str());
@@ -355,77 +475,138 @@ void ParticleManager::Update(const Camera* camera) {
     Matrix4x4 projectionMatrix = camera->GetProjectionMatrix();
     Matrix4x4 viewProjectionMatrix = camera->GetViewProjectionMatrix();
 
+    // アップロードバッファを次のフレーム分に切り替え（GPUが読み終えていなければ待つ）
+    uploadAllocator_.BeginFrame();
+
+    // リボン用の変換行列を書き込む
+    ribbonTransformAddress_ = 0;
+    LinearUploadAllocator::Allocation transform = uploadAllocator_.Allocate(sizeof(Matrix4x4), 256);
+    if (transform.cpuAddress) {
+        std::memcpy(transform.cpuAddress, &viewProjectionMatrix, sizeof(Matrix4x4));
+        ribbonTransformAddress_ = transform.gpuAddress;
+    }
+
     // 全パーティクルグループの更新
     for (auto& [name, group] : particleGroups) {
         // インスタンス数をリセット
         group.instanceCount = 0;
+        group.instanceAddress = 0;
+        group.ribbonVertexCount = 0;
+
+        // シミュレーションの更新
+        ParticleSimulation& simulation = group.simulation;
+        simulation.Update(1.0f / 60.0f); // 60FPS想定
 
-        // 各パーティクルの更新
-        for (auto it = group.particles.begin(); it != group.particles.end(); ) {
-            // 寿命チェック
-            it->lifeTime += 1.0f / 60.0f; // 60FPS想定
-            if (it->lifeTime >= it->lifeTimeMax) {
-                // 寿命が尽きたら削除
-                it = group.particles.erase(it);
+        // リボンの生成（ビルボードを描かない場合はここで終了）
+        if (group.ribbonEnabled) {
+            BuildRibbon(group, camera->GetTranslate());
+            if (!group.ribbonSettings.drawBillboards) {
                 continue;
             }
+        }
 
-            // パーティクルの更新
-            // 速度に加速度を加算
-            it->velocity.x += it->accel.x / 60.0f;
-            it->velocity.y += it->accel.y / 60.0f;
-            it->velocity.z += it->accel.z / 60.0f;
-
-            // 位置に速度を加算
-            it->position.x += it->velocity.x / 60.0f;
-            it->position.y += it->velocity.y / 60.0f;
-            it->position.z += it->velocity.z / 60.0f;
-
-            // 回転を更新
-            it->rotation += it->rotationVelocity / 60.0f;
-
-            // 線形補間でサイズと色を更新
-            float t = it->lifeTime / it->lifeTimeMax;
-            it->size = (1.0f - t) * it->startSize + t * it->endSize;
-
-            it->color.x = (1.0f - t) * it->startColor.x + t * it->endColor.x;
-            it->color.y = (1.0f - t) * it->startColor.y + t * it->endColor.y;
-            it->color.z = (1.0f - t) * it->startColor.z + t * it->endColor.z;
-            it->color.w = (1.0f - t) * it->startColor.w + t * it->endColor.w;
+        const uint32_t count = simulation.GetCount();
+        if (count == 0) {
+            continue;
+        }
 
+        // 今フレームのインスタンシングデータを確保
+        // 足りなければアロケータが拡張する。nullptrはバッファを作れなかった場合のみ（アロケータがログを出す）
+        LinearUploadAllocator::Allocation instances = uploadAllocator_.Allocate(sizeof(ParticleForGPU) * count, 16);
+        if (!instances.cpuAddress) {
+            continue;
+        }
+        ParticleForGPU* instanceData = static_cast<ParticleForGPU*>(instances.cpuAddress);
+        group.instanceAddress = instances.gpuAddress;
+
+        const float* positionX = simulation.GetPositionX();
+        const float* positionY = simulation.GetPositionY();
+        const float* positionZ = simulation.GetPositionZ();
+        const float* size = simulation.GetSize();
+        const float* rotation = simulation.GetRotation();
+        const float* colorR = simulation.GetColorR();
+        const float* colorG = simulation.GetColorG();
+        const float* colorB = simulation.GetColorB();
+        const float* colorA = simulation.GetColorA();
+
+        // 各パーティクルのインスタンシングデータを作成
+        for (uint32_t i = 0; i < count; ++i) {
             // スケール、回転、座標を使用して行列を作成
-            Vector3 scale = { it->size, it->size, it->size };
-            Vector3 rotate = { 0.0f, 0.0f, it->rotation };
+            Vector3 scale = { size[i], size[i], size[i] };
 
             // ワールド行列を計算（ビルボード処理も含む）
             Matrix4x4 matScale = MakeScaleMatrix(scale);
-            Matrix4x4 matRotZ = MakeRotateZMatrix(rotate.z);
+            Matrix4x4 matRotZ = MakeRotateZMatrix(rotation[i]);
 
             // スケール -> 回転 -> ビルボード -> 平行移動
             Matrix4x4 matWorld = matScale;
             matWorld = Multiply(matWorld, matRotZ);
             matWorld = Multiply(matWorld, billboardMatrix);
-            matWorld.m[3][0] = it->position.x;
-            matWorld.m[3][1] = it->position.y;
-            matWorld.m[3][2] = it->position.z;
+            matWorld.m[3][0] = positionX[i];
+            matWorld.m[3][1] = positionY[i];
+            matWorld.m[3][2] = positionZ[i];
 
             // WVP行列を計算
             Matrix4x4 matWVP = Multiply(matWorld, viewProjectionMatrix);
 
-            // インスタンシングデータの書き込み（新しいシェーダー形式に合わせて）
-            group.instanceData[group.instanceCount].WVP = matWVP;
-            group.instanceData[group.instanceCount].World = matWorld;
-            group.instanceData[group.instanceCount].color = it->color;
+            // インスタンシングデータの書き込み
+            // 書き込み結合メモリなので、読み戻さずに1要素ずつ先頭から順に書き込む
+            ParticleForGPU instance;
+            instance.WVP = matWVP;
+            instance.World = matWorld;
+            instance.color = { colorR[i], colorG[i], colorB[i], colorA[i] };
+            instanceData[group.instanceCount] = instance;
 
             // インスタンス数をインクリメント
             group.instanceCount++;
-
-            // 次のパーティクルへ
-            ++it;
         }
     }
 }
 
+void ParticleManager::BuildRibbon(ParticleGroup& group, const Vector3& cameraPosition) {
+    if (ribbonTransformAddress_ == 0) {
+        return;
+    }
+
+    // 生きているリボンの頂点数を数えて、必要な分だけ確保する
+    uint32_t vertexCount = CountParticleRibbonVertices(group.simulation, group.ribbonSettings, cameraPosition);
+    if (vertexCount == 0) {
+        return;
+    }
+
+    LinearUploadAllocator::Allocation allocation = uploadAllocator_.Allocate(sizeof(RibbonVertex) * vertexCount, alignof(RibbonVertex));
+    if (!allocation.cpuAddress) {
+        return;
+    }
+
+    group.ribbonVertexCount = BuildParticleRibbons(
+        group.simulation, group.ribbonSettings, cameraPosition,
+        static_cast<RibbonVertex*>(allocation.cpuAddress), vertexCount);
+
+    group.ribbonVbView.BufferLocation = allocation.gpuAddress;
+    group.ribbonVbView.SizeInBytes = sizeof(RibbonVertex) * group.ribbonVertexCount;
+    group.ribbonVbView.StrideInBytes = sizeof(RibbonVertex);
+}
+
+void ParticleManager::EnableRibbon(const std::string& name, const ParticleRibbonSettings& settings) {
+    auto it = particleGroups.find(name);
+    assert(it != particleGroups.end());
+    assert(settings.historyLength >= 2);
+
+    it->second.ribbonEnabled = true;
+    it->second.ribbonSettings = settings;
+    it->second.simulation.EnableTrail(settings.historyLength);
+}
+
+void ParticleManager::DisableRibbon(const std::string& name) {
+    auto it = particleGroups.find(name);
+    if (it != particleGroups.end()) {
+        it->second.ribbonEnabled = false;
+        it->second.ribbonVertexCount = 0;
+        it->second.simulation.EnableTrail(0);
+    }
+}
+
 void ParticleManager::Emit(const std::string& name, const Vector3& position, uint32_t count) {
     // 詳細設定版のEmitを呼び出し
     Emit(
@@ -480,140 +661,53 @@ void ParticleManager::Emit(
     auto it = particleGroups.find(name);
     assert(it != particleGroups.end());
 
-    // パラメータのバリデーション（最小値 <= 最大値であることを確認）
-    auto clampMinMax = [](float& min, float& max) {
-        if (min > max) {
-            std::swap(min, max);
-        }
-    };
-    
-    // ローカル変数でコピーしてバリデーション
-    Vector3 validVelocityMin = velocityMin;
-    Vector3 validVelocityMax = velocityMax;
-    Vector3 validAccelMin = accelMin;
-    Vector3 validAccelMax = accelMax;
-    Vector4 validStartColorMin = startColorMin;
-    Vector4 validStartColorMax = startColorMax;
-    Vector4 validEndColorMin = endColorMin;
-    Vector4 validEndColorMax = endColorMax;
-    
-    float validStartSizeMin = startSizeMin;
-    float validStartSizeMax = startSizeMax;
-    float validEndSizeMin = endSizeMin;
-    float validEndSizeMax = endSizeMax;
-    float validRotationMin = rotationMin;
-    float validRotationMax = rotationMax;
-    float validRotationVelocityMin = rotationVelocityMin;
-    float validRotationVelocityMax = rotationVelocityMax;
-    float validLifeTimeMin = lifeTimeMin;
-    float validLifeTimeMax = lifeTimeMax;
-    
-    // バリデーションと修正
-    clampMinMax(validVelocityMin.x, validVelocityMax.x);
-    clampMinMax(validVelocityMin.y, validVelocityMax.y);
-    clampMinMax(validVelocityMin.z, validVelocityMax.z);
-    
-    clampMinMax(validAccelMin.x, validAccelMax.x);
-    clampMinMax(validAccelMin.y, validAccelMax.y);
-    clampMinMax(validAccelMin.z, validAccelMax.z);
-    
-    clampMinMax(validStartSizeMin, validStartSizeMax);
-    clampMinMax(validEndSizeMin, validEndSizeMax);
-    
-    clampMinMax(validStartColorMin.x, validStartColorMax.x);
-    clampMinMax(validStartColorMin.y, validStartColorMax.y);
-    clampMinMax(validStartColorMin.z, validStartColorMax.z);
-    clampMinMax(validStartColorMin.w, validStartColorMax.w);
-    
-    clampMinMax(validEndColorMin.x, validEndColorMax.x);
-    clampMinMax(validEndColorMin.y, validEndColorMax.y);
-    clampMinMax(validEndColorMin.z, validEndColorMax.z);
-    clampMinMax(validEndColorMin.w, validEndColorMax.w);
-    
-    clampMinMax(validRotationMin, validRotationMax);
-    clampMinMax(validRotationVelocityMin, validRotationVelocityMax);
-    clampMinMax(validLifeTimeMin, validLifeTimeMax);
-
-    // 均等分布乱数生成器
-    std::uniform_real_distribution<float> velocityDistX(validVelocityMin.x, validVelocityMax.x);
-    std::uniform_real_distribution<float> velocityDistY(validVelocityMin.y, validVelocityMax.y);
-    std::uniform_real_distribution<float> velocityDistZ(validVelocityMin.z, validVelocityMax.z);
-
-    std::uniform_real_distribution<float> accelDistX(validAccelMin.x, validAccelMax.x);
-    std::uniform_real_distribution<float> accelDistY(validAccelMin.y, validAccelMax.y);
-    std::uniform_real_distribution<float> accelDistZ(validAccelMin.z, validAccelMax.z);
-
-    std::uniform_real_distribution<float> startSizeDist(validStartSizeMin, validStartSizeMax);
-    std::uniform_real_distribution<float> endSizeDist(validEndSizeMin, validEndSizeMax);
-
-    std::uniform_real_distribution<float> startColorDistR(validStartColorMin.x, validStartColorMax.x);
-    std::uniform_real_distribution<float> startColorDistG(validStartColorMin.y, validStartColorMax.y);
-    std::uniform_real_distribution<float> startColorDistB(validStartColorMin.z, validStartColorMax.z);
-    std::uniform_real_distribution<float> startColorDistA(validStartColorMin.w, validStartColorMax.w);
-
-    std::uniform_real_distribution<float> endColorDistR(validEndColorMin.x, validEndColorMax.x);
-    std::uniform_real_distribution<float> endColorDistG(validEndColorMin.y, validEndColorMax.y);
-    std::uniform_real_distribution<float> endColorDistB(validEndColorMin.z, validEndColorMax.z);
-    std::uniform_real_distribution<float> endColorDistA(validEndColorMin.w, validEndColorMax.w);
-
-    std::uniform_real_distribution<float> rotationDist(validRotationMin, validRotationMax);
-    std::uniform_real_distribution<float> rotationVelocityDist(validRotationVelocityMin, validRotationVelocityMax);
-
-    std::uniform_real_distribution<float> lifeTimeDist(validLifeTimeMin, validLifeTimeMax);
-
-    // 指定された数のパーティクルを生成
-    for (uint32_t i = 0; i < count; ++i) {
-        Particle particle;
-
-        // 座標
-        particle.position = position;
-
-        // 速度（ランダム）
-        particle.velocity.x = velocityDistX(randomEngine_);
-        particle.velocity.y = velocityDistY(randomEngine_);
-        particle.velocity.z = velocityDistZ(randomEngine_);
-
-        // 加速度（ランダム）
-        particle.accel.x = accelDistX(randomEngine_);
-        particle.accel.y = accelDistY(randomEngine_);
-        particle.accel.z = accelDistZ(randomEngine_);
-
-        // サイズ（ランダム）
-        particle.startSize = startSizeDist(randomEngine_);
-        particle.endSize = endSizeDist(randomEngine_);
-        particle.size = particle.startSize;
-
-        // 色（ランダム）
-        particle.startColor.x = startColorDistR(randomEngine_);
-        particle.startColor.y = startColorDistG(randomEngine_);
-        particle.startColor.z = startColorDistB(randomEngine_);
-        particle.startColor.w = startColorDistA(randomEngine_);
-
-        particle.endColor.x = endColorDistR(randomEngine_);
-        particle.endColor.y = endColorDistG(randomEngine_);
-        particle.endColor.z = endColorDistB(randomEngine_);
-        particle.endColor.w = endColorDistA(randomEngine_);
-
-        particle.color = particle.startColor;
-
-        // 回転（ランダム）
-        particle.rotation = rotationDist(randomEngine_);
-        particle.rotationVelocity = rotationVelocityDist(randomEngine_);
-
-        // 寿命（ランダム）
-        particle.lifeTimeMax = lifeTimeDist(randomEngine_);
-        particle.lifeTime = 0.0f;
-
-        // パーティクルリストに追加
-        it->second.particles.push_back(particle);
+    // 発生パラメータをまとめる（最小値と最大値が逆でも範囲内の値になる）
+    ParticleEmitParams params;
+    params.position = position;
+    params.velocityMin = velocityMin;
+    params.velocityMax = velocityMax;
+    params.accelMin = accelMin;
+    params.accelMax = accelMax;
+    params.startSizeMin = startSizeMin;
+    params.startSizeMax = startSizeMax;
+    params.endSizeMin = endSizeMin;
+    params.endSizeMax = endSizeMax;
+    params.startColorMin = startColorMin;
+    params.startColorMax = startColorMax;
+    params.endColorMin = endColorMin;
+    params.endColorMax = endColorMax;
+    params.rotationMin = rotationMin;
+    params.rotationMax = rotationMax;
+    params.rotationVelocityMin = rotationVelocityMin;
+    params.rotationVelocityMax = rotationVelocityMax;
+    params.lifeTimeMin = lifeTimeMin;
+    params.lifeTimeMax = lifeTimeMax;
+
+    // 指定された数のパーティクルを生成（容量を超えた分は発生しない）
+    it->second.simulation.Emit(params, count);
+}
+
+void ParticleManager::AddForceField(const std::string& name, const ParticleForceField& field) {
+    auto it = particleGroups.find(name);
+    assert(it != particleGroups.end());
+    it->second.simulation.AddForceField(field);
+}
+
+void ParticleManager::ClearForceFields(const std::string& name) {
+    auto it = particleGroups.find(name);
+    if (it != particleGroups.end()) {
+        it->second.simulation.ClearForceFields();
     }
 }
 
 void ParticleManager::Draw() {
+    // このフレームの確保を締め切る（フレームの終了のフェンス値は次のBeginFrameで記録される）
+    uploadAllocator_.EndFrame();
+
     // パーティクルがない場合は描画しない
     bool hasParticles = false;
     for (auto& [name, group] : particleGroups) {
-        if (!group.particles.empty()) {
+        if (group.simulation.GetCount() > 0) {
             hasParticles = true;
             break;
         }
@@ -642,7 +736,7 @@ void ParticleManager::Draw() {
     // 各パーティクルグループの描画
     for (auto& [name, group] : particleGroups) {
         // パーティクルがない場合はスキップ
-        if (group.particles.empty() || group.instanceCount == 0) {
+        if (group.instanceCount == 0) {
             continue;
         }
 
@@ -650,11 +744,31 @@ void ParticleManager::Draw() {
         srvManager_->SetGraphicsRootDescriptorTable(2, group.textureSrvIndex);
 
         // インスタンシングデータをセット（頂点シェーダー用）
-        srvManager_->SetGraphicsRootDescriptorTable(3, group.instanceSrvIndex);
+        commandList->SetGraphicsRootShaderResourceView(3, group.instanceAddress);
 
         // 描画（インスタンシング）
         commandList->DrawInstanced(4, group.instanceCount, 0, 0);
     }
+
+    // リボンの描画（グループごとに1本のストリップ）
+    bool hasRibbons = false;
+    for (auto& [name, group] : particleGroups) {
+        if (group.ribbonVertexCount > 0) {
+            if (!hasRibbons) {
+                commandList->SetPipelineState(ribbonPipelineState.Get());
+                commandList->SetGraphicsRootSignature(ribbonRootSignature.Get());
+                commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+                commandList->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
+                commandList->SetGraphicsRootConstantBufferView(1, directionalLightResource->GetGPUVirtualAddress());
+                commandList->SetGraphicsRootConstantBufferView(3, ribbonTransformAddress_);
+                hasRibbons = true;
+            }
+
+            srvManager_->SetGraphicsRootDescriptorTable(2, group.textureSrvIndex);
+            commandList->IASetVertexBuffers(0, 1, &group.ribbonVbView);
+            commandList->DrawInstanced(group.ribbonVertexCount, 1, 0, 0);
+        }
+    }
 }
 
 // デバッグ用：シンプルな四角形を描画
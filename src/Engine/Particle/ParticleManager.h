@@ -2,7 +2,6 @@
 
 #include <unordered_map>
 #include <string>
-#include <list>
 #include <random>
 #include <memory>
 #include "DirectXCommon.h"
@@ -10,43 +9,13 @@
 #include "Mymath.h"
 #include "Mymath.h"
 #include "Camera.h"
+#include "ParticleSimulation.h"
+#include "ParticleRibbon.h"
+#include "LinearUploadAllocator.h"
 
 // 前方宣言
 class ParticleEmitter;
 
-// パーティクル1粒の情報
-struct Particle {
-    // 座標
-    Vector3 position;
-    // 速度
-    Vector3 velocity;
-    // 加速度
-    Vector3 accel;
-    // 色
-    Vector4 color;
-    // 初期サイズ
-    float startSize;
-    // 最終サイズ
-    float endSize;
-    // 現在サイズ
-    float size;
-    // 初期色
-    Vector4 startColor;
-    // 最終色
-    Vector4 endColor;
-    // 回転
-    float rotation;
-    // 回転速度
-    float rotationVelocity;
-    // 経過時間
-    float lifeTime;
-    // 寿命
-    float lifeTimeMax;
-
-    // 生存フラグ
-    bool isDead = false;
-};
-
 // インスタンシング描画用データ
 struct ParticleForGPU {
     // WVP行列
@@ -63,20 +32,20 @@ struct ParticleGroup {
     std::string textureFilePath;
     uint32_t textureSrvIndex;
 
-    // パーティクルのリスト
-    std::list<Particle> particles;
-
-    // インスタンシングデータのSRVインデックス
-    uint32_t instanceSrvIndex;
+    // パーティクルのシミュレーション（描画から独立）
+    ParticleSimulation simulation;
 
-    // インスタンシングリソース
-    Microsoft::WRL::ComPtr<ID3D12Resource> instanceResource;
+    // 今フレームのインスタンシングデータ（フレームごとのアップロードバッファ内）
+    D3D12_GPU_VIRTUAL_ADDRESS instanceAddress = 0;
 
     // インスタンス数
     uint32_t instanceCount;
 
-    // インスタンシングデータを書き込むためのポインタ
-    ParticleForGPU* instanceData;
+    // リボン（軌跡）描画
+    bool ribbonEnabled = false;
+    ParticleRibbonSettings ribbonSettings;
+    uint32_t ribbonVertexCount = 0;
+    D3D12_VERTEX_BUFFER_VIEW ribbonVbView{};
 };
 
 // パーティクルマネージャクラス
@@ -94,12 +63,30 @@ private:
     // パーティクルグループコンテナ
     std::unordered_map<std::string, ParticleGroup> particleGroups;
 
+    // グループあたりの最大パーティクル数（インスタンシングリソースの要素数）
+    static const uint32_t kMaxInstanceCount = 10000;
+
     // 描画用ルートシグネチャ
     Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature;
 
     // 描画用パイプラインステート
     Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState;
 
+    // リボン描画用ルートシグネチャとパイプラインステート
+    Microsoft::WRL::ComPtr<ID3D12RootSignature> ribbonRootSignature;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> ribbonPipelineState;
+
+    // インスタンシングデータ・リボンの頂点と変換行列を書き込むフレームごとのアップロードバッファ
+    // GPUが前のフレームを読んでいる間に次のフレームを書き込めるよう、フェンスで管理して使い回す
+    LinearUploadAllocator uploadAllocator_;
+    D3D12_GPU_VIRTUAL_ADDRESS ribbonTransformAddress_ = 0;
+
+    // アップロードバッファのフレームあたりの初期容量（不足するとフレームの途中で拡張される）
+    static const size_t kUploadBufferSize = 8 * 1024 * 1024;
+
+    // アップロードバッファの数（同時に処理中にできるフレーム数）
+    static const uint32_t kUploadFrameCount = 3;
+
     // 頂点バッファビュー
     D3D12_VERTEX_BUFFER_VIEW vbView{};
 
@@ -131,6 +118,12 @@ private:
     // グラフィックスパイプラインの初期化
     void InitializeGraphicsPipeline();
 
+    // リボン描画用パイプラインの初期化
+    void InitializeRibbonPipeline();
+
+    // リボン頂点の生成
+    void BuildRibbon(ParticleGroup& group, const Vector3& cameraPosition);
+
     // ビルボード行列の計算
     void CalculateBillboardMatrix(const Camera* camera);
 
@@ -156,18 +149,14 @@ public:
     void ForceReleaseResources() {
         OutputDebugStringA("ParticleManager::ForceReleaseResources - Starting resource cleanup\n");
         
-        // 全パーティクルグループのリソース解放
-        for (auto& [name, group] : particleGroups) {
-            OutputDebugStringA(("ParticleManager: Releasing particle group - " + name + "\n").c_str());
-            if (group.instanceResource && group.instanceData) {
-                group.instanceResource->Unmap(0, nullptr);
-                group.instanceData = nullptr;
-            }
-            group.instanceResource.Reset();
-        }
+        // 全パーティクルグループの解放
         particleGroups.clear();
         OutputDebugStringA("ParticleManager: All particle groups cleared\n");
 
+        // アップロードバッファの解放
+        uploadAllocator_.Finalize();
+        OutputDebugStringA("ParticleManager: Upload buffers released\n");
+
         // その他のマップされたリソースの解放
         if (materialResource && materialData) {
             materialResource->Unmap(0, nullptr);
@@ -190,6 +179,10 @@ public:
             OutputDebugStringA("ParticleManager: Vertex resource reset\n");
         }
 
+        // リボン用リソースの解放
+        ribbonPipelineState.Reset();
+        ribbonRootSignature.Reset();
+
         // パイプラインステートとルートシグネチャの解放
         if (pipelineState) {
             pipelineState.Reset();
@@ -242,11 +235,28 @@ public:
         float lifeTimeMin,
         float lifeTimeMax);
 
+    // 力場の追加（グループ内の全パーティクルに毎フレーム適用）
+    void AddForceField(const std::string& name, const ParticleForceField& field);
+
+    // 力場の全削除
+    void ClearForceFields(const std::string& name);
+
+    // デバッグ用：アップロードバッファのGPU待ち回数
+    uint32_t GetUploadStallCount() const { return uploadAllocator_.GetStallCount(); }
+    // デバッグ用：アップロードバッファをフレームの途中で拡張した回数
+    uint32_t GetUploadGrowCount() const { return uploadAllocator_.GetGrowCount(); }
+
+    // リボン（軌跡）描画の有効化
+    void EnableRibbon(const std::string& name, const ParticleRibbonSettings& settings);
+
+    // リボン描画の無効化
+    void DisableRibbon(const std::string& name);
+
     // デバッグ用：パーティクル数の取得
     uint32_t GetParticleCount(const std::string& name) {
         auto it = particleGroups.find(name);
         if (it != particleGroups.end()) {
-            return static_cast<uint32_t>(it->second.particles.size());
+            return it->second.simulation.GetCount();
         }
         return 0;
     }
@@ -0,0 +1,149 @@
+#include "ParticleRibbon.h"
+#include "ParticleSimulation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    Vector3 Sub(const Vector3& a, const Vector3& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    Vector3 Cross(const Vector3& a, const Vector3& b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+    float LengthSq(const Vector3& v) { return v.x * v.x + v.y * v.y + v.z * v.z; }
+
+    // 軌跡のk番目の分割点に対応する履歴の番号（均等に間引く）
+    uint32_t SegmentAge(uint32_t k, uint32_t segmentCount, uint32_t trailCount) {
+        return (k * (trailCount - 1) + segmentCount / 2) / segmentCount;
+    }
+
+    // パーティクルiのリボンの分割数（先頭＝現在位置の距離で決める。生成しない場合は0）
+    uint32_t GetParticleSegmentCount(const ParticleSimulation& simulation, uint32_t i,
+        const ParticleRibbonSettings& settings, const Vector3& cameraPosition) {
+        const uint32_t trailCount = simulation.GetTrailCount(i);
+        if (trailCount < 2) {
+            return 0;
+        }
+        float distance = std::sqrt(LengthSq(Sub(simulation.GetTrailPosition(i, 0), cameraPosition)));
+        return std::min(CalculateRibbonSegmentCount(distance, settings), trailCount - 1);
+    }
+}
+
+uint32_t CalculateRibbonSegmentCount(float distance, const ParticleRibbonSettings& settings) {
+    if (settings.historyLength < 2 || distance > settings.cullDistance) {
+        return 0;
+    }
+
+    uint32_t maxSegments = settings.historyLength - 1;
+    uint32_t minSegments = std::clamp(settings.minSegments, 1u, maxSegments);
+    if (distance <= settings.lodNearDistance || settings.lodFarDistance <= settings.lodNearDistance) {
+        return maxSegments;
+    }
+
+    // 近距離～遠距離の間で分割数を線形に減らす
+    float t = std::min((distance - settings.lodNearDistance) / (settings.lodFarDistance - settings.lodNearDistance), 1.0f);
+    float segments = static_cast<float>(maxSegments) + (static_cast<float>(minSegments) - static_cast<float>(maxSegments)) * t;
+    return static_cast<uint32_t>(segments + 0.5f);
+}
+
+uint32_t CountParticleRibbonVertices(
+    const ParticleSimulation& simulation,
+    const ParticleRibbonSettings& settings,
+    const Vector3& cameraPosition) {
+
+    if (simulation.GetTrailLength() < 2) {
+        return 0;
+    }
+
+    uint32_t vertexCount = 0;
+    for (uint32_t i = 0; i < simulation.GetCount(); ++i) {
+        uint32_t segmentCount = GetParticleSegmentCount(simulation, i, settings, cameraPosition);
+        if (segmentCount > 0) {
+            vertexCount += (segmentCount + 1) * 2 + (vertexCount > 0 ? 2 : 0);
+        }
+    }
+    return vertexCount;
+}
+
+uint32_t BuildParticleRibbons(
+    const ParticleSimulation& simulation,
+    const ParticleRibbonSettings& settings,
+    const Vector3& cameraPosition,
+    RibbonVertex* out,
+    uint32_t maxVertexCount) {
+
+    if (simulation.GetTrailLength() < 2 || out == nullptr) {
+        return 0;
+    }
+
+    const uint32_t count = simulation.GetCount();
+    const float* size = simulation.GetSize();
+    const float* colorR = simulation.GetColorR();
+    const float* colorG = simulation.GetColorG();
+    const float* colorB = simulation.GetColorB();
+    const float* colorA = simulation.GetColorA();
+
+    uint32_t vertexCount = 0;
+    RibbonVertex lastVertex{};
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t segmentCount = GetParticleSegmentCount(simulation, i, settings, cameraPosition);
+        if (segmentCount == 0) {
+            continue;
+        }
+        const uint32_t trailCount = simulation.GetTrailCount(i);
+        const Vector3& head = simulation.GetTrailPosition(i, 0);
+
+        // 連結用の縮退頂点を含めて収まらなければ終了
+        uint32_t required = (segmentCount + 1) * 2 + (vertexCount > 0 ? 2 : 0);
+        if (vertexCount + required > maxVertexCount) {
+            break;
+        }
+
+        const float halfWidth = size[i] * settings.widthScale * 0.5f;
+        const Vector4 color = { colorR[i], colorG[i], colorB[i], colorA[i] };
+        Vector3 side = { 0.0f, 0.0f, 0.0f };
+
+        // 前後の点を順に送りながら参照する
+        Vector3 newer = head;
+        Vector3 position = head;
+        Vector3 older = simulation.GetTrailPosition(i, SegmentAge(1, segmentCount, trailCount));
+
+        for (uint32_t k = 0; k <= segmentCount; ++k) {
+            if (k > 0) {
+                newer = position;
+                position = older;
+                if (k < segmentCount) {
+                    older = simulation.GetTrailPosition(i, SegmentAge(k + 1, segmentCount, trailCount));
+                }
+            }
+
+            // 進行方向と視線の外積を幅方向にする（止まっている点は直前の向きを使う）
+            Vector3 axis = Cross(Sub(newer, older), Sub(cameraPosition, position));
+            float lengthSq = LengthSq(axis);
+            if (lengthSq > 1.0e-12f) {
+                float invLength = 1.0f / std::sqrt(lengthSq);
+                side = { axis.x * invLength, axis.y * invLength, axis.z * invLength };
+            }
+
+            // 尾に向かって細く、透明にする
+            float t = static_cast<float>(k) / static_cast<float>(segmentCount);
+            float width = halfWidth * (1.0f - t);
+            Vector4 vertexColor = { color.x, color.y, color.z, color.w * (1.0f - t) };
+
+            RibbonVertex left = { { position.x + side.x * width, position.y + side.y * width, position.z + side.z * width }, { t, 0.0f }, vertexColor };
+            RibbonVertex right = { { position.x - side.x * width, position.y - side.y * width, position.z - side.z * width }, { t, 1.0f }, vertexColor };
+
+            // 前のリボンとの間を縮退三角形でつなぐ
+            if (k == 0 && vertexCount > 0) {
+                out[vertexCount++] = lastVertex;
+                out[vertexCount++] = left;
+            }
+
+            // 書き込み結合メモリを想定して、読み戻さずに順番に書き込む
+            out[vertexCount++] = left;
+            out[vertexCount++] = right;
+            lastVertex = right;
+        }
+    }
+
+    return vertexCount;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Mymath.h"
+#include <cstdint>
+
+class ParticleSimulation;
+
+// リボン描画用の頂点（TRIANGLESTRIPで描画する）
+struct RibbonVertex {
+    Vector3 position;
+    Vector2 texcoord;
+    Vector4 color;
+};
+
+// リボンの設定
+struct ParticleRibbonSettings {
+    // 軌跡として保持する座標数（リボンの最大分割数+1）
+    uint32_t historyLength = 16;
+    // パーティクルのサイズに対するリボンの幅の倍率
+    float widthScale = 1.0f;
+    // 遠距離での最小分割数
+    uint32_t minSegments = 2;
+    // この距離までは最大分割数、lodFarDistanceで最小分割数になる
+    float lodNearDistance = 10.0f;
+    float lodFarDistance = 60.0f;
+    // この距離より遠いリボンは生成しない
+    float cullDistance = 120.0f;
+    // ビルボードも合わせて描画するか
+    bool drawBillboards = false;
+};
+
+// カメラからの距離に応じたリボンの分割数を計算
+uint32_t CalculateRibbonSegmentCount(float distance, const ParticleRibbonSettings& settings);
+
+// リボン1本あたりの最大頂点数（連結用の縮退頂点を含む）
+inline uint32_t GetMaxRibbonVertexCount(const ParticleRibbonSettings& settings) {
+    return settings.historyLength * 2 + 2;
+}
+
+// BuildParticleRibbonsが書き込む頂点数（生成前に必要な分だけバッファを確保するため）
+uint32_t CountParticleRibbonVertices(
+    const ParticleSimulation& simulation,
+    const ParticleRibbonSettings& settings,
+    const Vector3& cameraPosition);
+
+// シミュレーションの軌跡からカメラを向いたリボンの頂点を生成
+// 全リボンを縮退三角形で連結し、1回のTRIANGLESTRIP描画で済むようにする
+// outは書き込み専用のアップロードバッファを想定し、先頭から順に書き込む
+// 戻り値は書き込んだ頂点数（maxVertexCountを超える分は生成しない）
+uint32_t BuildParticleRibbons(
+    const ParticleSimulation& simulation,
+    const ParticleRibbonSettings& settings,
+    const Vector3& cameraPosition,
+    RibbonVertex* out,
+    uint32_t maxVertexCount);
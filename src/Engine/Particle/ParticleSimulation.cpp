@@ -0,0 +1,604 @@
+#include "ParticleSimulation.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+// x64ではSSE2が常に使えるため、4パーティクルずつまとめて処理する
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PARTICLE_SIMULATION_SSE2
+#endif
+
+#ifdef PARTICLE_SIMULATION_SSE2
+namespace {
+    // 4要素分のベクトル（成分ごとのレジスタ）
+    struct Vector3x4 {
+        __m128 x, y, z;
+    };
+
+    inline Vector3x4 Lerp4(const Vector3x4& v1, const Vector3x4& v2, __m128 t) {
+        return Vector3x4{
+            _mm_add_ps(v1.x, _mm_mul_ps(t, _mm_sub_ps(v2.x, v1.x))),
+            _mm_add_ps(v1.y, _mm_mul_ps(t, _mm_sub_ps(v2.y, v1.y))),
+            _mm_add_ps(v1.z, _mm_mul_ps(t, _mm_sub_ps(v2.z, v1.z))) };
+    }
+
+    // 切り捨て（SSE2にはfloorがないため、0方向への丸めから負の端数の分を引く。|value| < 2^31）
+    inline __m128 Floor4(__m128 value) {
+        __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(value));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, value), _mm_set1_ps(1.0f)));
+    }
+
+    // 1軸分の2つの格子インデックス（整数値のfloat）と補間係数（ParticleVectorField::Sampleと同じ計算）
+    template <bool Wrap>
+    inline void GridAxis4(__m128 grid, uint32_t size, __m128& i0, __m128& i1, __m128& t) {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 size4 = _mm_set1_ps(static_cast<float>(size));
+        const __m128 last = _mm_sub_ps(size4, one);
+        if constexpr (!Wrap) {
+            grid = _mm_min_ps(_mm_max_ps(grid, _mm_setzero_ps()), last);
+        }
+        __m128 cell = Floor4(grid);
+        t = _mm_sub_ps(grid, cell);
+        if constexpr (Wrap) {
+            // cellをsizeで割った余り（割り算の丸めで範囲を外れた分は1周分ずらして戻す）
+            __m128 wrapped = _mm_sub_ps(cell, _mm_mul_ps(size4, Floor4(_mm_div_ps(cell, size4))));
+            wrapped = _mm_add_ps(wrapped, _mm_and_ps(_mm_cmplt_ps(wrapped, _mm_setzero_ps()), size4));
+            wrapped = _mm_sub_ps(wrapped, _mm_and_ps(_mm_cmpge_ps(wrapped, size4), size4));
+            // NaNや極端に大きな座標でも格子の外を読まないように丸める
+            wrapped = _mm_min_ps(_mm_max_ps(wrapped, _mm_setzero_ps()), last);
+            i0 = wrapped;
+            __m128 next = _mm_add_ps(wrapped, one);
+            i1 = _mm_andnot_ps(_mm_cmpge_ps(next, size4), next);
+        } else {
+            i0 = cell;
+            i1 = _mm_min_ps(_mm_add_ps(cell, one), last);
+        }
+    }
+
+    // 4点のトライリニア補間。インデックスと補間係数はSIMDで求め、8つの角の値の読み込みだけをパーティクルごとに行う
+    // インデックスはfloatで計算するため、格子数は2^24まで
+    template <bool Wrap>
+    Vector3x4 SampleVolume4(const ParticleVectorField& volume, __m128 gridX, __m128 gridY, __m128 gridZ) {
+        __m128 x0, x1, y0, y1, z0, z1, tx, ty, tz;
+        GridAxis4<Wrap>(gridX, volume.GetSizeX(), x0, x1, tx);
+        GridAxis4<Wrap>(gridY, volume.GetSizeY(), y0, y1, ty);
+        GridAxis4<Wrap>(gridZ, volume.GetSizeZ(), z0, z1, tz);
+
+        // (z * sizeY + y) * sizeX + x
+        const __m128 sizeX = _mm_set1_ps(static_cast<float>(volume.GetSizeX()));
+        const __m128 sizeY = _mm_set1_ps(static_cast<float>(volume.GetSizeY()));
+        const __m128 rows[4] = {
+            _mm_mul_ps(_mm_add_ps(_mm_mul_ps(z0, sizeY), y0), sizeX),
+            _mm_mul_ps(_mm_add_ps(_mm_mul_ps(z0, sizeY), y1), sizeX),
+            _mm_mul_ps(_mm_add_ps(_mm_mul_ps(z1, sizeY), y0), sizeX),
+            _mm_mul_ps(_mm_add_ps(_mm_mul_ps(z1, sizeY), y1), sizeX) };
+        alignas(16) int32_t indices[8][4];
+        for (int row = 0; row < 4; ++row) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices[row * 2]), _mm_cvttps_epi32(_mm_add_ps(rows[row], x0)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices[row * 2 + 1]), _mm_cvttps_epi32(_mm_add_ps(rows[row], x1)));
+        }
+
+        // 角の値を読み込む（[row * 2 + 0/1] = x0/x1、rowは(y0,z0),(y1,z0),(y0,z1),(y1,z1)の順）
+        const Vector3* data = volume.GetData();
+        Vector3x4 corners[8];
+        for (int corner = 0; corner < 8; ++corner) {
+            const Vector3& a = data[indices[corner][0]];
+            const Vector3& b = data[indices[corner][1]];
+            const Vector3& c = data[indices[corner][2]];
+            const Vector3& d = data[indices[corner][3]];
+            corners[corner] = Vector3x4{ _mm_setr_ps(a.x, b.x, c.x, d.x), _mm_setr_ps(a.y, b.y, c.y, d.y), _mm_setr_ps(a.z, b.z, c.z, d.z) };
+        }
+
+        const Vector3x4 c00 = Lerp4(corners[0], corners[1], tx);
+        const Vector3x4 c10 = Lerp4(corners[2], corners[3], tx);
+        const Vector3x4 c01 = Lerp4(corners[4], corners[5], tx);
+        const Vector3x4 c11 = Lerp4(corners[6], corners[7], tx);
+        return Lerp4(Lerp4(c00, c10, ty), Lerp4(c01, c11, ty), tz);
+    }
+}
+#endif
+
+void ParticleSimulation::Initialize(uint32_t capacity, uint32_t seed) {
+    capacity_ = capacity;
+    count_ = 0;
+    time_ = 0.0;
+    SetSeed(seed);
+
+    // 全配列を容量分確保（以降のEmit/Updateでは確保しない）
+    for (std::vector<float>* array : {
+        &positionX_, &positionY_, &positionZ_,
+        &velocityX_, &velocityY_, &velocityZ_,
+        &accelX_, &accelY_, &accelZ_,
+        &size_, &startSize_, &endSize_,
+        &rotation_, &rotationVelocity_,
+        &colorR_, &colorG_, &colorB_, &colorA_,
+        &lifeTime_, &lifeTimeMax_ }) {
+        array->assign(capacity, 0.0f);
+    }
+    startColor_.assign(capacity, Vector4{});
+    endColor_.assign(capacity, Vector4{});
+
+    // 軌跡が有効なら容量に合わせて確保し直す
+    EnableTrail(trailLength_);
+}
+
+void ParticleSimulation::EnableTrail(uint32_t length) {
+    trailLength_ = length;
+    trail_.assign(static_cast<size_t>(capacity_) * length, Vector3{ 0.0f, 0.0f, 0.0f });
+    trailHead_.assign(length ? capacity_ : 0, 0u);
+    trailCount_.assign(length ? capacity_ : 0, 0u);
+
+    // 既存のパーティクルは現在位置から記録し直す
+    for (uint32_t i = 0; i < count_ && length; ++i) {
+        RecordTrail(i);
+    }
+}
+
+void ParticleSimulation::RecordTrail(uint32_t index) {
+    uint32_t head = (trailCount_[index] == 0) ? 0 : (trailHead_[index] + 1) % trailLength_;
+    trail_[static_cast<size_t>(index) * trailLength_ + head] = { positionX_[index], positionY_[index], positionZ_[index] };
+    trailHead_[index] = head;
+    if (trailCount_[index] < trailLength_) {
+        trailCount_[index]++;
+    }
+}
+
+void ParticleSimulation::SetSeed(uint32_t seed) {
+    // xorshiftは0の状態から抜け出せないため置き換える
+    randomState_ = (seed != 0) ? seed : 0x9E3779B9u;
+}
+
+float ParticleSimulation::NextRandom() {
+    // xorshift32
+    uint32_t x = randomState_;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    randomState_ = x;
+    // 上位24bitを[0, 1)に変換
+    return static_cast<float>(x >> 8) * (1.0f / 16777216.0f);
+}
+
+uint32_t ParticleSimulation::Emit(const ParticleEmitParams& params, uint32_t count) {
+    // 容量を超える分は切り捨て
+    uint32_t emitCount = (count < capacity_ - count_) ? count : capacity_ - count_;
+
+    for (uint32_t n = 0; n < emitCount; ++n) {
+        uint32_t i = count_++;
+
+        // 座標
+        positionX_[i] = params.position.x;
+        positionY_[i] = params.position.y;
+        positionZ_[i] = params.position.z;
+
+        // 速度（ランダム）
+        velocityX_[i] = RandomRange(params.velocityMin.x, params.velocityMax.x);
+        velocityY_[i] = RandomRange(params.velocityMin.y, params.velocityMax.y);
+        velocityZ_[i] = RandomRange(params.velocityMin.z, params.velocityMax.z);
+
+        // 加速度（ランダム）
+        accelX_[i] = RandomRange(params.accelMin.x, params.accelMax.x);
+        accelY_[i] = RandomRange(params.accelMin.y, params.accelMax.y);
+        accelZ_[i] = RandomRange(params.accelMin.z, params.accelMax.z);
+
+        // サイズ（ランダム）
+        startSize_[i] = RandomRange(params.startSizeMin, params.startSizeMax);
+        endSize_[i] = RandomRange(params.endSizeMin, params.endSizeMax);
+        size_[i] = startSize_[i];
+
+        // 色（ランダム）
+        startColor_[i] = {
+            RandomRange(params.startColorMin.x, params.startColorMax.x),
+            RandomRange(params.startColorMin.y, params.startColorMax.y),
+            RandomRange(params.startColorMin.z, params.startColorMax.z),
+            RandomRange(params.startColorMin.w, params.startColorMax.w) };
+        endColor_[i] = {
+            RandomRange(params.endColorMin.x, params.endColorMax.x),
+            RandomRange(params.endColorMin.y, params.endColorMax.y),
+            RandomRange(params.endColorMin.z, params.endColorMax.z),
+            RandomRange(params.endColorMin.w, params.endColorMax.w) };
+        colorR_[i] = startColor_[i].x;
+        colorG_[i] = startColor_[i].y;
+        colorB_[i] = startColor_[i].z;
+        colorA_[i] = startColor_[i].w;
+
+        // 回転（ランダム）
+        rotation_[i] = RandomRange(params.rotationMin, params.rotationMax);
+        rotationVelocity_[i] = RandomRange(params.rotationVelocityMin, params.rotationVelocityMax);
+
+        // 寿命（ランダム）
+        lifeTimeMax_[i] = RandomRange(params.lifeTimeMin, params.lifeTimeMax);
+        lifeTime_[i] = 0.0f;
+
+        // 軌跡を発生位置から開始
+        if (trailLength_ > 0) {
+            trailCount_[i] = 0;
+            RecordTrail(i);
+        }
+    }
+
+    return emitCount;
+}
+
+void ParticleSimulation::Update(float deltaTime) {
+    // 寿命チェック（末尾と入れ替えて削除するため、同じ位置をもう一度見る）
+    for (uint32_t i = 0; i < count_; ) {
+        lifeTime_[i] += deltaTime;
+        if (lifeTime_[i] >= lifeTimeMax_[i]) {
+            MoveParticle(i, --count_);
+            continue;
+        }
+        ++i;
+    }
+
+    time_ += deltaTime;
+    const uint32_t count = count_;
+
+    // 力場による速度の変化
+    for (const ParticleForceField& field : forceFields_) {
+        ApplyForceField(field, deltaTime);
+    }
+
+    // 生存パーティクルの更新（要素ごとの連続した配列を処理）
+    Integrate(deltaTime);
+
+    // 軌跡の記録
+    if (trailLength_ > 0) {
+        for (uint32_t i = 0; i < count; ++i) {
+            RecordTrail(i);
+        }
+    }
+
+    // 線形補間でサイズと色を更新
+    for (uint32_t i = 0; i < count; ++i) {
+        float t = lifeTime_[i] / lifeTimeMax_[i];
+        size_[i] = (1.0f - t) * startSize_[i] + t * endSize_[i];
+
+        colorR_[i] = (1.0f - t) * startColor_[i].x + t * endColor_[i].x;
+        colorG_[i] = (1.0f - t) * startColor_[i].y + t * endColor_[i].y;
+        colorB_[i] = (1.0f - t) * startColor_[i].z + t * endColor_[i].z;
+        colorA_[i] = (1.0f - t) * startColor_[i].w + t * endColor_[i].w;
+    }
+}
+
+void ParticleSimulation::MoveParticle(uint32_t dst, uint32_t src) {
+    if (dst == src) {
+        return;
+    }
+
+    positionX_[dst] = positionX_[src];
+    positionY_[dst] = positionY_[src];
+    positionZ_[dst] = positionZ_[src];
+    velocityX_[dst] = velocityX_[src];
+    velocityY_[dst] = velocityY_[src];
+    velocityZ_[dst] = velocityZ_[src];
+    accelX_[dst] = accelX_[src];
+    accelY_[dst] = accelY_[src];
+    accelZ_[dst] = accelZ_[src];
+    size_[dst] = size_[src];
+    startSize_[dst] = startSize_[src];
+    endSize_[dst] = endSize_[src];
+    rotation_[dst] = rotation_[src];
+    rotationVelocity_[dst] = rotationVelocity_[src];
+    colorR_[dst] = colorR_[src];
+    colorG_[dst] = colorG_[src];
+    colorB_[dst] = colorB_[src];
+    colorA_[dst] = colorA_[src];
+    startColor_[dst] = startColor_[src];
+    endColor_[dst] = endColor_[src];
+    lifeTime_[dst] = lifeTime_[src];
+    lifeTimeMax_[dst] = lifeTimeMax_[src];
+
+    if (trailLength_ > 0) {
+        std::copy_n(&trail_[static_cast<size_t>(src) * trailLength_], trailLength_,
+            &trail_[static_cast<size_t>(dst) * trailLength_]);
+        trailHead_[dst] = trailHead_[src];
+        trailCount_[dst] = trailCount_[src];
+    }
+}
+
+void ParticleSimulation::ApplyForceField(const ParticleForceField& field, float deltaTime) {
+    switch (field.type) {
+    case ParticleForceField::Type::GravityWell:
+        ApplyGravityWell(field, deltaTime);
+        break;
+    case ParticleForceField::Type::Drag:
+        ApplyDrag(field, deltaTime);
+        break;
+    case ParticleForceField::Type::Vortex:
+        ApplyVortex(field, deltaTime);
+        break;
+    case ParticleForceField::Type::CurlNoise:
+    case ParticleForceField::Type::VectorField:
+        ApplyVolume(field, deltaTime);
+        break;
+    }
+}
+
+void ParticleSimulation::ApplyGravityWell(const ParticleForceField& field, float deltaTime) {
+    // 加速度の大きさは strength / (1 + 距離^2)（中心付近で発散しないように緩和した逆二乗）
+    // radiusが指定されている場合は外側に向かって線形に減衰し、radiusで0になる
+    const float scale = field.strength * deltaTime;
+    const float invRadius = (field.radius > 0.0f) ? 1.0f / field.radius : 0.0f;
+    const float epsilon = 1.0e-6f;
+    uint32_t i = 0;
+
+#ifdef PARTICLE_SIMULATION_SSE2
+    const __m128 centerX = _mm_set1_ps(field.position.x);
+    const __m128 centerY = _mm_set1_ps(field.position.y);
+    const __m128 centerZ = _mm_set1_ps(field.position.z);
+    const __m128 scale4 = _mm_set1_ps(scale);
+    const __m128 invRadius4 = _mm_set1_ps(invRadius);
+    const __m128 hasRadius = (field.radius > 0.0f) ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 epsilon4 = _mm_set1_ps(epsilon);
+    for (; i + 4 <= count_; i += 4) {
+        __m128 dx = _mm_sub_ps(centerX, _mm_loadu_ps(&positionX_[i]));
+        __m128 dy = _mm_sub_ps(centerY, _mm_loadu_ps(&positionY_[i]));
+        __m128 dz = _mm_sub_ps(centerZ, _mm_loadu_ps(&positionZ_[i]));
+        __m128 distanceSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(distanceSq, epsilon4));
+
+        // 方向の正規化と大きさをまとめた係数
+        __m128 factor = _mm_div_ps(scale4, _mm_mul_ps(distance, _mm_add_ps(one, distanceSq)));
+        __m128 falloff = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(distance, invRadius4)));
+        factor = _mm_mul_ps(factor, _mm_or_ps(_mm_and_ps(hasRadius, falloff), _mm_andnot_ps(hasRadius, one)));
+
+        _mm_storeu_ps(&velocityX_[i], _mm_add_ps(_mm_loadu_ps(&velocityX_[i]), _mm_mul_ps(dx, factor)));
+        _mm_storeu_ps(&velocityY_[i], _mm_add_ps(_mm_loadu_ps(&velocityY_[i]), _mm_mul_ps(dy, factor)));
+        _mm_storeu_ps(&velocityZ_[i], _mm_add_ps(_mm_loadu_ps(&velocityZ_[i]), _mm_mul_ps(dz, factor)));
+    }
+#endif
+
+    for (; i < count_; ++i) {
+        float dx = field.position.x - positionX_[i];
+        float dy = field.position.y - positionY_[i];
+        float dz = field.position.z - positionZ_[i];
+        float distanceSq = dx * dx + dy * dy + dz * dz;
+        float distance = std::sqrt(distanceSq + epsilon);
+
+        float factor = scale / (distance * (1.0f + distanceSq));
+        if (field.radius > 0.0f) {
+            factor *= (std::max)(0.0f, 1.0f - distance * invRadius);
+        }
+
+        velocityX_[i] += dx * factor;
+        velocityY_[i] += dy * factor;
+        velocityZ_[i] += dz * factor;
+    }
+}
+
+void ParticleSimulation::ApplyDrag(const ParticleForceField& field, float deltaTime) {
+    // 速度に比例した抵抗（1フレームで向きが反転しないように0でクランプ）
+    const float damping = (std::max)(0.0f, 1.0f - field.strength * deltaTime);
+    uint32_t i = 0;
+
+#ifdef PARTICLE_SIMULATION_SSE2
+    const __m128 damping4 = _mm_set1_ps(damping);
+    for (; i + 4 <= count_; i += 4) {
+        _mm_storeu_ps(&velocityX_[i], _mm_mul_ps(_mm_loadu_ps(&velocityX_[i]), damping4));
+        _mm_storeu_ps(&velocityY_[i], _mm_mul_ps(_mm_loadu_ps(&velocityY_[i]), damping4));
+        _mm_storeu_ps(&velocityZ_[i], _mm_mul_ps(_mm_loadu_ps(&velocityZ_[i]), damping4));
+    }
+#endif
+
+    for (; i < count_; ++i) {
+        velocityX_[i] *= damping;
+        velocityY_[i] *= damping;
+        velocityZ_[i] *= damping;
+    }
+}
+
+void ParticleSimulation::ApplyVortex(const ParticleForceField& field, float deltaTime) {
+    // 軸周りの接線方向に加速（大きさはstrength、radiusが指定されていれば外側に向かって減衰）
+    const float scale = field.strength * deltaTime;
+    const float invRadius = (field.radius > 0.0f) ? 1.0f / field.radius : 0.0f;
+    const Vector3& axis = field.axis;
+    const float epsilon = 1.0e-6f;
+    uint32_t i = 0;
+
+#ifdef PARTICLE_SIMULATION_SSE2
+    const __m128 centerX = _mm_set1_ps(field.position.x);
+    const __m128 centerY = _mm_set1_ps(field.position.y);
+    const __m128 centerZ = _mm_set1_ps(field.position.z);
+    const __m128 axisX = _mm_set1_ps(axis.x);
+    const __m128 axisY = _mm_set1_ps(axis.y);
+    const __m128 axisZ = _mm_set1_ps(axis.z);
+    const __m128 scale4 = _mm_set1_ps(scale);
+    const __m128 invRadius4 = _mm_set1_ps(invRadius);
+    const __m128 hasRadius = (field.radius > 0.0f) ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 epsilon4 = _mm_set1_ps(epsilon);
+    for (; i + 4 <= count_; i += 4) {
+        __m128 rx = _mm_sub_ps(_mm_loadu_ps(&positionX_[i]), centerX);
+        __m128 ry = _mm_sub_ps(_mm_loadu_ps(&positionY_[i]), centerY);
+        __m128 rz = _mm_sub_ps(_mm_loadu_ps(&positionZ_[i]), centerZ);
+
+        // 接線方向 = axis × r
+        __m128 tx = _mm_sub_ps(_mm_mul_ps(axisY, rz), _mm_mul_ps(axisZ, ry));
+        __m128 ty = _mm_sub_ps(_mm_mul_ps(axisZ, rx), _mm_mul_ps(axisX, rz));
+        __m128 tz = _mm_sub_ps(_mm_mul_ps(axisX, ry), _mm_mul_ps(axisY, rx));
+        __m128 tangentLength = _mm_sqrt_ps(_mm_add_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz)), epsilon4));
+
+        __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)), _mm_mul_ps(rz, rz)));
+        __m128 falloff = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(distance, invRadius4)));
+        __m128 factor = _mm_div_ps(scale4, tangentLength);
+        factor = _mm_mul_ps(factor, _mm_or_ps(_mm_and_ps(hasRadius, falloff), _mm_andnot_ps(hasRadius, one)));
+
+        _mm_storeu_ps(&velocityX_[i], _mm_add_ps(_mm_loadu_ps(&velocityX_[i]), _mm_mul_ps(tx, factor)));
+        _mm_storeu_ps(&velocityY_[i], _mm_add_ps(_mm_loadu_ps(&velocityY_[i]), _mm_mul_ps(ty, factor)));
+        _mm_storeu_ps(&velocityZ_[i], _mm_add_ps(_mm_loadu_ps(&velocityZ_[i]), _mm_mul_ps(tz, factor)));
+    }
+#endif
+
+    for (; i < count_; ++i) {
+        float rx = positionX_[i] - field.position.x;
+        float ry = positionY_[i] - field.position.y;
+        float rz = positionZ_[i] - field.position.z;
+
+        float tx = axis.y * rz - axis.z * ry;
+        float ty = axis.z * rx - axis.x * rz;
+        float tz = axis.x * ry - axis.y * rx;
+        float tangentLength = std::sqrt(tx * tx + ty * ty + tz * tz + epsilon);
+
+        float factor = scale / tangentLength;
+        if (field.radius > 0.0f) {
+            float distance = std::sqrt(rx * rx + ry * ry + rz * rz);
+            factor *= (std::max)(0.0f, 1.0f - distance * invRadius);
+        }
+
+        velocityX_[i] += tx * factor;
+        velocityY_[i] += ty * factor;
+        velocityZ_[i] += tz * factor;
+    }
+}
+
+void ParticleSimulation::ApplyVolume(const ParticleForceField& field, float deltaTime) {
+    const ParticleVectorField* volume = field.volume.get();
+    if (!volume || volume->IsEmpty()) {
+        return;
+    }
+
+    const float scale = field.strength * deltaTime;
+    uint32_t i = 0;
+#ifdef PARTICLE_SIMULATION_SSE2
+    assert(static_cast<size_t>(volume->GetSizeX()) * volume->GetSizeY() * volume->GetSizeZ() <= (size_t{ 1 } << 24));
+#endif
+
+    if (field.type == ParticleForceField::Type::CurlNoise) {
+        // 座標×周波数を格子座標とし、ボリュームをループして参照
+        // スクロール量はボリュームの1周で割った余りにする（floatに戻しても小さい値のまま）
+        auto scrollOffset = [this](float speed, uint32_t size) {
+            return static_cast<float>(std::fmod(static_cast<double>(speed) * time_, static_cast<double>(size)));
+        };
+        const float offsetX = scrollOffset(field.scroll.x, volume->GetSizeX());
+        const float offsetY = scrollOffset(field.scroll.y, volume->GetSizeY());
+        const float offsetZ = scrollOffset(field.scroll.z, volume->GetSizeZ());
+
+#ifdef PARTICLE_SIMULATION_SSE2
+        const __m128 frequency4 = _mm_set1_ps(field.frequency);
+        const __m128 offsetX4 = _mm_set1_ps(offsetX);
+        const __m128 offsetY4 = _mm_set1_ps(offsetY);
+        const __m128 offsetZ4 = _mm_set1_ps(offsetZ);
+        const __m128 scale4 = _mm_set1_ps(scale);
+        for (; i + 4 <= count_; i += 4) {
+            Vector3x4 force = SampleVolume4<true>(*volume,
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&positionX_[i]), frequency4), offsetX4),
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&positionY_[i]), frequency4), offsetY4),
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&positionZ_[i]), frequency4), offsetZ4));
+            _mm_storeu_ps(&velocityX_[i], _mm_add_ps(_mm_loadu_ps(&velocityX_[i]), _mm_mul_ps(force.x, scale4)));
+            _mm_storeu_ps(&velocityY_[i], _mm_add_ps(_mm_loadu_ps(&velocityY_[i]), _mm_mul_ps(force.y, scale4)));
+            _mm_storeu_ps(&velocityZ_[i], _mm_add_ps(_mm_loadu_ps(&velocityZ_[i]), _mm_mul_ps(force.z, scale4)));
+        }
+#endif
+
+        for (; i < count_; ++i) {
+            Vector3 force = volume->Sample(
+                positionX_[i] * field.frequency + offsetX,
+                positionY_[i] * field.frequency + offsetY,
+                positionZ_[i] * field.frequency + offsetZ,
+                true);
+            velocityX_[i] += force.x * scale;
+            velocityY_[i] += force.y * scale;
+            velocityZ_[i] += force.z * scale;
+        }
+        return;
+    }
+
+    // 焼き込んだベクトル場は範囲内のパーティクルのみに働く
+    const Vector3& boundsMin = volume->GetBoundsMin();
+    const Vector3& boundsMax = volume->GetBoundsMax();
+
+#ifdef PARTICLE_SIMULATION_SSE2
+    const Vector3& worldToGrid = volume->GetWorldToGrid();
+    const __m128 minX = _mm_set1_ps(boundsMin.x);
+    const __m128 minY = _mm_set1_ps(boundsMin.y);
+    const __m128 minZ = _mm_set1_ps(boundsMin.z);
+    const __m128 maxX = _mm_set1_ps(boundsMax.x);
+    const __m128 maxY = _mm_set1_ps(boundsMax.y);
+    const __m128 maxZ = _mm_set1_ps(boundsMax.z);
+    const __m128 worldToGridX = _mm_set1_ps(worldToGrid.x);
+    const __m128 worldToGridY = _mm_set1_ps(worldToGrid.y);
+    const __m128 worldToGridZ = _mm_set1_ps(worldToGrid.z);
+    const __m128 scale4 = _mm_set1_ps(scale);
+    for (; i + 4 <= count_; i += 4) {
+        __m128 px = _mm_loadu_ps(&positionX_[i]);
+        __m128 py = _mm_loadu_ps(&positionY_[i]);
+        __m128 pz = _mm_loadu_ps(&positionZ_[i]);
+
+        // 範囲外のパーティクルは力を0にする（格子座標は端に丸めるので、読み込みは範囲内に収まる）
+        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(px, minX), _mm_cmple_ps(px, maxX)),
+            _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(py, minY), _mm_cmple_ps(py, maxY)),
+                _mm_and_ps(_mm_cmpge_ps(pz, minZ), _mm_cmple_ps(pz, maxZ))));
+        if (_mm_movemask_ps(inside) == 0) {
+            continue;
+        }
+        __m128 factor = _mm_and_ps(inside, scale4);
+
+        Vector3x4 force = SampleVolume4<false>(*volume,
+            _mm_mul_ps(_mm_sub_ps(px, minX), worldToGridX),
+            _mm_mul_ps(_mm_sub_ps(py, minY), worldToGridY),
+            _mm_mul_ps(_mm_sub_ps(pz, minZ), worldToGridZ));
+        _mm_storeu_ps(&velocityX_[i], _mm_add_ps(_mm_loadu_ps(&velocityX_[i]), _mm_mul_ps(force.x, factor)));
+        _mm_storeu_ps(&velocityY_[i], _mm_add_ps(_mm_loadu_ps(&velocityY_[i]), _mm_mul_ps(force.y, factor)));
+        _mm_storeu_ps(&velocityZ_[i], _mm_add_ps(_mm_loadu_ps(&velocityZ_[i]), _mm_mul_ps(force.z, factor)));
+    }
+#endif
+
+    for (; i < count_; ++i) {
+        Vector3 position = { positionX_[i], positionY_[i], positionZ_[i] };
+        if (position.x < boundsMin.x || position.y < boundsMin.y || position.z < boundsMin.z ||
+            position.x > boundsMax.x || position.y > boundsMax.y || position.z > boundsMax.z) {
+            continue;
+        }
+        Vector3 force = volume->SampleWorld(position, false);
+        velocityX_[i] += force.x * scale;
+        velocityY_[i] += force.y * scale;
+        velocityZ_[i] += force.z * scale;
+    }
+}
+
+void ParticleSimulation::Integrate(float deltaTime) {
+    uint32_t i = 0;
+
+#ifdef PARTICLE_SIMULATION_SSE2
+    const __m128 deltaTime4 = _mm_set1_ps(deltaTime);
+    for (; i + 4 <= count_; i += 4) {
+        // 速度に加速度を加算
+        __m128 vx = _mm_add_ps(_mm_loadu_ps(&velocityX_[i]), _mm_mul_ps(_mm_loadu_ps(&accelX_[i]), deltaTime4));
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(&velocityY_[i]), _mm_mul_ps(_mm_loadu_ps(&accelY_[i]), deltaTime4));
+        __m128 vz = _mm_add_ps(_mm_loadu_ps(&velocityZ_[i]), _mm_mul_ps(_mm_loadu_ps(&accelZ_[i]), deltaTime4));
+        _mm_storeu_ps(&velocityX_[i], vx);
+        _mm_storeu_ps(&velocityY_[i], vy);
+        _mm_storeu_ps(&velocityZ_[i], vz);
+
+        // 位置に速度を加算
+        _mm_storeu_ps(&positionX_[i], _mm_add_ps(_mm_loadu_ps(&positionX_[i]), _mm_mul_ps(vx, deltaTime4)));
+        _mm_storeu_ps(&positionY_[i], _mm_add_ps(_mm_loadu_ps(&positionY_[i]), _mm_mul_ps(vy, deltaTime4)));
+        _mm_storeu_ps(&positionZ_[i], _mm_add_ps(_mm_loadu_ps(&positionZ_[i]), _mm_mul_ps(vz, deltaTime4)));
+
+        // 回転を更新
+        _mm_storeu_ps(&rotation_[i], _mm_add_ps(_mm_loadu_ps(&rotation_[i]),
+            _mm_mul_ps(_mm_loadu_ps(&rotationVelocity_[i]), deltaTime4)));
+    }
+#endif
+
+    for (; i < count_; ++i) {
+        // 速度に加速度を加算
+        velocityX_[i] += accelX_[i] * deltaTime;
+        velocityY_[i] += accelY_[i] * deltaTime;
+        velocityZ_[i] += accelZ_[i] * deltaTime;
+
+        // 位置に速度を加算
+        positionX_[i] += velocityX_[i] * deltaTime;
+        positionY_[i] += velocityY_[i] * deltaTime;
+        positionZ_[i] += velocityZ_[i] * deltaTime;
+
+        // 回転を更新
+        rotation_[i] += rotationVelocity_[i] * deltaTime;
+    }
+}
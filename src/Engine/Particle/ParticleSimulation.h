@@ -0,0 +1,159 @@
+#pragma once
+
+#include "Mymath.h"
+#include "ParticleForceField.h"
+#include <cstdint>
+#include <vector>
+
+// パーティクル発生パラメータ（各値は最小～最大の範囲で乱数決定）
+struct ParticleEmitParams {
+    Vector3 position = { 0.0f, 0.0f, 0.0f };
+    Vector3 velocityMin = { -1.0f, -1.0f, -1.0f };
+    Vector3 velocityMax = { 1.0f, 1.0f, 1.0f };
+    Vector3 accelMin = { 0.0f, 0.0f, 0.0f };
+    Vector3 accelMax = { 0.0f, -9.8f, 0.0f };
+    float startSizeMin = 0.5f;
+    float startSizeMax = 1.0f;
+    float endSizeMin = 0.0f;
+    float endSizeMax = 0.0f;
+    Vector4 startColorMin = { 1.0f, 1.0f, 1.0f, 1.0f };
+    Vector4 startColorMax = { 1.0f, 1.0f, 1.0f, 1.0f };
+    Vector4 endColorMin = { 1.0f, 1.0f, 1.0f, 0.0f };
+    Vector4 endColorMax = { 1.0f, 1.0f, 1.0f, 0.0f };
+    float rotationMin = 0.0f;
+    float rotationMax = 0.0f;
+    float rotationVelocityMin = 0.0f;
+    float rotationVelocityMax = 0.0f;
+    float lifeTimeMin = 1.0f;
+    float lifeTimeMax = 3.0f;
+};
+
+// 描画から切り離したパーティクルシミュレーション
+// DirectXに依存しないため、GPUなしでの計測（ベンチマーク）にも使用できる
+// データは要素ごとの配列（SoA）で保持し、容量は初期化時に確保して以降は確保しない
+class ParticleSimulation {
+public:
+    // 初期化（capacity個分の領域を確保し、乱数のシードを設定）
+    void Initialize(uint32_t capacity, uint32_t seed);
+
+    // パーティクルの発生（容量を超えた分は発生しない。発生した数を返す）
+    uint32_t Emit(const ParticleEmitParams& params, uint32_t count);
+
+    // 更新（寿命の尽きたパーティクルは末尾と入れ替えて削除）
+    void Update(float deltaTime);
+
+    // 全パーティクルの削除
+    void Clear() { count_ = 0; }
+
+    // 乱数のシードを再設定
+    void SetSeed(uint32_t seed);
+
+    // 力場の追加・削除（Updateで全パーティクルに適用される）
+    void AddForceField(const ParticleForceField& field) { forceFields_.push_back(field); }
+    void ClearForceFields() { forceFields_.clear(); }
+    const std::vector<ParticleForceField>& GetForceFields() const { return forceFields_; }
+
+    // 軌跡（過去の座標の履歴）の有効化（lengthは保持する座標数、0で無効）
+    void EnableTrail(uint32_t length);
+
+    // 軌跡の保持数の取得（0なら無効）
+    uint32_t GetTrailLength() const { return trailLength_; }
+
+    // index番目のパーティクルの軌跡に記録されている座標数
+    uint32_t GetTrailCount(uint32_t index) const { return trailCount_[index]; }
+
+    // index番目のパーティクルのage番目に新しい座標（0が現在位置）
+    const Vector3& GetTrailPosition(uint32_t index, uint32_t age) const {
+        uint32_t slot = (trailHead_[index] + trailLength_ - age) % trailLength_;
+        return trail_[static_cast<size_t>(index) * trailLength_ + slot];
+    }
+
+    // 生存パーティクル数の取得
+    uint32_t GetCount() const { return count_; }
+
+    // 容量の取得
+    uint32_t GetCapacity() const { return capacity_; }
+
+    // 各要素の配列の取得（GetCount()個が有効）
+    const float* GetPositionX() const { return positionX_.data(); }
+    const float* GetPositionY() const { return positionY_.data(); }
+    const float* GetPositionZ() const { return positionZ_.data(); }
+    const float* GetSize() const { return size_.data(); }
+    const float* GetRotation() const { return rotation_.data(); }
+    const float* GetColorR() const { return colorR_.data(); }
+    const float* GetColorG() const { return colorG_.data(); }
+    const float* GetColorB() const { return colorB_.data(); }
+    const float* GetColorA() const { return colorA_.data(); }
+
+private:
+    // [0, 1)の乱数（実装に依存しない決定的な乱数）
+    float NextRandom();
+
+    // min～maxの乱数
+    float RandomRange(float min, float max) { return min + (max - min) * NextRandom(); }
+
+    // index番目の要素を末尾の要素で上書き
+    void MoveParticle(uint32_t dst, uint32_t src);
+
+    // 力場による速度の変化を適用
+    void ApplyForceField(const ParticleForceField& field, float deltaTime);
+    void ApplyGravityWell(const ParticleForceField& field, float deltaTime);
+    void ApplyDrag(const ParticleForceField& field, float deltaTime);
+    void ApplyVortex(const ParticleForceField& field, float deltaTime);
+    void ApplyVolume(const ParticleForceField& field, float deltaTime);
+
+    // 加速度・速度・回転の積分
+    void Integrate(float deltaTime);
+
+    // 現在位置を軌跡に記録
+    void RecordTrail(uint32_t index);
+
+    // 容量と生存数
+    uint32_t capacity_ = 0;
+    uint32_t count_ = 0;
+
+    // 乱数の状態
+    uint32_t randomState_ = 1;
+
+    // シミュレーション開始からの経過時間（ノイズのスクロール用。長時間動かしても精度が落ちないようにdouble）
+    double time_ = 0.0;
+
+    // 力場
+    std::vector<ParticleForceField> forceFields_;
+
+    // 座標
+    std::vector<float> positionX_;
+    std::vector<float> positionY_;
+    std::vector<float> positionZ_;
+    // 速度
+    std::vector<float> velocityX_;
+    std::vector<float> velocityY_;
+    std::vector<float> velocityZ_;
+    // 加速度
+    std::vector<float> accelX_;
+    std::vector<float> accelY_;
+    std::vector<float> accelZ_;
+    // サイズ（現在・初期・最終）
+    std::vector<float> size_;
+    std::vector<float> startSize_;
+    std::vector<float> endSize_;
+    // 回転と回転速度
+    std::vector<float> rotation_;
+    std::vector<float> rotationVelocity_;
+    // 色（現在・初期・最終）
+    std::vector<float> colorR_;
+    std::vector<float> colorG_;
+    std::vector<float> colorB_;
+    std::vector<float> colorA_;
+    std::vector<Vector4> startColor_;
+    std::vector<Vector4> endColor_;
+    // 経過時間と寿命
+    std::vector<float> lifeTime_;
+    std::vector<float> lifeTimeMax_;
+
+    // 軌跡（パーティクルごとにtrailLength_個のリングバッファ）
+    uint32_t trailLength_ = 0;
+    std::vector<Vector3> trail_;
+    std::vector<uint32_t> trailHead_;
+    std::vector<uint32_t> trailCount_;
+};
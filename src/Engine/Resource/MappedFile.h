@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// 読み取り専用でメモリにマップしたファイル
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { Close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 開いてマップする（空のファイルは失敗）
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return data_ != nullptr; }
+    std::span<const uint8_t> GetBytes() const { return { data_, size_ }; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
@@ -0,0 +1,310 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+namespace {
+    Vector3 ToVector3(const Vector4& v) { return { v.x, v.y, v.z }; }
+
+    Vector3 Cross(const Vector3& a, const Vector3& b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    float Dot(const Vector3& a, const Vector3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    // FIFOの頂点キャッシュ（ミスのたびに時刻を進め、最後に入れた時刻がcacheSize以上前なら追い出されている）
+    class VertexCacheSimulator {
+    public:
+        VertexCacheSimulator(size_t vertexCount, uint32_t cacheSize) : cacheTimes_(vertexCount, 0), time_(cacheSize + 1), cacheSize_(cacheSize) {}
+
+        // ミスならtrue
+        bool Access(uint32_t vertex) {
+            if (time_ - cacheTimes_[vertex] > cacheSize_) {
+                cacheTimes_[vertex] = time_++;
+                return true;
+            }
+            return false;
+        }
+
+        // 空にする
+        void Flush() { time_ += cacheSize_ + 1; }
+
+    private:
+        std::vector<uint32_t> cacheTimes_;
+        uint32_t time_;
+        uint32_t cacheSize_;
+    };
+}
+
+VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+    VertexCacheStatistics statistics;
+    VertexCacheSimulator cache(vertexCount, cacheSize);
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    uint32_t referencedCount = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        uint32_t vertex = indices[i];
+        assert(vertex < vertexCount);
+        statistics.transformedVertexCount += cache.Access(vertex) ? 1 : 0;
+        referencedCount += referenced[vertex] ? 0 : 1;
+        referenced[vertex] = 1;
+    }
+    size_t triangleCount = indexCount / 3;
+    statistics.acmr = triangleCount ? static_cast<float>(statistics.transformedVertexCount) / static_cast<float>(triangleCount) : 0.0f;
+    statistics.atvr = referencedCount ? static_cast<float>(statistics.transformedVertexCount) / static_cast<float>(referencedCount) : 0.0f;
+    return statistics;
+}
+
+void OptimizeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>& outIndices,
+    std::vector<uint32_t>* outClusterStarts) {
+    const size_t triangleCount = indexCount / 3;
+    outIndices.clear();
+    outIndices.reserve(triangleCount * 3);
+    if (outClusterStarts) {
+        outClusterStarts->clear();
+    }
+
+    // 頂点ごとの隣接する三角形（liveCountsはまだ出力していない三角形の数）
+    std::vector<uint32_t> liveCounts(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) {
+        ++liveCounts[indices[i]];
+    }
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveCounts[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            adjacency[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> cacheTimes(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    std::vector<uint32_t> deadEnds;  // 最近使った頂点（隣接する三角形が残っていれば次の扇の中心の候補）
+    std::vector<uint32_t> candidates;
+    size_t scanCursor = 0;
+
+    // 隣接する三角形が残る頂点を、最近使ったものから、なければ頂点番号の順に探す
+    auto skipDeadEnd = [&]() -> int64_t {
+        while (!deadEnds.empty()) {
+            uint32_t vertex = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveCounts[vertex] > 0) {
+                return vertex;
+            }
+        }
+        for (; scanCursor < vertexCount; ++scanCursor) {
+            if (liveCounts[scanCursor] > 0) {
+                return static_cast<int64_t>(scanCursor++);
+            }
+        }
+        return -1;
+    };
+
+    int64_t fan = skipDeadEnd();
+    if (fan >= 0 && outClusterStarts) {
+        outClusterStarts->push_back(0);
+    }
+    while (fan >= 0) {
+        // 扇の中心の頂点に隣接する三角形をすべて出力する
+        candidates.clear();
+        for (uint32_t a = adjacencyOffsets[fan]; a < adjacencyOffsets[fan + 1]; ++a) {
+            uint32_t triangle = adjacency[a];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = 1;
+            for (uint32_t k = 0; k < 3; ++k) {
+                uint32_t vertex = indices[triangle * 3 + k];
+                outIndices.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                --liveCounts[vertex];
+                if (time - cacheTimes[vertex] > cacheSize) {
+                    cacheTimes[vertex] = time++;
+                }
+            }
+        }
+
+        // 次の扇を広げてもキャッシュに残っている頂点のうち、最も古いものを選ぶ
+        int64_t best = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t vertex : candidates) {
+            if (liveCounts[vertex] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            if (time - cacheTimes[vertex] + 2 * liveCounts[vertex] <= cacheSize) {
+                priority = time - cacheTimes[vertex];
+            }
+            if (priority > bestPriority) {
+                best = vertex;
+                bestPriority = priority;
+            }
+        }
+        if (best < 0) {
+            best = skipDeadEnd();
+            if (best >= 0 && outClusterStarts) {
+                outClusterStarts->push_back(static_cast<uint32_t>(outIndices.size() / 3));
+            }
+        }
+        fan = best;
+    }
+}
+
+uint32_t OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<VertexData>& vertices, const std::vector<uint32_t>& clusterStarts,
+    uint32_t cacheSize, float threshold) {
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0) {
+        return 0;
+    }
+
+    // 隣り合わない位置へ移った所に加え、クラスタの中のACMRが全体に近づいた所でも区切る
+    const float meanAcmr = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size(), cacheSize).acmr;
+    std::vector<uint32_t> starts;
+    VertexCacheSimulator cache(vertices.size(), cacheSize);
+    for (size_t c = 0; c < clusterStarts.size(); ++c) {
+        uint32_t end = c + 1 < clusterStarts.size() ? clusterStarts[c + 1] : triangleCount;
+        uint32_t start = clusterStarts[c];
+        uint32_t misses = 0;
+        cache.Flush();
+        starts.push_back(start);
+        for (uint32_t t = start; t < end; ++t) {
+            for (uint32_t k = 0; k < 3; ++k) {
+                misses += cache.Access(indices[t * 3 + k]) ? 1 : 0;
+            }
+            if (t + 1 < end && static_cast<float>(misses) <= threshold * meanAcmr * static_cast<float>(t - start + 1)) {
+                start = t + 1;
+                misses = 0;
+                cache.Flush();
+                starts.push_back(start);
+            }
+        }
+    }
+    const uint32_t clusterCount = static_cast<uint32_t>(starts.size());
+
+    // クラスタごとの面積で重み付けした重心と法線（出力の巻き順で外向き）
+    struct Cluster {
+        uint32_t start;
+        uint32_t end;
+        Vector3 centroid;
+        Vector3 normal;
+        float area;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters(clusterCount);
+    Vector3 meshCentroid = { 0.0f, 0.0f, 0.0f };
+    float meshArea = 0.0f;
+    for (uint32_t c = 0; c < clusterCount; ++c) {
+        Cluster& cluster = clusters[c];
+        cluster = { starts[c], c + 1 < clusterCount ? starts[c + 1] : triangleCount, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, 0.0f, 0.0f };
+        for (uint32_t t = cluster.start; t < cluster.end; ++t) {
+            Vector3 p0 = ToVector3(vertices[indices[t * 3 + 0]].position);
+            Vector3 p1 = ToVector3(vertices[indices[t * 3 + 1]].position);
+            Vector3 p2 = ToVector3(vertices[indices[t * 3 + 2]].position);
+            Vector3 normal = Cross(p1 - p0, p2 - p0);
+            float area = std::sqrt(Dot(normal, normal));
+            cluster.centroid += (p0 + p1 + p2) * (area / 3.0f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+        meshCentroid += cluster.centroid;
+        meshArea += cluster.area;
+        if (cluster.area > 0.0f) {
+            cluster.centroid /= cluster.area;
+        }
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid /= meshArea;
+    }
+
+    // 外側を向いたクラスタほど手前のものを隠しやすいので先に描く
+    for (Cluster& cluster : clusters) {
+        float length = std::sqrt(Dot(cluster.normal, cluster.normal));
+        cluster.sortKey = length > 0.0f ? Dot(cluster.centroid - meshCentroid, cluster.normal) / length : 0.0f;
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (const Cluster& cluster : clusters) {
+        sorted.insert(sorted.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3);
+    }
+    indices = std::move(sorted);
+    return clusterCount;
+}
+
+uint32_t OptimizeVertexFetch(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices, std::vector<uint32_t>* outRemap) {
+    std::vector<uint32_t> remap(vertices.size(), kUnusedVertex);
+    uint32_t nextVertex = 0;
+    for (uint32_t& index : indices) {
+        if (remap[index] == kUnusedVertex) {
+            remap[index] = nextVertex++;
+        }
+        index = remap[index];
+    }
+    std::vector<VertexData> reordered(nextVertex);
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        if (remap[i] != kUnusedVertex) {
+            reordered[remap[i]] = vertices[i];
+        }
+    }
+    vertices = std::move(reordered);
+    if (outRemap) {
+        *outRemap = std::move(remap);
+    }
+    return nextVertex;
+}
+
+MeshOptimizeStatistics OptimizeMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices, const MeshOptimizeSettings& settings,
+    std::vector<uint32_t>* outRemap, const uint64_t* weldKeys) {
+    MeshOptimizeStatistics statistics;
+    statistics.inputVertexCount = static_cast<uint32_t>(vertices.size());
+
+    // インデックスがなければ頂点を順に描いていたものとして数える
+    if (indices.empty()) {
+        indices.resize(vertices.size() - vertices.size() % 3);
+        std::iota(indices.begin(), indices.end(), 0u);
+    }
+    indices.resize(indices.size() - indices.size() % 3);
+    statistics.before = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size(), settings.cacheSize);
+
+    // 1. 溶接
+    std::vector<uint32_t> weldRemap;
+    if (settings.weld) {
+        WeldMesh(vertices, indices, settings.weldSettings, &weldRemap, weldKeys);
+    }
+
+    // 2. 頂点キャッシュ
+    std::vector<uint32_t> optimized;
+    std::vector<uint32_t> clusterStarts;
+    OptimizeVertexCache(indices.data(), indices.size(), vertices.size(), settings.cacheSize, optimized, &clusterStarts);
+    indices = std::move(optimized);
+
+    // 3. オーバードロー
+    statistics.clusterCount = static_cast<uint32_t>(clusterStarts.size());
+    if (settings.overdrawThreshold > 0.0f) {
+        statistics.clusterCount = OptimizeOverdraw(indices, vertices, clusterStarts, settings.cacheSize, settings.overdrawThreshold);
+    }
+
+    // 4. 頂点の取得
+    std::vector<uint32_t> fetchRemap;
+    OptimizeVertexFetch(vertices, indices, &fetchRemap);
+
+    if (outRemap) {
+        outRemap->resize(statistics.inputVertexCount);
+        for (uint32_t i = 0; i < statistics.inputVertexCount; ++i) {
+            uint32_t welded = settings.weld ? weldRemap[i] : i;
+            (*outRemap)[i] = fetchRemap[welded];
+        }
+    }
+
+    statistics.outputVertexCount = static_cast<uint32_t>(vertices.size());
+    statistics.triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    statistics.after = AnalyzeVertexCache(indices.data(), indices.size(), vertices.size(), settings.cacheSize);
+    return statistics;
+}
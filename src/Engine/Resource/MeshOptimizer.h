@@ -0,0 +1,63 @@
+#pragma once
+#include "Mymath.h"
+#include "VertexWeld.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// インポート時のメッシュの最適化（三角形リストのインデックスの並べ替え）
+// 1. 溶接：同じ頂点をまとめてインデックスバッファにする（VertexWeld）
+// 2. 頂点キャッシュ：Tipsify（Sander et al. 2007）で、変換済みの頂点を使い回せる順に三角形を並べる
+// 3. オーバードロー：Tipsifyの結果をクラスタに分け、外側を向いたクラスタから描くように並べ替える
+//    （クラスタの中の順序は保つので、キャッシュの効率はほぼ変わらない）
+// 4. 頂点の取得：インデックスで最初に参照される順に頂点を並べ直し、使われない頂点を除く
+// 三角形の集合と各三角形の頂点の順序（巻き順）は変えない
+
+// 頂点キャッシュの効率（FIFOのキャッシュで数える）
+struct VertexCacheStatistics {
+    uint32_t transformedVertexCount = 0;  // 頂点シェーダーの実行回数（キャッシュミスの数）
+    float acmr = 0.0f;                    // 三角形あたりの実行回数（0.5～3。小さいほどよい）
+    float atvr = 0.0f;                    // 頂点あたりの実行回数（1が最小）
+};
+
+// 三角形リストのインデックスの頂点キャッシュの効率を数える
+VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16);
+
+// Tipsifyで三角形を並べ替える。outClusterStartsには、前の三角形と隣り合わない位置へ移った三角形の番号を入れる（先頭の0を含む）
+void OptimizeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>& outIndices,
+    std::vector<uint32_t>* outClusterStarts = nullptr);
+
+// Tipsifyの結果をクラスタに分け、外側を向いたクラスタが先になるように並べ替える
+// threshold：クラスタの中のACMRが全体のthreshold倍以下になったところでも区切る（大きいほど細かく分かれ、オーバードローは減るがキャッシュの効率は落ちる）
+// 戻り値はクラスタの数
+uint32_t OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<VertexData>& vertices, const std::vector<uint32_t>& clusterStarts,
+    uint32_t cacheSize, float threshold);
+
+// 最初に参照される順に頂点を並べ直し、インデックスを付け替える。outRemap[元の頂点] = 新しい頂点（使われなければkUnusedVertex）
+// 戻り値は残った頂点の数
+const uint32_t kUnusedVertex = 0xFFFFFFFFu;
+uint32_t OptimizeVertexFetch(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices, std::vector<uint32_t>* outRemap = nullptr);
+
+// 最適化の設定
+struct MeshOptimizeSettings {
+    bool weld = true;                  // 溶接する（スキンメッシュなど頂点ごとに別のデータを持つ場合は、そのデータをweldKeysに渡すか、falseにして元の頂点をそのまま使う）
+    VertexWeldSettings weldSettings;   // 既定は完全に一致する頂点のみ
+    uint32_t cacheSize = 16;           // 想定する頂点キャッシュの大きさ
+    float overdrawThreshold = 1.05f;   // 0ならオーバードローの並べ替えをしない
+};
+
+// 最適化の結果
+struct MeshOptimizeStatistics {
+    uint32_t inputVertexCount = 0;
+    uint32_t outputVertexCount = 0;
+    uint32_t triangleCount = 0;
+    uint32_t clusterCount = 0;
+    VertexCacheStatistics before;  // 入力のまま描いた場合（インデックスがなければ頂点を順に描いた場合）
+    VertexCacheStatistics after;
+};
+
+// メッシュをまとめて最適化する。indicesが空なら頂点を3つずつの三角形とみなす
+// outRemap[元の頂点] = 新しい頂点（使われなければkUnusedVertex）。ボーンウェイトなど頂点ごとの別のデータの付け替えに使う
+// weldKeysは溶接の追加のキー（元の頂点ごと。VertexWelder::Weldを参照）。キーが違う頂点はまとめない
+MeshOptimizeStatistics OptimizeMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices, const MeshOptimizeSettings& settings = {},
+    std::vector<uint32_t>* outRemap = nullptr, const uint64_t* weldKeys = nullptr);
@@ -0,0 +1,437 @@
+#include "ModelCache.h"
+#include "CompiledAnimationClip.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    const uint32_t kMagic = 0x48434D55;      // "UMCH"
+    const uint32_t kEndMarker = 0x444E4555;  // "UEND"
+    const size_t kArrayAlignment = 16;
+
+    // ファイルの先頭（本体の配列の位置はファイルの先頭からの16バイト境界）
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t kind;
+        uint32_t layout;      // そのまま書き出す構造体の大きさのハッシュ（コンパイラ・構造体の変更を検出する）
+        uint64_t sourceHash;
+        uint64_t fileSize;
+    };
+
+    uint32_t CalculateLayoutHash() {
+        const uint32_t sizes[] = {
+            sizeof(VertexData), sizeof(VertexWeightData), sizeof(MaterialTemplate), sizeof(Matrix4x4), sizeof(Transform),
+            sizeof(decltype(Joint::transform)), sizeof(KeyframeVector3), sizeof(KeyframeQuaternion), sizeof(wchar_t),
+        };
+        return static_cast<uint32_t>(HashBytes(sizes, sizeof(sizes)));
+    }
+
+    // 書き出し（配列は要素数の後に16バイト境界へそろえて置く）
+    class CacheWriter {
+    public:
+        template <typename T>
+        void Write(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Append(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void WriteArray(const T* data, size_t count) {
+            static_assert(std::is_trivially_copyable_v<T> && alignof(T) <= kArrayAlignment);
+            Write<uint64_t>(count);
+            bytes_.resize((bytes_.size() + kArrayAlignment - 1) & ~(kArrayAlignment - 1), 0);
+            Append(data, count * sizeof(T));
+        }
+
+        template <typename T>
+        void WriteArray(const std::vector<T>& values) { WriteArray(values.data(), values.size()); }
+
+        void WriteString(std::string_view text) {
+            Write<uint32_t>(static_cast<uint32_t>(text.size()));
+            Append(text.data(), text.size());
+        }
+
+        std::vector<uint8_t>& GetBytes() { return bytes_; }
+
+    private:
+        void Append(const void* data, size_t size) {
+            const uint8_t* begin = static_cast<const uint8_t*>(data);
+            bytes_.insert(bytes_.end(), begin, begin + size);
+        }
+
+        std::vector<uint8_t> bytes_;
+    };
+
+    // マップした領域からの読み出し（範囲外を読もうとしたら以降はすべて失敗する）
+    class CacheReader {
+    public:
+        explicit CacheReader(std::span<const uint8_t> bytes) : bytes_(bytes) {}
+
+        bool IsValid() const { return valid_; }
+        bool IsAtEnd() const { return offset_ == bytes_.size(); }
+        void Fail() { valid_ = false; }
+
+        template <typename T>
+        T Read() {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value{};
+            if (const uint8_t* data = Take(sizeof(T))) {
+                std::memcpy(&value, data, sizeof(T));
+            }
+            return value;
+        }
+
+        // 配列はコピーせずにマップした領域を指す
+        template <typename T>
+        std::span<const T> ReadArray() {
+            uint64_t count = Read<uint64_t>();
+            offset_ = (offset_ + kArrayAlignment - 1) & ~(kArrayAlignment - 1);
+            if (!valid_ || offset_ > bytes_.size() || count > (bytes_.size() - offset_) / sizeof(T)) {
+                valid_ = false;
+                return {};
+            }
+            const uint8_t* data = Take(static_cast<size_t>(count) * sizeof(T));
+            return { reinterpret_cast<const T*>(data), static_cast<size_t>(count) };
+        }
+
+        template <typename T>
+        void ReadArray(std::vector<T>& outValues) {
+            std::span<const T> values = ReadArray<T>();
+            outValues.assign(values.begin(), values.end());
+        }
+
+        std::string_view ReadString() {
+            uint32_t size = Read<uint32_t>();
+            const uint8_t* data = Take(size);
+            return data ? std::string_view(reinterpret_cast<const char*>(data), size) : std::string_view();
+        }
+
+        // 要素数として読んだ値が残りのバイト数を超えていれば壊れている
+        uint64_t ReadCount() {
+            uint64_t count = Read<uint64_t>();
+            if (count > bytes_.size() - offset_) {
+                valid_ = false;
+                return 0;
+            }
+            return count;
+        }
+
+    private:
+        const uint8_t* Take(size_t size) {
+            if (!valid_ || size > bytes_.size() - offset_) {
+                valid_ = false;
+                return nullptr;
+            }
+            const uint8_t* data = bytes_.data() + offset_;
+            offset_ += size;
+            return data;
+        }
+
+        std::span<const uint8_t> bytes_;
+        size_t offset_ = 0;
+        bool valid_ = true;
+    };
+
+    void WriteMaterial(CacheWriter& writer, const MaterialData& material) {
+        writer.WriteString(material.textureFilePath);
+        writer.Write(material.ambient);
+        writer.Write(material.diffuse);
+        writer.Write(material.specular);
+        writer.Write(material.shininess);
+        writer.Write(material.alpha);
+        writer.Write(material.textureScale);
+        writer.Write(material.textureOffset);
+        writer.Write<uint8_t>(material.isPBR);
+        writer.Write(material.baseColorFactor);
+        writer.Write(material.metallicFactor);
+        writer.Write(material.roughnessFactor);
+        writer.Write(material.normalScale);
+        writer.Write(material.occlusionStrength);
+        writer.Write(material.emissiveFactor);
+        writer.Write(material.alphaCutoff);
+        writer.WriteString(material.alphaMode);
+        writer.Write<uint8_t>(material.doubleSided);
+    }
+
+    void ReadMaterial(CacheReader& reader, MaterialData& material) {
+        material.textureFilePath = reader.ReadString();
+        material.ambient = reader.Read<Vector4>();
+        material.diffuse = reader.Read<Vector4>();
+        material.specular = reader.Read<Vector4>();
+        material.shininess = reader.Read<float>();
+        material.alpha = reader.Read<float>();
+        material.textureScale = reader.Read<Vector2>();
+        material.textureOffset = reader.Read<Vector2>();
+        material.isPBR = reader.Read<uint8_t>() != 0;
+        material.baseColorFactor = reader.Read<Vector4>();
+        material.metallicFactor = reader.Read<float>();
+        material.roughnessFactor = reader.Read<float>();
+        material.normalScale = reader.Read<float>();
+        material.occlusionStrength = reader.Read<float>();
+        material.emissiveFactor = reader.Read<Vector3>();
+        material.alphaCutoff = reader.Read<float>();
+        material.alphaMode = reader.ReadString();
+        material.doubleSided = reader.Read<uint8_t>() != 0;
+    }
+
+    void WriteSkinClusterData(CacheWriter& writer, const std::map<std::string, JointWeightData>& skinClusterData) {
+        writer.Write<uint64_t>(skinClusterData.size());
+        for (const auto& [name, jointWeight] : skinClusterData) {
+            writer.WriteString(name);
+            writer.Write(jointWeight.inverseBindPoseMatrix);
+            writer.WriteArray(jointWeight.vertexWeights);
+        }
+    }
+
+    void ReadSkinClusterData(CacheReader& reader, std::map<std::string, JointWeightData>& skinClusterData) {
+        skinClusterData.clear();
+        uint64_t count = reader.ReadCount();
+        for (uint64_t i = 0; i < count && reader.IsValid(); ++i) {
+            JointWeightData& jointWeight = skinClusterData[std::string(reader.ReadString())];
+            jointWeight.inverseBindPoseMatrix = reader.Read<Matrix4x4>();
+            reader.ReadArray(jointWeight.vertexWeights);
+        }
+    }
+
+    void WriteModelData(CacheWriter& writer, const ModelData& modelData) {
+        writer.WriteArray(modelData.vertices);
+        writer.WriteArray(modelData.indices);
+        writer.Write(modelData.rootTransform);
+        WriteMaterial(writer, modelData.material);
+        WriteSkinClusterData(writer, modelData.skinClusterData);
+
+        writer.Write<uint64_t>(modelData.matVertexData.size());
+        for (const auto& [name, matVertexData] : modelData.matVertexData) {
+            writer.WriteArray(name.data(), name.size());
+            writer.Write<uint64_t>(matVertexData.materialIndex);
+            writer.WriteArray(matVertexData.vertices);
+            writer.WriteArray(matVertexData.indices);
+            WriteSkinClusterData(writer, matVertexData.skinClusterData);
+        }
+
+        writer.Write<uint64_t>(modelData.materials.size());
+        for (const MaterialData& material : modelData.materials) {
+            WriteMaterial(writer, material);
+        }
+        writer.WriteArray(modelData.materialTemplates);
+    }
+
+    void ReadModelData(CacheReader& reader, ModelData& modelData) {
+        reader.ReadArray(modelData.vertices);
+        reader.ReadArray(modelData.indices);
+        modelData.rootTransform = reader.Read<Transform>();
+        ReadMaterial(reader, modelData.material);
+        ReadSkinClusterData(reader, modelData.skinClusterData);
+
+        modelData.matVertexData.clear();
+        uint64_t meshCount = reader.ReadCount();
+        for (uint64_t i = 0; i < meshCount && reader.IsValid(); ++i) {
+            std::span<const wchar_t> name = reader.ReadArray<wchar_t>();
+            MaterialVertexData& matVertexData = modelData.matVertexData[std::wstring(name.begin(), name.end())];
+            matVertexData.materialIndex = static_cast<size_t>(reader.Read<uint64_t>());
+            reader.ReadArray(matVertexData.vertices);
+            reader.ReadArray(matVertexData.indices);
+            ReadSkinClusterData(reader, matVertexData.skinClusterData);
+        }
+
+        modelData.materials.clear();
+        uint64_t materialCount = reader.ReadCount();
+        for (uint64_t i = 0; i < materialCount && reader.IsValid(); ++i) {
+            ReadMaterial(reader, modelData.materials.emplace_back());
+        }
+        reader.ReadArray(modelData.materialTemplates);
+    }
+
+    // ジョイントは番号順（親が先）に、子の一覧と名前の辞書を除いて書き出す
+    void WriteSkeleton(CacheWriter& writer, const Skeleton& skeleton) {
+        writer.Write<int32_t>(skeleton.joints.empty() ? -1 : skeleton.root);
+        writer.Write<uint64_t>(skeleton.joints.size());
+        for (const Joint& joint : skeleton.joints) {
+            writer.WriteString(joint.name);
+            writer.Write(joint.transform);
+            writer.Write(joint.localMatrix);
+            writer.Write<int32_t>(joint.parent ? *joint.parent : -1);
+        }
+    }
+
+    void ReadSkeleton(CacheReader& reader, Skeleton& skeleton) {
+        skeleton = Skeleton{};
+        skeleton.root = reader.Read<int32_t>();
+        uint64_t jointCount = reader.ReadCount();
+        skeleton.joints.resize(static_cast<size_t>(jointCount));
+        for (int32_t i = 0; i < static_cast<int32_t>(jointCount) && reader.IsValid(); ++i) {
+            Joint& joint = skeleton.joints[i];
+            joint.name = reader.ReadString();
+            joint.transform = reader.Read<decltype(Joint::transform)>();
+            joint.localMatrix = reader.Read<Matrix4x4>();
+            joint.skeletonSpaceMatrix = MakeIdentity4x4();
+            joint.index = i;
+            int32_t parent = reader.Read<int32_t>();
+            if (parent >= i) {
+                // 親が後ろにあるのは壊れている
+                reader.Fail();
+                return;
+            }
+            if (parent >= 0) {
+                joint.parent = parent;
+                skeleton.joints[parent].children.push_back(i);
+            }
+            skeleton.jointMap.emplace(joint.name, i);
+        }
+    }
+
+    void WriteAnimation(CacheWriter& writer, const Animation& animation) {
+        writer.Write(animation.duration);
+        writer.Write<uint64_t>(animation.nodeAnimations.size());
+        for (const auto& [name, nodeAnimation] : animation.nodeAnimations) {
+            writer.WriteString(name);
+            writer.WriteArray(nodeAnimation.translate);
+            writer.WriteArray(nodeAnimation.rotate);
+            writer.WriteArray(nodeAnimation.scale);
+        }
+    }
+
+    void ReadAnimation(CacheReader& reader, Animation& animation) {
+        animation.duration = reader.Read<float>();
+        animation.nodeAnimations.clear();
+        animation.events.Clear();
+        uint64_t nodeCount = reader.ReadCount();
+        for (uint64_t i = 0; i < nodeCount && reader.IsValid(); ++i) {
+            NodeAnimation& nodeAnimation = animation.nodeAnimations[std::string(reader.ReadString())];
+            reader.ReadArray(nodeAnimation.translate);
+            reader.ReadArray(nodeAnimation.rotate);
+            reader.ReadArray(nodeAnimation.scale);
+        }
+    }
+
+    bool EndsWithNoCase(std::string_view text, std::string_view suffix) {
+        return text.size() >= suffix.size() &&
+            std::equal(suffix.begin(), suffix.end(), text.end() - suffix.size(), [](char a, char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            });
+    }
+}
+
+uint64_t HashModelSource(const std::string& directoryPath, const std::string& filename) {
+    MappedFile file;
+    if (!file.Open(directoryPath + "/" + filename)) {
+        return 0;
+    }
+    std::span<const uint8_t> bytes = file.GetBytes();
+    uint64_t hash = HashBytes(bytes.data(), bytes.size());
+    if (!EndsWithNoCase(filename, ".gltf")) {
+        return hash;
+    }
+
+    // "uri": "xxx.bin" のバッファも含める（data:の埋め込みは本体に含まれる。テクスチャの画像はModelDataに入らないので除く）
+    std::string_view text(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    size_t position = 0;
+    while ((position = text.find("\"uri\"", position)) != std::string_view::npos) {
+        size_t begin = text.find('"', text.find(':', position + 5));
+        size_t end = begin == std::string_view::npos ? begin : text.find('"', begin + 1);
+        if (end == std::string_view::npos) {
+            break;
+        }
+        std::string_view uri = text.substr(begin + 1, end - begin - 1);
+        position = end + 1;
+        if (uri.starts_with("data:") || !EndsWithNoCase(uri, ".bin")) {
+            continue;
+        }
+        MappedFile buffer;
+        if (!buffer.Open(directoryPath + "/" + std::string(uri))) {
+            return 0;
+        }
+        hash = HashBytes(buffer.GetBytes().data(), buffer.GetBytes().size(), hash);
+    }
+    return hash;
+}
+
+std::string GetModelCachePath(const std::string& directoryPath, const std::string& filename, ModelCacheKind kind) {
+    return directoryPath + "/" + filename + (kind == ModelCacheKind::AnimatedMesh ? ".skin" : ".mesh") + ".modelcache";
+}
+
+bool WriteModelCache(const std::string& path, ModelCacheKind kind, uint64_t sourceHash, const ModelData& modelData,
+    const ModelCacheAnimation* animation) {
+
+    CacheWriter writer;
+    FileHeader header{ kMagic, kModelCacheVersion, static_cast<uint32_t>(kind), CalculateLayoutHash(), sourceHash, 0 };
+    writer.Write(header);
+    WriteModelData(writer, modelData);
+    if (kind == ModelCacheKind::AnimatedMesh) {
+        ModelCacheAnimation empty;
+        const ModelCacheAnimation& value = animation ? *animation : empty;
+        WriteSkeleton(writer, value.skeleton);
+        writer.WriteString(value.rootNodeName);
+        writer.Write<uint8_t>(value.animation.has_value());
+        if (value.animation) {
+            WriteAnimation(writer, *value.animation);
+        }
+    }
+    writer.Write(kEndMarker);
+
+    std::vector<uint8_t>& bytes = writer.GetBytes();
+    header.fileSize = bytes.size();
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    // 書き込み途中のファイルを読まないように、一時ファイルに書いてから置き換える
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool ReadModelCache(const std::string& path, ModelCacheKind kind, uint64_t sourceHash, ModelData& outModelData,
+    ModelCacheAnimation* outAnimation) {
+
+    MappedFile file;
+    if (!file.Open(path)) {
+        return false;
+    }
+    CacheReader reader(file.GetBytes());
+    FileHeader header = reader.Read<FileHeader>();
+    if (!reader.IsValid() || header.magic != kMagic || header.version != kModelCacheVersion ||
+        header.kind != static_cast<uint32_t>(kind) || header.layout != CalculateLayoutHash() ||
+        header.sourceHash != sourceHash || header.fileSize != file.GetBytes().size()) {
+        return false;
+    }
+
+    ModelData modelData;
+    ModelCacheAnimation animation;
+    ReadModelData(reader, modelData);
+    if (kind == ModelCacheKind::AnimatedMesh) {
+        ReadSkeleton(reader, animation.skeleton);
+        animation.rootNodeName = reader.ReadString();
+        if (reader.Read<uint8_t>() != 0) {
+            ReadAnimation(reader, animation.animation.emplace());
+        }
+    }
+    if (reader.Read<uint32_t>() != kEndMarker || !reader.IsValid() || !reader.IsAtEnd()) {
+        return false;
+    }
+
+    outModelData = std::move(modelData);
+    if (outAnimation) {
+        *outAnimation = std::move(animation);
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "AnimationData.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+// インポート済みモデルのバイナリキャッシュ
+// Assimpの読み込み・三角形化・頂点の展開を済ませたModelData（と、アニメーション付きモデルならスケルトンとクリップ）を
+// 元ファイルの内容のハッシュと一緒に書き出しておき、次回からはファイルをメモリにマップして読む
+// 頂点・インデックス・ボーンウェイト・キーの配列は16バイト境界に置き、要素ごとに解析せずマップした領域から一度にコピーする
+
+// キャッシュの種類（同じ元ファイルでも読み込む側によってModelDataの中身が違う）
+enum class ModelCacheKind : uint32_t {
+    StaticMesh = 1,    // Model::LoadFromGltf
+    AnimatedMesh = 2,  // AnimatedModel::LoadFromFile（スケルトンとアニメーション付き）
+};
+
+// インポートの処理（座標系の変換・頂点の展開など）を変えたら上げる。古いキャッシュは読まずに作り直す
+const uint32_t kModelCacheVersion = 3;
+
+// アニメーション付きモデルのキャッシュに入れるもの
+struct ModelCacheAnimation {
+    Skeleton skeleton;
+    std::string rootNodeName;
+    std::optional<Animation> animation;  // ファイルに含まれていたアニメーション（イベントは含めない）
+};
+
+// 元ファイルの内容のハッシュ（.gltfなら参照する.binも含める。読めなければ0）
+uint64_t HashModelSource(const std::string& directoryPath, const std::string& filename);
+
+// 元ファイルに対応するキャッシュファイルのパス
+std::string GetModelCachePath(const std::string& directoryPath, const std::string& filename, ModelCacheKind kind);
+
+// キャッシュを書き出す（一時ファイルに書いてから置き換える）。animationはAnimatedMeshのときだけ
+bool WriteModelCache(const std::string& path, ModelCacheKind kind, uint64_t sourceHash, const ModelData& modelData,
+    const ModelCacheAnimation* animation = nullptr);
+
+// キャッシュを読む。バージョン・種類・元ファイルのハッシュ・構造体の配置のどれかが違うか、壊れていればfalse
+// 配列はマップした領域から一度にコピーする（ModelDataがstd::vectorで持つため）
+bool ReadModelCache(const std::string& path, ModelCacheKind kind, uint64_t sourceHash, ModelData& outModelData,
+    ModelCacheAnimation* outAnimation = nullptr);
@@ -0,0 +1,382 @@
+#include "ObjParser.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    // 1行の中の読み取り位置
+    class LineCursor {
+    public:
+        LineCursor(const char* begin, const char* end) : current_(begin), end_(end) {}
+
+        void SkipSpaces() {
+            while (current_ < end_ && IsSpace(*current_)) {
+                ++current_;
+            }
+        }
+
+        std::string_view ReadToken() {
+            SkipSpaces();
+            const char* begin = current_;
+            while (current_ < end_ && !IsSpace(*current_)) {
+                ++current_;
+            }
+            return { begin, static_cast<size_t>(current_ - begin) };
+        }
+
+        // 行の残り（前後の空白を除く。ファイル名に空白を含む場合に使う）
+        std::string_view ReadRest() {
+            SkipSpaces();
+            const char* last = end_;
+            while (last > current_ && IsSpace(last[-1])) {
+                --last;
+            }
+            std::string_view rest(current_, static_cast<size_t>(last - current_));
+            current_ = end_;
+            return rest;
+        }
+
+        // 読めなければ値を変えずにfalse
+        bool ReadFloat(float& value) {
+            SkipSpaces();
+            if (current_ < end_ && *current_ == '+') {
+                ++current_;
+            }
+            float parsed = 0.0f;
+            std::from_chars_result result = std::from_chars(current_, end_, parsed);
+            if (result.ec != std::errc()) {
+                return false;
+            }
+            value = parsed;
+            current_ = result.ptr;
+            return true;
+        }
+
+        bool IsAtEnd() {
+            SkipSpaces();
+            return current_ >= end_;
+        }
+
+    private:
+        const char* current_;
+        const char* end_;
+    };
+
+    // 行ごとに処理する（改行はLF・CRLFのどちらでもよい）
+    template <typename Function>
+    void ForEachLine(std::string_view text, Function&& function) {
+        const char* current = text.data();
+        const char* end = text.data() + text.size();
+        while (current < end) {
+            const char* lineEnd = static_cast<const char*>(std::memchr(current, '\n', static_cast<size_t>(end - current)));
+            if (!lineEnd) {
+                lineEnd = end;
+            }
+            LineCursor cursor(current, lineEnd);
+            function(cursor);
+            current = lineEnd + 1;
+        }
+    }
+
+    // 行の種類ごとの数（面は三角形とみなす）
+    struct ObjLineCounts {
+        size_t positions = 0;
+        size_t texcoords = 0;
+        size_t normals = 0;
+        size_t faces = 0;
+    };
+
+    // 行頭の2文字だけを見て数える（行頭の空白は考えない。確保の目安なので正確でなくてよい）
+    ObjLineCounts CountLines(std::string_view text) {
+        ObjLineCounts counts;
+        const char* current = text.data();
+        const char* end = text.data() + text.size();
+        while (end - current >= 2) {
+            if (current[0] == 'v') {
+                counts.positions += IsSpace(current[1]) ? 1 : 0;
+                counts.texcoords += current[1] == 't' ? 1 : 0;
+                counts.normals += current[1] == 'n' ? 1 : 0;
+            } else if (current[0] == 'f' && IsSpace(current[1])) {
+                ++counts.faces;
+            }
+            const char* lineEnd = static_cast<const char*>(std::memchr(current, '\n', static_cast<size_t>(end - current)));
+            if (!lineEnd) {
+                break;
+            }
+            current = lineEnd + 1;
+        }
+        return counts;
+    }
+
+    // 面の1頂点の要素のインデックス（0始まり、なければ-1）
+    struct ObjCorner {
+        int32_t position;
+        int32_t texcoord;
+        int32_t normal;
+    };
+
+    // OBJのインデックス（1始まり、負なら末尾から）を0始まりにする。範囲外・0ならfalse
+    bool ResolveIndex(int64_t index, size_t count, int32_t& outIndex) {
+        int64_t resolved = index > 0 ? index - 1 : static_cast<int64_t>(count) + index;
+        if (index == 0 || resolved < 0 || resolved >= static_cast<int64_t>(count)) {
+            return false;
+        }
+        outIndex = static_cast<int32_t>(resolved);
+        return true;
+    }
+
+    // "v", "v/vt", "v//vn", "v/vt/vn" を読む
+    bool ParseCorner(std::string_view token, size_t positionCount, size_t texcoordCount, size_t normalCount, ObjCorner& outCorner) {
+        const char* current = token.data();
+        const char* end = token.data() + token.size();
+        const size_t counts[3] = { positionCount, texcoordCount, normalCount };
+        int32_t* elements[3] = { &outCorner.position, &outCorner.texcoord, &outCorner.normal };
+        outCorner = { -1, -1, -1 };
+        for (int32_t element = 0; element < 3; ++element) {
+            if (current < end && *current != '/') {
+                int64_t index = 0;
+                std::from_chars_result result = std::from_chars(current, end, index);
+                if (result.ec != std::errc() || !ResolveIndex(index, counts[element], *elements[element])) {
+                    return false;
+                }
+                current = result.ptr;
+            } else if (element == 0) {
+                return false;
+            }
+            if (current >= end) {
+                break;
+            }
+            if (*current != '/') {
+                return false;
+            }
+            ++current;
+        }
+        return current >= end;
+    }
+
+    // 位置・UV・法線のインデックスの組から頂点番号を引く表（頂点ごとのメモリ確保なし）
+    // 同じ位置を使う頂点を位置ごとの連結リストでたどる。面は近くの位置を続けて参照することが多いので、
+    // 組全体のハッシュより参照が局所的になる
+    class CornerVertexIndex {
+    public:
+        // 見つからなければnewVertexを登録してfalse
+        bool FindOrInsert(const ObjCorner& corner, uint32_t newVertex, uint32_t& outVertex) {
+            if (static_cast<size_t>(corner.position) >= firstVertices_.size()) {
+                firstVertices_.resize(std::max(firstVertices_.size() * 2, static_cast<size_t>(corner.position) + 1), kEmpty);
+            }
+            uint32_t& first = firstVertices_[corner.position];
+            for (uint32_t vertex = first; vertex != kEmpty; vertex = vertices_[vertex].next) {
+                if (vertices_[vertex].texcoord == corner.texcoord && vertices_[vertex].normal == corner.normal) {
+                    outVertex = vertex;
+                    return true;
+                }
+            }
+            assert(newVertex == vertices_.size());
+            vertices_.push_back({ corner.texcoord, corner.normal, first });
+            first = newVertex;
+            outVertex = newVertex;
+            return false;
+        }
+
+    private:
+        static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+        struct Entry {
+            int32_t texcoord;
+            int32_t normal;
+            uint32_t next;  // 同じ位置を使う次の頂点
+        };
+
+        std::vector<uint32_t> firstVertices_;  // 位置ごとの最後に登録した頂点
+        std::vector<Entry> vertices_;
+    };
+
+    Vector3 Cross(const Vector3& a, const Vector3& b) {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    Vector3 ToVector3(const Vector4& v) { return { v.x, v.y, v.z }; }
+}
+
+void ParseObj(std::string_view text, ObjMeshData& outMesh) {
+    outMesh = ObjMeshData{};
+    std::vector<Vector4> positions;
+    std::vector<Vector2> texcoords;
+    std::vector<Vector3> normals;
+    CornerVertexIndex vertexIndex;
+
+    // 先に行の種類を数えて確保しておく（大きなファイルで配列を何度も拡張してコピーしないように）
+    ObjLineCounts counts = CountLines(text);
+    positions.reserve(counts.positions);
+    texcoords.reserve(counts.texcoords);
+    normals.reserve(counts.normals);
+    outMesh.indices.reserve(counts.faces * 3);
+    outMesh.vertices.reserve(std::max(counts.positions, std::max(counts.texcoords, counts.normals)));
+
+    // 法線のない頂点は、位置ごとに面の法線を足し合わせて最後に正規化する
+    std::vector<Vector3> positionNormals;
+    std::vector<int32_t> smoothNormalPositions;  // 頂点ごとの位置のインデックス（法線があれば-1）
+    bool hasSmoothNormal = false;
+
+    std::vector<uint32_t> faceVertices;  // 面ごとに使い回す
+    ForEachLine(text, [&](LineCursor& cursor) {
+        std::string_view identifier = cursor.ReadToken();
+        if (identifier == "v") {
+            Vector4 position = { 0.0f, 0.0f, 0.0f, 1.0f };
+            cursor.ReadFloat(position.x);
+            cursor.ReadFloat(position.y);
+            cursor.ReadFloat(position.z);
+            position.x *= -1.0f;
+            positions.push_back(position);
+        } else if (identifier == "vt") {
+            Vector2 texcoord = { 0.0f, 0.0f };
+            cursor.ReadFloat(texcoord.x);
+            cursor.ReadFloat(texcoord.y);
+            texcoord.y = 1.0f - texcoord.y;
+            texcoords.push_back(texcoord);
+        } else if (identifier == "vn") {
+            Vector3 normal = { 0.0f, 0.0f, 0.0f };
+            cursor.ReadFloat(normal.x);
+            cursor.ReadFloat(normal.y);
+            cursor.ReadFloat(normal.z);
+            normal.x *= -1.0f;
+            normals.push_back(normal);
+        } else if (identifier == "f") {
+            faceVertices.clear();
+            bool valid = true;
+            while (!cursor.IsAtEnd()) {
+                ObjCorner corner;
+                if (!ParseCorner(cursor.ReadToken(), positions.size(), texcoords.size(), normals.size(), corner)) {
+                    valid = false;
+                    break;
+                }
+                uint32_t vertex = 0;
+                if (!vertexIndex.FindOrInsert(corner, static_cast<uint32_t>(outMesh.vertices.size()), vertex)) {
+                    VertexData vertexData;
+                    vertexData.position = positions[corner.position];
+                    vertexData.texcoord = corner.texcoord >= 0 ? texcoords[corner.texcoord] : Vector2{ 0.0f, 0.0f };
+                    vertexData.normal = corner.normal >= 0 ? normals[corner.normal] : Vector3{ 0.0f, 0.0f, 0.0f };
+                    outMesh.vertices.push_back(vertexData);
+                    smoothNormalPositions.push_back(corner.normal >= 0 ? -1 : corner.position);
+                    hasSmoothNormal = hasSmoothNormal || corner.normal < 0;
+                }
+                faceVertices.push_back(vertex);
+            }
+            if (!valid || faceVertices.size() < 3) {
+                ++outMesh.skippedFaceCount;
+                return;
+            }
+
+            // 扇形に分割し、巻き順を反転して登録する
+            for (size_t i = 1; i + 1 < faceVertices.size(); ++i) {
+                const uint32_t triangle[3] = { faceVertices[i + 1], faceVertices[i], faceVertices[0] };
+                outMesh.indices.insert(outMesh.indices.end(), triangle, triangle + 3);
+                if (!hasSmoothNormal) {
+                    continue;
+                }
+                // 変換後の座標と巻き順での面の法線（長さは面積の2倍なので、足し合わせると面積で重み付けされる）
+                Vector3 p0 = ToVector3(outMesh.vertices[triangle[0]].position);
+                Vector3 p1 = ToVector3(outMesh.vertices[triangle[1]].position);
+                Vector3 p2 = ToVector3(outMesh.vertices[triangle[2]].position);
+                Vector3 faceNormal = Cross(p1 - p0, p2 - p0);
+                if (positionNormals.size() < positions.size()) {
+                    positionNormals.resize(positions.size(), Vector3{ 0.0f, 0.0f, 0.0f });
+                }
+                for (uint32_t vertex : triangle) {
+                    if (smoothNormalPositions[vertex] >= 0) {
+                        positionNormals[smoothNormalPositions[vertex]] += faceNormal;
+                    }
+                }
+            }
+        } else if (identifier == "mtllib") {
+            outMesh.materialLibrary = cursor.ReadRest();
+        }
+    });
+
+    if (!hasSmoothNormal) {
+        return;
+    }
+    for (size_t i = 0; i < outMesh.vertices.size(); ++i) {
+        if (smoothNormalPositions[i] < 0) {
+            continue;
+        }
+        // 面に使われなかった位置や面積0の面だけなら上向きにする
+        const Vector3& sum = positionNormals[smoothNormalPositions[i]];
+        float length = std::sqrt(sum.x * sum.x + sum.y * sum.y + sum.z * sum.z);
+        outMesh.vertices[i].normal = length > 0.0f ? sum / length : Vector3{ 0.0f, 1.0f, 0.0f };
+    }
+}
+
+bool LoadObjMesh(const std::string& path, ObjMeshData& outMesh) {
+    MappedFile file;
+    if (!file.Open(path)) {
+        return false;
+    }
+    std::span<const uint8_t> bytes = file.GetBytes();
+    ParseObj(std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size()), outMesh);
+    return true;
+}
+
+void ParseMaterialTemplate(std::string_view text, const std::string& directoryPath, MaterialData& outMaterial) {
+    ForEachLine(text, [&](LineCursor& cursor) {
+        std::string_view identifier = cursor.ReadToken();
+        if (identifier == "map_Kd") {
+            // オプション（-s スケール, -o オフセット など）を読んでから、最後にファイル名
+            std::string_view textureFilename;
+            while (!cursor.IsAtEnd()) {
+                std::string_view token = cursor.ReadToken();
+                if (token == "-s") {
+                    cursor.ReadFloat(outMaterial.textureScale.x);
+                    cursor.ReadFloat(outMaterial.textureScale.y);
+                    float unused = 0.0f;
+                    cursor.ReadFloat(unused);
+                } else if (token == "-o") {
+                    cursor.ReadFloat(outMaterial.textureOffset.x);
+                    cursor.ReadFloat(outMaterial.textureOffset.y);
+                    float unused = 0.0f;
+                    cursor.ReadFloat(unused);
+                } else if (token == "-t") {
+                    float unused = 0.0f;
+                    cursor.ReadFloat(unused);
+                    cursor.ReadFloat(unused);
+                    cursor.ReadFloat(unused);
+                } else if (token == "-mm") {
+                    float unused = 0.0f;
+                    cursor.ReadFloat(unused);
+                    cursor.ReadFloat(unused);
+                } else if (!token.empty() && token[0] == '-') {
+                    // 値を1つ取るその他のオプション
+                    cursor.ReadToken();
+                } else {
+                    textureFilename = token;
+                    break;
+                }
+            }
+            if (!textureFilename.empty()) {
+                outMaterial.textureFilePath = directoryPath + "/" + std::string(textureFilename);
+            }
+        } else if (identifier == "Ka" || identifier == "Kd" || identifier == "Ks") {
+            Vector4 color = { 0.0f, 0.0f, 0.0f, 1.0f };
+            cursor.ReadFloat(color.x);
+            cursor.ReadFloat(color.y);
+            cursor.ReadFloat(color.z);
+            Vector4& target = identifier == "Ka" ? outMaterial.ambient : identifier == "Kd" ? outMaterial.diffuse : outMaterial.specular;
+            target = color;
+        } else if (identifier == "Ns") {
+            cursor.ReadFloat(outMaterial.shininess);
+        } else if (identifier == "d") {
+            cursor.ReadFloat(outMaterial.alpha);
+        } else if (identifier == "Tr") {
+            float transparency = 0.0f;
+            if (cursor.ReadFloat(transparency)) {
+                outMaterial.alpha = 1.0f - transparency;
+            }
+        }
+    });
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "Mymath.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// OBJ・MTLの解析（ファイル全体をメモリにマップし、行ごとに区切りを探してstd::from_charsで数値を読む）
+// - 面は3頂点以上の多角形を扇形に三角形へ分割する
+// - 面の頂点は v, v/vt, v//vn, v/vt/vn の形式で、負のインデックスはそれまでに読んだ要素の末尾からの位置
+// - UVがなければ(0, 0)、法線がなければ同じ位置を使う面の法線を面積で重み付けした平均を使う
+// - 位置・UV・法線のインデックスの組が同じ頂点は1つにまとめ、インデックスで参照する
+// 座標は右手系から左手系へ変換し（Xを反転、Vを反転）、三角形の巻き順を反転する（従来のModel::LoadObjFileと同じ）
+
+// OBJの解析結果
+struct ObjMeshData {
+    std::vector<VertexData> vertices;  // 重複を除いた頂点
+    std::vector<uint32_t> indices;     // 三角形ごとに3つ
+    std::string materialLibrary;       // mtllibのファイル名（最後に指定されたもの。なければ空）
+    uint32_t skippedFaceCount = 0;     // 範囲外のインデックスなどで読み飛ばした面の数
+};
+
+// OBJのテキストを解析する
+void ParseObj(std::string_view text, ObjMeshData& outMesh);
+
+// ファイルをメモリにマップして解析する（開けなければfalse）
+bool LoadObjMesh(const std::string& path, ObjMeshData& outMesh);
+
+// MTLのテキストを解析する（マテリアルが複数あっても1つのMaterialDataに後の指定で上書きする。従来と同じ）
+// テクスチャのパスは directoryPath + "/" + ファイル名 にする
+void ParseMaterialTemplate(std::string_view text, const std::string& directoryPath, MaterialData& outMaterial);
@@ -80,9 +80,35 @@ bool ResourcePreloader::HasPreloadedModel(const std::string& key) const {
     return preloadedModels_.find(key) != preloadedModels_.end();
 }
 
+void ResourcePreloader::PreloadAnimationClip(const std::string& key, const std::string& directoryPath, const std::string& filename) {
+    // 既に存在する場合は何もしない
+    if (preloadedClips_.find(key) != preloadedClips_.end()) {
+        OutputDebugStringA(("ResourcePreloader: Animation clip already preloaded with key: " + key + "\n").c_str());
+        return;
+    }
+
+    totalCount_++;
+
+    auto clip = std::make_shared<AnimationClipAsset>();
+    if (!LoadAnimationClipAsset(directoryPath, filename, *clip)) {
+        OutputDebugStringA(("ResourcePreloader: Failed to preload animation clip " + key + "\n").c_str());
+        return;
+    }
+    preloadedClips_[key] = std::move(clip);
+    loadedCount_++;
+
+    OutputDebugStringA(("ResourcePreloader: Preloaded animation clip with key: " + key + "\n").c_str());
+}
+
+std::shared_ptr<const AnimationClipAsset> ResourcePreloader::GetPreloadedAnimationClip(const std::string& key) const {
+    auto it = preloadedClips_.find(key);
+    return it != preloadedClips_.end() ? it->second : nullptr;
+}
+
 void ResourcePreloader::ClearAll() {
     OutputDebugStringA("ResourcePreloader: Clearing all preloaded resources\n");
     preloadedModels_.clear();
+    preloadedClips_.clear();
     totalCount_ = 0;
     loadedCount_ = 0;
 }
\ No newline at end of file
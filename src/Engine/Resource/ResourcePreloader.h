@@ -24,6 +24,12 @@ public:
     // プリロードされたモデルが存在するか確認
     bool HasPreloadedModel(const std::string& key) const;
 
+    // アニメーションだけのアセットのプリロード（メッシュを作らない。複数のモデルで共有する）
+    void PreloadAnimationClip(const std::string& key, const std::string& directoryPath, const std::string& filename);
+
+    // プリロードされたアニメーションの取得（所有権は移動せず共有する。なければnullptr）
+    std::shared_ptr<const AnimationClipAsset> GetPreloadedAnimationClip(const std::string& key) const;
+
     // プリロード進行状況を取得（0.0-1.0）
     float GetPreloadProgress() const { return totalCount_ > 0 ? float(loadedCount_) / float(totalCount_) : 1.0f; }
 
@@ -38,6 +44,9 @@ private:
 
     // プリロードされたモデルの保存
     std::unordered_map<std::string, std::unique_ptr<AnimatedModel>> preloadedModels_;
+
+    // プリロードされたアニメーションだけのアセット
+    std::unordered_map<std::string, std::shared_ptr<const AnimationClipAsset>> preloadedClips_;
     
     // プリロード進行状況管理
     int totalCount_ = 0;
@@ -0,0 +1,104 @@
+#include "VertexWeld.h"
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    const uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+    // scaleは許容差の逆数（0なら完全一致）
+    int32_t Quantize(float value, float scale) {
+        if (scale == 0.0f) {
+            // -0と0を同じにする
+            return value == 0.0f ? 0 : std::bit_cast<int32_t>(value);
+        }
+        float cell = std::floor(value * scale + 0.5f);
+        if (!(cell >= -2147483648.0f)) {
+            return std::numeric_limits<int32_t>::min();  // NaNもここ
+        }
+        if (cell >= 2147483648.0f) {
+            return std::numeric_limits<int32_t>::max();
+        }
+        return static_cast<int32_t>(cell);
+    }
+
+    float GetQuantizeScale(float epsilon) { return epsilon > 0.0f ? 1.0f / epsilon : 0.0f; }
+
+    uint64_t HashKey(const int32_t (&values)[10]) {
+        uint64_t hash = 0;
+        for (int32_t value : values) {
+            hash = (hash ^ static_cast<uint32_t>(value)) * 0x9E3779B97F4A7C15ull;
+        }
+        return hash ^ (hash >> 32);
+    }
+}
+
+uint32_t VertexWelder::Weld(const VertexData* vertices, size_t count, const VertexWeldSettings& settings, uint32_t* outRemap,
+    std::vector<VertexData>& outVertices, const uint64_t* vertexKeys) {
+    // 負荷率を1/2以下に保つ2のべき乗
+    size_t capacity = 16;
+    while (capacity < count * 2) {
+        capacity *= 2;
+    }
+    slots_.assign(capacity, kEmpty);
+    keys_.resize(count);
+    outVertices.clear();
+    outVertices.reserve(count);
+
+    const size_t mask = capacity - 1;
+    const float positionScale = GetQuantizeScale(settings.positionEpsilon);
+    const float normalScale = GetQuantizeScale(settings.normalEpsilon);
+    const float texcoordScale = GetQuantizeScale(settings.texcoordEpsilon);
+    for (size_t i = 0; i < count; ++i) {
+        const VertexData& vertex = vertices[i];
+        Key key = { {
+            Quantize(vertex.position.x, positionScale),
+            Quantize(vertex.position.y, positionScale),
+            Quantize(vertex.position.z, positionScale),
+            Quantize(vertex.normal.x, normalScale),
+            Quantize(vertex.normal.y, normalScale),
+            Quantize(vertex.normal.z, normalScale),
+            Quantize(vertex.texcoord.x, texcoordScale),
+            Quantize(vertex.texcoord.y, texcoordScale),
+            static_cast<int32_t>(vertexKeys ? vertexKeys[i] : 0),
+            static_cast<int32_t>(vertexKeys ? vertexKeys[i] >> 32 : 0),
+        } };
+        for (size_t slot = HashKey(key.values) & mask;; slot = (slot + 1) & mask) {
+            uint32_t welded = slots_[slot];
+            if (welded == kEmpty) {
+                welded = static_cast<uint32_t>(outVertices.size());
+                slots_[slot] = welded;
+                keys_[welded] = key;
+                outVertices.push_back(vertex);
+                outRemap[i] = welded;
+                break;
+            }
+            if (std::memcmp(keys_[welded].values, key.values, sizeof(key.values)) == 0) {
+                outRemap[i] = welded;
+                break;
+            }
+        }
+    }
+    return static_cast<uint32_t>(outVertices.size());
+}
+
+void WeldMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices, const VertexWeldSettings& settings,
+    std::vector<uint32_t>* outRemap, const uint64_t* vertexKeys) {
+    std::vector<uint32_t> remap(vertices.size());
+    std::vector<VertexData> welded;
+    VertexWelder welder;
+    welder.Weld(vertices.data(), vertices.size(), settings, remap.data(), welded, vertexKeys);
+
+    if (indices.empty()) {
+        indices = remap;
+    } else {
+        for (uint32_t& index : indices) {
+            index = remap[index];
+        }
+    }
+    vertices = std::move(welded);
+    if (outRemap) {
+        *outRemap = std::move(remap);
+    }
+}
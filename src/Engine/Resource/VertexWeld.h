@@ -0,0 +1,43 @@
+#pragma once
+#include "Mymath.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 頂点の溶接（位置・法線・UVが同じ頂点を1つにまとめ、インデックスで参照する）
+// 各要素を整数に量子化したものをキーにして開番地法のハッシュ表で引く（頂点ごとのメモリ確保なし、O(n)）
+
+// 溶接の設定（要素ごとの許容差）
+// 0なら完全一致（floatのビットパターンで比べる。-0と0だけは同じとみなす）
+// 正ならその幅の格子に丸めて比べる。同じ格子に入った頂点をまとめるので、格子の境界をまたぐ近い値はまとまらない
+struct VertexWeldSettings {
+    float positionEpsilon = 0.0f;
+    float normalEpsilon = 0.0f;
+    float texcoordEpsilon = 0.0f;
+};
+
+class VertexWelder {
+public:
+    // count個の頂点をまとめ、outRemap[i]に元の頂点iのまとめた後の番号を書く（outRemapはcount個）
+    // まとめた頂点は最初に現れたものの値を使い、現れた順にoutVerticesへ入れる。戻り値はまとめた頂点の数
+    // 作業用の配列は使い回すので、同じインスタンスで続けて溶接すれば確保は配列が足りないときだけになる
+    // vertexKeysは頂点ごとの追加のキー（count個）。VertexDataにないデータ（ボーンウェイトなど）が違う頂点をまとめないために使う
+    uint32_t Weld(const VertexData* vertices, size_t count, const VertexWeldSettings& settings, uint32_t* outRemap,
+        std::vector<VertexData>& outVertices, const uint64_t* vertexKeys = nullptr);
+
+private:
+    // 量子化した位置・法線・UVと追加のキー
+    struct Key {
+        int32_t values[10];
+    };
+
+    std::vector<uint32_t> slots_;  // まとめた頂点の番号（空きはkEmpty）
+    std::vector<Key> keys_;        // まとめた頂点ごとのキー
+};
+
+// メッシュを溶接してインデックスバッファにする
+// indicesが空なら頂点を3つずつの三角形とみなし、対応表がそのままインデックスバッファになる
+// indicesがあれば対応表で付け替える。outRemapには元の頂点ごとのまとめた後の番号を入れる
+// vertexKeysはVertexWelder::Weldと同じ（nullptrなら使わない）
+void WeldMesh(std::vector<VertexData>& vertices, std::vector<uint32_t>& indices, const VertexWeldSettings& settings,
+    std::vector<uint32_t>* outRemap = nullptr, const uint64_t* vertexKeys = nullptr);
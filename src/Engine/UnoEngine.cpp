@@ -87,6 +87,9 @@ void UnoEngine::Initialize() {
         // 3Dエフェクトマネージャの初期化
         EffectManager3D::GetInstance()->Initialize();
 
+        // アニメーションシステムの初期化（スケルトンの評価をワーカースレッドで行う）
+        AnimationSystem::GetInstance()->Initialize();
+
         // AABBコリジョンマネージャの初期化
         Collision::AABBCollisionManager::Create();
 
@@ -164,6 +167,12 @@ void UnoEngine::Update() {
         // シーンマネージャーの更新
         SceneManager::GetInstance()->Update();
 
+        // シーン内で登録されたアニメーションをまとめて評価
+        AnimationSystem::GetInstance()->Execute();
+
+        // 評価済みのスケルトンを読む更新（ジョイントに追従するカメラなど）
+        SceneManager::GetInstance()->PostAnimationUpdate();
+
         // SceneManagerからの終了リクエストをチェック
         if (SceneManager::GetInstance()->ShouldExit()) {
             endRequest_ = true;
@@ -226,6 +235,9 @@ void UnoEngine::Finalize() {
         // エフェクトマネージャの終了処理
         EffectManager3D::GetInstance()->Finalize();
 
+        // アニメーションシステムの終了処理（ワーカースレッドを停止）
+        AnimationSystem::GetInstance()->Finalize();
+
         // AABBコリジョンマネージャの終了処理
         Collision::AABBCollisionManager::Destroy();
 
@@ -444,6 +456,23 @@ void UnoEngine::ShowDebugInfo() {
     totalParticles += particleManager->GetParticleCount("smoke");
     ImGui::Text("アクティブパーティクル数: %d", totalParticles);
 
+    // アニメーションの評価（ワーカースレッド数を含む）
+    auto* animationSystem = AnimationSystem::GetInstance();
+    ImGui::Text("アニメーション: %u体 (評価%u体) %.2fms (%uスレッド)", animationSystem->GetLastInstanceCount(),
+        animationSystem->GetLastEvaluatedCount(), animationSystem->GetLastExecuteMilliseconds(),
+        JobSystem::GetInstance()->GetThreadCount());
+    AnimationLodSettings lodSettings = animationSystem->GetLodSettings();
+    if (ImGui::Checkbox("アニメーションLOD", &lodSettings.enabled)) {
+        animationSystem->SetLodSettings(lodSettings);
+    }
+    const AnimationPoseCache& poseCache = animationSystem->GetPoseCache();
+    ImGui::Text("ポーズキャッシュ: ヒット%u (パレット共有%u) ミス%u", poseCache.GetPoseHitCount() + poseCache.GetPaletteHitCount(),
+        poseCache.GetPaletteHitCount(), poseCache.GetMissCount());
+    bool poseCacheEnabled = animationSystem->IsPoseCacheEnabled();
+    if (ImGui::Checkbox("ポーズキャッシュ", &poseCacheEnabled)) {
+        animationSystem->SetPoseCacheEnabled(poseCacheEnabled);
+    }
+
     // 入力状態
     if (ImGui::TreeNode("入力状態")) {
         ImGui::Text("ESC: %s", input_->PushKey(DIK_ESCAPE) ? "押下中" : "未押下");
@@ -25,8 +25,10 @@
 #include "AnimatedModel.h"
 #include "Animation.h"
 #include "AnimationPlayer.h"
-#include "AnimationBlender.h"
+#include "AnimationBlendTree.h"
 #include "AnimationUtility.h"
+#include "AnimationSystem.h"
+#include "JobSystem.h"
 
 // 衝突判定関連
 #include "CollisionPrimitive.h"
@@ -33,18 +33,6 @@ void Player::Initialize(Camera* camera, bool enableCollision, bool enableEnviron
         // アニメーション登録
         Animation walkAnim = animatedModel_->GetAnimationPlayer().GetAnimation();
         animatedModel_->AddAnimation("walk", walkAnim);
-        
-        // スニークモデルもプリロード済みを使用
-        auto preloadedSneak = ResourcePreloader::GetInstance()->GetPreloadedModel("human_sneak");
-        if (preloadedSneak) {
-            Animation sneakWalkAnim = preloadedSneak->GetAnimationPlayer().GetAnimation();
-            animatedModel_->AddAnimation("sneakWalk", sneakWalkAnim);
-            OutputDebugStringA("Player: Using preloaded sneak animation\n");
-        } else {
-            // フォールバック: 通常読み込み
-            Animation sneakWalkAnim = engine->LoadAnimation("Resources/Models/human", "sneakWalk.gltf");
-            animatedModel_->AddAnimation("sneakWalk", sneakWalkAnim);
-        }
     } else {
         OutputDebugStringA("Player: Preloaded model not found, loading normally\n");
         // フォールバック: 通常読み込み
@@ -53,7 +41,18 @@ void Player::Initialize(Camera* camera, bool enableCollision, bool enableEnviron
         
         Animation walkAnim = animatedModel_->GetAnimationPlayer().GetAnimation();
         animatedModel_->AddAnimation("walk", walkAnim);
-        
+    }
+    
+    // スニークはアニメーションだけのアセットをリターゲットして追加（メッシュを持つモデルを別に作らない）
+    std::shared_ptr<const AnimationClipAsset> sneakClip = ResourcePreloader::GetInstance()->GetPreloadedAnimationClip("human_sneak");
+    if (!sneakClip) {
+        // フォールバック: 通常読み込み
+        auto clip = std::make_shared<AnimationClipAsset>();
+        if (LoadAnimationClipAsset("Resources/Models/human", "sneakWalk.gltf", *clip)) {
+            sneakClip = std::move(clip);
+        }
+    }
+    if (!sneakClip || !animatedModel_->AddRetargetedAnimation("sneakWalk", *sneakClip)) {
         Animation sneakWalkAnim = engine->LoadAnimation("Resources/Models/human", "sneakWalk.gltf");
         animatedModel_->AddAnimation("sneakWalk", sneakWalkAnim);
     }
@@ -226,6 +225,19 @@ void Player::DrawUI() {
         SetRotationSmoothingSpeed(smoothingSpeed);
     }
 
+    bool useRootMotion = useRootMotion_;
+    if (ImGui::Checkbox("Root Motion", &useRootMotion)) {
+        SetUseRootMotion(useRootMotion);
+    }
+    if (useRootMotion_) {
+        ImGui::Text("Root Motion Driven: %s", IsRootMotionDriven() ? "YES" : "NO (in-place clip)");
+    }
+
+    bool useFootIk = useFootIk_;
+    if (ImGui::Checkbox("Foot IK", &useFootIk)) {
+        SetUseFootIk(useFootIk);
+    }
+
     ImGui::End();
 #endif
 }
@@ -428,6 +440,48 @@ void Player::UpdateAnimation(float deltaTime) {
     } else {
         animatedModel_->Update(0.0f);
     }
+    
+    // ルートモーションで位置を進める（モデル空間の移動をスケールと向きに合わせてワールドに移す）
+    // 向きは入力で決めるため、クリップの回転は使わない
+    RootMotionDelta rootMotion = animatedModel_->ConsumeRootMotion();
+    if (isMoving_ && IsRootMotionDriven()) {
+        const Vector3& scale = object3d_->GetScale();
+        Vector3 movement = RotateYaw({ rootMotion.translate.x * scale.x, rootMotion.translate.y * scale.y, rootMotion.translate.z * scale.z }, currentRotationY_);
+        position_.x += movement.x;
+        position_.z += movement.z;
+    }
+}
+
+void Player::SetUseRootMotion(bool use) {
+    if (use) {
+        useRootMotion_ = animatedModel_->EnableRootMotion("mixamorig:Hips");
+    } else {
+        animatedModel_->DisableRootMotion();
+        useRootMotion_ = false;
+    }
+}
+
+void Player::SetUseFootIk(bool use) {
+    if (use && object3d_->GetFootIkRig().GetLegCount() == 0) {
+        object3d_->AddFootIkLeg("mixamorig:LeftUpLeg", "mixamorig:LeftLeg", "mixamorig:LeftFoot");
+        object3d_->AddFootIkLeg("mixamorig:RightUpLeg", "mixamorig:RightLeg", "mixamorig:RightFoot");
+    }
+    object3d_->SetFootIkEnabled(use);
+    useFootIk_ = object3d_->IsFootIkEnabled();
+}
+
+bool Player::IsRootMotionDriven() const {
+    if (!useRootMotion_) {
+        return false;
+    }
+    // 1ループで前に進まないクリップは、位置を速度の定数で進める
+    const float kMinLoopTravel = 0.01f;
+    const RootMotionTrack* track = animatedModel_->FindRootMotionTrack(animatedModel_->GetCurrentAnimationName());
+    if (!track) {
+        return false;
+    }
+    const Vector3& travel = track->GetLoopDelta().translate;
+    return std::sqrt(travel.x * travel.x + travel.z * travel.z) > kMinLoopTravel;
 }
 
 void Player::UpdateRotation(UnoEngine* engine, float deltaTime) {
@@ -550,9 +604,11 @@ void Player::MoveWithCameraDirection(float forward, float right, float deltaTime
         }
         float distance = currentSpeed * deltaTime;
         
-        // プレイヤーの位置を更新
-        position_.x += moveDirection.x * distance;
-        position_.z += moveDirection.z * distance;
+        // プレイヤーの位置を更新（ルートモーションで進む場合はUpdateAnimationで移動する）
+        if (!IsRootMotionDriven()) {
+            position_.x += moveDirection.x * distance;
+            position_.z += moveDirection.z * distance;
+        }
         
         // プレイヤーの向きを移動方向に設定
         targetRotationY_ = std::atan2(moveDirection.x, moveDirection.z);
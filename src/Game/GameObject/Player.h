@@ -32,6 +32,14 @@ public:
     void ResetAnimation();
     void ToggleSneakWalk();
     bool IsAnimationPaused() const { return animationPaused_; }
+    
+    // ルートモーション（有効ならクリップの腰の移動で位置を進める。その場で足踏みするクリップでは速度の定数を使う）
+    void SetUseRootMotion(bool use);
+    bool IsUsingRootMotion() const { return useRootMotion_; }
+    
+    // 足のIK（有効なら足元のコリジョンの高さに合わせて脚を曲げる）
+    void SetUseFootIk(bool use);
+    bool IsUsingFootIk() const { return useFootIk_; }
     std::string GetCurrentAnimationName() const;
     
     // 状態取得
@@ -87,6 +95,9 @@ private:
     void UpdateGravity(float deltaTime);
     void CheckGroundCollision();
     
+    // 現在のクリップの移動で位置を進めるか（ルートモーションが有効で、クリップが前に進む場合）
+    bool IsRootMotionDriven() const;
+    
     // モデル関連
     std::unique_ptr<Object3d> object3d_;
     std::unique_ptr<AnimatedModel> animatedModel_;
@@ -114,6 +125,8 @@ private:
     bool isBlending_ = false;
     float blendTimer_ = 0.0f;
     const float BLEND_DURATION = 0.3f;
+    bool useRootMotion_ = false;
+    bool useFootIk_ = false;
 
     // 重力・ジャンプ関連
     Vector3 velocity_ = Vector3{0.0f, 0.0f, 0.0f};
@@ -15,6 +15,12 @@ void GamePlayScene::Initialize() {
     lightManager_ = std::make_unique<LightManager>();
     lightManager_->Initialize();
 
+    // ヒットエフェクトのインスタンスを先に確保しておく（戦闘中にエミッターを作らないように）
+    EffectManager3D* effectManager = engine->GetEffectManager3D();
+    for (uint32_t i = 0; i < EffectManager3D::kEffectTypeCount; ++i) {
+        effectManager->Prewarm(static_cast<HitEffect3D::EffectType>(i), kHitEffectPrewarmCount);
+    }
+
     // FPSカメラの初期化（true: 一人称, false: 三人称）
     fpsCamera_ = std::make_unique<FPSCamera>();
     fpsCamera_->Initialize(true); 
@@ -95,9 +101,8 @@ void GamePlayScene::Update() {
     // FPSカメラモードかどうかでカメラ更新を切り替え
     if (fpsCamera_ && fpsCamera_->IsFPSMode()) {
         // FPSモード: FPSカメラ専用の更新
+        // 目のジョイントへの追従は今フレームのポーズが出てからPostAnimationUpdateで行う
         fpsCamera_->UpdateCameraRotation(camera_, engine);
-        player_->UpdateFPSCamera(fpsCamera_.get());
-        camera_->Update();
     } else {
         // 三人称モード: 通常のカメラシステム
         player_->UpdateCameraSystem(engine);
@@ -157,6 +162,24 @@ void GamePlayScene::Update() {
 #endif
 }
 
+void GamePlayScene::PostAnimationUpdate() {
+    if (!fpsCamera_ || !fpsCamera_->IsFPSMode()) {
+        return;
+    }
+
+    // 今フレームに評価した目のジョイント位置へカメラを合わせる
+    player_->UpdateFPSCamera(fpsCamera_.get());
+    camera_->Update();
+
+    // Updateで計算した行列は移動前のカメラなので描画するものだけ計算し直す（FPSモードではプレイヤーは描画しない）
+    if (ground_) {
+        ground_->UpdateTransformationMatrix();
+    }
+    if (objeObject_) {
+        objeObject_->UpdateTransformationMatrix();
+    }
+}
+
 void GamePlayScene::Draw() {
     if (skyboxEnabled_ && skybox_) {
         skybox_->Draw(camera_);
@@ -13,6 +13,7 @@ public:
 
     void Initialize() override;
     void Update() override;
+    void PostAnimationUpdate() override;
     void Draw() override;
     void Finalize() override;
 
@@ -21,6 +22,9 @@ private:
     void UpdateCamera();
     void DrawUI();
 
+    // シーン読み込み時に確保しておくヒットエフェクトの数（タイプごと）
+    static const uint32_t kHitEffectPrewarmCount = 4;
+
     std::unique_ptr<Player> player_;
     std::unique_ptr<Object3d> ground_;
     std::unique_ptr<AnimatedModel> groundModel_;
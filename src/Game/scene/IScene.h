@@ -22,6 +22,8 @@ public:
 
     virtual void Initialize() = 0;
     virtual void Update() = 0;
+    // AnimationSystem::Execute後の更新（今フレームのスケルトンを読む処理：カメラのジョイント追従など）
+    virtual void PostAnimationUpdate() {}
     virtual void Draw() = 0;
     virtual void Finalize() = 0;
 
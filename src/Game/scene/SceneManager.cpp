@@ -83,6 +83,17 @@ void SceneManager::Update() {
     }
 }
 
+void SceneManager::PostAnimationUpdate() {
+    if (currentScene_) {
+        try {
+            currentScene_->PostAnimationUpdate();
+        }
+        catch (const std::exception&) {
+            // エラーは無視
+        }
+    }
+}
+
 void SceneManager::Draw() {
     // SRVヒープを描画前に設定
     if (srvManager_) {
@@ -34,6 +34,9 @@ public:
     // 更新
     void Update();
 
+    // アニメーション評価後の更新
+    void PostAnimationUpdate();
+
     // 描画
     void Draw();
 
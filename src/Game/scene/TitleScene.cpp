@@ -46,7 +46,8 @@ void TitleScene::Initialize() {
     noiseSprite_->setColor({ 1.0f, 1.0f, 1.0f, 0.0f }); // 初期は透明
 
     ResourcePreloader::GetInstance()->PreloadAnimatedModelLightweight("human_walk", "Resources/Models/human", "walk.gltf", dxCommon_);
-    ResourcePreloader::GetInstance()->PreloadAnimatedModelLightweight("human_sneak", "Resources/Models/human", "sneakWalk.gltf", dxCommon_);
+    // スニークはアニメーションだけを読み込み、歩きのモデルのスケルトンにリターゲットして使う
+    ResourcePreloader::GetInstance()->PreloadAnimationClip("human_sneak", "Resources/Models/human", "sneakWalk.gltf");
 
     // ランダム砂嵐の初期タイミングを設定
     srand(static_cast<unsigned int>(time(nullptr)));